@@ -58,6 +58,7 @@ Four EduBfM_DiscardAll(void)
     Four 	e;			/* error */
     Two 	i;			/* index */
     Four 	type;			/* buffer type */
+    BFM_LATENCY(BFM_API_DISCARDALL);
 
     for (type = 0; type < NUM_BUF_TYPES; type++) {
         for (i = 0; i < BI_NBUFS(type); i++) {
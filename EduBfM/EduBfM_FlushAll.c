@@ -59,6 +59,7 @@ Four EduBfM_FlushAll(void)
     Four        e;                      /* error */
     Two         i;                      /* index */
     Four        type;                   /* buffer type */
+    BFM_LATENCY(BFM_API_FLUSHALL);
 
     // For All Type of Buffer Pools
     for (type = 0; type < NUM_BUF_TYPES; type++) {
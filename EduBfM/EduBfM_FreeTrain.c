@@ -62,6 +62,7 @@ Four EduBfM_FreeTrain(
 {
     Four                index;          /* index on buffer holding the train */
     Four 		e;		/* error code */
+    BFM_LATENCY(BFM_API_FREETRAIN);
 
     /*@ check if the parameter is valid. */
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
@@ -74,6 +74,7 @@ Four EduBfM_GetTrain(
 {
     Four                e;                      /* for error */
     Four                index;                  /* index of the buffer pool */
+    BFM_LATENCY(BFM_API_GETTRAIN);
 
 
     /*@ Check the validity of given parameters */
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Latency.c
+ *
+ * Description :
+ *  Count the latencies of the calls of the interface functions of EduBfM.
+ *  The histograms are kept by Util_latency.c; this file has the table of
+ *  the interface functions, and UTIL_LATENCY_FUNCTIONS() defines the
+ *  functions below on it.
+ *
+ * Exports:
+ *  Four EduBfM_SetLatencyTracking(Boolean, Four)
+ *  Four EduBfM_GetLatency(Four, BufferLatency*)
+ *  Four EduBfM_ResetLatency(void)
+ *  Four EduBfM_DumpLatency(FILE*)
+ *  Util_LatencyTimer edubfm_BeginLatency(Four)
+ *  void edubfm_EndLatency(Util_LatencyTimer*)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* Names of the interface functions, in the order of BFM_API_* */
+static const char *edubfm_apiNames[BFM_NAPIS] = {
+    "GetTrain", "FreeTrain", "SetDirty", "DiscardAll", "FlushAll" };
+
+static Util_LatencyTable edubfm_latency = UTIL_LATENCY_TABLE(edubfm_apiNames, BFM_NAPIS); /* latencies of EduBfM */
+static __thread Util_LatencyThread *edubfm_latencyThread = NULL; /* histograms of this thread */
+
+
+/*@
+ * EduBfM_SetLatencyTracking(), EduBfM_GetLatency(), EduBfM_ResetLatency(),
+ * EduBfM_DumpLatency(), and edubfm_BeginLatency()/edubfm_EndLatency() called by BFM_LATENCY()
+ */
+UTIL_LATENCY_FUNCTIONS(EduBfM, edubfm, edubfm_latency, edubfm_latencyThread, BufferLatency, eBADPARAMETER_EDUBFM, eMEMORYALLOCERR_EDUBFM)
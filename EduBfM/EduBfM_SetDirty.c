@@ -65,6 +65,7 @@ Four EduBfM_SetDirty(
     Four                type )                  /* IN buffer type */
 {
     Four                index;                  /* an index of the buffer table & pool */
+    BFM_LATENCY(BFM_API_SETDIRTY);
 
 
     /*@ Is the paramter valid? */
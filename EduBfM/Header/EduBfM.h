@@ -26,6 +26,9 @@
 #define _EDUBFM_H_
 
 
+#include "EduBfM_Internal.h"
+
+
 /*@
  * Function Prototypes
  */
@@ -35,6 +38,10 @@ Four EduBfM_GetTrain(TrainID *, char **, Four);
 Four EduBfM_SetDirty(TrainID *, Four);
 Four EduBfM_DiscardAll(void);
 Four EduBfM_FlushAll(void);
+Four EduBfM_SetLatencyTracking(Boolean, Four);
+Four EduBfM_GetLatency(Four, BufferLatency*);
+Four EduBfM_ResetLatency(void);
+Four EduBfM_DumpLatency(FILE*);
 
 
 #endif /* _EDUBFM_H_ */
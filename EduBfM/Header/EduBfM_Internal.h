@@ -25,6 +25,8 @@
 #ifndef _EDUBFM_INTERNAL_H_
 #define _EDUBFM_INTERNAL_H_
 
+#include "Util_latency.h"
+
 
 /*@
  * Constant Definitions
@@ -109,6 +111,21 @@ typedef struct {
     Two*       		 	hashTable;	/* hash table */
 } BufferInfo;
 
+
+/*
+ * Latency Histograms:
+ *  The latency of each call of an interface function is counted in the
+ *  per-thread histograms of Util_latency.c, which are shared by the
+ *  modules; nothing is counted unless the tracking is switched on by
+ *  EduBfM_SetLatencyTracking().
+ */
+/* The interface functions whose latencies are counted */
+enum { BFM_API_GETTRAIN, BFM_API_FREETRAIN, BFM_API_SETDIRTY,
+       BFM_API_DISCARDALL, BFM_API_FLUSHALL, BFM_NAPIS };
+
+/* The latencies of an interface function, merged over all threads, in microseconds */
+typedef Util_Latency BufferLatency;
+
 /* Macro: BI_BUFSIZE(type)
  * Description: return the size of a buffer element of a buffer pool (unit: # of pages)
  * Parameter:
@@ -230,6 +247,17 @@ typedef struct {
 
 extern BufferInfo bufInfo[];
 
+/* Macro: BFM_LATENCY(api)
+ * Description: count the latency of the current call of an interface function;
+ *              must be the last declaration of the function. The latency is
+ *              counted when the function returns, on any path.
+ * Parameters:
+ *  Four api                        : the interface function, one of BFM_API_*
+ */
+#define BFM_LATENCY(api) \
+    Util_LatencyTimer _latencyTimer __attribute__((cleanup(edubfm_EndLatency))) = edubfm_BeginLatency(api)
+
+
 /*@
  * Function Prototypes
  */
@@ -241,6 +269,8 @@ Four edubfm_FlushTrain(TrainID *, Four);
 Four edubfm_Insert(BfMHashKey *, Two, Four); 
 Four edubfm_LookUp(BfMHashKey *, Four);
 Four edubfm_ReadTrain(TrainID *, char *, Four);
+Util_LatencyTimer edubfm_BeginLatency(Four);
+void edubfm_EndLatency(Util_LatencyTimer*);
 
 
 #endif /* _EDUBFM_INTERNAL_H_ */
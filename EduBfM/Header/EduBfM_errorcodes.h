@@ -97,3 +97,5 @@
 #define eNOMORELOCKCONTROLBLOCKS_BFM             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,59)
 #define NUM_ERRORS_BFM_ERR_BASE                  60
 #define eNOTSUPPORTED_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,61)
+#define eBADPARAMETER_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,62)
+#define eMEMORYALLOCERR_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,63)
@@ -0,0 +1,840 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Bench.c
+ *
+ * Description : 
+ *  Benchmark of EduBtM driven by workload files. Each workload is a load
+ *  file followed by a transaction file in the format of test/workloads:
+ *  one INSERT, DELETE or SCAN operation per line. A workload is run a
+ *  number of times on a new index each time; the first runs warm up and
+ *  are not measured. The latency of every operation is measured, and the
+ *  throughput and the latency percentiles of each type of operation are
+ *  reported in JSON together with the buffer hit ratio of each run.
+ *
+ *  The buffer hit ratio counts the pages the index asks of the buffer
+ *  manager. It is measured by wrapping BfM_GetTrain() at link time (see
+ *  the EduBtM_Bench target of the Makefile): before a page is fixed, the
+ *  buffer hash table is looked up to see whether the page is resident.
+ *
+ * Usage:
+ *  EduBtM_Bench [-w warmups] [-r runs] [-o output] [-d directory] [-k int|email]
+ *               [-p pages] [-s pageSize] [-b] [-m writeBufferKB] [-a] [-l slowUs] [workload ...]
+ *  A workload is "load,txns" or "txns". Without workloads, the performance
+ *  workloads of the directory (test/workloads/ by default) are run.
+ *  With -s, the indexes use pages of 1024, 2048 or 4096 (default) bytes.
+ *  With -b, the indexes buffer the insertions at the root (BTM_BUFFERED).
+ *  With -m, the indexes keep the insertions in a write buffer of the given
+ *  size in memory; the buffer is merged into the tree before the index is
+ *  dropped, within the time of the run.
+ *  With -a, the indexes are kept in adaptive radix trees in memory (BTM_ART)
+ *  instead of B+ trees, to compare the two engines on the same workloads.
+ *  With -l, the latency histograms of EduBtM are switched on and dumped to
+ *  stderr at the end, with the calls taking slowUs microseconds or more.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdint.h>
+#include "EduBtM_common.h"
+#include "OM_Internal.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+#include "EduBtM_TestModule.h"
+
+
+#define BENCH_MAXWORKLOADS	64			/* max # of workloads of a benchmark */
+#define BENCH_MAXRUNS		100			/* max # of measured runs of a workload */
+#define BENCH_NPHASES		2			/* load and transaction phases */
+#define BENCH_NOPS			3			/* INSERT, DELETE and SCAN */
+#define BENCH_DEFAULTWARMUPS	1
+#define BENCH_DEFAULTRUNS	5
+#define BENCH_DEFAULTPAGES	20000		/* # of pages of the benchmark volume */
+#define BENCH_MAXLINE		1024
+
+#define OPINDEX(op)			((op) - INSERT)	/* index of an operation in the arrays */
+
+struct benchWorkload {
+	char		name[MAXFILENAME];		/* name in the report */
+	char		load[MAXFILENAME];		/* load file; empty if none */
+	char		txns[MAXFILENAME];		/* transaction file */
+	Four		keyType;				/* RANDINT or EMAIL */
+};
+
+struct benchLatencies {
+	uint64_t	*ns;					/* latency of each operation in ns */
+	Four		n;						/* # of latencies */
+	Four		max;					/* # of latencies the array can hold */
+	uint64_t	total;					/* sum of the latencies */
+};
+
+struct benchRun {
+	uint64_t	elapsedNs;				/* time of the run */
+	Four		count[BENCH_NPHASES][BENCH_NOPS];	/* # of operations */
+	uint64_t	ns[BENCH_NPHASES][BENCH_NOPS];		/* time spent in the operations */
+	Four		nGets;					/* # of pages asked of the buffer manager */
+	Four		nHits;					/* # of pages found in the buffer */
+};
+
+static const char *phaseNames[BENCH_NPHASES] = { "load", "txns" };
+static const char *opNames[BENCH_NOPS] = { "INSERT", "DELETE", "SCAN" };
+
+static Four benchGets = 0;				/* # of BfM_GetTrain() calls */
+static Four benchHits = 0;				/* # of the calls which found the page in the buffer */
+static Four benchIndexOptions = 0;			/* options of the indexes made; see EduBtM_CreateIndexWithOptions() */
+static Four benchWriteBufferKB = 0;			/* size of the write buffer of the indexes made; 0 if none */
+
+const struct objectMapStruct *objectMap = NULL;
+
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+Four SM_DestroyFile(FileID*, void*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+Four bfm_LookUp(PageID*, Four);
+Four __real_BfM_GetTrain(TrainID*, char**, Four);
+
+Four benchRunWorkload(Four, struct benchWorkload*, Boolean, struct benchLatencies[][BENCH_NOPS], struct benchRun*);
+Four benchReplay(char*, Four, ObjectID*, PageID*, KeyDesc*, Four*, Boolean, struct benchLatencies*, struct benchRun*, Four);
+Four benchExecute(ObjectID*, PageID*, KeyDesc*, Four, Four*, Four);
+void benchMakeKey(Four, char*, KeyValue*);
+Four benchCompOp(char*);
+Four benchAddLatency(struct benchLatencies*, uint64_t);
+double benchPercentile(struct benchLatencies*, double);
+int benchCompareLatency(const void*, const void*);
+void benchPrintWorkload(FILE*, struct benchWorkload*, Four, struct benchRun*, struct benchLatencies[][BENCH_NOPS], Boolean);
+uint64_t benchNow(void);
+
+
+
+/*@================================
+ * main()
+ *================================*/
+/*
+ * Function: Four main(int, char**)
+ *
+ * Description:
+ *  Parse the options, mount a new volume and run the workloads, writing
+ *  the report to the output file.
+ *
+ * Returns:
+ *  0 on success, 1 on failure
+ */
+Four main(
+		int		argc,				/* IN # of arguments */
+		char	**argv)				/* IN arguments */
+{
+	Four	e;									/* for errors */
+	Four	i, r;								/* loop indexes */
+	int		c;									/* option character */
+	Four	handle;								/* system handle */
+	char	*devNames[1];						/* device name */
+	Four	volId = 1000;						/* volume identifier */
+	Four	numPages[1];						/* # of pages of the device */
+	XactID	xactId;								/* transaction identifier */
+	Four	nWarmups = BENCH_DEFAULTWARMUPS;	/* # of runs not measured */
+	Four	nRuns = BENCH_DEFAULTRUNS;			/* # of runs measured */
+	char	*outName = NULL;					/* output file name; stdout if NULL */
+	char	*dirName = "test/workloads/";		/* directory of the default workloads */
+	Four	keyType = NIL;						/* key type of the given workloads; NIL to guess */
+	FILE	*outFp;								/* output file */
+	char	*comma;								/* separator of the load and transaction files */
+	Four	slowUs = NIL;						/* threshold of the slow calls; NIL if the latencies are not tracked */
+	Four	nWorkloads = 0;						/* # of workloads */
+	struct benchWorkload	workloads[BENCH_MAXWORKLOADS];
+	struct benchRun			runs[BENCH_MAXRUNS];
+	struct benchLatencies	lat[BENCH_NPHASES][BENCH_NOPS];
+	static char	*keyNames[] = { "rand_int", "mono_inc", "email" };
+	static char	specNames[] = "abcde";
+
+	numPages[0] = BENCH_DEFAULTPAGES;
+
+	while ((c = getopt(argc, argv, "w:r:o:d:k:p:s:bm:al:")) != -1) {
+		switch (c) {
+			case 'w': nWarmups = atoi(optarg); break;
+			case 'r': nRuns = atoi(optarg); break;
+			case 'o': outName = optarg; break;
+			case 'd': dirName = optarg; break;
+			case 'k': keyType = strcmp(optarg, "email") == 0 ? EMAIL : RANDINT; break;
+			case 'p': numPages[0] = atoi(optarg); break;
+			case 's':
+				c = atoi(optarg);
+				benchIndexOptions &= ~BTM_PAGESIZE_MASK;
+				benchIndexOptions |= c == 1024 ? BTM_PAGESIZE_1K : c == 2048 ? BTM_PAGESIZE_2K : 0;
+				if (c == PAGESIZE || (benchIndexOptions & BTM_PAGESIZE_MASK) != 0) break;
+				fprintf(stderr, "page size should be 1024, 2048 or %d\n", PAGESIZE);
+				return(1);
+			case 'b': benchIndexOptions |= BTM_BUFFERED; break;
+			case 'm': benchWriteBufferKB = atoi(optarg); break;
+			case 'a': benchIndexOptions |= BTM_ART; break;
+			case 'l': slowUs = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage: %s [-w warmups] [-r runs] [-o output] [-d directory] "
+						"[-k int|email] [-p pages] [-s pageSize] [-b] [-m writeBufferKB] [-a] [-l slowUs] [load,txns | txns] ...\n", argv[0]);
+				return(1);
+		}
+	}
+	if (nWarmups < 0 || nRuns < 1 || nRuns > BENCH_MAXRUNS || numPages[0] < 1) {
+		fprintf(stderr, "bad number of runs or pages\n");
+		return(1);
+	}
+	if (benchWriteBufferKB < 0 || benchWriteBufferKB > BTM_MAXWRITEBUFFERKB) {
+		fprintf(stderr, "write buffer size should be 0 to %d KB\n", BTM_MAXWRITEBUFFERKB);
+		return(1);
+	}
+
+	/*@ make the list of workloads */
+	if (optind == argc) {
+		for (i = 0; i < 3 * 5; i++) {
+			sprintf(workloads[i].name, "%s_%c", keyNames[i / 5], specNames[i % 5]);
+			sprintf(workloads[i].load, "%s/performance_%s_load_zipf_int_100M_%c.dat", dirName, keyNames[i / 5], specNames[i % 5]);
+			sprintf(workloads[i].txns, "%s/performance_%s_txns_zipf_int_100M_%c.dat", dirName, keyNames[i / 5], specNames[i % 5]);
+			workloads[i].keyType = i / 5 == 2 ? EMAIL : RANDINT;
+		}
+		nWorkloads = 3 * 5;
+	}
+	for (; optind < argc && nWorkloads < BENCH_MAXWORKLOADS; optind++, nWorkloads++) {
+		strncpy(workloads[nWorkloads].name, argv[optind], MAXFILENAME - 1);
+		workloads[nWorkloads].name[MAXFILENAME - 1] = '\0';
+		workloads[nWorkloads].load[0] = '\0';
+		strncpy(workloads[nWorkloads].txns, argv[optind], MAXFILENAME - 1);
+		workloads[nWorkloads].txns[MAXFILENAME - 1] = '\0';
+
+		comma = strchr(argv[optind], ',');
+		if (comma != NULL) {
+			sprintf(workloads[nWorkloads].load, "%.*s", (int)(comma - argv[optind]), argv[optind]);
+			strncpy(workloads[nWorkloads].txns, comma + 1, MAXFILENAME - 1);
+		}
+
+		if (keyType != NIL) workloads[nWorkloads].keyType = keyType;
+		else workloads[nWorkloads].keyType = strstr(argv[optind], "email") != NULL ? EMAIL : RANDINT;
+	}
+
+	outFp = outName == NULL ? stdout : fopen(outName, "w");
+	if (outFp == NULL) {
+		fprintf(stderr, "cannot open %s\n", outName);
+		return(1);
+	}
+
+	/*@ mount a new volume */
+	devNames[0] = "bench.vol";
+	e = LRDS_Init();
+	if (e < eNOERROR) { fprintf(stderr, "LRDS_Init failed!!!\n"); return(1); }
+	e = LRDS_AllocHandle(&handle);
+	if (e < eNOERROR) { fprintf(stderr, "LRDS_AllocHandle failed!!!\n"); LRDS_Final(); return(1); }
+	e = LRDS_FormatDataVolume(1, devNames, "bench", volId, 16, numPages, 16);
+	if (e >= eNOERROR) e = LRDS_Mount(1, devNames, &volId);
+	if (e >= eNOERROR) e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	if (e < eNOERROR) {
+		fprintf(stderr, "cannot mount the volume %s!!!\n", devNames[0]);
+		LRDS_FreeHandle(handle);
+		LRDS_Final();
+		return(1);
+	}
+
+	if (slowUs != NIL) EduBtM_SetLatencyTracking(TRUE, slowUs < 0 ? 0 : slowUs);
+
+	/*@ run the workloads */
+	fprintf(outFp, "{\n  \"warmupRuns\": %d,\n  \"runs\": %d,\n  \"workloads\": [", nWarmups, nRuns);
+	for (i = 0; i < nWorkloads; i++) {
+		fprintf(stderr, "%s is now running...\n", workloads[i].name);
+		memset(lat, 0, sizeof(lat));
+
+		for (r = 0; r < nWarmups + nRuns; r++) {
+			e = benchRunWorkload(volId, &workloads[i], r >= nWarmups, lat, &runs[r < nWarmups ? 0 : r - nWarmups]);
+			if (e < eNOERROR) break;
+		}
+
+		if (e < eNOERROR) fprintf(stderr, "%s failed: error %d\n", workloads[i].name, e);
+		else benchPrintWorkload(outFp, &workloads[i], nRuns, runs, lat, i == 0);
+
+		for (r = 0; r < BENCH_NPHASES * BENCH_NOPS; r++) free(lat[r / BENCH_NOPS][r % BENCH_NOPS].ns);
+	}
+	fprintf(outFp, "\n  ]\n}\n");
+	if (outFp != stdout) fclose(outFp);
+
+	if (slowUs != NIL) EduBtM_DumpLatency(stderr);
+
+	LRDS_CommitTransaction(&xactId);
+	LRDS_Dismount(volId);
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+
+	return(0);
+}
+
+
+
+/*@================================
+ * __wrap_BfM_GetTrain()
+ *================================*/
+/*
+ * Function: Four __wrap_BfM_GetTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Count the pages asked of the buffer manager and those of them which are
+ *  in the buffer, then fix the page with the real BfM_GetTrain().
+ *
+ * Returns:
+ *  error code of BfM_GetTrain()
+ */
+Four __wrap_BfM_GetTrain(
+		TrainID		*trainId,			/* IN train to fix */
+		char		**retBuf,			/* OUT pointer to the buffer */
+		Four		type)				/* IN buffer type */
+{
+	benchGets++;
+	if (bfm_LookUp(trainId, type) != NIL) benchHits++;
+
+	return(__real_BfM_GetTrain(trainId, retBuf, type));
+}
+
+
+
+/*@================================
+ * benchRunWorkload()
+ *================================*/
+/*
+ * Function: Four benchRunWorkload(Four, struct benchWorkload*, Boolean,
+ *                                 struct benchLatencies[][], struct benchRun*)
+ *
+ * Description:
+ *  Run the workload once on a new index of a new file, which are dropped
+ *  afterwards. If 'measured' is TRUE, the latencies are added to 'lat'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four benchRunWorkload(
+		Four					volId,			/* IN volume of the index */
+		struct benchWorkload	*wl,			/* IN workload */
+		Boolean					measured,		/* IN TRUE if the latencies are kept */
+		struct benchLatencies	lat[][BENCH_NOPS],	/* INOUT latencies of the measured runs */
+		struct benchRun			*run)			/* OUT figures of the run */
+{
+	Four			e;				/* for errors */
+	FileID			fid;			/* file of the index */
+	ObjectID		catalogEntry;	/* catalog object of the file */
+	ObjectID		*catObjForFile = &catalogEntry;	/* for GET_PTR_TO_CATENTRY_FOR_BTREE() */
+	PageID			root;			/* root page of the index */
+	PhysicalFileID	pFid;			/* physical file of the index */
+	PageID			catPid;			/* page of the catalog object */
+	KeyDesc			kdesc;			/* key descriptor */
+	Four			numObjects = 0;	/* # of objects inserted */
+	SlottedPage		*catPage;		/* buffer page containing the catalog object */
+	sm_CatOverlayForBtree *catEntry;	/* Btree part of the catalog entry */
+	BtreeIndexParams	params;		/* run-time parameters of the index */
+	uint64_t		start;			/* start time of the run */
+
+	memset(run, 0, sizeof(struct benchRun));
+	benchGets = benchHits = 0;
+	start = benchNow();
+
+	e = SM_CreateFile(volId, &fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+	e = EduBtM_CreateIndexWithOptions(&catalogEntry, &root, benchIndexOptions);
+	if (e < eNOERROR) ERR(e);
+
+	if (benchWriteBufferKB > 0) {
+		e = EduBtM_GetIndexParams(&root, &params);
+		if (e < eNOERROR) ERR(e);
+		params.writeBufferKB = benchWriteBufferKB;
+		e = EduBtM_SetIndexParams(&root, &params);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	kdesc.flag = KEYFLAG_UNIQUE;
+	kdesc.nparts = 1;
+	kdesc.kpart[0].type = wl->keyType == EMAIL ? SM_VARSTRING : SM_INT;
+	kdesc.kpart[0].offset = 0;
+	kdesc.kpart[0].length = wl->keyType == EMAIL ? MAXKEY : sizeof(Four);
+
+	if (wl->load[0] != '\0') {
+		e = benchReplay(wl->load, volId, &catalogEntry, &root, &kdesc, &numObjects, measured, lat[0], run, 0);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReplay(wl->txns, volId, &catalogEntry, &root, &kdesc, &numObjects, measured, lat[1], run, 1);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_FlushWriteBuffer(&root);
+	if (e < eNOERROR) ERR(e);
+
+	MAKE_PAGEID(catPid, catalogEntry.volNo, catalogEntry.pageNo);
+	e = BfM_GetTrain(&catPid, (char**)&catPage, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, catEntry);
+	MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+	e = BfM_FreeTrain(&catPid, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_DropIndex(&pFid, &root, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	run->elapsedNs = benchNow() - start;
+	run->nGets = benchGets;
+	run->nHits = benchHits;
+
+	return(eNOERROR);
+}
+
+
+
+/*@================================
+ * benchReplay()
+ *================================*/
+/*
+ * Function: Four benchReplay(char*, Four, ObjectID*, PageID*, KeyDesc*, Four*, Boolean,
+ *                            struct benchLatencies*, struct benchRun*, Four)
+ *
+ * Description:
+ *  Execute the operations of the workload file one by one, timing each.
+ *  The lines which are not operations are skipped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM : the file cannot be opened
+ *    some errors caused by function calls
+ */
+Four benchReplay(
+		char					*fileName,		/* IN workload file */
+		Four					volId,			/* IN volume of the index */
+		ObjectID				*catalogEntry,	/* IN catalog object of the file */
+		PageID					*root,			/* IN root page of the index */
+		KeyDesc					*kdesc,			/* IN key descriptor */
+		Four					*numObjects,	/* INOUT # of objects inserted */
+		Boolean					measured,		/* IN TRUE if the latencies are kept */
+		struct benchLatencies	*lat,			/* INOUT latencies of the phase */
+		struct benchRun			*run,			/* INOUT figures of the run */
+		Four					phase)			/* IN phase of the file */
+{
+	Four		e;							/* for errors */
+	FILE		*fp;						/* workload file */
+	char		line[BENCH_MAXLINE];		/* a line of the file */
+	char		*opString;					/* operation of the line */
+	Four		op;							/* operation code */
+	uint64_t	start;						/* start time of the operation */
+	uint64_t	ns;							/* latency of the operation */
+
+	fp = fopen(fileName, "r");
+	if (fp == NULL) {
+		fprintf(stderr, "No workload file %s\n", fileName);
+		ERR(eBADPARAMETER_BTM);
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		opString = strtok(line, " \t\r\n");
+		if (opString == NULL) continue;
+		if (strcmp(opString, "INSERT") == 0) op = INSERT;
+		else if (strcmp(opString, "DELETE") == 0) op = DELETE;
+		else if (strcmp(opString, "SCAN") == 0) op = SCAN;
+		else continue;
+
+		start = benchNow();
+		e = benchExecute(catalogEntry, root, kdesc, volId, numObjects, op);
+		ns = benchNow() - start;
+		if (e < eNOERROR) {
+			fclose(fp);
+			ERR(e);
+		}
+
+		run->count[phase][OPINDEX(op)]++;
+		run->ns[phase][OPINDEX(op)] += ns;
+		if (measured) {
+			e = benchAddLatency(&lat[OPINDEX(op)], ns);
+			if (e < eNOERROR) {
+				fclose(fp);
+				ERR(e);
+			}
+		}
+	}
+
+	fclose(fp);
+
+	return(eNOERROR);
+}
+
+
+
+/*@================================
+ * benchExecute()
+ *================================*/
+/*
+ * Function: Four benchExecute(ObjectID*, PageID*, KeyDesc*, Four, Four*, Four)
+ *
+ * Description:
+ *  Execute an operation whose arguments are the next tokens of the line
+ *  being parsed by strtok(), as EduBtM_Test does:
+ *    INSERT key
+ *    DELETE key                   (fetches the key, then deletes its object)
+ *    SCAN startOp [startKey] stopOp [stopKey]
+ *  BOF and EOF take no key; a number after them limits the # of objects
+ *  fetched by the scan.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four benchExecute(
+		ObjectID	*catalogEntry,		/* IN catalog object of the file */
+		PageID		*root,				/* IN root page of the index */
+		KeyDesc		*kdesc,				/* IN key descriptor */
+		Four		volId,				/* IN volume of the index */
+		Four		*numObjects,		/* INOUT # of objects inserted */
+		Four		op)					/* IN operation code */
+{
+	Four		e;						/* for errors */
+	Four		keyType;				/* key type */
+	ObjectID	oid;					/* object id */
+	KeyValue	kval;					/* value of key */
+	KeyValue	startKval;				/* start value of key */
+	KeyValue	stopKval;				/* stop value of key */
+	Four		startCompOp;			/* start comparison operator */
+	Four		stopCompOp;				/* stop comparison operator */
+	char		*token;					/* next token of the line */
+	Four		limit;					/* max # of objects to fetch; 0 if none */
+	Four		n;						/* # of objects fetched */
+	BtreeCursor	cursor;					/* cursor of the scan */
+	BtreeCursor	next;					/* next object cursor */
+
+	keyType = kdesc->kpart[0].type == SM_VARSTRING ? EMAIL : RANDINT;
+
+	switch (op) {
+		case INSERT:
+			benchMakeKey(keyType, strtok(NULL, " \t\r\n"), &kval);
+			oid.volNo = volId;
+			oid.pageNo = 777;
+			oid.slotNo = *numObjects;
+			oid.unique = (*numObjects)++;
+
+			e = EduBtM_InsertObject(catalogEntry, root, kdesc, &kval, &oid, &dlPool, &dlHead);
+			if (e < eNOERROR && e != eDUPLICATEDKEY_BTM) ERR(e);
+			break;
+
+		case DELETE:
+			benchMakeKey(keyType, strtok(NULL, " \t\r\n"), &kval);
+
+			e = EduBtM_Fetch(root, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+			if (e < eNOERROR) ERR(e);
+			if (cursor.flag != CURSOR_ON) break;
+
+			e = EduBtM_DeleteObject(catalogEntry, root, kdesc, &kval, &cursor.oid, &dlPool, &dlHead);
+			if (e < eNOERROR && e != eNOTFOUND_BTM) ERR(e);
+			break;
+
+		case SCAN:
+			/* The key of BOF and EOF is not used, but it should be a valid key */
+			benchMakeKey(keyType, NULL, &startKval);
+			benchMakeKey(keyType, NULL, &stopKval);
+			limit = 0;
+
+			startCompOp = benchCompOp(strtok(NULL, " \t\r\n"));
+			if (startCompOp != SM_BOF && startCompOp != SM_EOF)
+				benchMakeKey(keyType, strtok(NULL, " \t\r\n"), &startKval);
+
+			stopCompOp = benchCompOp(strtok(NULL, " \t\r\n"));
+			if (stopCompOp != SM_BOF && stopCompOp != SM_EOF)
+				benchMakeKey(keyType, strtok(NULL, " \t\r\n"), &stopKval);
+			else if ((token = strtok(NULL, " \t\r\n")) != NULL)
+				limit = atoi(token);
+
+			if (startCompOp == NIL || stopCompOp == NIL) break;
+
+			e = EduBtM_Fetch(root, kdesc, &startKval, startCompOp, &stopKval, stopCompOp, &cursor);
+			if (e < eNOERROR) ERR(e);
+
+			for (n = 1; cursor.flag == CURSOR_ON && (limit == 0 || n < limit); n++) {
+				e = EduBtM_FetchNext(root, kdesc, &stopKval, stopCompOp, &cursor, &next);
+				if (e < eNOERROR) ERR(e);
+				cursor = next;
+			}
+			break;
+	}
+
+	return(eNOERROR);
+}
+
+
+
+/*@================================
+ * benchMakeKey()
+ *================================*/
+/*
+ * Function: void benchMakeKey(Four, char*, KeyValue*)
+ *
+ * Description:
+ *  Make the key value of a key in a workload file as EduBtM_Test does: an
+ *  integer key keeps the low 32 bits of the number, and a string key is a
+ *  varstring of MAXKEY bytes. A NULL key makes the key 0 or "".
+ *
+ * Returns:
+ *  None
+ */
+void benchMakeKey(
+		Four		keyType,			/* IN key type */
+		char		*rawKey,			/* IN key in the file; NULL if none */
+		KeyValue	*kval)				/* OUT key value */
+{
+	Four		intKey;					/* integer key */
+	Two			length;					/* length of the string key */
+
+	if (keyType == EMAIL) {
+		memset(kval->val, 0, sizeof(Two) + MAXKEY);
+		length = rawKey == NULL ? 0 : strlen(rawKey);
+		if (length > MAXKEY - 1) length = MAXKEY - 1;
+		kval->len = MAXKEY;
+		memcpy(&kval->val[0], &length, sizeof(Two));
+		if (length > 0) memcpy(&kval->val[sizeof(Two)], rawKey, length);
+	}
+	else {
+		intKey = rawKey == NULL ? 0 : (Four)strtoll(rawKey, NULL, 10);
+		kval->len = sizeof(Four_Invariable);
+		memcpy(&kval->val[0], &intKey, sizeof(Four_Invariable));
+	}
+}
+
+
+
+/*@================================
+ * benchCompOp()
+ *================================*/
+/*
+ * Function: Four benchCompOp(char*)
+ *
+ * Description:
+ *  Convert the name of a comparison operator to its code.
+ *
+ * Returns:
+ *  the comparison operator; NIL if the name is unknown
+ */
+Four benchCompOp(
+		char		*name)				/* IN name of the operator */
+{
+	if (name == NULL) return(NIL);
+	if (strcmp(name, "EQ") == 0) return(SM_EQ);
+	if (strcmp(name, "LT") == 0) return(SM_LT);
+	if (strcmp(name, "LE") == 0) return(SM_LE);
+	if (strcmp(name, "GT") == 0) return(SM_GT);
+	if (strcmp(name, "GE") == 0) return(SM_GE);
+	if (strcmp(name, "EOF") == 0) return(SM_EOF);
+	if (strcmp(name, "BOF") == 0) return(SM_BOF);
+
+	return(NIL);
+}
+
+
+
+/*@================================
+ * benchAddLatency()
+ *================================*/
+/*
+ * Function: Four benchAddLatency(struct benchLatencies*, uint64_t)
+ *
+ * Description:
+ *  Append a latency to the array, doubling the array when it is full.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBTM
+ */
+Four benchAddLatency(
+		struct benchLatencies	*lat,	/* INOUT latencies */
+		uint64_t				ns)		/* IN latency to append */
+{
+	uint64_t	*grown;					/* enlarged array */
+
+	if (lat->n == lat->max) {
+		grown = (uint64_t*)realloc(lat->ns, (lat->max > 0 ? 2 * lat->max : 1024) * sizeof(uint64_t));
+		if (grown == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+		lat->ns = grown;
+		lat->max = lat->max > 0 ? 2 * lat->max : 1024;
+	}
+
+	lat->ns[lat->n++] = ns;
+	lat->total += ns;
+
+	return(eNOERROR);
+}
+
+
+
+/*@================================
+ * benchPercentile()
+ *================================*/
+/*
+ * Function: double benchPercentile(struct benchLatencies*, double)
+ *
+ * Description:
+ *  Return the p-th percentile of the latencies in microseconds: the
+ *  smallest latency not exceeded by p percent of them. The latencies
+ *  should be sorted.
+ *
+ * Returns:
+ *  the percentile; 0 if there is no latency
+ */
+double benchPercentile(
+		struct benchLatencies	*lat,	/* IN sorted latencies */
+		double					p)		/* IN percent */
+{
+	Four	idx;						/* index of the percentile */
+
+	if (lat->n == 0) return(0.0);
+
+	idx = (Four)(p / 100.0 * lat->n + 0.999999) - 1;
+	if (idx < 0) idx = 0;
+	if (idx >= lat->n) idx = lat->n - 1;
+
+	return(lat->ns[idx] / 1000.0);
+}
+
+
+
+/*@================================
+ * benchCompareLatency()
+ *================================*/
+/*
+ * Function: int benchCompareLatency(const void*, const void*)
+ *
+ * Description:
+ *  qsort() comparison function for latencies.
+ *
+ * Returns:
+ *  negative, 0 or positive as the first latency is less, equal or greater
+ */
+int benchCompareLatency(
+		const void	*a,					/* IN a latency */
+		const void	*b)					/* IN another latency */
+{
+	uint64_t	x = *(const uint64_t*)a;
+	uint64_t	y = *(const uint64_t*)b;
+
+	return(x < y ? -1 : x > y ? 1 : 0);
+}
+
+
+
+/*@================================
+ * benchPrintWorkload()
+ *================================*/
+/*
+ * Function: void benchPrintWorkload(FILE*, struct benchWorkload*, Four, struct benchRun*,
+ *                                   struct benchLatencies[][], Boolean)
+ *
+ * Description:
+ *  Write the report of a workload as a JSON object: the figures of each
+ *  measured run, and a summary of all of them with the throughput and the
+ *  latency percentiles of each type of operation in each phase.
+ *
+ * Returns:
+ *  None
+ */
+void benchPrintWorkload(
+		FILE					*fp,		/* IN output file */
+		struct benchWorkload	*wl,		/* IN workload */
+		Four					nRuns,		/* IN # of measured runs */
+		struct benchRun			*runs,		/* IN figures of the measured runs */
+		struct benchLatencies	lat[][BENCH_NOPS],	/* INOUT latencies; sorted on return */
+		Boolean					first)		/* IN TRUE if it is the first workload */
+{
+	Four	r, p, o;					/* loop indexes */
+	Boolean	firstOp;					/* TRUE until an operation is printed */
+	struct benchLatencies	*l;			/* latencies of an operation */
+
+	fprintf(fp, "%s\n    {\n", first ? "" : ",");
+	fprintf(fp, "      \"name\": \"%s\",\n", wl->name);
+	fprintf(fp, "      \"load\": \"%s\",\n", wl->load);
+	fprintf(fp, "      \"txns\": \"%s\",\n", wl->txns);
+	fprintf(fp, "      \"keyType\": \"%s\",\n", wl->keyType == EMAIL ? "email" : "int");
+	fprintf(fp, "      \"engine\": \"%s\",\n", (benchIndexOptions & BTM_ART) ? "art" : "btree");
+	fprintf(fp, "      \"pageSize\": %d,\n", BTM_FLAGS_PAGESIZE(benchIndexOptions));
+	fprintf(fp, "      \"buffered\": %s,\n", (benchIndexOptions & BTM_BUFFERED) ? "true" : "false");
+	fprintf(fp, "      \"writeBufferKB\": %d,\n", benchWriteBufferKB);
+
+	fprintf(fp, "      \"runs\": [");
+	for (r = 0; r < nRuns; r++) {
+		fprintf(fp, "%s\n        { \"elapsedUs\": %.3f, \"bufferGets\": %d, \"bufferHits\": %d, \"hitRatio\": %.6f",
+				r == 0 ? "" : ",", runs[r].elapsedNs / 1000.0, runs[r].nGets, runs[r].nHits,
+				runs[r].nGets > 0 ? (double)runs[r].nHits / runs[r].nGets : 0.0);
+		for (p = 0; p < BENCH_NPHASES; p++) {
+			fprintf(fp, ",\n          \"%s\": {", phaseNames[p]);
+			firstOp = TRUE;
+			for (o = 0; o < BENCH_NOPS; o++) {
+				if (runs[r].count[p][o] == 0) continue;
+				fprintf(fp, "%s \"%s\": { \"count\": %d, \"opsPerSec\": %.1f }", firstOp ? "" : ",", opNames[o],
+						runs[r].count[p][o], runs[r].ns[p][o] > 0 ? runs[r].count[p][o] * 1e9 / runs[r].ns[p][o] : 0.0);
+				firstOp = FALSE;
+			}
+			fprintf(fp, " }");
+		}
+		fprintf(fp, " }");
+	}
+	fprintf(fp, "\n      ],\n");
+
+	fprintf(fp, "      \"summary\": {");
+	for (p = 0; p < BENCH_NPHASES; p++) {
+		fprintf(fp, "%s\n        \"%s\": {", p == 0 ? "" : ",", phaseNames[p]);
+		firstOp = TRUE;
+		for (o = 0; o < BENCH_NOPS; o++) {
+			l = &lat[p][o];
+			if (l->n == 0) continue;
+			qsort(l->ns, l->n, sizeof(uint64_t), benchCompareLatency);
+			fprintf(fp, "%s\n          \"%s\": { \"count\": %d, \"opsPerSec\": %.1f, \"meanUs\": %.3f, "
+					"\"p50Us\": %.3f, \"p99Us\": %.3f, \"p999Us\": %.3f, \"maxUs\": %.3f }",
+					firstOp ? "" : ",", opNames[o], l->n, l->total > 0 ? l->n * 1e9 / l->total : 0.0,
+					l->total / 1000.0 / l->n, benchPercentile(l, 50.0), benchPercentile(l, 99.0),
+					benchPercentile(l, 99.9), l->ns[l->n - 1] / 1000.0);
+			firstOp = FALSE;
+		}
+		fprintf(fp, "%s}", firstOp ? " " : "\n        ");
+	}
+	fprintf(fp, "\n      }\n    }");
+}
+
+
+
+/*@================================
+ * benchNow()
+ *================================*/
+/*
+ * Function: uint64_t benchNow(void)
+ *
+ * Description:
+ *  Return the time of the monotonic clock in nanoseconds.
+ *
+ * Returns:
+ *  the time
+ */
+uint64_t benchNow(void)
+{
+	struct timespec	t;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t);
+
+	return((uint64_t)t.tv_sec * 1000000000 + t.tv_nsec);
+}
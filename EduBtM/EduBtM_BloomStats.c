@@ -0,0 +1,90 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_BloomStats.c
+ *
+ * Description :
+ *  Report the statistics of the Bloom filter of a Btree index, from which
+ *  the observed false positive rate of the filter is computed.
+ *
+ * Exports:
+ *  Four EduBtM_GetBloomStats(PageID*, BtreeBloomStats*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * EduBtM_GetBloomStats()
+ *================================*/
+/*
+ * Function: Four EduBtM_GetBloomStats(PageID*, BtreeBloomStats*)
+ *
+ * Description:
+ *  Get the statistics of the Bloom filter of the index given by 'root'.
+ *  A false positive is an equality search or a deletion of a key which the
+ *  filter did not rule out, but which was not found in the index; the false
+ *  positive rate is the fraction of the absent keys looked up which were
+ *  not ruled out. The statistics are all 0 for an index without a filter.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ */
+Four EduBtM_GetBloomStats(
+    PageID              *root,          /* IN root page of the index */
+    BtreeBloomStats     *stats)         /* OUT statistics of the Bloom filter */
+{
+    btm_IndexInfo       *info;          /* information about the index */
+    Four                nAbsent;        /* # of absent keys looked up */
+    BTM_LATENCY(BTM_API_GETBLOOMSTATS);
+
+
+    /*@ check parameters */
+    if (root == NULL || stats == NULL) ERR(eBADPARAMETER_BTM);
+
+    stats->nKeys = stats->nBits = stats->nBuilds = 0;
+    stats->nChecks = stats->nNegatives = stats->nFalsePositives = 0;
+    stats->falsePositiveRate = 0.0;
+
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info == NULL || info->params.bloomBitsPerKey == 0) return(eNOERROR);
+
+    stats->nKeys = info->bloom.nKeys;
+    stats->nBits = info->bloom.nBits;
+    stats->nBuilds = info->bloom.nBuilds;
+    stats->nChecks = info->bloom.nChecks;
+    stats->nNegatives = info->bloom.nNegatives;
+    stats->nFalsePositives = info->bloom.nFalsePositives;
+
+    nAbsent = info->bloom.nNegatives + info->bloom.nFalsePositives;
+    if (nAbsent > 0) stats->falsePositiveRate = (double)info->bloom.nFalsePositives / nAbsent;
+
+    return(eNOERROR);
+
+}   /* EduBtM_GetBloomStats() */
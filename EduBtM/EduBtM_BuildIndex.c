@@ -0,0 +1,865 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_BuildIndex.c
+ *
+ * Description:
+ *  Build a B+ tree on the objects of a data file by an external sort
+ *  instead of inserting the objects one by one. The pages of the data file
+ *  are read in order, and the key of each object is extracted into a run
+ *  buffer holding at most 'runSize' pairs. A full buffer is sorted and
+ *  written to a temporary file; with several workers, the buffers are
+ *  sorted and written by threads while the next buffer is filled. The runs
+ *  are then merged, in more than one pass if there are too many of them,
+ *  and the merged pairs are bulk loaded, so that the leaves are written in
+ *  key order. When all pairs fit in one buffer, no file is written.
+ *
+ *  A key part is read from the object data at the offset given by its
+ *  KeyPart: an SM_INT part is a 4-byte integer, and an SM_VARSTRING part
+ *  is a 2-byte length followed by at most 'length' characters, the same
+ *  format as in a key value.
+ *
+ * Exports:
+ *  Four EduBtM_BuildIndex(ObjectID*, PageID*, KeyDesc*, Four, Four, Two, Two,
+ *                         Pool*, DeallocListElem*)
+ *  Four edubtm_ExtractKey(KeyDesc*, Object*, KeyValue*)
+ *  void edubtm_SortPairs(KeyDesc*, btm_SortPair*, btm_SortPair*, Four)
+ *  void edubtm_MergeSort(void*, void*, Four, Four, btm_SortCompare, void*)
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+#include "OM_Internal.h"
+
+
+/* A run buffer, which is sorted and written to a run file when it is full */
+typedef struct {
+    KeyDesc             *kdesc;         /* key descriptor */
+    btm_SortPair        *pairs;         /* pairs of the run */
+    btm_SortPair        *tmp;           /* work area of the sort */
+    Four                nPairs;         /* # of pairs in the buffer */
+    FILE                *fp;            /* run file written; NULL if none */
+    Four                error;          /* error of writing the run; eNOERROR if none */
+    Boolean             busy;           /* TRUE while a thread sorts and writes the buffer */
+    pthread_t           thread;         /* the thread sorting the buffer */
+} btm_RunBuffer;
+
+/* State of an index build */
+typedef struct {
+    KeyDesc             kdesc;          /* key descriptor */
+    Four                nBuffers;       /* # of run buffers */
+    btm_RunBuffer       buffers[BTM_MAXBUILDWORKERS]; /* run buffers */
+    FILE                **runs;         /* run files written */
+    Four                nRuns;          /* # of run files */
+    Four                maxRuns;        /* # of run files 'runs' can hold */
+} btm_IndexBuild;
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_BuildRuns(btm_IndexBuild*, ObjectID*, Four, Boolean*);
+Four edubtm_StartRun(btm_IndexBuild*, btm_RunBuffer*);
+Four edubtm_FinishRun(btm_IndexBuild*, btm_RunBuffer*);
+void *edubtm_WriteRun(void*);
+Four edubtm_MergeRuns(KeyDesc*, FILE**, Four, FILE*, Four);
+Four edubtm_ReadPair(FILE*, btm_SortPair*);
+Four edubtm_WritePair(FILE*, btm_SortPair*);
+Four edubtm_ComparePairs(KeyDesc*, btm_SortPair*, btm_SortPair*);
+Four edubtm_CompareSortPairs(void*, void*, void*);
+void edubtm_FreeIndexBuild(btm_IndexBuild*);
+
+
+
+/*@================================
+ * EduBtM_BuildIndex()
+ *================================*/
+/*
+ * Function: Four EduBtM_BuildIndex(ObjectID*, PageID*, KeyDesc*, Four, Four, Two, Two,
+ *                                  Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Build the B+ tree given by 'root' on the objects of the data file whose
+ *  catalog object is 'catObjForFile'. The B+ tree should be empty, i.e.
+ *  just created by EduBtM_CreateIndex() with the same catalog object. At
+ *  most 'runSize' pairs are sorted in memory by each of 'nWorkers' workers,
+ *  which bounds the memory used to about 2 * nWorkers * runSize pairs. The
+ *  fill factors are those of EduBtM_InitSortedBulkLoad().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eNOTEMPTYINDEX_EDUBTM
+ *    eDUPLICATEDKEY_BTM
+ *    eBADKEYFIELD_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    eSORTFILEIO_EDUBTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  If an error occurs while the pairs are loaded, the pairs loaded before
+ *  are left in the B+ tree.
+ */
+Four EduBtM_BuildIndex(
+    ObjectID                    *catObjForFile,         /* IN catalog object of the data file */
+    PageID                      *root,                  /* IN root page of the B+ tree */
+    KeyDesc                     *kdesc,                 /* IN Btree key descriptor */
+    Four                        runSize,                /* IN max # of pairs sorted in memory by a worker */
+    Four                        nWorkers,               /* IN # of workers sorting the runs */
+    Two                         leafFillFactor,         /* IN fill factor of leaf pages (%) */
+    Two                         internalFillFactor,     /* IN fill factor of internal pages (%) */
+    Pool                        *dlPool,                /* INOUT pool of dealloc list elements */
+    DeallocListElem             *dlHead)                /* INOUT head of the dealloc list */
+{
+    Four                        e;                      /* error number */
+    Four                        i;                      /* index */
+    Four                        blkLdId;                /* bulk load ID */
+    Boolean                     inMemory;               /* TRUE if all pairs are in the first buffer */
+    btm_IndexBuild              build;                  /* state of the build */
+    btm_RunBuffer               *buf;                   /* the first run buffer */
+    BTM_LATENCY(BTM_API_BUILDINDEX);
+
+
+    /*@ check parameters */
+    if (catObjForFile == NULL || root == NULL || kdesc == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (runSize < 1 || nWorkers < 1 || nWorkers > BTM_MAXBUILDWORKERS) ERR(eBADPARAMETER_BTM);
+
+    /* The bulk load checks the rest of the parameters and that the index is empty. */
+    blkLdId = EduBtM_InitSortedBulkLoad(catObjForFile, root, kdesc, leafFillFactor, internalFillFactor);
+    if (blkLdId < eNOERROR) ERR(blkLdId);
+
+    /*@ allocate the run buffers */
+    memset(&build, 0, sizeof(btm_IndexBuild));
+    build.kdesc = *kdesc;
+    build.nBuffers = nWorkers;
+    for (i = 0; i < nWorkers; i++) {
+        buf = &build.buffers[i];
+        buf->kdesc = &build.kdesc;
+        buf->pairs = (btm_SortPair*)malloc(sizeof(btm_SortPair) * runSize);
+        buf->tmp = (btm_SortPair*)malloc(sizeof(btm_SortPair) * runSize);
+        if (buf->pairs == NULL || buf->tmp == NULL) {
+            edubtm_FreeIndexBuild(&build);
+            (Four) EduBtM_FinalSortedBulkLoad(blkLdId, dlPool, dlHead);
+            ERR(eMEMORYALLOCERR_EDUBTM);
+        }
+    }
+
+    /*@ make the sorted runs */
+    e = edubtm_BuildRuns(&build, catObjForFile, runSize, &inMemory);
+
+    /*@ load the pairs in key order */
+    if (e >= eNOERROR) {
+        buf = &build.buffers[0];
+        if (inMemory) {
+            for (i = 0; i < buf->nPairs && e >= eNOERROR; i++)
+                e = EduBtM_NextSortedBulkLoad(blkLdId, &buf->pairs[i].kval, &buf->pairs[i].oid);
+        }
+        else {
+            e = edubtm_MergeRuns(&build.kdesc, build.runs, build.nRuns, NULL, blkLdId);
+            build.nRuns = 0;
+        }
+    }
+
+    edubtm_FreeIndexBuild(&build);
+
+    if (e < eNOERROR) {
+        (Four) EduBtM_FinalSortedBulkLoad(blkLdId, dlPool, dlHead);
+        ERR(e);
+    }
+
+    e = EduBtM_FinalSortedBulkLoad(blkLdId, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBtM_BuildIndex() */
+
+
+
+/*@================================
+ * edubtm_BuildRuns()
+ *================================*/
+/*
+ * Function: Four edubtm_BuildRuns(btm_IndexBuild*, ObjectID*, Four, Boolean*)
+ *
+ * Description:
+ *  Read the pages of the data file in order and put the pair of each of
+ *  its objects into the run buffers, which are used in turn. A full buffer
+ *  is sorted and written to a run file by a thread when there are several
+ *  buffers; before a buffer is filled again, its run is waited for. The
+ *  run files are made so that at most BTM_MAXMERGEFANIN of them remain.
+ *
+ *  If all pairs fit in the first buffer, it is only sorted and '*inMemory'
+ *  is set to TRUE.
+ *
+ * Returns:
+ *  error code
+ *    eBADKEYFIELD_EDUBTM
+ *    eSORTFILEIO_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_BuildRuns(
+    btm_IndexBuild              *build,                 /* INOUT state of the build */
+    ObjectID                    *catObjForFile,         /* IN catalog object of the data file */
+    Four                        runSize,                /* IN max # of pairs of a run */
+    Boolean                     *inMemory)              /* OUT TRUE if no run file is written */
+{
+    Four                        e;                      /* error number */
+    Two                         i;                      /* slot No. */
+    Four                        cur;                    /* the run buffer being filled */
+    PhysicalFileID              pFid;                   /* page holding the catalog object */
+    PageID                      pid;                    /* the data page being read */
+    ShortPageID                 nextPage;               /* the data page read next */
+    SlottedPage                 *catPage;               /* buffer page containing the catalog object */
+    sm_CatOverlayForData        *catEntry;              /* catalog information of the data file */
+    SlottedPage                 *apage;                 /* buffer of 'pid' */
+    Object                      *obj;                   /* an object in the page */
+    btm_RunBuffer               *buf;                   /* the run buffer being filled */
+    btm_SortPair                *pair;                  /* the pair of an object */
+
+
+    *inMemory = FALSE;
+
+    MAKE_PHYSICALFILEID(pFid, catObjForFile->volNo, catObjForFile->pageNo);
+    e = BfM_GetTrain((PageID*)&pFid, (char**)&catPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    nextPage = catEntry->firstPage;
+    e = BfM_FreeTrain((PageID*)&pFid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    cur = 0;
+    buf = &build->buffers[cur];
+
+    /*@ extract the pairs page by page */
+    while (nextPage != NIL) {
+        MAKE_PAGEID(pid, catObjForFile->volNo, nextPage);
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        for (i = 0; i < apage->header.nSlots; i++) {
+            if (apage->slot[-i].offset == EMPTYSLOT) continue;
+
+            /* the next buffer is used once its previous run is written */
+            if (buf->nPairs == runSize) {
+                e = edubtm_StartRun(build, buf);
+                if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+
+                cur = (cur + 1) % build->nBuffers;
+                buf = &build->buffers[cur];
+                e = edubtm_FinishRun(build, buf);
+                if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+            }
+
+            obj = (Object*)&apage->data[apage->slot[-i].offset];
+            pair = &buf->pairs[buf->nPairs];
+            e = edubtm_ExtractKey(&build->kdesc, obj, &pair->kval);
+            if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+
+            pair->oid.volNo = pid.volNo;
+            pair->oid.pageNo = pid.pageNo;
+            pair->oid.slotNo = i;
+            pair->oid.unique = apage->slot[-i].unique;
+            buf->nPairs++;
+        }
+
+        nextPage = apage->header.nextPage;
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    /*@ sort in memory when no run was written */
+    if (build->nRuns == 0 && cur == 0) {
+        edubtm_SortPairs(&build->kdesc, buf->pairs, buf->tmp, buf->nPairs);
+        *inMemory = TRUE;
+        return(eNOERROR);
+    }
+
+    /*@ write the last run and wait for all of them */
+    e = edubtm_StartRun(build, buf);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < build->nBuffers; i++) {
+        e = edubtm_FinishRun(build, &build->buffers[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_BuildRuns() */
+
+
+
+/*@================================
+ * edubtm_StartRun()
+ *================================*/
+/*
+ * Function: Four edubtm_StartRun(btm_IndexBuild*, btm_RunBuffer*)
+ *
+ * Description:
+ *  Sort the buffer and write it to a new run file, by a new thread when
+ *  the build has several buffers; otherwise the run is written at once.
+ *
+ * Returns:
+ *  error code
+ *    eSORTFILEIO_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ */
+Four edubtm_StartRun(
+    btm_IndexBuild              *build,                 /* INOUT state of the build */
+    btm_RunBuffer               *buf)                   /* INOUT the full run buffer */
+{
+    if (buf->nPairs == 0) return(eNOERROR);
+
+    buf->busy = TRUE;
+    buf->error = eNOERROR;
+
+    /* Without another buffer, or without a thread, the run is written here. */
+    if (build->nBuffers == 1 || pthread_create(&buf->thread, NULL, edubtm_WriteRun, buf) != 0) {
+        buf->busy = FALSE;
+        (void) edubtm_WriteRun(buf);
+        return(edubtm_FinishRun(build, buf));
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_StartRun() */
+
+
+
+/*@================================
+ * edubtm_FinishRun()
+ *================================*/
+/*
+ * Function: Four edubtm_FinishRun(btm_IndexBuild*, btm_RunBuffer*)
+ *
+ * Description:
+ *  Wait until the run of the buffer is written, add the run file to the
+ *  build, and empty the buffer. When BTM_MAXMERGEFANIN run files are
+ *  made, they are merged into one.
+ *
+ * Returns:
+ *  error code
+ *    eSORTFILEIO_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_FinishRun(
+    btm_IndexBuild              *build,                 /* INOUT state of the build */
+    btm_RunBuffer               *buf)                   /* INOUT the run buffer */
+{
+    Four                        e;                      /* error number */
+    FILE                        **runs;                 /* enlarged array of run files */
+    FILE                        *fp;                    /* the merged run file */
+
+
+    if (buf->busy) {
+        pthread_join(buf->thread, NULL);
+        buf->busy = FALSE;
+    }
+
+    buf->nPairs = 0;
+
+    if (buf->error < eNOERROR) ERR(buf->error);
+
+    if (buf->fp == NULL) return(eNOERROR);
+
+    if (build->nRuns == build->maxRuns) {
+        runs = (FILE**)realloc(build->runs, sizeof(FILE*) * (build->maxRuns + BTM_MAXMERGEFANIN));
+        if (runs == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        build->runs = runs;
+        build->maxRuns += BTM_MAXMERGEFANIN;
+    }
+    build->runs[build->nRuns++] = buf->fp;
+    buf->fp = NULL;
+
+    /*@ merge the runs made so far when there are as many as can be merged at once */
+    if (build->nRuns == BTM_MAXMERGEFANIN) {
+        fp = tmpfile();
+        if (fp == NULL) ERR(eSORTFILEIO_EDUBTM);
+
+        e = edubtm_MergeRuns(&build->kdesc, build->runs, build->nRuns, fp, NIL);
+        build->nRuns = 0;
+        if (e < eNOERROR) {
+            fclose(fp);
+            ERR(e);
+        }
+
+        build->runs[build->nRuns++] = fp;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_FinishRun() */
+
+
+
+/*@================================
+ * edubtm_WriteRun()
+ *================================*/
+/*
+ * Function: void *edubtm_WriteRun(void*)
+ *
+ * Description:
+ *  Sort the pairs of a run buffer and write them to a new temporary file.
+ *  It may run in a thread of its own, so it calls no function of the
+ *  buffer manager and reports its error in the buffer.
+ *
+ * Returns:
+ *  NULL
+ */
+void *edubtm_WriteRun(
+    void                        *runBuffer)             /* INOUT the run buffer (btm_RunBuffer*) */
+{
+    Four                        i;                      /* index */
+    btm_RunBuffer               *buf;                   /* the run buffer */
+
+
+    buf = (btm_RunBuffer*)runBuffer;
+
+    edubtm_SortPairs(buf->kdesc, buf->pairs, buf->tmp, buf->nPairs);
+
+    buf->fp = tmpfile();
+    if (buf->fp == NULL) {
+        buf->error = eSORTFILEIO_EDUBTM;
+        return(NULL);
+    }
+
+    for (i = 0; i < buf->nPairs; i++) {
+        if (edubtm_WritePair(buf->fp, &buf->pairs[i]) < eNOERROR) {
+            buf->error = eSORTFILEIO_EDUBTM;
+            break;
+        }
+    }
+
+    if (buf->error == eNOERROR && fflush(buf->fp) != 0) buf->error = eSORTFILEIO_EDUBTM;
+
+    if (buf->error < eNOERROR) {
+        fclose(buf->fp);
+        buf->fp = NULL;
+    }
+    else
+        rewind(buf->fp);
+
+    return(NULL);
+
+} /* edubtm_WriteRun() */
+
+
+
+/*@================================
+ * edubtm_MergeRuns()
+ *================================*/
+/*
+ * Function: Four edubtm_MergeRuns(KeyDesc*, FILE**, Four, FILE*, Four)
+ *
+ * Description:
+ *  Merge the sorted run files into the file 'out', or, if 'out' is NULL,
+ *  into the bulk load 'blkLdId'. The next pair of each run is kept in a
+ *  heap ordered by the pairs. The run files are closed; 'out' is rewound
+ *  to be read.
+ *
+ * Returns:
+ *  error code
+ *    eSORTFILEIO_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_MergeRuns(
+    KeyDesc                     *kdesc,                 /* IN key descriptor */
+    FILE                        **runs,                 /* IN run files to merge */
+    Four                        nRuns,                  /* IN # of run files */
+    FILE                        *out,                   /* IN file to write; NULL if bulk loaded */
+    Four                        blkLdId)                /* IN bulk load ID if 'out' is NULL */
+{
+    Four                        e;                      /* error number */
+    Four                        i;                      /* index */
+    Four                        child;                  /* a child in the heap */
+    Four                        nHeap;                  /* # of runs in the heap */
+    Four                        top;                    /* run of the least pair */
+    Four                        *heap;                  /* runs ordered by their next pairs */
+    btm_SortPair                *next;                  /* next pair of each run */
+
+
+    heap = (Four*)malloc(sizeof(Four) * nRuns);
+    next = (btm_SortPair*)malloc(sizeof(btm_SortPair) * nRuns);
+    if (heap == NULL || next == NULL) {
+        e = eMEMORYALLOCERR_EDUBTM;
+        nHeap = 0;
+    }
+    else {
+        /*@ put the first pair of each run into the heap */
+        e = eNOERROR;
+        nHeap = 0;
+        for (i = 0; i < nRuns && e >= eNOERROR; i++) {
+            e = edubtm_ReadPair(runs[i], &next[i]);
+            if (e == TRUE) {
+                /* sift up */
+                for (child = nHeap++;
+                     child > 0 && edubtm_ComparePairs(kdesc, &next[i], &next[heap[(child-1)/2]]) == LESS;
+                     child = (child-1)/2)
+                    heap[child] = heap[(child-1)/2];
+                heap[child] = i;
+            }
+        }
+    }
+
+    /*@ take the least pair until all runs are exhausted */
+    while (nHeap > 0 && e >= eNOERROR) {
+        top = heap[0];
+
+        if (out != NULL)
+            e = edubtm_WritePair(out, &next[top]);
+        else
+            e = EduBtM_NextSortedBulkLoad(blkLdId, &next[top].kval, &next[top].oid);
+        if (e < eNOERROR) break;
+
+        e = edubtm_ReadPair(runs[top], &next[top]);
+        if (e < eNOERROR) break;
+        if (e == FALSE) top = heap[--nHeap];
+
+        /* sift down 'top' from the root */
+        for (i = 0; (child = 2*i + 1) < nHeap; i = child) {
+            if (child + 1 < nHeap && edubtm_ComparePairs(kdesc, &next[heap[child+1]], &next[heap[child]]) == LESS)
+                child++;
+            if (edubtm_ComparePairs(kdesc, &next[heap[child]], &next[top]) != LESS) break;
+            heap[i] = heap[child];
+        }
+        if (nHeap > 0) heap[i] = top;
+    }
+
+    for (i = 0; i < nRuns; i++) fclose(runs[i]);
+    if (heap != NULL) free(heap);
+    if (next != NULL) free(next);
+
+    if (e < eNOERROR) ERR(e);
+
+    if (out != NULL) {
+        if (fflush(out) != 0) ERR(eSORTFILEIO_EDUBTM);
+        rewind(out);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_MergeRuns() */
+
+
+
+/*@================================
+ * edubtm_ReadPair()
+ *================================*/
+/*
+ * Function: Four edubtm_ReadPair(FILE*, btm_SortPair*)
+ *
+ * Description:
+ *  Read the next pair of a run file, stored as the ObjectID, the key
+ *  length, and the key value.
+ *
+ * Returns:
+ *  TRUE if a pair is read, FALSE at the end of the file, or error code
+ *    eSORTFILEIO_EDUBTM
+ */
+Four edubtm_ReadPair(
+    FILE                        *fp,                    /* IN run file */
+    btm_SortPair                *pair)                  /* OUT the pair read */
+{
+    if (fread(&pair->oid, sizeof(ObjectID), 1, fp) != 1)
+        return(ferror(fp) ? eSORTFILEIO_EDUBTM : FALSE);
+
+    if (fread(&pair->kval.len, sizeof(Two), 1, fp) != 1 ||
+        pair->kval.len < 0 || pair->kval.len > MAXKEYLEN ||
+        fread(pair->kval.val, 1, pair->kval.len, fp) != (size_t)pair->kval.len)
+        ERR(eSORTFILEIO_EDUBTM);
+
+    return(TRUE);
+
+} /* edubtm_ReadPair() */
+
+
+
+/*@================================
+ * edubtm_WritePair()
+ *================================*/
+/*
+ * Function: Four edubtm_WritePair(FILE*, btm_SortPair*)
+ *
+ * Description:
+ *  Append a pair to a run file.
+ *
+ * Returns:
+ *  error code
+ *    eSORTFILEIO_EDUBTM
+ */
+Four edubtm_WritePair(
+    FILE                        *fp,                    /* IN run file */
+    btm_SortPair                *pair)                  /* IN the pair to write */
+{
+    if (fwrite(&pair->oid, sizeof(ObjectID), 1, fp) != 1 ||
+        fwrite(&pair->kval.len, sizeof(Two), 1, fp) != 1 ||
+        fwrite(pair->kval.val, 1, pair->kval.len, fp) != (size_t)pair->kval.len)
+        return(eSORTFILEIO_EDUBTM);
+
+    return(eNOERROR);
+
+} /* edubtm_WritePair() */
+
+
+
+/*@================================
+ * edubtm_ExtractKey()
+ *================================*/
+/*
+ * Function: Four edubtm_ExtractKey(KeyDesc*, Object*, KeyValue*)
+ *
+ * Description:
+ *  Make the key value of an object from the key parts in its data.
+ *
+ * Returns:
+ *  error code
+ *    eBADKEYFIELD_EDUBTM
+ *    eNOTSUPPORTED_EDUBTM
+ */
+Four edubtm_ExtractKey(
+    KeyDesc                     *kdesc,                 /* IN key descriptor */
+    Object                      *obj,                   /* IN the object */
+    KeyValue                    *kval)                  /* OUT key value of the object */
+{
+    Two                         i;                      /* index of the key parts */
+    Two                         len;                    /* length of a string part */
+    Four                        offset;                 /* offset of a key part in the object */
+
+
+    /* The data of a large object is not in the page. */
+    if (obj->header.properties & P_LRGOBJ) return(eNOTSUPPORTED_EDUBTM);
+
+    kval->len = 0;
+    for (i = 0; i < kdesc->nparts; i++) {
+        offset = kdesc->kpart[i].offset;
+
+        switch (kdesc->kpart[i].type) {
+            case SM_INT:
+                if (offset < 0 || offset + (CONSTANT_CASTING_TYPE)sizeof(Four_Invariable) > obj->header.length ||
+                    kval->len + sizeof(Four_Invariable) > MAXKEYLEN)
+                    return(eBADKEYFIELD_EDUBTM);
+
+                memcpy(&kval->val[kval->len], &obj->data[offset], sizeof(Four_Invariable));
+                kval->len += sizeof(Four_Invariable);
+                break;
+
+            case SM_VARSTRING:
+                if (offset < 0 || offset + (CONSTANT_CASTING_TYPE)sizeof(Two) > obj->header.length)
+                    return(eBADKEYFIELD_EDUBTM);
+
+                memcpy(&len, &obj->data[offset], sizeof(Two));
+                if (len < 0 || len > kdesc->kpart[i].length ||
+                    offset + (CONSTANT_CASTING_TYPE)sizeof(Two) + len > obj->header.length ||
+                    kval->len + sizeof(Two) + len > MAXKEYLEN)
+                    return(eBADKEYFIELD_EDUBTM);
+
+                memcpy(&kval->val[kval->len], &obj->data[offset], sizeof(Two) + len);
+                kval->len += sizeof(Two) + len;
+                break;
+
+            default:
+                return(eNOTSUPPORTED_EDUBTM);
+        }
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_ExtractKey() */
+
+
+
+/*@================================
+ * edubtm_ComparePairs()
+ *================================*/
+/*
+ * Function: Four edubtm_ComparePairs(KeyDesc*, btm_SortPair*, btm_SortPair*)
+ *
+ * Description:
+ *  Compare two pairs by their keys, and by their ObjectIDs if the keys
+ *  are equal, so that the ObjectIDs of a key are loaded in order.
+ *
+ * Returns:
+ *  EQUAL, GREATER, or LESS
+ */
+Four edubtm_ComparePairs(
+    KeyDesc                     *kdesc,                 /* IN key descriptor */
+    btm_SortPair                *pair1,                 /* IN the first pair */
+    btm_SortPair                *pair2)                 /* IN the second pair */
+{
+    Four                        cmp;                    /* result of comparison */
+
+
+    cmp = edubtm_KeyCompare(kdesc, &pair1->kval, &pair2->kval);
+    if (cmp != EQUAL) return(cmp);
+
+    return(btm_ObjectIdComp(&pair1->oid, &pair2->oid));
+
+} /* edubtm_ComparePairs() */
+
+
+
+/*@================================
+ * edubtm_CompareSortPairs()
+ *================================*/
+/*
+ * Function: Four edubtm_CompareSortPairs(void*, void*, void*)
+ *
+ * Description:
+ *  edubtm_MergeSort() comparison function of the pairs; 'context' is the
+ *  key descriptor.
+ *
+ * Returns:
+ *  EQUAL, GREATER, or LESS
+ */
+Four edubtm_CompareSortPairs(
+    void                        *context,               /* IN key descriptor */
+    void                        *pair1,                 /* IN the first pair */
+    void                        *pair2)                 /* IN the second pair */
+{
+    return(edubtm_ComparePairs((KeyDesc*)context, (btm_SortPair*)pair1, (btm_SortPair*)pair2));
+
+} /* edubtm_CompareSortPairs() */
+
+
+
+/*@================================
+ * edubtm_SortPairs()
+ *================================*/
+/*
+ * Function: void edubtm_SortPairs(KeyDesc*, btm_SortPair*, btm_SortPair*, Four)
+ *
+ * Description:
+ *  Sort the pairs by edubtm_MergeSort() using the work area 'tmp' of the
+ *  same size.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_SortPairs(
+    KeyDesc                     *kdesc,                 /* IN key descriptor */
+    btm_SortPair                *pairs,                 /* INOUT pairs to sort */
+    btm_SortPair                *tmp,                   /* IN work area of 'nPairs' pairs */
+    Four                        nPairs)                 /* IN # of pairs */
+{
+    edubtm_MergeSort(pairs, tmp, nPairs, sizeof(btm_SortPair), edubtm_CompareSortPairs, kdesc);
+
+} /* edubtm_SortPairs() */
+
+
+
+/*@================================
+ * edubtm_MergeSort()
+ *================================*/
+/*
+ * Function: void edubtm_MergeSort(void*, void*, Four, Four, btm_SortCompare, void*)
+ *
+ * Description:
+ *  Sort 'nElems' elements of 'size' bytes with a bottom-up merge sort using
+ *  the work area 'tmp' of the same size. 'compare' is given 'context' and
+ *  two elements. Unlike qsort(), it needs no global variable for the
+ *  context, so that several sorts can run at once; the sort is stable.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_MergeSort(
+    void                        *elems,                 /* INOUT elements to sort */
+    void                        *tmp,                   /* IN work area of 'nElems' elements */
+    Four                        nElems,                 /* IN # of elements */
+    Four                        size,                   /* IN size of an element */
+    btm_SortCompare             compare,                /* IN comparison function */
+    void                        *context)               /* IN context given to 'compare' */
+{
+    Four                        width;                  /* length of the sorted sequences */
+    Four                        lo, mid, hi;            /* bounds of the two sequences merged */
+    Four                        i, j, k;                /* indexes */
+    char                        *src, *dst, *t;         /* merged from 'src' to 'dst' */
+
+
+    src = (char*)elems;
+    dst = (char*)tmp;
+
+    for (width = 1; width < nElems; width *= 2) {
+        for (lo = 0; lo < nElems; lo += 2 * width) {
+            mid = (lo + width < nElems) ? lo + width : nElems;
+            hi = (lo + 2 * width < nElems) ? lo + 2 * width : nElems;
+
+            for (i = lo, j = mid, k = lo; k < hi; k++) {
+                if (i < mid && (j >= hi || compare(context, src + j*size, src + i*size) != LESS))
+                    memcpy(dst + k*size, src + (i++)*size, size);
+                else
+                    memcpy(dst + k*size, src + (j++)*size, size);
+            }
+        }
+        t = src; src = dst; dst = t;
+    }
+
+    if (src != (char*)elems) memcpy(elems, src, size * nElems);
+
+} /* edubtm_MergeSort() */
+
+
+
+/*@================================
+ * edubtm_FreeIndexBuild()
+ *================================*/
+/*
+ * Function: void edubtm_FreeIndexBuild(btm_IndexBuild*)
+ *
+ * Description:
+ *  Wait for the threads of the build, and free its buffers and run files.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_FreeIndexBuild(
+    btm_IndexBuild              *build)                 /* INOUT state of the build */
+{
+    Four                        i;                      /* index */
+    btm_RunBuffer               *buf;                   /* a run buffer */
+
+
+    for (i = 0; i < build->nBuffers; i++) {
+        buf = &build->buffers[i];
+        if (buf->busy) pthread_join(buf->thread, NULL);
+        if (buf->fp != NULL) fclose(buf->fp);
+        if (buf->pairs != NULL) free(buf->pairs);
+        if (buf->tmp != NULL) free(buf->tmp);
+    }
+
+    for (i = 0; i < build->nRuns; i++) fclose(build->runs[i]);
+    if (build->runs != NULL) free(build->runs);
+
+} /* edubtm_FreeIndexBuild() */
@@ -0,0 +1,672 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_BulkLoad.c
+ *
+ * Description :
+ *  Build a B+ tree bottom-up from a stream of <key, ObjectID> pairs sorted
+ *  in ascending key order. Leaf pages are filled sequentially up to a fill
+ *  factor and linked by 'prevPage'/'nextPage'; whenever a page is full, the
+ *  first key of its successor is pushed into the level above, so that the
+ *  internal levels grow from the leaves to the root. Every new page is
+ *  allocated near the page allocated just before it, which lays the tree
+ *  out in the order it is written.
+ *
+ *  If the keys of the index are not unique, the pairs of a key may follow
+ *  one another; their ObjectIDs are added to the entry of the key, which
+ *  moves them to overflow pages when it outgrows a third of a page or the
+ *  fill factor of its page.
+ *
+ * Exports:
+ *  Four EduBtM_InitSortedBulkLoad(ObjectID*, PageID*, KeyDesc*, Two, Two)
+ *  Four EduBtM_NextSortedBulkLoad(Four, KeyValue*, ObjectID*)
+ *  Four EduBtM_FinalSortedBulkLoad(Four, Pool*, DeallocListElem*)
+ *  Four EduBtM_BulkLoad(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*,
+ *                       Two, Two, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "Util.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "OM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_BulkLoadNewPage(btm_BulkLoad*, Two);
+Four edubtm_BulkLoadReleasePage(PageID*, BtreePage*);
+Four edubtm_BulkLoadPushUp(btm_BulkLoad*, Two, KeyValue*, ShortPageID, ShortPageID);
+Four edubtm_BulkLoadObjectId(btm_BulkLoad*, ObjectID*);
+
+
+/*@ Global Variables */
+static btm_BulkLoad edubtm_bulkLoadTable[BTM_MAXBULKLOADS];  /* bulk loads in progress */
+
+
+
+/*@================================
+ * EduBtM_InitSortedBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduBtM_InitSortedBulkLoad(ObjectID*, PageID*, KeyDesc*, Two, Two)
+ *
+ * Description:
+ *  Start a sorted bulk load into the B+ tree given by 'root'. The B+ tree
+ *  should be empty, i.e. just created by EduBtM_CreateIndex(). The fill
+ *  factors are given in percent of a page and should be between 50 and
+ *  100; below half full, a page would underflow on the first deletion.
+ *  An index kept in an adaptive radix tree has no pages to load.
+ *
+ * Returns:
+ *  bulk load ID (>= 0) or error code
+ *    eBADPARAMETER_BTM
+ *    eNOTSUPPORTED_EDUBTM
+ *    eNOTEMPTYINDEX_EDUBTM
+ *    eTOOMANYBULKLOADS_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_InitSortedBulkLoad(
+    ObjectID                    *catObjForFile,         /* IN catalog object of B+ tree file */
+    PageID                      *root,                  /* IN root page of the B+ tree */
+    KeyDesc                     *kdesc,                 /* IN Btree key descriptor */
+    Two                         leafFillFactor,         /* IN fill factor of leaf pages (%) */
+    Two                         internalFillFactor)     /* IN fill factor of internal pages (%) */
+{
+    Four                        e;                      /* error number */
+    Four                        blkLdId;                /* bulk load ID */
+    btm_BulkLoad                *blkLd;                 /* bulk load entry */
+    BtreePage                   *rootPage;              /* pointer to a buffer holding the root page */
+    Four                        flags;                  /* page flags of the root page */
+    int                         i;
+    BTM_LATENCY(BTM_API_INITSORTEDBULKLOAD);
+
+
+    /*@ check parameters */
+    if (catObjForFile == NULL || root == NULL || kdesc == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (leafFillFactor < 50 || leafFillFactor > 100) ERR(eBADPARAMETER_BTM);
+
+    if (internalFillFactor < 50 || internalFillFactor > 100) ERR(eBADPARAMETER_BTM);
+
+    /* Error check whether using not supported functionality by EduBtM */
+    for(i=0; i<kdesc->nparts; i++)
+    {
+        if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
+            ERR(eNOTSUPPORTED_EDUBTM);
+    }
+
+    if (edubtm_GetArtIndex(root) != NULL) ERR(eNOTSUPPORTED_EDUBTM);
+
+    for (blkLdId = 0; blkLdId < BTM_MAXBULKLOADS; blkLdId++)
+        if (!edubtm_bulkLoadTable[blkLdId].isUsed) break;
+    if (blkLdId == BTM_MAXBULKLOADS) ERR(eTOOMANYBULKLOADS_EDUBTM);
+
+    /* The B+ tree should have no entry, buffered or not */
+    e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (!(rootPage->any.hdr.type & LEAF) || rootPage->bl.hdr.nSlots != 0)
+        ERRB1(eNOTEMPTYINDEX_EDUBTM, root, PAGE_BUF);
+
+    flags = rootPage->any.hdr.flags & BTM_INHERITED_FLAGS;
+    if ((flags & BTM_KEYHEAD) && !(flags & BTM_KEYHEAD_KIND))
+        flags |= edubtm_KeyHeadKind(kdesc);
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    blkLd = &edubtm_bulkLoadTable[blkLdId];
+    blkLd->isUsed = TRUE;
+    blkLd->catObjForFile = *catObjForFile;
+    blkLd->root = *root;
+    blkLd->kdesc = *kdesc;
+    blkLd->leafFill = (BTM_FLAGS_PAGESIZE(flags) - BL_FIXED) * leafFillFactor / 100;
+    blkLd->internalFill = (BTM_FLAGS_PAGESIZE(flags) - BI_FIXED) * internalFillFactor / 100;
+    blkLd->pageFlags = flags;
+    blkLd->nLevels = 0;
+    blkLd->lastAllocPid = *root;
+
+    return(blkLdId);
+
+} /* EduBtM_InitSortedBulkLoad() */
+
+
+
+/*@================================
+ * EduBtM_NextSortedBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduBtM_NextSortedBulkLoad(Four, KeyValue*, ObjectID*)
+ *
+ * Description:
+ *  Append a <key, ObjectID> pair to the bulk load. The key should be
+ *  greater than the key appended just before, or equal to it if the keys
+ *  of the index are not unique and the index is not clustered; otherwise
+ *  the pair is rejected and the bulk load may go on with the next pair.
+ *  The entries of a clustered index are loaded without records.
+ *
+ * Returns:
+ *  error code
+ *    eBADBULKLOADID_EDUBTM
+ *    eDUPLICATEDKEY_BTM
+ *    eDUPLICATEDOBJECTID_BTM
+ *    eNOTSORTED_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_NextSortedBulkLoad(
+    Four                        blkLdId,        /* IN bulk load ID */
+    KeyValue                    *kval,          /* IN key value */
+    ObjectID                    *oid)           /* IN ObjectID to be inserted */
+{
+    Four                        e;              /* error number */
+    Four                        cmp;            /* result of comparison */
+    btm_BulkLoad                *blkLd;         /* bulk load entry */
+    BtreeLeaf                   *lpage;         /* the leaf page being filled */
+    PageID                      prevPid;        /* the leaf page filled before */
+    BtreeLeaf                   *prevPage;      /* buffer of 'prevPid' */
+    btm_LeafEntry               *entry;         /* a new leaf entry */
+    Two                         alignedKlen;    /* aligned length of the key length */
+    Two                         entryLen;       /* length of the new entry */
+    Four                        neededSpace;    /* space for the new entry, its slot, and its key head */
+    Four                        headLen;        /* length of a key head */
+    Four                        filled;         /* # of bytes used in the leaf page */
+    BTM_LATENCY(BTM_API_NEXTSORTEDBULKLOAD);
+
+
+    if (blkLdId < 0 || blkLdId >= BTM_MAXBULKLOADS || !edubtm_bulkLoadTable[blkLdId].isUsed)
+        ERR(eBADBULKLOADID_EDUBTM);
+    if (kval == NULL || oid == NULL) ERR(eBADPARAMETER_BTM);
+
+    blkLd = &edubtm_bulkLoadTable[blkLdId];
+
+    /* The keys should be given in ascending order */
+    if (blkLd->nLevels > 0) {
+        cmp = edubtm_KeyCompare(&blkLd->kdesc, kval, &blkLd->lastKey);
+        if (cmp == EQUAL && ((blkLd->kdesc.flag & KEYFLAG_UNIQUE) || (blkLd->pageFlags & BTM_CLUSTERED)))
+            ERR(eDUPLICATEDKEY_BTM);
+        if (cmp == LESS) ERR(eNOTSORTED_EDUBTM);
+
+        /* Another ObjectID of the key appended just before */
+        if (cmp == EQUAL) {
+            e = edubtm_BulkLoadObjectId(blkLd, oid);
+            if (e < eNOERROR) ERR(e);
+
+            return(eNOERROR);
+        }
+    }
+
+    alignedKlen = ALIGNED_LENGTH(kval->len);
+    entryLen = sizeof(Two) + sizeof(Two) + alignedKlen + sizeof(ObjectID);
+    if (blkLd->pageFlags & BTM_CLUSTERED) entryLen += BTM_INLINE_LEN(NIL);
+    headLen = (blkLd->pageFlags & BTM_KEYHEAD) ? sizeof(KeyHead) : 0;
+    neededSpace = entryLen + sizeof(Two) + headLen;
+
+    if (blkLd->nLevels == 0) {
+        /* the first leaf page */
+        e = edubtm_BulkLoadNewPage(blkLd, 0);
+        if (e < eNOERROR) ERR(e);
+        blkLd->nLevels = 1;
+    }
+    else {
+        lpage = &blkLd->page[0]->bl;
+        filled = BTM_PAGE_SIZE(lpage) - BL_FIXED - BL_CFREE(lpage) + lpage->hdr.nSlots*headLen;
+
+        if (filled + neededSpace > blkLd->leafFill || BL_CFREE(lpage) < neededSpace) {
+            /* Start a new leaf page and link it next to the full one */
+            prevPid = blkLd->pid[0];
+            prevPage = lpage;
+
+            e = edubtm_BulkLoadNewPage(blkLd, 0);
+            if (e < eNOERROR) ERR(e);
+
+            prevPage->hdr.nextPage = blkLd->pid[0].pageNo;
+            blkLd->page[0]->bl.hdr.prevPage = prevPid.pageNo;
+
+            /* The first key of the new leaf page discriminates the two pages */
+            e = edubtm_BulkLoadPushUp(blkLd, 1, kval, prevPid.pageNo, blkLd->pid[0].pageNo);
+            if (e < eNOERROR) ERR(e);
+
+            e = edubtm_BulkLoadReleasePage(&prevPid, (BtreePage*)prevPage);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    /* Append the new entry to the leaf page */
+    lpage = &blkLd->page[0]->bl;
+    lpage->slot[-lpage->hdr.nSlots] = lpage->hdr.free;
+    entry = (btm_LeafEntry*)&lpage->data[lpage->hdr.free];
+    entry->nObjects = 1;
+    entry->klen = kval->len;
+    memcpy(entry->kval, kval->val, kval->len);
+    memcpy(&entry->kval[alignedKlen], oid, sizeof(ObjectID));
+    if (blkLd->pageFlags & BTM_CLUSTERED) edubtm_PutInlineRecord(entry, NULL, NIL);
+    lpage->hdr.free += entryLen;
+    lpage->hdr.nSlots++;
+
+    blkLd->lastKey.len = kval->len;
+    memcpy(blkLd->lastKey.val, kval->val, kval->len);
+
+    return(eNOERROR);
+
+} /* EduBtM_NextSortedBulkLoad() */
+
+
+
+/*@================================
+ * EduBtM_FinalSortedBulkLoad()
+ *================================*/
+/*
+ * Function: Four EduBtM_FinalSortedBulkLoad(Four, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Finish the bulk load. The pages being filled are written out and the
+ *  top page is copied into the root page, because the root page of a
+ *  B+ tree never moves. The page which held the top is deallocated.
+ *
+ * Returns:
+ *  error code
+ *    eBADBULKLOADID_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_FinalSortedBulkLoad(
+    Four                        blkLdId,        /* IN bulk load ID */
+    Pool                        *dlPool,        /* INOUT pool of dealloc list elements */
+    DeallocListElem             *dlHead)        /* INOUT head of the dealloc list */
+{
+    Four                        e;              /* error number */
+    Two                         level;          /* level of a B+ tree */
+    btm_BulkLoad                *blkLd;         /* bulk load entry */
+    PageID                      topPid;         /* the top page built by the bulk load */
+    BtreePage                   *topPage;       /* buffer of 'topPid' */
+    BtreePage                   *rootPage;      /* pointer to a buffer holding the root page */
+    DeallocListElem             *dlElem;        /* an element of the dealloc list */
+    btm_IndexInfo               *info;          /* information about the index */
+    Four                        msgPage;        /* first page of the message buffer of the root */
+    BTM_LATENCY(BTM_API_FINALSORTEDBULKLOAD);
+
+
+    if (blkLdId < 0 || blkLdId >= BTM_MAXBULKLOADS || !edubtm_bulkLoadTable[blkLdId].isUsed)
+        ERR(eBADBULKLOADID_EDUBTM);
+    if (dlPool == NULL || dlHead == NULL) ERR(eBADPARAMETER_BTM);
+
+    blkLd = &edubtm_bulkLoadTable[blkLdId];
+    blkLd->isUsed = FALSE;
+
+    if (blkLd->nLevels == 0) return(eNOERROR);
+
+    for (level = 0; level < blkLd->nLevels - 1; level++) {
+        e = edubtm_BulkLoadReleasePage(&blkLd->pid[level], blkLd->page[level]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    /* Copy the top page into the root page */
+    topPid = blkLd->pid[blkLd->nLevels - 1];
+    topPage = blkLd->page[blkLd->nLevels - 1];
+    edubtm_BuildKeyHeads(topPage, NULL);
+
+    e = edubtm_GetTrainForUpdate(&blkLd->root, (char**)&rootPage);
+    if (e < eNOERROR) ERRB1(e, &topPid, PAGE_BUF);
+
+    msgPage = rootPage->any.hdr.reserved;
+    memcpy(rootPage, topPage, PAGESIZE);
+    rootPage->any.hdr.pid = blkLd->root;
+    rootPage->any.hdr.type |= ROOT;
+    rootPage->any.hdr.reserved = msgPage;
+
+    e = BfM_SetDirty(&blkLd->root, PAGE_BUF);
+    if (e < eNOERROR) ERRB2(e, &blkLd->root, PAGE_BUF, &topPid, PAGE_BUF);
+    e = BfM_FreeTrain(&blkLd->root, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &topPid, PAGE_BUF);
+
+    /* Deallocate the page which held the top */
+    topPage->any.hdr.type = FREEPAGE;
+
+    e = Util_getElementFromPool(dlPool, &dlElem);
+    if (e < eNOERROR) ERRB1(e, &topPid, PAGE_BUF);
+    dlElem->type = DL_PAGE;
+    dlElem->elem.pid = topPid;
+    dlElem->next = dlHead->next;
+    dlHead->next = dlElem;
+
+    e = BfM_SetDirty(&topPid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &topPid, PAGE_BUF);
+    e = BfM_FreeTrain(&topPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /* The Bloom filter does not hold the loaded keys; it is rebuilt when used next */
+    info = edubtm_GetIndexInfo(&blkLd->root, FALSE);
+    if (info != NULL) info->bloom.valid = FALSE;
+
+    return(eNOERROR);
+
+} /* EduBtM_FinalSortedBulkLoad() */
+
+
+
+/*@================================
+ * EduBtM_BulkLoad()
+ *================================*/
+/*
+ * Function: Four EduBtM_BulkLoad(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*,
+ *                                Two, Two, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Bulk load an array of <key, ObjectID> pairs sorted in ascending key
+ *  order into an empty B+ tree.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  If an error occurs in the middle, the pairs before the erroneous one
+ *  are left in the B+ tree.
+ */
+Four EduBtM_BulkLoad(
+    ObjectID                    *catObjForFile,         /* IN catalog object of B+ tree file */
+    PageID                      *root,                  /* IN root page of the B+ tree */
+    KeyDesc                     *kdesc,                 /* IN Btree key descriptor */
+    Four                        nObjects,               /* IN # of pairs */
+    KeyValue                    *kvals,                 /* IN key values sorted in ascending order */
+    ObjectID                    *oids,                  /* IN ObjectIDs of the keys */
+    Two                         leafFillFactor,         /* IN fill factor of leaf pages (%) */
+    Two                         internalFillFactor,     /* IN fill factor of internal pages (%) */
+    Pool                        *dlPool,                /* INOUT pool of dealloc list elements */
+    DeallocListElem             *dlHead)                /* INOUT head of the dealloc list */
+{
+    Four                        e;                      /* error number */
+    Four                        blkLdId;                /* bulk load ID */
+    Four                        i;                      /* index */
+    BTM_LATENCY(BTM_API_BULKLOAD);
+
+
+    if (nObjects < 0 || (nObjects > 0 && (kvals == NULL || oids == NULL))) ERR(eBADPARAMETER_BTM);
+
+    blkLdId = EduBtM_InitSortedBulkLoad(catObjForFile, root, kdesc, leafFillFactor, internalFillFactor);
+    if (blkLdId < eNOERROR) ERR(blkLdId);
+
+    for (i = 0; i < nObjects; i++) {
+        e = EduBtM_NextSortedBulkLoad(blkLdId, &kvals[i], &oids[i]);
+        if (e < eNOERROR) {
+            (Four) EduBtM_FinalSortedBulkLoad(blkLdId, dlPool, dlHead);
+            ERR(e);
+        }
+    }
+
+    e = EduBtM_FinalSortedBulkLoad(blkLdId, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBtM_BulkLoad() */
+
+
+
+/*@================================
+ * edubtm_BulkLoadNewPage()
+ *================================*/
+/*
+ * Function: Four edubtm_BulkLoadNewPage(btm_BulkLoad*, Two)
+ *
+ * Description:
+ *  Allocate a new page near the page allocated last and make it the page
+ *  being filled on the given level. The page is kept fixed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_BulkLoadNewPage(
+    btm_BulkLoad                *blkLd,         /* INOUT bulk load entry */
+    Two                         level)          /* IN level of the new page; 0 for a leaf */
+{
+    Four                        e;              /* error number */
+    PageID                      newPid;         /* a new page */
+    BtreePage                   *apage;         /* buffer of 'newPid' */
+
+
+    e = btm_AllocPage(&blkLd->catObjForFile, &blkLd->lastAllocPid, &newPid);
+    if (e < eNOERROR) ERR(e);
+
+    if (level == 0)
+        e = edubtm_InitLeaf(&newPid, FALSE, FALSE);
+    else
+        e = edubtm_InitInternal(&newPid, FALSE, FALSE);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetTrain(&newPid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    apage->any.hdr.flags |= blkLd->pageFlags;
+
+    blkLd->pid[level] = newPid;
+    blkLd->page[level] = apage;
+    blkLd->lastAllocPid = newPid;
+
+    return(eNOERROR);
+
+} /* edubtm_BulkLoadNewPage() */
+
+
+
+/*@================================
+ * edubtm_BulkLoadReleasePage()
+ *================================*/
+/*
+ * Function: Four edubtm_BulkLoadReleasePage(PageID*, BtreePage*)
+ *
+ * Description:
+ *  Write out a page which is filled completely.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_BulkLoadReleasePage(
+    PageID                      *pid,           /* IN the filled page */
+    BtreePage                   *apage)         /* INOUT buffer of 'pid' */
+{
+    Four                        e;              /* error number */
+
+
+    edubtm_BuildKeyHeads(apage, NULL);
+
+    e = BfM_SetDirty(pid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_BulkLoadReleasePage() */
+
+
+
+/*@================================
+ * edubtm_BulkLoadPushUp()
+ *================================*/
+/*
+ * Function: Four edubtm_BulkLoadPushUp(btm_BulkLoad*, Two, KeyValue*, ShortPageID, ShortPageID)
+ *
+ * Description:
+ *  Append the internal entry <key, right> to the internal page being
+ *  filled on the given level. 'left' is the page on the level below which
+ *  precedes 'right'; it becomes 'p0' when the level is new. If the page is
+ *  full, a new internal page is started with 'p0' = 'right' and the key
+ *  moves up to the next level.
+ *
+ * Returns:
+ *  error code
+ *    eEXCEEDMAXDEPTHOFBTREE_BTM
+ *    some errors caused by function calls
+ */
+Four edubtm_BulkLoadPushUp(
+    btm_BulkLoad                *blkLd,         /* INOUT bulk load entry */
+    Two                         level,          /* IN level to push the entry into */
+    KeyValue                    *key,           /* IN discriminator key */
+    ShortPageID                 left,           /* IN page preceding 'right' on the level below */
+    ShortPageID                 right)          /* IN page on the level below starting with 'key' */
+{
+    Four                        e;              /* error number */
+    BtreeInternal               *ipage;         /* the internal page being filled */
+    PageID                      prevPid;        /* the internal page filled before */
+    BtreeInternal               *prevPage;      /* buffer of 'prevPid' */
+    btm_InternalEntry           *entry;         /* a new internal entry */
+    Two                         entryLen;       /* length of the new entry */
+    Four                        neededSpace;    /* space for the new entry, its slot, and its key head */
+    Four                        headLen;        /* length of a key head */
+    Four                        filled;         /* # of bytes used in the internal page */
+
+
+    if (level >= BTM_MAXLEVEL) ERR(eEXCEEDMAXDEPTHOFBTREE_BTM);
+
+    if (level == blkLd->nLevels) {
+        /* a new level above the current top */
+        e = edubtm_BulkLoadNewPage(blkLd, level);
+        if (e < eNOERROR) ERR(e);
+
+        blkLd->page[level]->bi.hdr.p0 = left;
+        blkLd->nLevels++;
+    }
+
+    ipage = &blkLd->page[level]->bi;
+    entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + key->len);
+    headLen = (blkLd->pageFlags & BTM_KEYHEAD) ? sizeof(KeyHead) : 0;
+    neededSpace = entryLen + sizeof(Two) + headLen;
+    filled = BTM_PAGE_SIZE(ipage) - BI_FIXED - BI_CFREE(ipage) + ipage->hdr.nSlots*headLen;
+
+    if (ipage->hdr.nSlots > 0 &&
+        (filled + neededSpace > blkLd->internalFill || BI_CFREE(ipage) < neededSpace)) {
+        /* Start a new internal page; the key moves up to the next level */
+        prevPid = blkLd->pid[level];
+        prevPage = ipage;
+
+        e = edubtm_BulkLoadNewPage(blkLd, level);
+        if (e < eNOERROR) ERR(e);
+
+        blkLd->page[level]->bi.hdr.p0 = right;
+
+        e = edubtm_BulkLoadPushUp(blkLd, level + 1, key, prevPid.pageNo, blkLd->pid[level].pageNo);
+        if (e < eNOERROR) ERR(e);
+
+        e = edubtm_BulkLoadReleasePage(&prevPid, (BtreePage*)prevPage);
+        if (e < eNOERROR) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    /* Append the new entry to the internal page */
+    ipage->slot[-ipage->hdr.nSlots] = ipage->hdr.free;
+    entry = (btm_InternalEntry*)&ipage->data[ipage->hdr.free];
+    entry->spid = right;
+    entry->klen = key->len;
+    memcpy(entry->kval, key->val, key->len);
+    ipage->hdr.free += entryLen;
+    ipage->hdr.nSlots++;
+
+    return(eNOERROR);
+
+} /* edubtm_BulkLoadPushUp() */
+
+
+
+/*@================================
+ * edubtm_BulkLoadObjectId()
+ *================================*/
+/*
+ * Function: Four edubtm_BulkLoadObjectId(btm_BulkLoad*, ObjectID*)
+ *
+ * Description:
+ *  Add an ObjectID to the entry appended last, which has the same key. The
+ *  entry grows in its leaf page while it is shorter than a third of a page
+ *  and the page is within its fill factor; otherwise its ObjectIDs go to
+ *  overflow pages, and the following ones are inserted there.
+ *
+ * Returns:
+ *  error code
+ *    eDUPLICATEDOBJECTID_BTM
+ *    some errors caused by function calls
+ */
+Four edubtm_BulkLoadObjectId(
+    btm_BulkLoad                *blkLd,         /* INOUT bulk load entry */
+    ObjectID                    *oid)           /* IN ObjectID to be inserted */
+{
+    Four                        e;              /* error number */
+    BtreeLeaf                   *lpage;         /* the leaf page being filled */
+    Two                         slotNo;         /* slot of the last entry */
+    btm_LeafEntry               *entry;         /* the last entry */
+    ObjectID                    *oidArray;      /* ObjectID array of the entry */
+    Two                         oidArrayElemNo; /* the ObjectID is inserted after this element */
+    PageID                      ovPid;          /* the first overflow page of the entry */
+    Four                        headLen;        /* length of a key head */
+    Four                        filled;         /* # of bytes used in the leaf page */
+
+
+    lpage = &blkLd->page[0]->bl;
+    slotNo = lpage->hdr.nSlots - 1;
+    entry = (btm_LeafEntry*)&lpage->data[lpage->slot[-slotNo]];
+
+    if (entry->nObjects < 0) {
+        MAKE_PAGEID(ovPid, blkLd->pid[0].volNo, BTM_LEAFENTRY_OVPAGE(entry));
+        e = btm_InsertOverflow(&blkLd->catObjForFile, &ovPid, oid);
+        if (e < eNOERROR) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    oidArray = BTM_LEAFENTRY_OIDS(entry);
+    if (btm_BinarySearchOidArray(oidArray, oid, entry->nObjects, &oidArrayElemNo))
+        ERR(eDUPLICATEDOBJECTID_BTM);
+
+    headLen = (blkLd->pageFlags & BTM_KEYHEAD) ? sizeof(KeyHead) : 0;
+    filled = BTM_PAGE_SIZE(lpage) - BL_FIXED - BL_CFREE(lpage) + lpage->hdr.nSlots*headLen;
+
+    if (BTM_LEAFENTRY_LEN(lpage, entry) + OBJECTID_SIZE > OVERFLOW_SPLIT(lpage) ||
+        filled + OBJECTID_SIZE > blkLd->leafFill || BL_CFREE(lpage) < OBJECTID_SIZE) {
+        e = btm_CreateOverflow(&blkLd->catObjForFile, lpage, slotNo, oid);
+        if (e < eNOERROR) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    /* The last entry is followed by the contiguous free area */
+    memmove(&oidArray[oidArrayElemNo+2], &oidArray[oidArrayElemNo+1],
+            (entry->nObjects - oidArrayElemNo - 1) * OBJECTID_SIZE);
+    oidArray[oidArrayElemNo+1] = *oid;
+    entry->nObjects++;
+    lpage->hdr.free += OBJECTID_SIZE;
+
+    return(eNOERROR);
+
+} /* edubtm_BulkLoadObjectId() */
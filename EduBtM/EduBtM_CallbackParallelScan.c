@@ -0,0 +1,511 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_CallbackParallelScan.c
+ *
+ * Description:
+ *  Callback-parallel scan of a range of a B+ tree: the entries are read
+ *  one batch at a time, and only the callbacks processing them run in
+ *  parallel. The range is split into
+ *  sub-ranges (morsels) at the separator keys of the root and, when the
+ *  root does not give enough of them, of the lower internal levels. Each
+ *  worker thread takes the next morsel not yet taken, scans it with
+ *  EduBtM_OpenScan()/EduBtM_FetchNextBatch(), and passes the entries in
+ *  batches to the callback of the caller. A morsel is much smaller than
+ *  the share of a worker, so the workers stay busy even when the morsels
+ *  hold very different numbers of entries.
+ *
+ *  The buffer manager is not thread-safe, so every call of a worker to
+ *  EduBtM is made under one mutex shared by all the scans; reading the
+ *  pages is not parallel and does not get faster with more workers. Only
+ *  the callbacks, which process the entries, run in parallel, so the scan
+ *  pays off when the work per entry is larger than reading it. A batch
+ *  stays valid while its callback runs, since its leaf stays fixed by the
+ *  scan of the worker. The index should not be updated during the scan.
+ *
+ * Exports:
+ *  Four EduBtM_CallbackParallelScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four,
+ *                           Four, BtreeScanCallback, void*)
+ *  Four edubtm_SplitScanRange(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four,
+ *                             Four, btm_ScanMorsel*, Four*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+
+
+/* State shared by the workers of a parallel scan */
+typedef struct {
+    PageID              root;           /* root page of the index */
+    KeyDesc             kdesc;          /* key descriptor */
+    btm_ScanMorsel      *morsels;       /* the sub-ranges of the scan */
+    Four                nMorsels;       /* # of sub-ranges */
+    Four                nextMorsel;     /* the sub-range to be taken next */
+    BtreeScanCallback   callback;       /* callback receiving the entries */
+    void                *arg;           /* argument of the callback */
+    Four                error;          /* the first error of the workers; eNOERROR if none */
+} btm_ParallelScan;
+
+/* A worker of a parallel scan */
+typedef struct {
+    btm_ParallelScan    *pscan;         /* the parallel scan */
+    Four                workerNo;       /* worker No. passed to the callback */
+} btm_ScanWorker;
+
+
+/*@ Global Variables */
+static pthread_mutex_t edubtm_parallelScanMutex = PTHREAD_MUTEX_INITIALIZER;  /* serializes the calls to EduBtM */
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_CollectSeparators(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, Four, Four, KeyValue*, Four*, Boolean*);
+void *edubtm_ScanWorker(void*);
+Four edubtm_ScanMorsels(btm_ParallelScan*, Four);
+
+
+
+/*@================================
+ * EduBtM_CallbackParallelScan()
+ *================================*/
+/*
+ * Function: Four EduBtM_CallbackParallelScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four,
+ *                                    Four, BtreeScanCallback, void*)
+ *
+ * Description:
+ *  Scan the range given by the start and stop conditions with 'nWorkers'
+ *  workers and call 'callback' with every batch of entries found. The
+ *  conditions are those of EduBtM_Fetch() for a forward scan: the start
+ *  operator is SM_BOF, SM_EQ, SM_GE, or SM_GT, and the stop operator is
+ *  SM_EOF, SM_EQ, SM_LE, or SM_LT. The entries of a batch are in key order,
+ *  but the batches of different workers come in no particular order.
+ *  The workers read the index one at a time; only the callbacks run in
+ *  parallel.
+ *
+ *  The callback gets 'arg', the No. of the worker (0 to nWorkers-1), and
+ *  the batch; it is called by one worker at a time for the same worker
+ *  No., but by several workers at once. When it returns a negative value,
+ *  the workers stop after their current batch and the value is returned.
+ *  With one worker, the scan runs in the calling thread. An index kept in
+ *  an adaptive radix tree cannot be scanned in parallel.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eBADCOMPOP_BTM
+ *    eNOTSUPPORTED_EDUBTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_CallbackParallelScan(
+    PageID                      *root,          /* IN root page's PageID */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *startKval,     /* IN key value of start condition */
+    Four                        startCompOp,    /* IN comparison operator of start condition */
+    KeyValue                    *stopKval,      /* IN key value of stop condition */
+    Four                        stopCompOp,     /* IN comparison operator of stop condition */
+    Four                        nWorkers,       /* IN # of workers */
+    BtreeScanCallback           callback,       /* IN callback receiving the entries */
+    void                        *arg)           /* IN argument of the callback */
+{
+    Four                        e;              /* error number */
+    Four                        i;              /* index */
+    Four                        nStarted;       /* # of worker threads started */
+    btm_ParallelScan            pscan;          /* state shared by the workers */
+    btm_ScanWorker              workers[BTM_MAXSCANWORKERS]; /* the workers */
+    pthread_t                   threads[BTM_MAXSCANWORKERS]; /* threads of the workers */
+    BTM_LATENCY(BTM_API_CALLBACKPARALLELSCAN);
+
+
+    /*@ check parameters */
+    if (root == NULL || kdesc == NULL || startKval == NULL || stopKval == NULL || callback == NULL)
+        ERR(eBADPARAMETER_BTM);
+
+    if (nWorkers < 1 || nWorkers > BTM_MAXSCANWORKERS) ERR(eBADPARAMETER_BTM);
+
+    if (startCompOp != SM_BOF && startCompOp != SM_EQ && startCompOp != SM_GE && startCompOp != SM_GT)
+        ERR(eBADCOMPOP_BTM);
+
+    if (stopCompOp != SM_EOF && stopCompOp != SM_EQ && stopCompOp != SM_LE && stopCompOp != SM_LT)
+        ERR(eBADCOMPOP_BTM);
+
+    if (edubtm_GetArtIndex(root) != NULL) ERR(eNOTSUPPORTED_EDUBTM);
+
+    /* The workers only read the tree; flush the buffered insertions of the range first */
+    e = edubtm_FlushMessages(root, startKval, startCompOp, stopKval, stopCompOp);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, startKval, startCompOp, stopKval, stopCompOp);
+    if (e < eNOERROR) ERR(e);
+
+    pscan.morsels = (btm_ScanMorsel*)malloc(sizeof(btm_ScanMorsel) * BTM_MAXMORSELS);
+    if (pscan.morsels == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+    e = edubtm_SplitScanRange(root, kdesc, startKval, startCompOp, stopKval, stopCompOp,
+                              nWorkers * BTM_MORSELS_PER_WORKER, pscan.morsels, &pscan.nMorsels);
+    if (e < eNOERROR) {
+        free(pscan.morsels);
+        ERR(e);
+    }
+
+    pscan.root = *root;
+    pscan.kdesc = *kdesc;
+    pscan.nextMorsel = 0;
+    pscan.callback = callback;
+    pscan.arg = arg;
+    pscan.error = eNOERROR;
+
+    /* More workers than morsels would have nothing to do. */
+    if (nWorkers > pscan.nMorsels) nWorkers = pscan.nMorsels;
+
+    if (nWorkers <= 1) {
+        e = edubtm_ScanMorsels(&pscan, 0);
+        free(pscan.morsels);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    /*@ start the workers */
+    for (nStarted = 0; nStarted < nWorkers; nStarted++) {
+        workers[nStarted].pscan = &pscan;
+        workers[nStarted].workerNo = nStarted;
+        if (pthread_create(&threads[nStarted], NULL, edubtm_ScanWorker, &workers[nStarted]) != 0) break;
+    }
+
+    /* Without any thread the calling thread does the whole scan. */
+    if (nStarted == 0)
+        pscan.error = edubtm_ScanMorsels(&pscan, 0);
+
+    for (i = 0; i < nStarted; i++)
+        pthread_join(threads[i], NULL);
+
+    free(pscan.morsels);
+
+    if (pscan.error < eNOERROR) ERR(pscan.error);
+
+    return(eNOERROR);
+
+} /* EduBtM_CallbackParallelScan() */
+
+
+
+/*@================================
+ * edubtm_SplitScanRange()
+ *================================*/
+/*
+ * Function: Four edubtm_SplitScanRange(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four,
+ *                                      Four, btm_ScanMorsel*, Four*)
+ *
+ * Description:
+ *  Split the range given by the start and stop conditions into about
+ *  'nWanted' morsels at the separator keys inside the range. The keys of
+ *  the root are used if they are enough; otherwise the keys of the next
+ *  levels are added, down to the first level giving enough keys, and every
+ *  n-th of them is taken so that no more than 'nWanted' morsels are made.
+ *  Only the subtrees overlapping the range are visited. With separators
+ *  s1 < ... < sn the morsels are
+ *    [start, s1), [s1, s2), ..., [sn, stop]
+ *  which together cover the range exactly once. An equality search is not
+ *  split.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_SplitScanRange(
+    PageID                      *root,          /* IN root page's PageID */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *startKval,     /* IN key value of start condition */
+    Four                        startCompOp,    /* IN comparison operator of start condition */
+    KeyValue                    *stopKval,      /* IN key value of stop condition */
+    Four                        stopCompOp,     /* IN comparison operator of stop condition */
+    Four                        nWanted,        /* IN # of morsels wanted */
+    btm_ScanMorsel              *morsels,       /* OUT morsels; room for BTM_MAXMORSELS */
+    Four                        *nMorsels)      /* OUT # of morsels */
+{
+    Four                        e;              /* error number */
+    Four                        i;              /* index */
+    Four                        depth;          /* the lowest level whose keys are used */
+    Four                        nKeys;          /* # of keys inside the range down to 'depth' */
+    Four                        nSeps;          /* # of separators taken */
+    Four                        stride;         /* one of 'stride' keys is taken */
+    Boolean                     leafReached;    /* TRUE if the leaves are reached */
+    KeyValue                    *seps;          /* separators taken */
+
+
+    nSeps = 0;
+
+    if (nWanted > BTM_MAXMORSELS) nWanted = BTM_MAXMORSELS;
+
+    if (startCompOp != SM_EQ && nWanted > 1) {
+
+        /*@ find the level giving enough keys */
+        leafReached = FALSE;
+        for (depth = 0; ; depth++) {
+            nKeys = 0;
+            e = edubtm_CollectSeparators(root, kdesc, startKval, startCompOp, stopKval, stopCompOp,
+                                         depth, 1, NULL, &nKeys, &leafReached);
+            if (e < eNOERROR) ERR(e);
+
+            if (leafReached || nKeys + 1 >= nWanted) break;
+        }
+
+        if (nKeys > 0) {
+            seps = (KeyValue*)malloc(sizeof(KeyValue) * (nWanted - 1));
+            if (seps == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+            stride = (nKeys + nWanted - 2) / (nWanted - 1);
+            e = edubtm_CollectSeparators(root, kdesc, startKval, startCompOp, stopKval, stopCompOp,
+                                         depth, stride, seps, &nSeps, &leafReached);
+            if (e < eNOERROR) {
+                free(seps);
+                ERR(e);
+            }
+            nSeps = (nSeps + stride - 1) / stride;
+
+            for (i = 0; i < nSeps; i++) {
+                morsels[i+1].startKval = seps[i];
+                morsels[i+1].startCompOp = SM_GE;
+                morsels[i].stopKval = seps[i];
+                morsels[i].stopCompOp = SM_LT;
+            }
+
+            free(seps);
+        }
+    }
+
+    morsels[0].startKval = *startKval;
+    morsels[0].startCompOp = startCompOp;
+    morsels[nSeps].stopKval = *stopKval;
+    morsels[nSeps].stopCompOp = stopCompOp;
+
+    *nMorsels = nSeps + 1;
+
+    return(eNOERROR);
+
+} /* edubtm_SplitScanRange() */
+
+
+
+/*@================================
+ * edubtm_CollectSeparators()
+ *================================*/
+/*
+ * Function: Four edubtm_CollectSeparators(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four,
+ *                                         Four, Four, KeyValue*, Four*, Boolean*)
+ *
+ * Description:
+ *  Visit in key order the keys of the internal pages of the subtree
+ *  'root', down to 'depth' levels below 'root', which are strictly inside
+ *  the range, and count them in '*nKeys'. Every 'stride'-th key counted is
+ *  copied to 'seps' unless it is NULL. Only the children whose keys may be
+ *  inside the range are visited.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_CollectSeparators(
+    PageID                      *root,          /* IN root of the subtree */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *startKval,     /* IN key value of start condition */
+    Four                        startCompOp,    /* IN comparison operator of start condition */
+    KeyValue                    *stopKval,      /* IN key value of stop condition */
+    Four                        stopCompOp,     /* IN comparison operator of stop condition */
+    Four                        depth,          /* IN # of levels below 'root' to visit */
+    Four                        stride,         /* IN one of 'stride' keys is copied */
+    KeyValue                    *seps,          /* OUT keys copied; NULL if only counted */
+    Four                        *nKeys,         /* INOUT # of keys counted */
+    Boolean                     *leafReached)   /* OUT set to TRUE if a leaf is visited */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* slot No. */
+    BtreeInternal               *apage;         /* buffer of 'root' */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+    PageID                      child;          /* a child page */
+    Boolean                     afterStart;     /* TRUE if the key of slot i is after the start */
+    Boolean                     beforeStop;     /* TRUE if the key of slot i is before the stop */
+
+
+    e = BfM_GetTrain(root, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (!(apage->hdr.type & INTERNAL)) {
+        *leafReached = TRUE;
+        e = BfM_FreeTrain(root, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    for (i = 0; i <= apage->hdr.nSlots; i++) {
+        if (i < apage->hdr.nSlots) {
+            iEntry = (btm_InternalEntry*)&apage->data[apage->slot[-i]];
+            afterStart = (startCompOp == SM_BOF ||
+                          edubtm_KeyCompare(kdesc, (KeyValue*)&iEntry->klen, startKval) == GREATER);
+            beforeStop = (stopCompOp == SM_EOF ||
+                          edubtm_KeyCompare(kdesc, (KeyValue*)&iEntry->klen, stopKval) == LESS);
+        }
+        else {
+            afterStart = TRUE;
+            beforeStop = FALSE;
+        }
+
+        /*@ visit the child left of slot i, which holds the keys less than the key of slot i */
+        if (depth > 0 && afterStart) {
+            if (i == 0)
+                MAKE_PAGEID(child, root->volNo, apage->hdr.p0);
+            else
+                MAKE_PAGEID(child, root->volNo, ((btm_InternalEntry*)&apage->data[apage->slot[-(i-1)]])->spid);
+
+            e = edubtm_CollectSeparators(&child, kdesc, startKval, startCompOp, stopKval, stopCompOp,
+                                         depth - 1, stride, seps, nKeys, leafReached);
+            if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+        }
+
+        if (i == apage->hdr.nSlots) break;
+
+        /*@ take the key of slot i */
+        if (afterStart && beforeStop) {
+            if (seps != NULL && *nKeys % stride == 0)
+                memcpy(&seps[*nKeys / stride], &iEntry->klen, sizeof(Two) + iEntry->klen);
+            (*nKeys)++;
+        }
+
+        /* The children right of a key not before the stop hold no key inside the range. */
+        if (!beforeStop) break;
+    }
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_CollectSeparators() */
+
+
+
+/*@================================
+ * edubtm_ScanWorker()
+ *================================*/
+/*
+ * Function: void *edubtm_ScanWorker(void*)
+ *
+ * Description:
+ *  Thread body of a worker of a parallel scan. The first error of the
+ *  workers is kept in the shared state.
+ *
+ * Returns:
+ *  NULL
+ */
+void *edubtm_ScanWorker(
+    void                        *worker)        /* IN the worker (btm_ScanWorker*) */
+{
+    Four                        e;              /* error number */
+    btm_ScanWorker              *w;             /* the worker */
+
+
+    w = (btm_ScanWorker*)worker;
+
+    e = edubtm_ScanMorsels(w->pscan, w->workerNo);
+
+    if (e < eNOERROR) {
+        pthread_mutex_lock(&edubtm_parallelScanMutex);
+        if (w->pscan->error == eNOERROR) w->pscan->error = e;
+        pthread_mutex_unlock(&edubtm_parallelScanMutex);
+    }
+
+    return(NULL);
+
+} /* edubtm_ScanWorker() */
+
+
+
+/*@================================
+ * edubtm_ScanMorsels()
+ *================================*/
+/*
+ * Function: Four edubtm_ScanMorsels(btm_ParallelScan*, Four)
+ *
+ * Description:
+ *  Take the morsels of the parallel scan one by one until none is left or
+ *  a worker has failed, and pass the entries of each to the callback. The
+ *  calls to EduBtM are made while holding the mutex of the parallel scans;
+ *  the callback is called without it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_ScanMorsels(
+    btm_ParallelScan            *pscan,         /* INOUT the parallel scan */
+    Four                        workerNo)       /* IN worker No. */
+{
+    Four                        e;              /* error number */
+    Four                        n;              /* # of entries of a batch */
+    btm_ScanMorsel              *morsel;        /* the morsel being scanned */
+    BtreeScan                   scan;           /* scan of the morsel */
+    BtreeScanItem               items[BTM_SCANBATCHSIZE]; /* a batch of entries */
+
+
+    for ( ; ; ) {
+        /*@ take the next morsel */
+        pthread_mutex_lock(&edubtm_parallelScanMutex);
+        if (pscan->error < eNOERROR || pscan->nextMorsel >= pscan->nMorsels) {
+            pthread_mutex_unlock(&edubtm_parallelScanMutex);
+            return(eNOERROR);
+        }
+        morsel = &pscan->morsels[pscan->nextMorsel++];
+
+        e = EduBtM_OpenScan(&pscan->root, &pscan->kdesc, &morsel->startKval, morsel->startCompOp,
+                            &morsel->stopKval, morsel->stopCompOp, &scan);
+        pthread_mutex_unlock(&edubtm_parallelScanMutex);
+        if (e < eNOERROR) ERR(e);
+
+        /*@ pass the entries of the morsel to the callback */
+        for ( ; ; ) {
+            pthread_mutex_lock(&edubtm_parallelScanMutex);
+            n = (pscan->error < eNOERROR) ? 0 : EduBtM_FetchNextBatch(&scan, BTM_SCANBATCHSIZE, items);
+            pthread_mutex_unlock(&edubtm_parallelScanMutex);
+            if (n <= 0) break;
+
+            n = pscan->callback(pscan->arg, workerNo, n, items);
+            if (n < eNOERROR) break;
+        }
+
+        pthread_mutex_lock(&edubtm_parallelScanMutex);
+        e = EduBtM_CloseScan(&scan);
+        pthread_mutex_unlock(&edubtm_parallelScanMutex);
+
+        if (n < eNOERROR) ERR(n);
+        if (e < eNOERROR) ERR(e);
+    }
+
+} /* edubtm_ScanMorsels() */
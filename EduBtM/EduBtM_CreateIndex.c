@@ -30,11 +30,13 @@
  *
  * Exports:
  *  Four EduBtM_CreateIndex(ObjectID*, PageID*)
+ *  Four EduBtM_CreateIndexWithOptions(ObjectID*, PageID*, Four)
  */
 
 
 #include "EduBtM_common.h"
 #include "EduBtM_Internal.h"
+#include "EduBtM.h"
 #include "OM_Internal.h"
 #include "BfM.h"
 
@@ -63,12 +65,62 @@
 Four EduBtM_CreateIndex(
     ObjectID *catObjForFile,	/* IN catalog object of B+ tree file */
     PageID *rootPid)		/* OUT root page of the newly created B+tree */
+{
+    BTM_LATENCY(BTM_API_CREATEINDEX);
+
+
+    return(EduBtM_CreateIndexWithOptions(catObjForFile, rootPid, 0));
+    
+} /* EduBtM_CreateIndex() */
+
+
+
+/*@================================
+ * EduBtM_CreateIndexWithOptions()
+ *================================*/
+/* 
+ * Function: Four  EduBtM_CreateIndexWithOptions(ObjectID*, PageID*, Four)
+ *
+ * Description : 
+ *  Create the new B+ tree Index with the given page layout options.
+ *  The options are page flags which every page of the B+ tree takes over
+ *  from the root page:
+ *    BTM_KEYHEAD     : the pages keep a key head array below the slot array
+ *    BTM_PAGESIZE_2K : the leaf and internal pages use 2048 bytes
+ *    BTM_PAGESIZE_1K : the leaf and internal pages use 1024 bytes
+ *    BTM_BUFFERED    : the root buffers the insertions in message pages
+ *    BTM_CLUSTERED   : the leaf entries keep the records of their objects
+ *                      (see EduBtM_InsertRecord())
+ *  Without a page size option the pages use all PAGESIZE bytes.
+ *  With the BTM_ART option, which is not a page flag, the index is kept in
+ *  an adaptive radix tree in memory and the root page stays empty; it
+ *  cannot be combined with BTM_CLUSTERED.
+ *
+ * Returns :
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eTOOMANYINDEXES_EDUBTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  The parameter rootPid is filled with the new root page's PageID. 
+ */
+Four EduBtM_CreateIndexWithOptions(
+    ObjectID *catObjForFile,	/* IN catalog object of B+ tree file */
+    PageID *rootPid,		/* OUT root page of the newly created B+tree */
+    Four options)		/* IN page layout options */
 {
     Four e;			/* error number */
     Boolean isTmp;
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
     PhysicalFileID pFid;	/* physical file ID */
+    BtreeLeaf *rootPage;	/* pointer to a buffer holding the root page */
+    BTM_LATENCY(BTM_API_CREATEINDEXWITHOPTIONS);
+
+    if (options & ~(BTM_KEYHEAD | BTM_PAGESIZE_MASK | BTM_BUFFERED | BTM_CLUSTERED | BTM_ART)) ERR(eBADPARAMETER_BTM);
+    if ((options & BTM_CLUSTERED) && (options & BTM_ART)) ERR(eBADPARAMETER_BTM);
+    if (BTM_FLAGS_PAGESIZE(options) < BTM_MIN_PAGESIZE) ERR(eBADPARAMETER_BTM);
 
     e = BfM_GetTrain(catObjForFile, (char**)&catPage, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
@@ -81,10 +133,31 @@ Four EduBtM_CreateIndex(
     //할당받은page를 root page로 초기화함
     e = edubtm_InitLeaf(rootPid, TRUE, FALSE);
     if (e < eNOERROR) ERR(e);
+
+    /* Forget what was known about a dropped index whose root page is reused */
+    edubtm_FreeIndexInfo(rootPid);
+    edubtm_DropArtIndex(rootPid);
+
+    if (options & BTM_ART) {
+        e = edubtm_CreateArtIndex(rootPid);
+        if (e < eNOERROR) ERR(e);
+        options &= ~BTM_ART;
+    }
+
+    /* The kind of the key heads is determined by the first insertion */
+    if (options != 0) {
+        e = BfM_GetTrain(rootPid, (char**)&rootPage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        rootPage->hdr.flags |= options;
+        e = BfM_SetDirty(rootPid, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, rootPid, PAGE_BUF);
+        e = BfM_FreeTrain(rootPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
     
     e = BfM_FreeTrain(catObjForFile, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
 
     return(eNOERROR);
     
-} /* EduBtM_CreateIndex() */
+} /* EduBtM_CreateIndexWithOptions() */
@@ -59,9 +59,17 @@
  *  may be splitted in spite of deleting. In this case, it is used the 'lh'
  *  flag and an internal item as similar to inserting.
  *
+ *  The buffered insertions of the key, if any, are flushed into the tree
+ *  first, from the message buffer of the root and from the write buffer of
+ *  the index, so that the pair is deleted only from the tree. A key which
+ *  the Bloom filter of the index rules out is reported to be not found
+ *  without fixing a page. An index made with the BTM_ART option is changed
+ *  in its adaptive radix tree.
+ *
  * Returns:
  *  error code
  *    eBADPARAMETER_BTM
+ *    eNOTFOUND_BTM
  *    some errors caused by fucntion calls
  */
 Four EduBtM_DeleteObject(
@@ -81,6 +89,12 @@ Four EduBtM_DeleteObject(
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
     PhysicalFileID pFid;        /* B+-tree file's FileID */
+    BtreePage *rootPage;	/* pointer to a buffer holding the root page */
+    btm_IndexInfo *info;	/* information about the index */
+    Boolean mayContain;		/* FALSE if the Bloom filter rules the key out */
+    Four msgPage;		/* first page of the message buffer of the root */
+    btm_ArtIndex *art;		/* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_DELETEOBJECT);
 
 
     /*@ check parameters */
@@ -103,33 +117,87 @@ Four EduBtM_DeleteObject(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
+    /* An index kept in an adaptive radix tree has no pages to change */
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        e = edubtm_ArtDelete(art, kdesc, kval, oid);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    /* Flush the buffered insertions of the key before deleting it */
+    e = edubtm_FlushMessages(root, kval, SM_EQ, kval, SM_EQ);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, kval, SM_EQ, kval, SM_EQ);
+    if (e < eNOERROR) ERR(e);
+
+    /* Bloom filter이 key가 없다고 하면 page를 fix하지 않고 끝냄 */
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info != NULL) {
+        e = edubtm_CheckBloomFilter(root, info, kval, &mayContain);
+        if (e < eNOERROR) ERR(e);
+        if (!mayContain) ERR(eNOTFOUND_BTM);
+    }
 
 	e = BfM_GetTrain(catObjForFile, (char**)&catPage, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
     GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, catEntry);
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    /* Leaves may be merged and freed by the deletion; forget the rightmost leaf hint */
+    if (info != NULL) info->rightmostLeaf.pageNo = NIL;
+    edubtm_RemoveAdaptiveHash(root, kval);
+
     /*edubtm_Delete()를 호출하여 삭제할 object에 대한 <object의key, object ID> pair를 B+ tree 색인에서 삭제함*/
     lf = lh = FALSE;
-    e = edubtm_Delete(catObjForFile, root, kdesc, kval, oid, &lf, &lh, &item, dlPool, dlHead);
-    if (e < eNOERROR) ERR(e);
+    e = edubtm_Delete(catObjForFile, root, kdesc, kval, oid, &lf, &lh, &item, dlPool, dlHead, info);
+    if (e == eNOTFOUND_BTM && info != NULL) edubtm_NoteBloomFalsePositive(info);
+    if (e < eNOERROR) ERRB1(e, catObjForFile, PAGE_BUF);
+
+    if (info != NULL) edubtm_NoteBloomDeletion(info);
 
     /*Root page에서 underflow가 발생한 경우, btm_root_delete()를 호출하여 이를처리함*/
     if (lf == TRUE){
-        e = btm_root_delete(&pFid, root, dlPool, dlHead);
+        /* btm_root_delete() is not aware of the key head layout */
+        e = edubtm_GetTrainForUpdate(root, (char**)&rootPage);
         if (e < eNOERROR) ERR(e);
-        e = BfM_SetDirty(root, PAGE_BUF);
+        if (rootPage->any.hdr.type & INTERNAL) {
+            e = edubtm_DropKeyHeadsAround(root, &rootPage->bi, -1);
+            if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+
+            /* btm_root_delete() copies the only child into the root and frees it */
+            e = edubtm_SaveVersionsAround(root, &rootPage->bi, -1);
+            if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+
+            e = BfM_SetDirty(root, PAGE_BUF);
+            if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+        }
+        msgPage = rootPage->any.hdr.reserved;
+        e = BfM_FreeTrain(root, PAGE_BUF);
         if (e < eNOERROR) ERR(e);
+
+        e = btm_root_delete(&pFid, root, dlPool, dlHead);
+        if (e < eNOERROR) ERRB1(e, catObjForFile, PAGE_BUF);
+
+        /* the root keeps its message buffer */
+        e = edubtm_GetTrainForUpdate(root, (char**)&rootPage);
+        if (e < eNOERROR) ERRB1(e, catObjForFile, PAGE_BUF);
+        if (rootPage->any.hdr.reserved != msgPage) {
+            rootPage->any.hdr.reserved = msgPage;
+            e = BfM_SetDirty(root, PAGE_BUF);
+            if (e < eNOERROR) ERRB2(e, root, PAGE_BUF, catObjForFile, PAGE_BUF);
+        }
+        e = BfM_FreeTrain(root, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, catObjForFile, PAGE_BUF);
     }
     /*Root page에서 split이 발생한 경우, edubtm_root_insert()를 호출하여이를처리함*/
     if (lh == TRUE){
         e = edubtm_root_insert(catObjForFile, root, &item);
-        if (e < eNOERROR) ERR(e);
-        e = BfM_SetDirty(root, PAGE_BUF);
-        if (e < eNOERROR) ERR(e);
+        if (e < eNOERROR) ERRB1(e, catObjForFile, PAGE_BUF);
+        if (info != NULL) info->nRootSplits++;
+    }
 
-    } else 
+    if (info != NULL) info->nDeletes++;
 
-    
     e = BfM_FreeTrain(catObjForFile, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
     return(eNOERROR);
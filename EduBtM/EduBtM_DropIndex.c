@@ -61,11 +61,16 @@ Four EduBtM_DropIndex(
     DeallocListElem *dlHead) /* INOUT head of the dealloc list */
 {
     Four e;			/* for the error number */
+    BTM_LATENCY(BTM_API_DROPINDEX);
 
 
     /*@ Free all pages concerned with the root. */
     e = edubtm_FreePages(pFid, rootPid, dlPool, dlHead);
 	if (e < eNOERROR) ERR(e);
+
+    /* The root page may be reused by another index */
+    edubtm_FreeIndexInfo(rootPid);
+    edubtm_DropArtIndex(rootPid);
 	
     return(eNOERROR);
     
@@ -46,7 +46,7 @@
 
 
 /*@ Internal Function Prototypes */
-Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
+Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, btm_LeafHint*);
 
 
 
@@ -61,6 +61,14 @@ Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCurs
  *  For ODYSSEUS/EduCOSMOS EduBtM, refer to the EduBtM project manual.)
  *
  *  Find the first object satisfying the given condition. See above for detail.
+ *  An equality search of an index with a Bloom filter ends without fixing a
+ *  page when the filter rules the key out. It then looks up the adaptive
+ *  hash index, which gives
+ *  the leaf slot of a key searched often. Otherwise it looks for a recently
+ *  visited leaf whose key range contains the key; if there is one, only
+ *  that leaf is searched. The buffered insertions of the keys in the range
+ *  of a buffered index are flushed into the tree first. An index made with
+ *  the BTM_ART option is searched in its adaptive radix tree.
  *
  * Returns:
  *  error code
@@ -82,6 +90,13 @@ Four EduBtM_Fetch(
 {
     int i;
     Four e;		   /* error number */
+    btm_IndexInfo *info;   /* information about the index */
+    btm_LeafHint *hint;    /* a leaf hint containing the key */
+    btm_LeafHint newHint;  /* the leaf hint made by the search */
+    Boolean found;         /* TRUE if the key is found by the adaptive hash index */
+    Boolean mayContain;    /* FALSE if the Bloom filter rules the key out */
+    btm_ArtIndex *art;     /* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_FETCH);
 
     
     if (root == NULL) ERR(eBADPARAMETER_BTM);
@@ -92,6 +107,21 @@ Four EduBtM_Fetch(
         if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
             ERR(eNOTSUPPORTED_EDUBTM);
     }
+
+    /* adaptive radix tree로 관리되는 index는 tree에서 검색함 */
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        e = edubtm_ArtFetch(art, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    /* 범위에 속하는 buffered insertion을 먼저 tree에 반영함 */
+    e = edubtm_FlushMessages(root, startKval, startCompOp, stopKval, stopCompOp);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, startKval, startCompOp, stopKval, stopCompOp);
+    if (e < eNOERROR) ERR(e);
+
     /*파라미터로주어진startCompOp가 SM_BOF일 경우,
     – B+ tree 색인의 첫 번째object (가장 작은 key 값을 갖는 leaf index entry) 를 검색함. */
     if (startCompOp == SM_BOF){
@@ -105,10 +135,53 @@ Four EduBtM_Fetch(
         if (e < eNOERROR) ERR(e);      
     } 
     
+    /* SM_EQ인 경우, 최근에 방문한 leaf page 중 key가 그 범위에 속하는 page가 있으면
+    해당 page만 검색하고, 없으면 root부터 검색하면서 방문한 leaf page를 기억해 둠 */
+    else if (startCompOp == SM_EQ && (info = edubtm_GetIndexInfo(root, TRUE)) != NULL){
+        /* 자주 검색되는 key는 adaptive hash index에서 leaf slot을 바로 찾음 */
+        found = FALSE;
+        if (stopCompOp == SM_EQ){
+            /* Bloom filter이 key가 없다고 하면 page를 fix하지 않고 검색을 끝냄 */
+            e = edubtm_CheckBloomFilter(root, info, startKval, &mayContain);
+            if (e < eNOERROR) ERR(e);
+            if (!mayContain){
+                cursor->flag = CURSOR_EOS;
+                return(eNOERROR);
+            }
+
+            e = edubtm_LookUpAdaptiveHash(root, info, kdesc, startKval, cursor, &found);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        if (!found){
+            hint = edubtm_LookUpLeafHint(info, kdesc, startKval);
+            if (hint != NULL){
+                e = edubtm_Fetch(&hint->leaf, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor, NULL);
+                if (e < eNOERROR) ERR(e);
+            }
+            else{
+                newHint.hasLow = newHint.hasHigh = FALSE;
+                newHint.leaf = *root;
+                e = edubtm_Fetch(root, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor, &newHint);
+                if (e < eNOERROR) ERR(e);
+
+                /* root page가 leaf page이면 기억할 필요가 없음 */
+                if (newHint.leaf.pageNo != root->pageNo) edubtm_AddLeafHint(info, &newHint);
+            }
+
+            /* 찾은 key는 검색 횟수를 세어 adaptive hash index에 넣음 */
+            if (stopCompOp == SM_EQ && cursor->flag == CURSOR_ON)
+                edubtm_NoteAdaptiveHash(root, info, cursor);
+
+            /* Bloom filter이 걸러내지 못한 없는 key를 셈 */
+            if (stopCompOp == SM_EQ && cursor->flag == CURSOR_EOS)
+                edubtm_NoteBloomFalsePositive(info);
+        }
+    }
     /* 이외의경우, edubtm_Fetch()를 호출하여 B+ tree 색인에서 검색 조건을 만족하는 첫번째
     <object의 key, object ID> pair가 저장된 leaf index entry를 검색함 */
     else{
-        e = edubtm_Fetch(root, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor);
+        e = edubtm_Fetch(root, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor, NULL);
         if (e < eNOERROR) ERR(e);
     }
 
@@ -122,7 +195,8 @@ Four EduBtM_Fetch(
  * edubtm_Fetch()
  *================================*/
 /*
- * Function: Four edubtm_Fetch(PageID*, KeyDesc*, KeyVlaue*, Four, KeyValue*, Four, BtreeCursor*)
+ * Function: Four edubtm_Fetch(PageID*, KeyDesc*, KeyVlaue*, Four, KeyValue*, Four, BtreeCursor*,
+ *                          btm_LeafHint*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -131,6 +205,8 @@ Four EduBtM_Fetch(
  *  Find the first object satisfying the given condition.
  *  This function handles only the following conditions:
  *  SM_EQ, SM_LT, SM_LE, SM_GT, SM_GE.
+ *  If 'hint' is given, the leaf page reached and the range of keys the
+ *  visited internal entries direct to it are returned through it.
  *
  * Returns:
  *  Error code *   
@@ -145,7 +221,8 @@ Four edubtm_Fetch(
     Four                startCompOp,    /* IN comparison operator of start condition */
     KeyValue            *stopKval,      /* IN key value of stop condition */
     Four                stopCompOp,     /* IN comparison operator of stop condition */
-    BtreeCursor         *cursor)        /* OUT Btree Cursor */
+    BtreeCursor         *cursor,        /* OUT Btree Cursor */
+    btm_LeafHint        *hint)          /* INOUT leaf reached and its key range; NULL if not needed */
 {
     Four                e;              /* error number */
     Four                cmp;            /* result of comparison */
@@ -161,6 +238,7 @@ Four edubtm_Fetch(
     PageNo              ovPageNo;       /* PageNo of the overflow page */
     PageID              prevPid;        /* PageID of the previous page */
     PageID              nextPid;        /* PageID of the next page */
+    ShortPageID         sibling;        /* sibling of an empty leaf page */
     ObjectID            *oidArray;      /* array of the ObjectIDs */
     Two                 iEntryOffset;   /* starting offset of an internal entry */
     btm_InternalEntry   *iEntry;        /* an internal entry */
@@ -178,7 +256,7 @@ Four edubtm_Fetch(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
-    e = BfM_GetTrain(root, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetSnapshotTrain(root, (char**)&apage);
     if (e < eNOERROR) ERR(e);
 
     if (apage->any.hdr.type & INTERNAL) {
@@ -192,15 +270,29 @@ Four edubtm_Fetch(
             MAKE_PAGEID(child, root->volNo, apage->bi.hdr.p0);
         }
 
-        e = edubtm_Fetch(&child, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor);
-        if (e < eNOERROR) ERR(e);
-        
+        /* The entries around the child bound the keys in its subtree */
+        if (hint != NULL) {
+            if (idx >= 0) {
+                hint->hasLow = TRUE;
+                memcpy(&hint->low, &iEntry->klen, sizeof(Two) + iEntry->klen);
+            }
+            if (idx + 1 < apage->bi.hdr.nSlots) {
+                iEntry = (btm_InternalEntry*)&apage->bi.data[apage->bi.slot[-(idx+1)]];
+                hint->hasHigh = TRUE;
+                memcpy(&hint->high, &iEntry->klen, sizeof(Two) + iEntry->klen);
+            }
+        }
+
+        e = edubtm_Fetch(&child, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor, hint);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+
         e = BfM_FreeTrain(root, PAGE_BUF);
         if (e < eNOERROR) ERR(e);
     }
     else if (apage->any.hdr.type & LEAF) {
         found = edubtm_BinarySearchLeaf(apage, kdesc, startKval, &idx);
         leafPid = root;
+        if (hint != NULL) hint->leaf = *root;
         cursor->flag = (One)CURSOR_ON;
         switch (startCompOp){
         case SM_EQ:
@@ -254,9 +346,24 @@ Four edubtm_Fetch(
         e = BfM_FreeTrain(root, PAGE_BUF);
         if (e < 0) ERR(e);
 
-        e = BfM_GetTrain(leafPid, (char**)&apage, PAGE_BUF);
+        e = edubtm_GetSnapshotTrain(leafPid, (char**)&apage);
         if (e < 0) ERR(e);
 
+        /* A leaf may be left empty when it cannot be merged, so pass over it to its sibling */
+        while (cursor->flag != CURSOR_EOS && apage->bl.hdr.nSlots == 0){
+            sibling = (slotNo < 0) ? apage->bl.hdr.prevPage : apage->bl.hdr.nextPage;
+            if (sibling == NIL){
+                cursor->flag = (One)CURSOR_EOS;
+            } else{
+                e = BfM_FreeTrain(leafPid, PAGE_BUF);
+                if (e < 0) ERR(e);
+                MAKE_PAGEID(nextPid, root->volNo, sibling);
+                leafPid = &nextPid;
+                e = edubtm_GetSnapshotTrain(leafPid, (char**)&apage);
+                if (e < 0) ERR(e);
+            }
+        }
+
         if (cursor->flag != CURSOR_EOS){ // determine EOS or not
             
             if (slotNo < 0){
@@ -268,10 +375,12 @@ Four edubtm_Fetch(
 
             lEntryOffset = apage->bl.slot[-slotNo];
             lEntry = (btm_LeafEntry*)&apage->bl.data[lEntryOffset];
-			alignedKlen = ALIGNED_LENGTH(lEntry->klen);
             memcpy(&cursor->key, &lEntry->klen, sizeof(KeyValue));
-            // memcpy(&cursor->oid, &lEntry->kval + alignedKlen, sizeof(ObjectID));
-            cursor->oid = *(ObjectID*)&lEntry->kval[alignedKlen];
+
+            // 작은 key 쪽으로 검색하는 경우 (SM_LT, SM_LE) 에는 key의 마지막 object ID를 가리킴
+            e = edubtm_FirstObjectId(leafPid->volNo, lEntry, (startCompOp == SM_LT || startCompOp == SM_LE),
+                                     &cursor->overflow, &cursor->oidArrayElemNo, &cursor->oid);
+            if (e < eNOERROR) ERRB1(e, leafPid, PAGE_BUF);
             
             invalidCondition = FALSE;
             cmp = edubtm_KeyCompare(kdesc, &cursor->key, stopKval);
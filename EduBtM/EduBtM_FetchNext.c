@@ -60,6 +60,7 @@ Four edubtm_FetchNext(KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
  * By the B+ tree structure modification resulted from the splitting or merging
  * the current cursor may point to the invalid position. So we should adjust
  * the B+ tree cursor before using the cursor.
+ * An index made with the BTM_ART option is scanned in its adaptive radix tree.
  *
  * Returns:
  *  error code
@@ -88,6 +89,8 @@ Four EduBtM_FetchNext(
     BtreeOverflow               *opage;         /* pointer to a buffer holding an overflow page */
     btm_LeafEntry               *entry;         /* pointer to a leaf entry */
     BtreeCursor                 tCursor;        /* a temporary Btree cursor */
+    btm_ArtIndex                *art;           /* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_FETCHNEXT);
   
     
     /*@ check parameter */
@@ -107,6 +110,12 @@ Four EduBtM_FetchNext(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        e = edubtm_ArtFetchNext(art, kdesc, kval, compOp, current, next);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
     e = edubtm_FetchNext(kdesc, kval, compOp, current, next);
     if (e < 0) ERR(e);
     
@@ -152,6 +161,8 @@ Four edubtm_FetchNext(
     BtreeOverflow 	*opage;		/* pointer to a buffer holding an overflow page */
     Two             lEntryOffset;   /* starting offset of a leaf entry */
     btm_LeafEntry 	*entry;		/* pointer to a leaf entry */    
+    Boolean 		backward;	/* TRUE if the scan goes to smaller keys */
+    Boolean 		found;		/* TRUE if the key has the next ObjectID */
     
     
     /* Error check whether using not supported functionality by EduBtM */
@@ -163,38 +174,57 @@ Four edubtm_FetchNext(
     }
 
     leaf = current->leaf;
-    next->flag = CURSOR_ON;
     overflow = current->leaf;
-    e = BfM_GetTrain(&leaf, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetSnapshotTrain(&leaf, (char**)&apage);
     if (e < eNOERROR) ERR(e);
 
-    if (compOp == SM_GT || compOp == SM_GE || compOp == SM_BOF){
+    backward = (compOp == SM_GT || compOp == SM_GE || compOp == SM_BOF) ? TRUE : FALSE;
+
+    // 같은 key의 다음 object ID가 있으면 key를 비교하지 않고 그 object ID를 가리킴
+    if (next != current) *next = *current;
+    next->flag = CURSOR_ON;
+    entry = (btm_LeafEntry*)&apage->data[apage->slot[-(current->slotNo)]];
+    e = edubtm_NextObjectId(leaf.volNo, entry, backward, &next->overflow, &next->oidArrayElemNo, &next->oid, &found);
+    if (e < eNOERROR) ERRB1(e, &leaf, PAGE_BUF);
+
+    if (found){
+        e = BfM_FreeTrain(&leaf, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    if (backward){
         next->slotNo = current->slotNo - 1;
     } else {
         next->slotNo = current->slotNo + 1;
     }
 
-    if (next->slotNo < 0){
-        if (apage->hdr.prevPage == NIL){
-            next->flag = CURSOR_EOS;
-        } else{
-            e = BfM_FreeTrain(&leaf, PAGE_BUF);
-            if (e < eNOERROR) ERR(e);
-            MAKE_PAGEID(overflow, leaf.volNo, apage->hdr.prevPage);
-            e = BfM_GetTrain(&overflow, (char**)&apage, PAGE_BUF);
-            if (e < eNOERROR) ERR(e);
-            next->slotNo = apage->hdr.nSlots - 1;
-        }
-    } else if(next->slotNo >= apage->hdr.nSlots){
-        if (apage->hdr.nextPage == NIL){
-            next->flag = CURSOR_EOS;
+    /* A leaf may be left empty when it cannot be merged, so keep moving until an entry is found */
+    while (next->flag == CURSOR_ON && (next->slotNo < 0 || next->slotNo >= apage->hdr.nSlots)){
+        if (next->slotNo < 0){
+            if (apage->hdr.prevPage == NIL){
+                next->flag = CURSOR_EOS;
+            } else{
+                e = BfM_FreeTrain(&overflow, PAGE_BUF);
+                if (e < eNOERROR) ERR(e);
+                leaf = overflow;
+                MAKE_PAGEID(overflow, leaf.volNo, apage->hdr.prevPage);
+                e = edubtm_GetSnapshotTrain(&overflow, (char**)&apage);
+                if (e < eNOERROR) ERR(e);
+                next->slotNo = apage->hdr.nSlots - 1;
+            }
         } else{
-            e = BfM_FreeTrain(&leaf, PAGE_BUF);
-            if (e < eNOERROR) ERR(e);
-            MAKE_PAGEID(overflow, leaf.volNo, apage->hdr.nextPage);
-            e = BfM_GetTrain(&overflow, (char**)&apage, PAGE_BUF);
-            if (e < eNOERROR) ERR(e);
-            next->slotNo = 0;
+            if (apage->hdr.nextPage == NIL){
+                next->flag = CURSOR_EOS;
+            } else{
+                e = BfM_FreeTrain(&overflow, PAGE_BUF);
+                if (e < eNOERROR) ERR(e);
+                leaf = overflow;
+                MAKE_PAGEID(overflow, leaf.volNo, apage->hdr.nextPage);
+                e = edubtm_GetSnapshotTrain(&overflow, (char**)&apage);
+                if (e < eNOERROR) ERR(e);
+                next->slotNo = 0;
+            }
         }
     }
 
@@ -203,9 +233,9 @@ Four edubtm_FetchNext(
     if (next->flag == CURSOR_ON){
         lEntryOffset = apage->slot[-(next->slotNo)];
         entry = (btm_LeafEntry*)&apage->data[lEntryOffset];
-        alignedKlen = ALIGNED_LENGTH(entry->klen);
-        next->oid = *(ObjectID*)&entry->kval[alignedKlen];
         memcpy(&next->key, &entry->klen, sizeof(KeyValue));
+        e = edubtm_FirstObjectId(leaf.volNo, entry, backward, &next->overflow, &next->oidArrayElemNo, &next->oid);
+        if (e < eNOERROR) ERRB1(e, &overflow, PAGE_BUF);
 
         next->leaf = overflow;
         cmp = edubtm_KeyCompare(kdesc, &next->key, kval);
@@ -0,0 +1,150 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_FetchRecord.c
+ *
+ * Description:
+ *  Find the first or the next ObjectID satisfying the given condition as
+ *  EduBtM_Fetch() and EduBtM_FetchNext() do, and return the record kept
+ *  with it in a clustered index.
+ *
+ * Exports:
+ *  Four EduBtM_FetchRecord(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, BtreeRecord*)
+ *  Four EduBtM_FetchNextRecord(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*, BtreeRecord*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+
+
+
+/*@================================
+ * EduBtM_FetchRecord()
+ *================================*/
+/*
+ * Function: Four EduBtM_FetchRecord(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, BtreeRecord*)
+ *
+ * Description:
+ *  Find the first object satisfying the given condition by EduBtM_Fetch().
+ *  If the object is found in a clustered index (see BTM_CLUSTERED) and its
+ *  leaf entry keeps its record, the record is copied from the leaf, which
+ *  is still in the buffer after the search; the object itself is not read.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  cursor  : The found ObjectID and its position in the Btree Leaf
+ *  record  : The record of the found ObjectID; 'len' is NIL if the index
+ *            does not keep it
+ */
+Four EduBtM_FetchRecord(
+    PageID   *root,		/* IN The current root of the subtree */
+    KeyDesc  *kdesc,		/* IN Btree key descriptor */
+    KeyValue *startKval,	/* IN key value of start condition */
+    Four     startCompOp,	/* IN comparison operator of start condition */
+    KeyValue *stopKval,		/* IN key value of stop condition */
+    Four     stopCompOp,	/* IN comparison operator of stop condition */
+    BtreeCursor *cursor,	/* OUT Btree Cursor */
+    BtreeRecord *record)	/* OUT record of the found ObjectID */
+{
+    Four e;			/* error number */
+    BTM_LATENCY(BTM_API_FETCHRECORD);
+
+
+    if (root == NULL || cursor == NULL || record == NULL) ERR(eBADPARAMETER_BTM);
+
+    record->len = NIL;
+
+    e = EduBtM_Fetch(root, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor);
+    if (e < eNOERROR) ERR(e);
+
+    /* adaptive radix tree로 관리되는 index의 cursor는 leaf를 가리키지 않음 */
+    if (cursor->flag == CURSOR_ON && edubtm_GetArtIndex(root) == NULL) {
+        e = edubtm_GetInlineRecord(cursor, record);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}   /* EduBtM_FetchRecord() */
+
+
+
+/*@================================
+ * EduBtM_FetchNextRecord()
+ *================================*/
+/*
+ * Function: Four EduBtM_FetchNextRecord(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*, BtreeRecord*)
+ *
+ * Description:
+ *  Fetch the next ObjectID satisfying the given condition by
+ *  EduBtM_FetchNext(), and its record as EduBtM_FetchRecord() does.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eBADCURSOR
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  next    : The next ObjectID and its position in the Btree Leaf
+ *  record  : The record of the next ObjectID; 'len' is NIL if the index
+ *            does not keep it
+ */
+Four EduBtM_FetchNextRecord(
+    PageID      *root,		/* IN root page's PageID */
+    KeyDesc     *kdesc,		/* IN key descriptor */
+    KeyValue    *kval,		/* IN key value of stop condition */
+    Four        compOp,		/* IN comparison operator of stop condition */
+    BtreeCursor *current,	/* IN current B+ tree cursor */
+    BtreeCursor *next,		/* OUT next B+ tree cursor */
+    BtreeRecord *record)	/* OUT record of the next ObjectID */
+{
+    Four e;			/* error number */
+    BTM_LATENCY(BTM_API_FETCHNEXTRECORD);
+
+
+    if (root == NULL || current == NULL || next == NULL || record == NULL) ERR(eBADPARAMETER_BTM);
+
+    record->len = NIL;
+
+    e = EduBtM_FetchNext(root, kdesc, kval, compOp, current, next);
+    if (e < eNOERROR) ERR(e);
+
+    /* EduBtM_FetchNext() leaves 'next' as it is at the end of the scan */
+    if (current->flag == CURSOR_ON && next->flag == CURSOR_ON && edubtm_GetArtIndex(root) == NULL) {
+        e = edubtm_GetInlineRecord(next, record);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}   /* EduBtM_FetchNextRecord() */
@@ -0,0 +1,72 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_FlushWriteBuffer.c
+ *
+ * Description :
+ *  Merge the write buffer of a Btree index into the tree.
+ *
+ * Exports:
+ *  Four EduBtM_FlushWriteBuffer(PageID*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * EduBtM_FlushWriteBuffer()
+ *================================*/
+/*
+ * Function: Four EduBtM_FlushWriteBuffer(PageID*)
+ *
+ * Description:
+ *  Merge all the insertions kept in the write buffer of the index given by
+ *  'root' into the tree, e.g. before the end of the transaction. Nothing is
+ *  done for an index without a write buffer.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_FlushWriteBuffer(
+    PageID              *root)          /* IN root page of the index */
+{
+    Four                e;              /* error number */
+    BTM_LATENCY(BTM_API_FLUSHWRITEBUFFER);
+
+
+    /*@ check parameters */
+    if (root == NULL) ERR(eBADPARAMETER_BTM);
+
+    e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* EduBtM_FlushWriteBuffer() */
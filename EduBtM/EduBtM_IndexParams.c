@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_IndexParams.c
+ *
+ * Description :
+ *  Set and get the run-time parameters of a Btree index. The parameters
+ *  are kept in memory with the other information about the index and are
+ *  not stored in the pages.
+ *
+ * Exports:
+ *  Four EduBtM_SetIndexParams(PageID*, BtreeIndexParams*)
+ *  Four EduBtM_GetIndexParams(PageID*, BtreeIndexParams*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * EduBtM_SetIndexParams()
+ *================================*/
+/*
+ * Function: Four EduBtM_SetIndexParams(PageID*, BtreeIndexParams*)
+ *
+ * Description:
+ *  Set the run-time parameters of the index given by 'root':
+ *    appendSplitRatio : fill (%) of the page being split when a key is
+ *                       appended to its end during ascending insertion;
+ *                       between 50 (split at half) and 100 (move only the
+ *                       new key to the new page)
+ *    underflowRatio   : fill (%) at or below which a page underflows after
+ *                       a deletion and is merged or redistributed; between
+ *                       0 (only an empty page) and 50 (not half full)
+ *    bloomBitsPerKey  : bits per key of the Bloom filter of the keys, up to
+ *                       BTM_MAXBLOOMBITSPERKEY; 0 if the index has no filter.
+ *                       The filter is built from the leaves when it is
+ *                       first used after it is set
+ *    writeBufferKB    : memory (KB) for the insertions kept in the write
+ *                       buffer of the index before they are merged into the
+ *                       tree, up to BTM_MAXWRITEBUFFERKB; 0 if the index has
+ *                       no write buffer. The buffered insertions which do
+ *                       not fit into the new size are merged at once
+ *    inlineRecordMax  : max length of a record kept in its leaf entry by a
+ *                       clustered index, up to BTM_MAXINLINERECORD; 0 if
+ *                       only empty records are kept. It applies to the
+ *                       records inserted afterwards
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eTOOMANYINDEXES_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_SetIndexParams(
+    PageID              *root,          /* IN root page of the index */
+    BtreeIndexParams    *params)        /* IN parameters to set */
+{
+    Four                e;              /* error number */
+    btm_IndexInfo       *info;          /* information about the index */
+    BTM_LATENCY(BTM_API_SETINDEXPARAMS);
+
+
+    /*@ check parameters */
+    if (root == NULL || params == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (params->appendSplitRatio < 50 || params->appendSplitRatio > 100) ERR(eBADPARAMETER_BTM);
+
+    if (params->underflowRatio < 0 || params->underflowRatio > 50) ERR(eBADPARAMETER_BTM);
+
+    if (params->bloomBitsPerKey < 0 || params->bloomBitsPerKey > BTM_MAXBLOOMBITSPERKEY) ERR(eBADPARAMETER_BTM);
+
+    if (params->writeBufferKB < 0 || params->writeBufferKB > BTM_MAXWRITEBUFFERKB) ERR(eBADPARAMETER_BTM);
+
+    if (params->inlineRecordMax < 0 || params->inlineRecordMax > BTM_MAXINLINERECORD) ERR(eBADPARAMETER_BTM);
+
+    info = edubtm_GetIndexInfo(root, TRUE);
+    if (info == NULL) ERR(eTOOMANYINDEXES_EDUBTM);
+
+    if (info->writeBuffer.nBytes > params->writeBufferKB * 1024) {
+        e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    if (params->bloomBitsPerKey != info->params.bloomBitsPerKey) edubtm_FreeBloomFilter(info);
+
+    info->params = *params;
+
+    return(eNOERROR);
+
+}   /* EduBtM_SetIndexParams() */
+
+
+
+/*@================================
+ * EduBtM_GetIndexParams()
+ *================================*/
+/*
+ * Function: Four EduBtM_GetIndexParams(PageID*, BtreeIndexParams*)
+ *
+ * Description:
+ *  Get the run-time parameters of the index given by 'root'. An index whose
+ *  parameters were never set has the default parameters.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ */
+Four EduBtM_GetIndexParams(
+    PageID              *root,          /* IN root page of the index */
+    BtreeIndexParams    *params)        /* OUT parameters of the index */
+{
+    btm_IndexInfo       *info;          /* information about the index */
+    BTM_LATENCY(BTM_API_GETINDEXPARAMS);
+
+
+    /*@ check parameters */
+    if (root == NULL || params == NULL) ERR(eBADPARAMETER_BTM);
+
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info != NULL)
+        *params = info->params;
+    else
+        SET_DEFAULT_INDEXPARAMS(*params);
+
+    return(eNOERROR);
+
+}   /* EduBtM_GetIndexParams() */
@@ -54,6 +54,17 @@
  *  If an overflow page is created as the result of the insert, it may occur
  *  merging or redistibuting two leaves and this may affect the root.
  *
+ *  The insertion into an index with a write buffer is kept in the buffer,
+ *  to be merged into the tree later. Otherwise, when the key belongs to the
+ *  rightmost leaf remembered from a previous insertion and the leaf has
+ *  room, the ObjectID is put into the leaf directly without descending the
+ *  tree. Otherwise the insertion into a buffered index (see BTM_BUFFERED)
+ *  is appended to the message buffer of the root, to be flushed into the
+ *  tree later; the rightmost leaf of a buffered index is not used, and the
+ *  buffer is flushed before an insertion into a root that is a leaf. The key is entered into the Bloom filter of the index, if
+ *  any. An index made with the BTM_ART option is kept in its adaptive radix
+ *  tree instead.
+ *
  * Returns:
  *  error code
  *    eBADPARAMETER_BTM
@@ -76,6 +87,10 @@ Four EduBtM_InsertObject(
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
     PhysicalFileID pFid;	 /* B+-tree file's FileID */
+    btm_IndexInfo *info;	/* information about the index */
+    Boolean done;		/* TRUE if inserted into the rightmost leaf directly */
+    btm_ArtIndex *art;		/* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_INSERTOBJECT);
 
     
     /*@ check parameters */
@@ -96,18 +111,60 @@ Four EduBtM_InsertObject(
         if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
             ERR(eNOTSUPPORTED_EDUBTM);
     }
+
+    /* An index kept in an adaptive radix tree has no pages to change */
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        e = edubtm_ArtInsert(art, kdesc, kval, oid);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
     
+    /* Append to the rightmost leaf without descending the tree if possible */
+    info = edubtm_GetIndexInfo(root, TRUE);
+    if (info != NULL) {
+        edubtm_NoteInsertion(info, kdesc, kval);
+
+        /* Keep the insertion in memory if the index has a write buffer */
+        e = edubtm_BufferWrite(catObjForFile, info, kdesc, kval, oid, &done);
+        if (e < eNOERROR) ERR(e);
+
+        /* after the write buffer has looked the key up in the filter */
+        edubtm_AddBloomKey(info, kval);
+        if (done) {
+            info->nInserts++;
+            return(eNOERROR);
+        }
+
+        e = edubtm_InsertRightmostLeaf(catObjForFile, info, kdesc, kval, oid, NULL, &done);
+        if (e < eNOERROR) ERR(e);
+        if (done) {
+            info->nInserts++;
+            return(eNOERROR);
+        }
+    }
+
+    /* Buffer the insertion at the root if the index is buffered */
+    e = edubtm_BufferMessage(catObjForFile, root, kdesc, kval, oid, &done);
+    if (e < eNOERROR) ERR(e);
+    if (done) {
+        if (info != NULL) info->nInserts++;
+        return(eNOERROR);
+    }
+
     /*edubtm_Insert()를 호출하여 새로운 object에 대한 <object의 key, object ID> pair를 
     B+ tree 색인에 삽입*/
     lf = lh = FALSE;
-    e = edubtm_Insert(catObjForFile, root, kdesc, kval, oid, &lf, &lh, &item, dlPool, dlHead);
+    e = edubtm_Insert(catObjForFile, root, kdesc, kval, oid, NULL, &lf, &lh, &item, dlPool, dlHead, info);
     if (e < eNOERROR) ERR(e);
     /*  Root page에서 split이 발생하여 새로운 root page 생성이필요한경우, 
     edubtm_root_insert()를 호출하여 이를처리함*/
     if (lh == TRUE){
         e = edubtm_root_insert(catObjForFile, root, &item);
         if (e < eNOERROR) ERR(e);
+        if (info != NULL) info->nRootSplits++;
     }
+
+    if (info != NULL) info->nInserts++;
     
     return(eNOERROR);
     
@@ -0,0 +1,281 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_InsertObjects.c
+ *
+ * Description :
+ *  Insert a batch of <key, ObjectID> pairs into a Btree. The batch is sorted
+ *  by key and inserted with a single descent of the tree, so that each page
+ *  is fixed once for all the keys falling into it.
+ *
+ * Exports:
+ *  Four EduBtM_InsertObjects(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*,
+ *                            Four*, Pool*, DeallocListElem*)
+ *  Four edubtm_InsertSortedBatch(ObjectID*, PageID*, btm_InsertBatch*, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+#include "OM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_CompareBatchOrder(void*, void*, void*);
+
+
+
+/*@================================
+ * EduBtM_InsertObjects()
+ *================================*/
+/*
+ * Function: Four EduBtM_InsertObjects(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*,
+ *                                     ObjectID*, Four*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Insert the pairs <kvals[i], oids[i]> (0 <= i < nObjects) into a Btree.
+ *  The pairs need not be sorted. They are inserted with one descent of the
+ *  tree by edubtm_InsertGroup(), and a page that overflows is split once
+ *  for all its new keys. If the root is split, new roots are made by
+ *  edubtm_root_insert() until the items of the split fit into the root.
+ *
+ *  A key which is already in the index, or which appears more than once in
+ *  the batch, is inserted only once; 'nInserted' returns the number of
+ *  pairs actually inserted.
+ *
+ *  If the keys of the index are not unique, the pairs are inserted one by
+ *  one by EduBtM_InsertObject(), which adds the ObjectID of a key already
+ *  in the index to its entry; only a pair already in the index is skipped,
+ *  or, in a clustered index (see BTM_CLUSTERED), a key already in it.
+ *  The pairs of an index made with the BTM_ART option are inserted one by
+ *  one too, skipping a key already in a unique index.
+ *  The message buffer and the write buffer of a unique index are merged
+ *  into the tree first.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_InsertObjects(
+    ObjectID                    *catObjForFile,         /* IN catalog object of B+ tree file */
+    PageID                      *root,                  /* IN the root of Btree */
+    KeyDesc                     *kdesc,                 /* IN key descriptor */
+    Four                        nObjects,               /* IN # of pairs to insert */
+    KeyValue                    *kvals,                 /* IN key values */
+    ObjectID                    *oids,                  /* IN ObjectIDs which will be inserted */
+    Four                        *nInserted,             /* OUT # of pairs inserted */
+    Pool                        *dlPool,                /* INOUT pool of dealloc list */
+    DeallocListElem             *dlHead)                /* INOUT head of the dealloc list */
+{
+    Four                        e;                      /* error number */
+    Four                        i;
+    btm_InsertBatch             batch;                  /* the batch to insert */
+    Four                        *tmp;                   /* work area of the sort */
+    btm_IndexInfo               *info;                  /* information about the index */
+    BTM_LATENCY(BTM_API_INSERTOBJECTS);
+
+
+    /*@ check parameters */
+    if (catObjForFile == NULL || root == NULL || kdesc == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (nObjects < 0 || (nObjects > 0 && (kvals == NULL || oids == NULL))) ERR(eBADPARAMETER_BTM);
+
+    /* Error check whether using not supported functionality by EduBtM */
+    for(i=0; i<kdesc->nparts; i++)
+    {
+        if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
+            ERR(eNOTSUPPORTED_EDUBTM);
+    }
+
+    if (nInserted != NULL) *nInserted = 0;
+    if (nObjects == 0) return(eNOERROR);
+
+    /*@ insert the pairs one by one into a non-unique index or an adaptive radix tree */
+    if (!(kdesc->flag & KEYFLAG_UNIQUE) || edubtm_GetArtIndex(root) != NULL) {
+        for (i = 0; i < nObjects; i++) {
+            e = EduBtM_InsertObject(catObjForFile, root, kdesc, &kvals[i], &oids[i], dlPool, dlHead);
+            if (e == eDUPLICATEDOBJECTID_BTM || e == eDUPLICATEDKEY_BTM) continue;
+            if (e < eNOERROR) ERR(e);
+
+            if (nInserted != NULL) (*nInserted)++;
+        }
+
+        return(eNOERROR);
+    }
+
+    /* the keys of the buffers are in the index already */
+    e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ sort the batch */
+    batch.kdesc = kdesc;
+    batch.kvals = kvals;
+    batch.oids = oids;
+    batch.nInserted = 0;
+    batch.order = (Four*)malloc(2 * nObjects * sizeof(Four));
+    if (batch.order == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+    tmp = &batch.order[nObjects];
+
+    for (i = 0; i < nObjects; i++) batch.order[i] = i;
+
+    edubtm_MergeSort(batch.order, tmp, nObjects, sizeof(Four), edubtm_CompareBatchOrder, &batch);
+
+    /*@ insert the batch with one descent */
+    info = edubtm_GetIndexInfo(root, TRUE);
+    if (info != NULL)
+        for (i = 0; i < nObjects; i++) edubtm_AddBloomKey(info, &kvals[i]);
+
+    e = edubtm_InsertSortedBatch(catObjForFile, root, &batch, nObjects);
+    free(batch.order);
+    if (e < eNOERROR) ERR(e);
+
+    if (nInserted != NULL) *nInserted = batch.nInserted;
+    if (info != NULL) info->nInserts += batch.nInserted;
+
+    return(eNOERROR);
+
+}   /* EduBtM_InsertObjects() */
+
+
+
+/*@================================
+ * edubtm_InsertSortedBatch()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertSortedBatch(ObjectID*, PageID*, btm_InsertBatch*, Four)
+ *
+ * Description:
+ *  Insert the first 'nPairs' pairs of a batch whose 'order' is sorted by
+ *  key into a unique index with one descent of the tree. If the root is
+ *  split, new roots are made by edubtm_root_insert() until the items of the
+ *  split fit into the root. 'batch->nInserted' is increased by the number
+ *  of pairs actually inserted; the counters of insertions of the index are
+ *  left to the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_InsertSortedBatch(
+    ObjectID                    *catObjForFile,         /* IN catalog object of B+ tree file */
+    PageID                      *root,                  /* IN the root of Btree */
+    btm_InsertBatch             *batch,                 /* INOUT the batch to insert */
+    Four                        nPairs)                 /* IN # of pairs to insert */
+{
+    Four                        e;                      /* error number */
+    btm_InternalItemList        ritems;                 /* Internal Items returned by the root */
+    btm_InternalItemList        others;                 /* Internal Items after the first one */
+    btm_InternalItemList        rest;                   /* Internal Items returned by the new root */
+    BtreePage                   *rootPage;              /* pointer to a buffer holding the root page */
+    btm_IndexInfo               *info;                  /* information about the index */
+
+
+    /* The pages may be split; the leaf hints of the index are no longer valid */
+    info = edubtm_GetIndexInfo(root, TRUE);
+    if (info != NULL) info->smoCount++;
+
+    ritems.nItems = ritems.maxItems = 0;
+    ritems.items = NULL;
+
+    e = edubtm_InsertGroup(catObjForFile, root, batch, 0, nPairs, &ritems, info);
+
+    /*@ grow the tree while the root is split */
+    while (e >= eNOERROR && ritems.nItems > 0) {
+
+        /* The first item becomes the unique entry of the new root. */
+        e = edubtm_root_insert(catObjForFile, root, &ritems.items[0]);
+        if (e >= eNOERROR && info != NULL) info->nRootSplits++;
+        if (e < eNOERROR || ritems.nItems == 1) break;
+
+        /* The other items are inserted into the new root, which may be split again. */
+        rest.nItems = rest.maxItems = 0;
+        rest.items = NULL;
+
+        e = edubtm_GetTrainForUpdate(root, (char**)&rootPage);
+        if (e < eNOERROR) break;
+
+        others.nItems = ritems.nItems - 1;
+        others.maxItems = 0;
+        others.items = &ritems.items[1];
+
+        e = edubtm_InsertInternalGroup(catObjForFile, root, &rootPage->bi, batch->kdesc, &others, &rest, info);
+        free(ritems.items);
+        ritems = rest;
+        if (e < eNOERROR) {
+            (Four) BfM_FreeTrain(root, PAGE_BUF);
+            break;
+        }
+
+        e = BfM_SetDirty(root, PAGE_BUF);
+        if (e < eNOERROR) {
+            (Four) BfM_FreeTrain(root, PAGE_BUF);
+            break;
+        }
+
+        e = BfM_FreeTrain(root, PAGE_BUF);
+    }
+
+    free(ritems.items);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_InsertSortedBatch() */
+
+
+
+/*@================================
+ * edubtm_CompareBatchOrder()
+ *================================*/
+/*
+ * Function: Four edubtm_CompareBatchOrder(void*, void*, void*)
+ *
+ * Description:
+ *  edubtm_MergeSort() comparison function for the indexes of a batch given
+ *  as 'context'. The sort is stable, so pairs with equal keys keep their
+ *  order in the batch and the first of them is the one inserted.
+ *
+ * Returns:
+ *  EQUAL, GREATER, or LESS
+ */
+Four edubtm_CompareBatchOrder(
+    void                        *context,       /* IN the batch being sorted */
+    void                        *a,             /* IN index of the first pair */
+    void                        *b)             /* IN index of the second pair */
+{
+    btm_InsertBatch             *batch = (btm_InsertBatch*)context; /* the batch */
+
+
+    return(edubtm_KeyCompare(batch->kdesc, &batch->kvals[*(Four*)a], &batch->kvals[*(Four*)b]));
+
+}   /* edubtm_CompareBatchOrder() */
@@ -0,0 +1,154 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_InsertRecord.c
+ *
+ * Description :
+ *  Insert an ObjectID 'oid' with its record into a clustered Btree whose
+ *  key value is 'kval'.
+ *
+ * Exports:
+ *  Four EduBtM_InsertRecord(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Pool*, DeallocListElem*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * EduBtM_InsertRecord()
+ *================================*/
+/*
+ * Function: Four EduBtM_InsertRecord(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Insert an ObjectID 'oid' into a Btree whose key value is 'kval' as
+ *  EduBtM_InsertObject() does, and keep a copy of 'record', the record of
+ *  the object, in the leaf entry of a clustered index (see BTM_CLUSTERED)
+ *  so that EduBtM_FetchRecord() returns it without reading the object.
+ *  A record longer than 'inlineRecordMax' of the index is not kept; nor is
+ *  any record by an index which is not clustered.
+ *
+ *  The pair is inserted into the tree directly, after the buffered
+ *  insertions of the key are flushed, since the write buffer and the
+ *  message buffer keep no records. An index made with the BTM_ART option
+ *  keeps the pair only.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eDUPLICATEDKEY_BTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_InsertRecord(
+    ObjectID *catObjForFile,	/* IN catalog object of B+ tree file */
+    PageID   *root,		/* IN the root of Btree */
+    KeyDesc  *kdesc,		/* IN key descriptor */
+    KeyValue *kval,		/* IN key value */
+    ObjectID *oid,		/* IN ObjectID which will be inserted */
+    BtreeRecord *record,	/* IN record of the object */
+    Pool     *dlPool,		/* INOUT pool of dealloc list */
+    DeallocListElem *dlHead) /* INOUT head of the dealloc list */
+{
+    int i;
+    Four e;			/* error number */
+    Boolean lh;			/* for spliting */
+    Boolean lf;			/* for merging */
+    InternalItem item;		/* Internal Item */
+    btm_IndexInfo *info;	/* information about the index */
+    Boolean done;		/* TRUE if inserted into the rightmost leaf directly */
+    btm_ArtIndex *art;		/* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_INSERTRECORD);
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (root == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (kdesc == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (kval == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (oid == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (record == NULL || record->len < 0 || record->len > BTM_MAXINLINERECORD) ERR(eBADPARAMETER_BTM);
+
+    /* Error check whether using not supported functionality by EduBtM */
+    for(i=0; i<kdesc->nparts; i++)
+    {
+        if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
+            ERR(eNOTSUPPORTED_EDUBTM);
+    }
+
+    /* An index kept in an adaptive radix tree has no leaf entries */
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        e = edubtm_ArtInsert(art, kdesc, kval, oid);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    info = edubtm_GetIndexInfo(root, TRUE);
+    if (info != NULL) {
+        edubtm_NoteInsertion(info, kdesc, kval);
+        edubtm_AddBloomKey(info, kval);
+    }
+
+    /* 같은 key의 buffered insertion을 먼저 tree에 반영함 */
+    e = edubtm_FlushMessages(root, kval, SM_EQ, kval, SM_EQ);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, kval, SM_EQ, kval, SM_EQ);
+    if (e < eNOERROR) ERR(e);
+
+    /* Append to the rightmost leaf without descending the tree if possible */
+    if (info != NULL) {
+        e = edubtm_InsertRightmostLeaf(catObjForFile, info, kdesc, kval, oid, record, &done);
+        if (e < eNOERROR) ERR(e);
+        if (done) {
+            info->nInserts++;
+            return(eNOERROR);
+        }
+    }
+
+    lf = lh = FALSE;
+    e = edubtm_Insert(catObjForFile, root, kdesc, kval, oid, record, &lf, &lh, &item, dlPool, dlHead, info);
+    if (e < eNOERROR) ERR(e);
+
+    if (lh == TRUE){
+        e = edubtm_root_insert(catObjForFile, root, &item);
+        if (e < eNOERROR) ERR(e);
+        if (info != NULL) info->nRootSplits++;
+    }
+
+    if (info != NULL) info->nInserts++;
+
+    return(eNOERROR);
+
+}   /* EduBtM_InsertRecord() */
@@ -0,0 +1,69 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Latency.c
+ *
+ * Description :
+ *  Count the latencies of the calls of the interface functions of EduBtM.
+ *  The histograms are kept by Util_latency.c; this file has the table of
+ *  the interface functions, and UTIL_LATENCY_FUNCTIONS() defines the
+ *  functions below on it.
+ *
+ * Exports:
+ *  Four EduBtM_SetLatencyTracking(Boolean, Four)
+ *  Four EduBtM_GetLatency(Four, BtreeLatency*)
+ *  Four EduBtM_ResetLatency(void)
+ *  Four EduBtM_DumpLatency(FILE*)
+ *  Util_LatencyTimer edubtm_BeginLatency(Four)
+ *  void edubtm_EndLatency(Util_LatencyTimer*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+/* Names of the interface functions, in the order of BTM_API_* */
+static const char *edubtm_apiNames[BTM_NAPIS] = {
+    "CreateIndex", "CreateIndexWithOptions", "DropIndex",
+    "InsertObject", "InsertObjects", "DeleteObject",
+    "Fetch", "FetchNext", "OpenScan", "FetchNextBatch",
+    "CloseScan", "CallbackParallelScan", "InitSortedBulkLoad",
+    "NextSortedBulkLoad", "FinalSortedBulkLoad", "BulkLoad",
+    "BuildIndex", "SetIndexParams", "GetIndexParams",
+    "GetBloomStats", "GetStats", "OpenSnapshot",
+    "SnapshotFetch", "SnapshotFetchNext", "CloseSnapshot",
+    "FlushWriteBuffer", "InsertRecord", "FetchRecord",
+    "FetchNextRecord" };
+
+static Util_LatencyTable edubtm_latency = UTIL_LATENCY_TABLE(edubtm_apiNames, BTM_NAPIS); /* latencies of EduBtM */
+static __thread Util_LatencyThread *edubtm_latencyThread = NULL; /* histograms of this thread */
+
+
+/*@
+ * EduBtM_SetLatencyTracking(), EduBtM_GetLatency(), EduBtM_ResetLatency(),
+ * EduBtM_DumpLatency(), and edubtm_BeginLatency()/edubtm_EndLatency() called by BTM_LATENCY()
+ */
+UTIL_LATENCY_FUNCTIONS(EduBtM, edubtm, edubtm_latency, edubtm_latencyThread, BtreeLatency, eBADPARAMETER_BTM, eMEMORYALLOCERR_EDUBTM)
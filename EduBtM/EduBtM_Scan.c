@@ -0,0 +1,325 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Scan.c
+ *
+ * Description:
+ *  Scan a range of a B+ tree in batches. Unlike EduBtM_FetchNext(), which
+ *  fixes the leaf, copies the whole key into the cursor, and frees the leaf
+ *  for every ObjectID, a scan keeps its current leaf fixed between calls and
+ *  returns up to the requested number of entries of the leaf at once, with
+ *  their keys pointing into the fixed leaf.
+ *
+ *  The index should not be updated while a scan on it is open.
+ *
+ * Exports:
+ *  Four EduBtM_OpenScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeScan*)
+ *  Four EduBtM_FetchNextBatch(BtreeScan*, Four, BtreeScanItem*)
+ *  Four EduBtM_CloseScan(BtreeScan*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+#include "EduBtM.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_ScanNextLeaf(BtreeScan*);
+
+
+
+/*@================================
+ * EduBtM_OpenScan()
+ *================================*/
+/*
+ * Function: Four EduBtM_OpenScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeScan*)
+ *
+ * Description:
+ *  Open a scan on the B+ tree given by 'root'. The start and stop conditions
+ *  are the same as those of EduBtM_Fetch(); as for EduBtM_FetchNext(), the
+ *  scan goes to smaller keys if the stop operator is SM_GT, SM_GE, or SM_BOF.
+ *  The leaf of the first entry is fixed until the scan moves off it or is
+ *  closed by EduBtM_CloseScan(). An index kept in an adaptive radix tree
+ *  has no leaves to scan; it is scanned by EduBtM_FetchNext().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eNOTSUPPORTED_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_OpenScan(
+    PageID                      *root,          /* IN root page's PageID */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *startKval,     /* IN key value of start condition */
+    Four                        startCompOp,    /* IN comparison operator of start condition */
+    KeyValue                    *stopKval,      /* IN key value of stop condition */
+    Four                        stopCompOp,     /* IN comparison operator of stop condition */
+    BtreeScan                   *scan)          /* OUT the scan opened */
+{
+    Four                        e;              /* error number */
+    BtreeCursor                 cursor;         /* cursor on the first entry */
+    BTM_LATENCY(BTM_API_OPENSCAN);
+
+
+    /*@ check parameters */
+    if (root == NULL || kdesc == NULL || startKval == NULL || stopKval == NULL || scan == NULL)
+        ERR(eBADPARAMETER_BTM);
+
+    scan->flag = CURSOR_INVALID;
+    scan->page = NULL;
+
+    if (edubtm_GetArtIndex(root) != NULL) ERR(eNOTSUPPORTED_EDUBTM);
+
+    e = EduBtM_Fetch(root, kdesc, startKval, startCompOp, stopKval, stopCompOp, &cursor);
+    if (e < eNOERROR) ERR(e);
+
+    scan->kdesc = *kdesc;
+    scan->stopKval = *stopKval;
+    scan->stopCompOp = stopCompOp;
+    scan->forward = (stopCompOp == SM_GT || stopCompOp == SM_GE || stopCompOp == SM_BOF) ? FALSE : TRUE;
+
+    if (cursor.flag != CURSOR_ON) {
+        scan->flag = CURSOR_EOS;
+        return(eNOERROR);
+    }
+
+    /*@ fix the leaf of the first entry */
+    scan->leaf = cursor.leaf;
+    scan->slotNo = cursor.slotNo;
+    scan->oidNo = NIL;
+
+    e = BfM_GetTrain(&scan->leaf, (char**)&scan->page, PAGE_BUF);
+    if (e < eNOERROR) {
+        scan->page = NULL;
+        ERR(e);
+    }
+
+    scan->flag = CURSOR_ON;
+
+    return(eNOERROR);
+
+} /* EduBtM_OpenScan() */
+
+
+
+/*@================================
+ * EduBtM_FetchNextBatch()
+ *================================*/
+/*
+ * Function: Four EduBtM_FetchNextBatch(BtreeScan*, Four, BtreeScanItem*)
+ *
+ * Description:
+ *  Return up to 'maxItems' next entries of the scan in 'items'. All the
+ *  entries returned by a call come from one leaf; the scan moves to the
+ *  next leaf when the current one has no more entries. The key values
+ *  point into the fixed leaf and are valid until the next call on the
+ *  scan. A key with several ObjectIDs gives an item for each of them, in
+ *  ObjectID order (reverse order for a backward scan); the stop condition
+ *  is checked once per key.
+ *
+ * Returns:
+ *  # of entries returned (0 at the end of the scan) or error code
+ *    eBADPARAMETER_BTM
+ *    eBADCURSOR
+ *    some errors caused by function calls
+ */
+Four EduBtM_FetchNextBatch(
+    BtreeScan                   *scan,          /* INOUT the scan */
+    Four                        maxItems,       /* IN max # of entries to return */
+    BtreeScanItem               *items)         /* OUT entries returned */
+{
+    Four                        e;              /* error number */
+    Four                        n;              /* # of entries returned */
+    Four                        cmp;            /* comparison result */
+    Four                        stopCompOp;     /* comparison operator of stop condition */
+    Two                         step;           /* direction of the scan in the slot array */
+    BtreeLeaf                   *apage;         /* the fixed leaf */
+    btm_LeafEntry               *entry;         /* pointer to a leaf entry */
+    Boolean                     found;          /* TRUE if the key has the next ObjectID */
+    BTM_LATENCY(BTM_API_FETCHNEXTBATCH);
+
+
+    /*@ check parameters */
+    if (scan == NULL || items == NULL || maxItems <= 0) ERR(eBADPARAMETER_BTM);
+
+    if (scan->flag != CURSOR_ON && scan->flag != CURSOR_EOS) ERR(eBADCURSOR);
+
+    stopCompOp = scan->stopCompOp;
+    step = scan->forward ? 1 : -1;
+
+    /* A leaf may run out before giving any entry, e.g. when the last call
+     * stopped at the end of an ObjectID list in overflow pages. */
+    n = 0;
+    while (n == 0 && scan->flag == CURSOR_ON) {
+        /*@ move to the leaf having the next entry */
+        while (scan->flag == CURSOR_ON && (scan->slotNo < 0 || scan->slotNo >= scan->page->hdr.nSlots)) {
+            e = edubtm_ScanNextLeaf(scan);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        if (scan->flag == CURSOR_EOS) return(0);
+
+        apage = scan->page;
+
+        while (n < maxItems && scan->slotNo >= 0 && scan->slotNo < apage->hdr.nSlots) {
+            entry = (btm_LeafEntry*)&apage->data[apage->slot[-scan->slotNo]];
+
+            if (scan->oidNo == NIL) {
+                /* Stop Condition 적용 */
+                if (stopCompOp != SM_EOF && stopCompOp != SM_BOF) {
+                    cmp = edubtm_KeyCompare(&scan->kdesc, (KeyValue*)&entry->klen, &scan->stopKval);
+                    if ((stopCompOp == SM_LT && cmp != LESS) ||
+                        (stopCompOp == SM_LE && cmp == GREATER) ||
+                        (stopCompOp == SM_GT && cmp != GREATER) ||
+                        (stopCompOp == SM_GE && cmp == LESS) ||
+                        (stopCompOp == SM_EQ && cmp != EQUAL)) {
+                        scan->flag = CURSOR_EOS;
+                        break;
+                    }
+                }
+
+                e = edubtm_FirstObjectId(scan->leaf.volNo, entry, !scan->forward,
+                                         &scan->overflow, &scan->oidNo, &items[n].oid);
+                if (e < eNOERROR) ERR(e);
+            }
+            else {
+                /* the rest of the ObjectIDs of a key in overflow pages */
+                e = edubtm_NextObjectId(scan->leaf.volNo, entry, !scan->forward,
+                                        &scan->overflow, &scan->oidNo, &items[n].oid, &found);
+                if (e < eNOERROR) ERR(e);
+
+                if (!found) {
+                    scan->oidNo = NIL;
+                    scan->slotNo += step;
+                    continue;
+                }
+            }
+
+            items[n].klen = entry->klen;
+            items[n].kval = entry->kval;
+            n++;
+
+            /* After the last ObjectID of a list in the leaf, go on to the next entry */
+            if (IS_NILPAGEID(scan->overflow) && scan->oidNo == (scan->forward ? entry->nObjects - 1 : 0)) {
+                scan->oidNo = NIL;
+                scan->slotNo += step;
+            }
+        }
+    }
+
+    return(n);
+
+} /* EduBtM_FetchNextBatch() */
+
+
+
+/*@================================
+ * EduBtM_CloseScan()
+ *================================*/
+/*
+ * Function: Four EduBtM_CloseScan(BtreeScan*)
+ *
+ * Description:
+ *  Close the scan and free the leaf fixed by it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_CloseScan(
+    BtreeScan                   *scan)          /* INOUT the scan */
+{
+    Four                        e;              /* error number */
+    BTM_LATENCY(BTM_API_CLOSESCAN);
+
+
+    /*@ check parameters */
+    if (scan == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (scan->page != NULL) {
+        scan->page = NULL;
+        e = BfM_FreeTrain(&scan->leaf, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    scan->flag = CURSOR_INVALID;
+
+    return(eNOERROR);
+
+} /* EduBtM_CloseScan() */
+
+
+
+/*@================================
+ * edubtm_ScanNextLeaf()
+ *================================*/
+/*
+ * Function: Four edubtm_ScanNextLeaf(BtreeScan*)
+ *
+ * Description:
+ *  Free the current leaf of the scan and fix the next leaf in the direction
+ *  of the scan. The scan reaches its end if there is no more leaf.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_ScanNextLeaf(
+    BtreeScan                   *scan)          /* INOUT the scan */
+{
+    Four                        e;              /* error number */
+    ShortPageID                 nextPage;       /* the next leaf in the direction of the scan */
+
+
+    nextPage = scan->forward ? scan->page->hdr.nextPage : scan->page->hdr.prevPage;
+
+    /* At the end, the last leaf stays fixed until the scan is closed. */
+    if (nextPage == NIL) {
+        scan->flag = CURSOR_EOS;
+        return(eNOERROR);
+    }
+
+    scan->page = NULL;
+    e = BfM_FreeTrain(&scan->leaf, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(scan->leaf, scan->leaf.volNo, nextPage);
+    e = BfM_GetTrain(&scan->leaf, (char**)&scan->page, PAGE_BUF);
+    if (e < eNOERROR) {
+        scan->page = NULL;
+        scan->flag = CURSOR_INVALID;
+        ERR(e);
+    }
+
+    scan->slotNo = scan->forward ? 0 : scan->page->hdr.nSlots - 1;
+
+    return(eNOERROR);
+
+} /* edubtm_ScanNextLeaf() */
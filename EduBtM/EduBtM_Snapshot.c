@@ -0,0 +1,250 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Snapshot.c
+ *
+ * Description:
+ *  Read a B+ tree as it was at a point in time while writers go on
+ *  changing it. A snapshot is opened on an index, read with
+ *  EduBtM_SnapshotFetch() and EduBtM_SnapshotFetchNext(), which work as
+ *  EduBtM_Fetch() and EduBtM_FetchNext() do, and closed when the reader
+ *  is done. The pages changed after the snapshot was opened are read from
+ *  their versions saved by the writers (see edubtm_PageVersion.c).
+ *
+ *  The searches of a snapshot go from the root; they do not use the leaf
+ *  hints, the adaptive hash index, or the Bloom filter of the index, which
+ *  follow the current pages.
+ *
+ * Exports:
+ *  Four EduBtM_OpenSnapshot(PageID*, BtreeSnapshot*)
+ *  Four EduBtM_SnapshotFetch(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*)
+ *  Four EduBtM_SnapshotFetchNext(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*)
+ *  Four EduBtM_CloseSnapshot(BtreeSnapshot*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, btm_LeafHint*);
+Four edubtm_FetchNext(KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+
+
+
+/*@================================
+ * EduBtM_OpenSnapshot()
+ *================================*/
+/*
+ * Function: Four EduBtM_OpenSnapshot(PageID*, BtreeSnapshot*)
+ *
+ * Description:
+ *  Open a snapshot of the B+ tree given by 'root'. The snapshot sees the
+ *  tree as it is now until it is closed; the insertions buffered in the
+ *  root of a buffered index are flushed into the tree first. An index kept
+ *  in an adaptive radix tree has no page versions to take a snapshot of.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eNOTSUPPORTED_EDUBTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_OpenSnapshot(
+    PageID                      *root,          /* IN root page of the index */
+    BtreeSnapshot               *snapshot)      /* OUT the snapshot */
+{
+    Four                        e;              /* error number */
+    BTM_LATENCY(BTM_API_OPENSNAPSHOT);
+
+
+    /*@ check parameters */
+    if (root == NULL || snapshot == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (edubtm_GetArtIndex(root) != NULL) ERR(eNOTSUPPORTED_EDUBTM);
+
+    e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    snapshot->root = *root;
+
+    e = edubtm_OpenEpoch(snapshot);
+    if (e < eNOERROR) ERR(e);
+
+    snapshot->flag = CURSOR_ON;
+
+    return(eNOERROR);
+
+} /* EduBtM_OpenSnapshot() */
+
+
+
+/*@================================
+ * EduBtM_SnapshotFetch()
+ *================================*/
+/*
+ * Function: Four EduBtM_SnapshotFetch(BtreeSnapshot*, KeyDesc*, KeyValue*, Four,
+ *                                     KeyValue*, Four, BtreeCursor*)
+ *
+ * Description:
+ *  Find the first object satisfying the given condition in the snapshot,
+ *  as EduBtM_Fetch() does in the current tree.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eBADCURSOR
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  cursor : the found ObjectID and its position in the snapshot
+ */
+Four EduBtM_SnapshotFetch(
+    BtreeSnapshot               *snapshot,      /* IN the snapshot */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *startKval,     /* IN key value of start condition */
+    Four                        startCompOp,    /* IN comparison operator of start condition */
+    KeyValue                    *stopKval,      /* IN key value of stop condition */
+    Four                        stopCompOp,     /* IN comparison operator of stop condition */
+    BtreeCursor                 *cursor)        /* OUT B+ tree cursor */
+{
+    Four                        e;              /* error number */
+    BtreeSnapshot               *old;           /* the snapshot this thread read before */
+    BTM_LATENCY(BTM_API_SNAPSHOTFETCH);
+
+
+    /*@ check parameters */
+    if (snapshot == NULL || kdesc == NULL || startKval == NULL || stopKval == NULL || cursor == NULL)
+        ERR(eBADPARAMETER_BTM);
+
+    if (snapshot->flag != CURSOR_ON) ERR(eBADCURSOR);
+
+    old = edubtm_SetReadSnapshot(snapshot);
+
+    if (startCompOp == SM_BOF)
+        e = edubtm_FirstObject(&snapshot->root, kdesc, stopKval, stopCompOp, cursor);
+    else if (startCompOp == SM_EOF)
+        e = edubtm_LastObject(&snapshot->root, kdesc, stopKval, stopCompOp, cursor);
+    else
+        e = edubtm_Fetch(&snapshot->root, kdesc, startKval, startCompOp, stopKval, stopCompOp, cursor, NULL);
+
+    edubtm_SetReadSnapshot(old);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBtM_SnapshotFetch() */
+
+
+
+/*@================================
+ * EduBtM_SnapshotFetchNext()
+ *================================*/
+/*
+ * Function: Four EduBtM_SnapshotFetchNext(BtreeSnapshot*, KeyDesc*, KeyValue*, Four,
+ *                                         BtreeCursor*, BtreeCursor*)
+ *
+ * Description:
+ *  Get the next object of the snapshot after the one of 'current', as
+ *  EduBtM_FetchNext() does in the current tree. The cursor should come
+ *  from the same snapshot.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eBADCURSOR
+ *    some errors caused by function calls
+ */
+Four EduBtM_SnapshotFetchNext(
+    BtreeSnapshot               *snapshot,      /* IN the snapshot */
+    KeyDesc                     *kdesc,         /* IN key descriptor */
+    KeyValue                    *kval,          /* IN key value of stop condition */
+    Four                        compOp,         /* IN comparison operator of stop condition */
+    BtreeCursor                 *current,       /* IN current B+ tree cursor */
+    BtreeCursor                 *next)          /* OUT next B+ tree cursor */
+{
+    Four                        e;              /* error number */
+    BtreeSnapshot               *old;           /* the snapshot this thread read before */
+    BTM_LATENCY(BTM_API_SNAPSHOTFETCHNEXT);
+
+
+    /*@ check parameters */
+    if (snapshot == NULL || kdesc == NULL || kval == NULL || current == NULL || next == NULL)
+        ERR(eBADPARAMETER_BTM);
+
+    if (snapshot->flag != CURSOR_ON) ERR(eBADCURSOR);
+
+    if (current->flag != CURSOR_ON && current->flag != CURSOR_EOS) ERR(eBADCURSOR);
+
+    if (current->flag == CURSOR_EOS) return(eNOERROR);
+
+    old = edubtm_SetReadSnapshot(snapshot);
+    e = edubtm_FetchNext(kdesc, kval, compOp, current, next);
+    edubtm_SetReadSnapshot(old);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBtM_SnapshotFetchNext() */
+
+
+
+/*@================================
+ * EduBtM_CloseSnapshot()
+ *================================*/
+/*
+ * Function: Four EduBtM_CloseSnapshot(BtreeSnapshot*)
+ *
+ * Description:
+ *  Close the snapshot. The versions which no open snapshot needs any more
+ *  are freed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    eBADCURSOR
+ */
+Four EduBtM_CloseSnapshot(
+    BtreeSnapshot               *snapshot)      /* INOUT the snapshot */
+{
+    BTM_LATENCY(BTM_API_CLOSESNAPSHOT);
+
+
+    /*@ check parameters */
+    if (snapshot == NULL) ERR(eBADPARAMETER_BTM);
+
+    if (snapshot->flag != CURSOR_ON) ERR(eBADCURSOR);
+
+    edubtm_CloseEpoch(snapshot);
+    snapshot->flag = CURSOR_INVALID;
+
+    return(eNOERROR);
+
+} /* EduBtM_CloseSnapshot() */
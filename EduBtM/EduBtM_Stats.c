@@ -0,0 +1,256 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Stats.c
+ *
+ * Description :
+ *  Report the statistics of a Btree index: the counters kept by the
+ *  insertions and deletions, and the shape of the tree, which is computed
+ *  by a scan of all its pages when an exact report is asked for.
+ *
+ * Exports:
+ *  Four EduBtM_GetStats(PageID*, Boolean, BtreeStats*)
+ *  Four edubtm_CollectStats(PageID*, Four, BtreeStats*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * EduBtM_GetStats()
+ *================================*/
+/*
+ * Function: Four EduBtM_GetStats(PageID*, Boolean, BtreeStats*)
+ *
+ * Description:
+ *  Get the statistics of the index given by 'root'. The counters are read
+ *  from the information about the index; they are all 0 if the index has
+ *  not been updated since its information was made. The height and the
+ *  page size are found by following the first child pointers down to a
+ *  leaf. If 'exact' is TRUE, every page of the index is visited to count
+ *  the pages, entries and overflow pages, and to measure the fill of the
+ *  pages and the key lengths; otherwise those figures are left 0. The
+ *  insertions buffered in the root of a buffered index are counted in
+ *  'nMessages', and those kept in the write buffer of the index in
+ *  'nWriteBuffered'; an exact report flushes them into the tree first.
+ *  For an index kept in an adaptive radix tree, which has no pages, only
+ *  'nKeys' and 'nObjects' are reported.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM
+ *    some errors caused by function calls
+ */
+Four EduBtM_GetStats(
+    PageID              *root,          /* IN root page of the index */
+    Boolean             exact,          /* IN TRUE if all pages should be visited */
+    BtreeStats          *stats)         /* OUT statistics of the index */
+{
+    Four                e;              /* error number */
+    btm_IndexInfo       *info;          /* information about the index */
+    PageID              pid;            /* a page on the leftmost path */
+    BtreePage           *apage;         /* pointer to the buffer holding 'pid' */
+    Boolean             isLeaf;         /* TRUE if 'pid' is a leaf page */
+    btm_ArtIndex        *art;           /* adaptive radix tree of the index; NULL if none */
+    BTM_LATENCY(BTM_API_GETSTATS);
+
+
+    /*@ check parameters */
+    if (root == NULL || stats == NULL) ERR(eBADPARAMETER_BTM);
+
+    memset(stats, 0, sizeof(BtreeStats));
+
+    if ((art = edubtm_GetArtIndex(root)) != NULL) {
+        stats->nKeys = art->nKeys;
+        stats->nObjects = art->nObjects;
+        stats->exact = TRUE;
+        return(eNOERROR);
+    }
+
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info != NULL) {
+        stats->nInserts = info->nInserts;
+        stats->nDeletes = info->nDeletes;
+        stats->nLeafSplits = info->nLeafSplits;
+        stats->nInternalSplits = info->nInternalSplits;
+        stats->nRootSplits = info->nRootSplits;
+        stats->nUnderflows = info->nUnderflows;
+        stats->nOverflowLists = info->nOverflowLists;
+    }
+
+    if (exact) {
+        e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+        if (e < eNOERROR) ERR(e);
+
+        e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    if (info != NULL) stats->nWriteBuffered = info->writeBuffer.nPairs;
+
+    e = edubtm_CountMessages(root, &stats->nMessages);
+    if (e < eNOERROR) ERR(e);
+
+    if (exact) {
+        e = edubtm_CollectStats(root, 0, stats);
+        if (e < eNOERROR) ERR(e);
+
+        /* The sums are turned into averages */
+        if (stats->nLeaves > 0) stats->leafFill /= stats->nLeaves;
+        if (stats->nInternals > 0) stats->internalFill /= stats->nInternals;
+        if (stats->nKeys > 0) stats->avgKeyLen /= stats->nKeys;
+        stats->exact = TRUE;
+
+        return(eNOERROR);
+    }
+
+    /*@ follow the first child pointers to a leaf */
+    pid = *root;
+    do {
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        isLeaf = (apage->any.hdr.type & LEAF) ? TRUE : FALSE;
+        if (!isLeaf) pid.pageNo = apage->bi.hdr.p0;
+        if (stats->height == 0) stats->pageSize = BTM_PAGE_SIZE(&apage->any);
+
+        e = BfM_FreeTrain(&apage->any.hdr.pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        stats->height++;
+    } while (!isLeaf);
+
+    return(eNOERROR);
+
+}   /* EduBtM_GetStats() */
+
+
+
+/*@================================
+ * edubtm_CollectStats()
+ *================================*/
+/*
+ * Function: Four edubtm_CollectStats(PageID*, Four, BtreeStats*)
+ *
+ * Description:
+ *  Add the pages and entries of the B+ subtree rooted at 'pid', which is
+ *  'level' levels below the root, to the statistics. The fills and the key
+ *  lengths are added up; the caller divides them by the counts.
+ *
+ * Returns:
+ *  error code
+ *    eBADBTREEPAGE_BTM
+ *    some errors caused by function calls
+ */
+Four edubtm_CollectStats(
+    PageID              *pid,           /* IN root page of the B+ subtree */
+    Four                level,          /* IN # of levels above the page */
+    BtreeStats          *stats)         /* INOUT statistics being collected */
+{
+    Four                e;              /* error number */
+    Two                 i;              /* slot No. */
+    Four                b;              /* bucket of the key length histogram */
+    PageID              tPid;           /* a child page */
+    PageID              ovPid;          /* an overflow page */
+    BtreePage           *apage;         /* pointer to the buffer holding 'pid' */
+    BtreeOverflow       *opage;         /* pointer to the buffer holding an overflow page */
+    btm_InternalEntry   *iEntry;        /* an internal entry */
+    btm_LeafEntry       *lEntry;        /* a leaf entry */
+
+
+    e = BfM_GetTrain(pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (level == 0) stats->pageSize = BTM_PAGE_SIZE(&apage->any);
+
+    if (apage->any.hdr.type & INTERNAL) {
+        stats->nInternals++;
+        stats->internalFill += 100.0 * (BTM_PAGE_SIZE(&apage->bi) - BI_FIXED - BI_FREE(&apage->bi)) / (BTM_PAGE_SIZE(&apage->bi) - BI_FIXED);
+
+        MAKE_PAGEID(tPid, pid->volNo, apage->bi.hdr.p0);
+        e = edubtm_CollectStats(&tPid, level + 1, stats);
+        if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+
+        for (i = 0; i < apage->bi.hdr.nSlots; i++) {
+            iEntry = (btm_InternalEntry*)&apage->bi.data[apage->bi.slot[-i]];
+
+            MAKE_PAGEID(tPid, pid->volNo, iEntry->spid);
+            e = edubtm_CollectStats(&tPid, level + 1, stats);
+            if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+        }
+    }
+    else if (apage->any.hdr.type & LEAF) {
+        stats->nLeaves++;
+        stats->leafFill += 100.0 * (BTM_PAGE_SIZE(&apage->bl) - BL_FIXED - BL_FREE(&apage->bl)) / (BTM_PAGE_SIZE(&apage->bl) - BL_FIXED);
+        if (level + 1 > stats->height) stats->height = level + 1;
+
+        for (i = 0; i < apage->bl.hdr.nSlots; i++) {
+            lEntry = (btm_LeafEntry*)&apage->bl.data[apage->bl.slot[-i]];
+
+            if (stats->nKeys == 0 || lEntry->klen < stats->minKeyLen) stats->minKeyLen = lEntry->klen;
+            if (lEntry->klen > stats->maxKeyLen) stats->maxKeyLen = lEntry->klen;
+            stats->avgKeyLen += lEntry->klen;
+            stats->nKeys++;
+
+            for (b = 0; b < BTM_KEYLENBUCKETS - 1; b++)
+                if (lEntry->klen <= (BTM_STATS_MINKEYLEN << b)) break;
+            stats->keyLenHist[b]++;
+
+            if (lEntry->nObjects >= 0) {
+                stats->nObjects += lEntry->nObjects;
+                continue;
+            }
+
+            /*@ count the ObjectIDs in the overflow pages of the entry */
+            stats->nOverflowKeys++;
+            MAKE_PAGEID(ovPid, pid->volNo, BTM_LEAFENTRY_OVPAGE(lEntry));
+            while (ovPid.pageNo != NIL) {
+                e = BfM_GetTrain(&ovPid, (char**)&opage, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+
+                stats->nOverflowPages++;
+                stats->nObjects += opage->hdr.nObjects;
+                tPid = ovPid;
+                ovPid.pageNo = opage->hdr.nextPage;
+
+                e = BfM_FreeTrain(&tPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+            }
+        }
+    }
+    else
+        ERRB1(eBADBTREEPAGE_BTM, pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_CollectStats() */
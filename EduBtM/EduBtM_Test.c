@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include "EduBtM_common.h"
 #include "EduBtM_basictypes.h"
+#include "OM_Internal.h"
 #include "EduBtM.h"
 #include "EduBtM_TestModule.h"
 #include "Util_hash.h"
@@ -56,6 +57,27 @@ struct AnalyticsStruct {
 	int 	numEtcError;
 };
 
+/* A pair of a reference set */
+struct referencePairStruct {
+	Four		key;			/* key No.; see makeReferenceKeyValue() */
+	ObjectID	oid;			/* object id */
+};
+
+/* The pairs an index under test should hold, checked by checkIndex() */
+struct referenceStruct {
+	Boolean		longKeys;		/* TRUE if the keys are made by makeLongKeyValue() */
+	Four		nPairs;			/* # of pairs */
+	struct referencePairStruct pairs[NUMREFERENCEPAIRS];	/* the pairs */
+};
+
+/* The entries found by the workers of a callback-parallel scan */
+struct parallelScanStruct {
+	struct referenceStruct *ref;					/* sorted reference set of the index */
+	char		seen[NUMREFERENCEPAIRS];			/* # of times each pair was found */
+	Four		nUnknown[NUMPARALLELSCANWORKERS];	/* # of entries not in the reference set, per worker */
+	Four		nUnordered[NUMPARALLELSCANWORKERS];	/* # of entries out of key order in a batch, per worker */
+};
+
 struct perfTestResultStruct {
 	Four		keyType;
 	Four		specType;
@@ -63,6 +85,8 @@ struct perfTestResultStruct {
 };
 
 static Boolean logFlag;
+static KeyValue testKvals[NUMREFERENCEPAIRS];	/* key values given to the bulk loads and batch insertions */
+static ObjectID testOids[NUMREFERENCEPAIRS];	/* ObjectIDs given with 'testKvals' */
 const struct objectMapStruct *objectMap = NULL;
 
 Four dumpBtreePage(PageID*, KeyDesc);
@@ -84,6 +108,39 @@ void printFinalScore(Four, Four, Four);
 void fprintJSONResult(FILE*, Four, Four);
 Four gradeWorkload(struct AnalyticsStruct *);
 Four totalErrorCount(struct AnalyticsStruct *);
+Four testBufferedIndexes(Four, struct AnalyticsStruct*);
+Four testSmallPageDeletions(Four, struct AnalyticsStruct*);
+void makeTestObjectId(Four, Four, ObjectID*);
+void makeLongKeyValue(Four, KeyValue*);
+Four testKeyHeads(Four, struct AnalyticsStruct*);
+Four testBulkLoads(Four, struct AnalyticsStruct*);
+Four testBuildIndex(Four, struct AnalyticsStruct*);
+Four testInsertObjects(Four, struct AnalyticsStruct*);
+Four testDuplicateKeys(Four, struct AnalyticsStruct*);
+Four testBloomFilters(Four, struct AnalyticsStruct*);
+Four testRangeScans(Four, struct AnalyticsStruct*);
+Four testSnapshots(Four, struct AnalyticsStruct*);
+Four testArtIndexes(Four, struct AnalyticsStruct*);
+Four testClusteredIndexes(Four, struct AnalyticsStruct*);
+Four createTestFile(Four, FileID*, ObjectID*, PhysicalFileID*);
+void makeTestKeyDesc(Boolean, Boolean, KeyDesc*);
+Four makeReferenceKey(Four);
+void makeReferenceKeyValue(struct referenceStruct*, Four, KeyValue*);
+Four referenceKeyNo(struct referenceStruct*, char*);
+void addReferencePair(struct referenceStruct*, Four, ObjectID*);
+Four insertReferencePair(ObjectID*, PageID*, KeyDesc*, struct referenceStruct*, Four, ObjectID*);
+Four deleteReferencePairs(ObjectID*, PageID*, KeyDesc*, struct referenceStruct*, Four, struct AnalyticsStruct*);
+int compareReferencePairs(const void*, const void*);
+void sortReference(struct referenceStruct*);
+Four findReferencePair(struct referenceStruct*, char*, ObjectID*);
+Boolean sameReferencePair(struct referenceStruct*, Four, char*, ObjectID*);
+Four checkIndex(PageID*, KeyDesc*, struct referenceStruct*, Four, struct AnalyticsStruct*);
+Four checkRangeScans(PageID*, KeyDesc*, struct referenceStruct*, Four, Four, Four, Four, Four, struct AnalyticsStruct*);
+Four collectParallelScan(void*, Four, Four, BtreeScanItem*);
+Four checkSnapshot(BtreeSnapshot*, KeyDesc*, struct referenceStruct*, struct AnalyticsStruct*);
+void makeTestRecord(Four, BtreeRecord*);
+Boolean sameTestRecord(BtreeRecord*, BtreeRecord*);
+Four OM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
 
 /*@================================
  * EduBtM_Test()
@@ -258,6 +315,126 @@ Four EduBtM_Test(Four volId, Four handle){
 		}
 	}
 	
+	printf("\n########################### BUFFERED INDEXES #############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testBufferedIndexes(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n######################### SMALL PAGE DELETIONS ###########################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testSmallPageDeletions(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################### KEY HEADS ################################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testKeyHeads(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################### BULK LOADS ###############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testBulkLoads(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################## BUILD INDEX ###############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testBuildIndex(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################ BATCH INSERTIONS ############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testInsertObjects(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################# DUPLICATE KEYS #############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testDuplicateKeys(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################# BLOOM FILTERS ##############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testBloomFilters(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################## RANGE SCANS ###############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testRangeScans(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n############################### SNAPSHOTS ################################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testSnapshots(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n########################## ADAPTIVE RADIX TREES ##########################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testArtIndexes(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
+	printf("\n########################### CLUSTERED INDEXES ############################\n");
+	{
+		struct AnalyticsStruct tmpAnalytics = {0};
+
+		e = testClusteredIndexes(volId, &tmpAnalytics);
+		if (e < eNOERROR) tmpAnalytics.numEtcError++;
+		printAnalytics(&tmpAnalytics);
+		mergeAnalytics(&tmpAnalytics, &curAnalytics);
+	}
+
 	printf("\n########################### TOTAL TEST RESULT ############################\n");
 	printf("\n                               Coverage \n");
 	printAnalytics(&curAnalytics);
@@ -272,6 +449,2086 @@ Four EduBtM_Test(Four volId, Four handle){
 /* End test for variable key value. */
 
 
+/*@================================
+ * testBufferedIndexes()
+ *================================*/
+/*
+ * Function: Four testBufferedIndexes(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test that the insertions kept in the buffers of an index give the same
+ *  answers as the insertions made in the tree:
+ *  - a buffered index (BTM_BUFFERED) whose root becomes a leaf while
+ *    insertions are left in its message buffer
+ *  - a unique buffered index, into which the keys in its message buffer
+ *    and in its tree are inserted again
+ *  - a unique index with a write buffer, into which the keys already in the
+ *    tree are inserted again and then deleted
+ *  - indexes with a Bloom filter which is built while insertions are left
+ *    in the message buffer or in the write buffer
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testBufferedIndexes(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		key;				/* integer key */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	ObjectID	*catObjForFile = &catalogEntry;	/* for GET_PTR_TO_CATENTRY_FOR_BTREE() */
+	SlottedPage	*catPage;			/* buffer page containing the catalog object */
+	sm_CatOverlayForBtree *catEntry;	/* Btree part of the catalog entry */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PageID		catPid;				/* page of the catalog object */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	KeyValue	kval;				/* value of key */
+	ObjectID	oid;				/* object id */
+	BtreeCursor	cursor;				/* cursor of an equality search */
+	BtreeIndexParams params;		/* run-time parameters of the index tested */
+
+	e = SM_CreateFile(volId, &fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	MAKE_PAGEID(catPid, catalogEntry.volNo, catalogEntry.pageNo);
+	e = BfM_GetTrain(&catPid, (char**)&catPage, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, catEntry);
+	MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+	e = BfM_FreeTrain(&catPid, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+
+	kdesc.flag = KEYFLAG_UNIQUE;
+	kdesc.nparts = 1;
+	kdesc.kpart[0].type = SM_INT;
+	kdesc.kpart[0].offset = 0;
+	kdesc.kpart[0].length = sizeof(Four);
+
+	/* A buffered index whose root becomes a leaf with insertions left in its buffer */
+	e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_BUFFERED);
+	if (e < eNOERROR) ERR(e);
+
+	for (key = 0; key < NUMBUFFERTESTKEYS + NUMBUFFERPENDINGKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	/* the keys below NUMBUFFERTESTKEYS are flushed by their deletions only */
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_DeleteObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &dlPool, &dlHead);
+		if (e == eNOTFOUND_BTM) analytics->numDeleteNoExistButExist++;
+		else if (e < eNOERROR) ERR(e);
+	}
+
+	for (i = 0; i < NUMBUFFERPENDINGKEYS; i++) {
+		key = NUMBUFFERTESTKEYS + i;
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+
+		/* a key left in the buffer is in the index */
+		makeTestObjectId(volId, key + NUMBUFFERPENDINGKEYS, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e == eNOERROR) analytics->numInsertDupButNoDup++;
+		else if (e != eDUPLICATEDKEY_BTM) ERR(e);
+
+		e = EduBtM_Fetch(&rootPid, &kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		makeTestObjectId(volId, key, &oid);
+		if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+		else if (memcmp(&cursor.oid, &oid, sizeof(ObjectID)) != 0) analytics->numScanNotSameObject++;
+
+		e = EduBtM_DeleteObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &dlPool, &dlHead);
+		if (e == eNOTFOUND_BTM) analytics->numDeleteNoExistButExist++;
+		else if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	/* A unique buffered index; the keys in the buffer and in the tree are inserted again */
+	e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_BUFFERED);
+	if (e < eNOERROR) ERR(e);
+
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	for (key = NUMBUFFERTESTKEYS - 1; key >= 0; key--) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key + NUMBUFFERTESTKEYS, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e == eNOERROR) analytics->numInsertDupButNoDup++;
+		else if (e != eDUPLICATEDKEY_BTM) ERR(e);
+	}
+
+	/* the pair inserted first is kept */
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		e = EduBtM_Fetch(&rootPid, &kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		makeTestObjectId(volId, key, &oid);
+		if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+		else if (memcmp(&cursor.oid, &oid, sizeof(ObjectID)) != 0) analytics->numScanNotSameObject++;
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	/* A unique index with a write buffer; the keys in the tree are inserted again */
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_GetIndexParams(&rootPid, &params);
+	if (e < eNOERROR) ERR(e);
+	params.writeBufferKB = 64;
+	e = EduBtM_SetIndexParams(&rootPid, &params);
+	if (e < eNOERROR) ERR(e);
+
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_FlushWriteBuffer(&rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key + NUMBUFFERTESTKEYS, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e == eNOERROR) analytics->numInsertDupButNoDup++;
+		else if (e != eDUPLICATEDKEY_BTM) ERR(e);
+	}
+
+	/* a deleted key does not come back from the buffer */
+	for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+		makeKeyValue(RANDINT, &key, NULL, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_DeleteObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &dlPool, &dlHead);
+		if (e == eNOTFOUND_BTM) analytics->numDeleteNoExistButExist++;
+		else if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_Fetch(&rootPid, &kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		if (cursor.flag == CURSOR_ON) analytics->numScanNotFoundButFound++;
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	/* Bloom filters built while the keys are in the message buffer or the write buffer */
+	for (i = 0; i < 2; i++) {
+		e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, i == 0 ? BTM_BUFFERED : 0);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_GetIndexParams(&rootPid, &params);
+		if (e < eNOERROR) ERR(e);
+		params.bloomBitsPerKey = 10;
+		params.writeBufferKB = i == 0 ? 0 : 64;
+		e = EduBtM_SetIndexParams(&rootPid, &params);
+		if (e < eNOERROR) ERR(e);
+
+		/* the keys of the write buffer are not looked up in the tree if they need not be unique */
+		kdesc.flag = i == 0 ? KEYFLAG_UNIQUE : 0;
+
+		for (key = 0; key < NUMBUFFERTESTKEYS; key++) {
+			makeKeyValue(RANDINT, &key, NULL, &kval);
+			makeTestObjectId(volId, key, &oid);
+			e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		/* the first search builds the filter */
+		for (key = NUMBUFFERTESTKEYS - 1; key >= 0; key--) {
+			makeKeyValue(RANDINT, &key, NULL, &kval);
+			e = EduBtM_Fetch(&rootPid, &kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+			if (e < eNOERROR) ERR(e);
+			if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+		}
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testSmallPageDeletions()
+ *================================*/
+/*
+ * Function: Four testSmallPageDeletions(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test the deletions from an index of 1024-byte pages with long keys,
+ *  which leave pages with only one child: blocks of NUMSMALLPAGEBLOCK keys
+ *  are deleted, every other block, so that whole leaves and subtrees lose
+ *  all their keys. The forward and the backward scans over the whole index
+ *  should return the keys left in order, and no empty leaf should be left
+ *  in the leaf chain; each one left is counted as an unknown error.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testSmallPageDeletions(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		key;				/* # of the key */
+	Four		nLeft;				/* # of the keys left */
+	FileID		fid;				/* file of the index */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	ObjectID	*catObjForFile = &catalogEntry;	/* for GET_PTR_TO_CATENTRY_FOR_BTREE() */
+	SlottedPage	*catPage;			/* buffer page containing the catalog object */
+	sm_CatOverlayForBtree *catEntry;	/* Btree part of the catalog entry */
+	PhysicalFileID pFid;			/* physical file of the index */
+	PageID		catPid;				/* page of the catalog object */
+	PhysicalIndexID	rootPid;		/* root page of the index */
+	PageID		pid;				/* a page of the index */
+	BtreePage	*apage;				/* buffer of 'pid' */
+	ShortPageID	nextPage;			/* next page to visit; NIL if none */
+	KeyDesc		kdesc;				/* key descriptor */
+	KeyValue	kval;				/* value of key */
+	KeyValue	startKval;			/* start value of key of a scan */
+	KeyValue	stopKval;			/* stop value of key of a scan */
+	ObjectID	oid;				/* object id */
+	BtreeCursor	cursor;				/* cursor of a scan */
+	BtreeCursor	next;				/* next cursor of a scan */
+
+	e = SM_CreateFile(volId, &fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	MAKE_PAGEID(catPid, catalogEntry.volNo, catalogEntry.pageNo);
+	e = BfM_GetTrain(&catPid, (char**)&catPage, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, catEntry);
+	MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+	e = BfM_FreeTrain(&catPid, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+
+	kdesc.flag = KEYFLAG_UNIQUE;
+	kdesc.nparts = 1;
+	kdesc.kpart[0].type = SM_VARSTRING;
+	kdesc.kpart[0].offset = 0;
+	kdesc.kpart[0].length = NUMSMALLPAGEKEYLEN;
+
+	e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_PAGESIZE_1K);
+	if (e < eNOERROR) ERR(e);
+
+	for (key = 0; key < NUMSMALLPAGEKEYS; key++) {
+		makeLongKeyValue(key, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, NULL, NULL);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	/* the keys of the even blocks go */
+	nLeft = 0;
+	for (key = 0; key < NUMSMALLPAGEKEYS; key++) {
+		if ((key / NUMSMALLPAGEBLOCK) % 2 != 0) {
+			nLeft++;
+			continue;
+		}
+
+		makeLongKeyValue(key, &kval);
+		makeTestObjectId(volId, key, &oid);
+		e = EduBtM_DeleteObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &dlPool, &dlHead);
+		if (e == eNOTFOUND_BTM) analytics->numDeleteNoExistButExist++;
+		else if (e < eNOERROR) ERR(e);
+	}
+
+	/* forward and backward scans over the whole index */
+	makeLongKeyValue(0, &startKval);
+	makeLongKeyValue(NUMSMALLPAGEKEYS, &stopKval);
+	for (i = 0; i < 2; i++) {
+		if (i == 0) {
+			key = NUMSMALLPAGEBLOCK;
+			e = EduBtM_Fetch(&rootPid, &kdesc, &startKval, SM_BOF, &stopKval, SM_EOF, &cursor);
+		}
+		else {
+			key = NUMSMALLPAGEKEYS - 1;
+			while ((key / NUMSMALLPAGEBLOCK) % 2 == 0) key--;
+			e = EduBtM_Fetch(&rootPid, &kdesc, &stopKval, SM_EOF, &startKval, SM_BOF, &cursor);
+		}
+		if (e < eNOERROR) ERR(e);
+
+		while (cursor.flag == CURSOR_ON && key >= 0 && key < NUMSMALLPAGEKEYS) {
+			makeTestObjectId(volId, key, &oid);
+			if (memcmp(&cursor.oid, &oid, sizeof(ObjectID)) != 0) analytics->numScanNotSameObject++;
+
+			/* the next key left in the scan direction */
+			do key += (i == 0) ? 1 : -1;
+			while (key >= 0 && key < NUMSMALLPAGEKEYS && (key / NUMSMALLPAGEBLOCK) % 2 == 0);
+
+			if (i == 0)
+				e = EduBtM_FetchNext(&rootPid, &kdesc, &stopKval, SM_EOF, &cursor, &next);
+			else
+				e = EduBtM_FetchNext(&rootPid, &kdesc, &startKval, SM_BOF, &cursor, &next);
+			if (e < eNOERROR) ERR(e);
+			cursor = next;
+		}
+
+		if (cursor.flag == CURSOR_ON) analytics->numScanNotFoundButFound++;
+		else if (key >= 0 && key < NUMSMALLPAGEKEYS) analytics->numScanFoundButNotFound++;
+	}
+
+	/* no empty leaf is left in the leaf chain */
+	pid = rootPid;
+	for (;;) {
+		e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		nextPage = (apage->any.hdr.type & INTERNAL) ? apage->bi.hdr.p0 : NIL;
+		e = BfM_FreeTrain(&pid, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+
+		if (nextPage == NIL) break;
+		pid.pageNo = nextPage;
+	}
+
+	while (nLeft > 0) {
+		e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		if (apage->bl.hdr.nSlots == 0) analytics->numEtcError++;
+		nextPage = apage->bl.hdr.nextPage;
+		e = BfM_FreeTrain(&pid, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+
+		if (nextPage == NIL) break;
+		pid.pageNo = nextPage;
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+/*@================================
+ * testKeyHeads()
+ *================================*/
+/*
+ * Function: Four testKeyHeads(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test the indexes whose pages keep a key head array (BTM_KEYHEAD), with
+ *  integer keys and with long string keys. The keys are inserted out of
+ *  order and every third pair is then deleted; the index is checked
+ *  against the reference set after each step by checkIndex().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testKeyHeads(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the pair */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < 2; i++) {
+		ref.longKeys = i == 1 ? TRUE : FALSE;
+		ref.nPairs = 0;
+		makeTestKeyDesc(ref.longKeys, TRUE, &kdesc);
+
+		e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_KEYHEAD);
+		if (e < eNOERROR) ERR(e);
+
+		for (n = 0; n < NUMREFERENCEKEYS; n++) {
+			makeTestObjectId(volId, n, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(n), &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		e = checkIndex(&rootPid, &kdesc, &ref, BTM_KEYHEAD, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 3, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkIndex(&rootPid, &kdesc, &ref, BTM_KEYHEAD, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testBulkLoads()
+ *================================*/
+/*
+ * Function: Four testBulkLoads(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test the indexes built bottom-up:
+ *  - a unique index loaded by EduBtM_BulkLoad() from a sorted array, into
+ *    which other keys are inserted afterwards
+ *  - an index with duplicate keys loaded pair by pair by the sorted bulk
+ *    load, with a key whose ObjectIDs go to overflow pages, from which
+ *    every fourth pair is then deleted
+ *  The index is checked against the reference set after each step.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testBulkLoads(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		n;					/* # of the pair */
+	Four		key;				/* key No. */
+	Four		blkLdId;			/* ID of the sorted bulk load */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	KeyValue	kval;				/* value of key */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	/* A unique index loaded from an array; the keys are multiples of 4 */
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, TRUE, &kdesc);
+
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	for (n = 0; n < NUMREFERENCEKEYS; n++) {
+		makeReferenceKeyValue(&ref, 4 * n, &testKvals[n]);
+		makeTestObjectId(volId, n, &testOids[n]);
+		addReferencePair(&ref, 4 * n, &testOids[n]);
+	}
+
+	e = EduBtM_BulkLoad(&catalogEntry, &rootPid, &kdesc, NUMREFERENCEKEYS, testKvals, testOids, 90, 90, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	/* the insertions split the full pages left by the load */
+	for (n = 0; n < NUMREFERENCEKEYS; n += 2) {
+		makeTestObjectId(volId, NUMREFERENCEKEYS + n, &oid);
+		e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, 4 * n + 2, &oid);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	/* An index with duplicate keys loaded by the sorted bulk load */
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, FALSE, &kdesc);
+
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	blkLdId = EduBtM_InitSortedBulkLoad(&catalogEntry, &rootPid, &kdesc, 80, 80);
+	if (blkLdId < eNOERROR) ERR(blkLdId);
+
+	/* 5 ObjectIDs for each key, and then NUMHEAVYOBJECTS for the last key */
+	for (n = 0; n < NUMREFERENCEKEYS + NUMHEAVYOBJECTS; n++) {
+		key = n < NUMREFERENCEKEYS ? 2 * (n / 5) : 2 * (NUMREFERENCEKEYS / 5);
+		makeReferenceKeyValue(&ref, key, &kval);
+		makeTestObjectId(volId, n, &oid);
+		e = EduBtM_NextSortedBulkLoad(blkLdId, &kval, &oid);
+		if (e < eNOERROR) ERR(e);
+		addReferencePair(&ref, key, &oid);
+	}
+
+	e = EduBtM_FinalSortedBulkLoad(blkLdId, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 4, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testBuildIndex()
+ *================================*/
+/*
+ * Function: Four testBuildIndex(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test EduBtM_BuildIndex() on a data file whose objects hold an integer
+ *  key at offset 0: once with all pairs sorted in one run, and once with
+ *  runs of NUMBUILDRUNSIZE pairs sorted by several workers, which are too
+ *  many to be merged in one pass. Each index is checked against the
+ *  reference set of the objects.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testBuildIndex(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the object */
+	Four		key;				/* key No. */
+	FileID		fid;				/* data file of the objects */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectHdr	objHdr;				/* header of a new object */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, TRUE, &kdesc);
+
+	objHdr.properties = 0;
+	objHdr.tag = 0;
+	objHdr.length = 0;
+	for (n = 0; n < NUMREFERENCEKEYS; n++) {
+		key = makeReferenceKey(n);
+		e = OM_CreateObject(&catalogEntry, NULL, &objHdr, sizeof(Four), (char*)&key, &oid);
+		if (e < eNOERROR) ERR(e);
+		addReferencePair(&ref, key, &oid);
+	}
+
+	for (i = 0; i < 2; i++) {
+		e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+		if (e < eNOERROR) ERR(e);
+
+		if (i == 0)
+			e = EduBtM_BuildIndex(&catalogEntry, &rootPid, &kdesc, NUMREFERENCEKEYS, 1, 90, 90, &dlPool, &dlHead);
+		else
+			e = EduBtM_BuildIndex(&catalogEntry, &rootPid, &kdesc, NUMBUILDRUNSIZE, 4, 90, 90, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testInsertObjects()
+ *================================*/
+/*
+ * Function: Four testInsertObjects(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test EduBtM_InsertObjects() with an unsorted batch into an index which
+ *  already holds half of the keys:
+ *  - into a unique index, the keys already in the index and the keys
+ *    repeated in the batch are inserted once; the first pair is kept
+ *  - into an index with duplicate keys, every pair is inserted except
+ *    those already in the index
+ *  The # of pairs inserted and the index are checked against the
+ *  reference set.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testInsertObjects(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the pair */
+	Four		nBatch;				/* # of pairs of the batch */
+	Four		nInserted;			/* # of pairs inserted by the batch */
+	Four		nExpected;			/* # of pairs the batch should insert */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < 2; i++) {
+		ref.longKeys = FALSE;
+		ref.nPairs = 0;
+		makeTestKeyDesc(FALSE, i == 0 ? TRUE : FALSE, &kdesc);
+
+		e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+		if (e < eNOERROR) ERR(e);
+
+		for (n = 0; n < NUMREFERENCEKEYS / 2; n++) {
+			makeTestObjectId(volId, n, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(n), &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		/* every key with a new ObjectID */
+		nBatch = 0;
+		for (n = 0; n < NUMREFERENCEKEYS; n++) {
+			makeReferenceKeyValue(&ref, makeReferenceKey(n), &testKvals[nBatch]);
+			makeTestObjectId(volId, NUMREFERENCEKEYS + n, &testOids[nBatch]);
+			if (i == 1 || n >= NUMREFERENCEKEYS / 2) addReferencePair(&ref, makeReferenceKey(n), &testOids[nBatch]);
+			nBatch++;
+		}
+		nExpected = i == 0 ? NUMREFERENCEKEYS / 2 : NUMREFERENCEKEYS;
+
+		/* the new keys once more for a unique index, the pairs in the index for the other */
+		for (n = 0; n < NUMREFERENCEKEYS / 4; n++) {
+			if (i == 0) {
+				makeReferenceKeyValue(&ref, makeReferenceKey(NUMREFERENCEKEYS / 2 + n), &testKvals[nBatch]);
+				makeTestObjectId(volId, 2 * NUMREFERENCEKEYS + n, &testOids[nBatch]);
+			}
+			else {
+				makeReferenceKeyValue(&ref, makeReferenceKey(n), &testKvals[nBatch]);
+				makeTestObjectId(volId, n, &testOids[nBatch]);
+			}
+			nBatch++;
+		}
+
+		e = EduBtM_InsertObjects(&catalogEntry, &rootPid, &kdesc, nBatch, testKvals, testOids, &nInserted, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+
+		if (nInserted > nExpected) analytics->numInsertDupButNoDup += nInserted - nExpected;
+		else if (nInserted < nExpected) analytics->numInsertNoDupButDup += nExpected - nInserted;
+
+		e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testDuplicateKeys()
+ *================================*/
+/*
+ * Function: Four testDuplicateKeys(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test an index with duplicate keys: NUMHEAVYKEYS keys get
+ *  NUMHEAVYOBJECTS ObjectIDs each, which go to overflow pages, and the
+ *  other keys one to three ObjectIDs in their leaf entries. The ObjectIDs
+ *  of a key are inserted in descending order. Half of the pairs are then
+ *  deleted again and again, until the lists of the heavy keys are back in
+ *  their leaves. The index is checked against the reference set after
+ *  each step, and the statistics should count the overflow lists.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testDuplicateKeys(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i, j;
+	Four		n;					/* # of the pair */
+	Four		key;				/* # of the key */
+	FileID		fid;				/* file of the index */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the index */
+	PhysicalIndexID	rootPid;		/* root page of the index */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	BtreeStats	stats;				/* statistics of the index */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, FALSE, &kdesc);
+
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	/* the pairs are numbered downwards, so that each key gets its ObjectIDs in descending order */
+	n = NUMREFERENCEPAIRS;
+	for (i = 0; i < NUMHEAVYOBJECTS; i++) {
+		for (key = 0; key < NUMHEAVYKEYS; key++) {
+			makeTestObjectId(volId, --n, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(NUMLIGHTKEYS + key), &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		/* two light keys between the ObjectIDs of the heavy ones */
+		for (key = 2 * i; key < 2 * i + 2; key++) {
+			for (j = 0; j <= key % 3; j++) {
+				makeTestObjectId(volId, --n, &oid);
+				e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(key), &oid);
+				if (e < eNOERROR) ERR(e);
+			}
+		}
+	}
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_GetStats(&rootPid, TRUE, &stats);
+	if (e < eNOERROR) ERR(e);
+	if (stats.nOverflowKeys != NUMHEAVYKEYS) analytics->numEtcError++;
+
+	/* the lists shrink from NUMHEAVYOBJECTS to a few ObjectIDs */
+	for (i = NUMHEAVYOBJECTS; i > 8; i /= 2) {
+		e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 2, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_GetStats(&rootPid, TRUE, &stats);
+	if (e < eNOERROR) ERR(e);
+	if (stats.nOverflowKeys != 0) analytics->numEtcError++;
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testBloomFilters()
+ *================================*/
+/*
+ * Function: Four testBloomFilters(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test unique indexes with a Bloom filter, with integer keys and with
+ *  long string keys. checkIndex() looks up every key of the reference set
+ *  and an absent key next to it, so the filter should answer most of the
+ *  absent keys without a false positive rate above 5%. A third of the keys
+ *  are then deleted, which makes the filter stale, and the index is
+ *  checked again.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testBloomFilters(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the pair */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	BtreeIndexParams params;		/* run-time parameters of the index tested */
+	BtreeBloomStats	bloomStats;		/* statistics of the Bloom filter */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < 2; i++) {
+		ref.longKeys = i == 1 ? TRUE : FALSE;
+		ref.nPairs = 0;
+		makeTestKeyDesc(ref.longKeys, TRUE, &kdesc);
+
+		e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_GetIndexParams(&rootPid, &params);
+		if (e < eNOERROR) ERR(e);
+		params.bloomBitsPerKey = 10;
+		e = EduBtM_SetIndexParams(&rootPid, &params);
+		if (e < eNOERROR) ERR(e);
+
+		for (n = 0; n < NUMREFERENCEKEYS; n++) {
+			makeTestObjectId(volId, n, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(n), &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_GetBloomStats(&rootPid, &bloomStats);
+		if (e < eNOERROR) ERR(e);
+		if (bloomStats.nNegatives < NUMREFERENCEKEYS / 2 || bloomStats.falsePositiveRate > 0.05)
+			analytics->numEtcError++;
+
+		e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 3, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testRangeScans()
+ *================================*/
+/*
+ * Function: Four testRangeScans(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test the range scans of an index with duplicate keys, some of whose
+ *  ObjectIDs are in overflow pages, by checkRangeScans(): the cursor, the
+ *  batch and the callback-parallel scans over ranges whose bounds are
+ *  keys in the index or keys between them, with every pair of operators.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testRangeScans(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i, j;
+	Four		n;					/* # of the pair */
+	Four		key;				/* key No. */
+	FileID		fid;				/* file of the index */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the index */
+	PhysicalIndexID	rootPid;		/* root page of the index */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+	Four		lowKeys[] = {0, 2 * (NUMREFERENCEKEYS / 4), 2 * (NUMREFERENCEKEYS / 4) + 1};
+	Four		highKeys[] = {2 * (NUMREFERENCEKEYS / 2), 2 * (NUMREFERENCEKEYS / 2) + 1, 2 * NUMREFERENCEKEYS};
+	Four		lowOps[] = {SM_BOF, SM_GE, SM_GT};
+	Four		highOps[] = {SM_EOF, SM_LE, SM_LT};
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, FALSE, &kdesc);
+
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	/* NUMHEAVYOBJECTS ObjectIDs for every 500th key, two for every other key, and one for the rest */
+	n = 0;
+	for (i = 0; i < NUMREFERENCEKEYS; i++) {
+		key = makeReferenceKey(i);
+		for (j = 0; j < (key % 1000 == 0 ? NUMHEAVYOBJECTS : (key % 4 == 0 ? 2 : 1)); j++) {
+			makeTestObjectId(volId, n++, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, key, &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+	}
+
+	sortReference(&ref);
+	for (i = 0; i < sizeof(lowOps) / sizeof(Four); i++) {
+		for (j = 0; j < sizeof(highOps) / sizeof(Four); j++) {
+			for (n = 0; n < sizeof(lowKeys) / sizeof(Four); n++) {
+				e = checkRangeScans(&rootPid, &kdesc, &ref, 0, lowKeys[n], lowOps[i], highKeys[n], highOps[j], analytics);
+				if (e < eNOERROR) ERR(e);
+			}
+		}
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testSnapshots()
+ *================================*/
+/*
+ * Function: Four testSnapshots(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test two snapshots of a unique index opened before rounds of deletions
+ *  and insertions which split and merge its pages. Each snapshot should
+ *  keep answering as the reference set of the time it was opened, while
+ *  the index answers as the current reference set.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testSnapshots(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		n;					/* # of the pair */
+	FileID		fid;				/* file of the index */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the index */
+	PhysicalIndexID	rootPid;		/* root page of the index */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	BtreeSnapshot	snapshots[2];	/* snapshots of the index */
+	struct referenceStruct ref;		/* pairs the index should hold */
+	struct referenceStruct snapshotRefs[2];	/* pairs the snapshots should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, TRUE, &kdesc);
+
+	e = EduBtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	for (n = 0; n < NUMREFERENCEKEYS / 2; n++) {
+		makeTestObjectId(volId, n, &oid);
+		e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(n), &oid);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_OpenSnapshot(&rootPid, &snapshots[0]);
+	if (e < eNOERROR) ERR(e);
+	snapshotRefs[0] = ref;
+
+	e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 3, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	for (n = NUMREFERENCEKEYS / 2; n < NUMREFERENCEKEYS; n++) {
+		makeTestObjectId(volId, n, &oid);
+		e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(n), &oid);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_OpenSnapshot(&rootPid, &snapshots[1]);
+	if (e < eNOERROR) ERR(e);
+	snapshotRefs[1] = ref;
+
+	e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 2, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	for (n = 0; n < 2; n++) {
+		e = checkSnapshot(&snapshots[n], &kdesc, &snapshotRefs[n], analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_CloseSnapshot(&snapshots[n]);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = checkIndex(&rootPid, &kdesc, &ref, 0, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testArtIndexes()
+ *================================*/
+/*
+ * Function: Four testArtIndexes(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test the indexes kept in adaptive radix trees (BTM_ART): a unique index
+ *  of integer keys, an index of integer keys with three ObjectIDs each,
+ *  and a unique index of long string keys. Every third pair is deleted
+ *  after the insertions, and the index is checked against the reference
+ *  set after each step; the batch and the parallel scans should be
+ *  refused.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testArtIndexes(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the pair */
+	FileID		fid;				/* file of the indexes */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the indexes */
+	PhysicalIndexID	rootPid;		/* root page of the index tested */
+	KeyDesc		kdesc;				/* key descriptor */
+	ObjectID	oid;				/* object id */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < 3; i++) {
+		ref.longKeys = i == 2 ? TRUE : FALSE;
+		ref.nPairs = 0;
+		makeTestKeyDesc(ref.longKeys, i == 1 ? FALSE : TRUE, &kdesc);
+
+		e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_ART);
+		if (e < eNOERROR) ERR(e);
+
+		for (n = 0; n < (i == 1 ? 3 * NUMREFERENCEKEYS / 2 : NUMREFERENCEKEYS); n++) {
+			makeTestObjectId(volId, n, &oid);
+			e = insertReferencePair(&catalogEntry, &rootPid, &kdesc, &ref, makeReferenceKey(i == 1 ? n % (NUMREFERENCEKEYS / 2) : n), &oid);
+			if (e < eNOERROR) ERR(e);
+		}
+
+		e = checkIndex(&rootPid, &kdesc, &ref, BTM_ART, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 3, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkIndex(&rootPid, &kdesc, &ref, BTM_ART, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * testClusteredIndexes()
+ *================================*/
+/*
+ * Function: Four testClusteredIndexes(Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Test a clustered index (BTM_CLUSTERED) whose pairs are inserted with
+ *  the records made by makeTestRecord(), some of which are too long to be
+ *  kept inline. Besides checkIndex(), the records returned by
+ *  EduBtM_FetchRecord() for every key and by a scan with
+ *  EduBtM_FetchNextRecord() should be those inserted. Every third pair is
+ *  then deleted, and the index is checked again.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four testClusteredIndexes(
+		Four volId,						/* IN volume ID */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four 		e;					/* for errors */
+	Four		i;
+	Four		n;					/* # of the pair */
+	FileID		fid;				/* file of the index */
+	ObjectID	catalogEntry;		/* catalog object of the file */
+	PhysicalFileID pFid;			/* physical file of the index */
+	PhysicalIndexID	rootPid;		/* root page of the index */
+	KeyDesc		kdesc;				/* key descriptor */
+	KeyValue	kval;				/* value of key */
+	KeyValue	startKval;			/* start value of key of a scan */
+	KeyValue	stopKval;			/* stop value of key of a scan */
+	ObjectID	oid;				/* object id */
+	BtreeCursor	cursor;				/* cursor of a scan */
+	BtreeCursor	next;				/* next cursor of a scan */
+	BtreeRecord	record;				/* record inserted */
+	BtreeRecord	fetched;			/* record returned */
+	struct referenceStruct ref;		/* pairs the index should hold */
+
+	e = createTestFile(volId, &fid, &catalogEntry, &pFid);
+	if (e < eNOERROR) ERR(e);
+
+	ref.longKeys = FALSE;
+	ref.nPairs = 0;
+	makeTestKeyDesc(FALSE, TRUE, &kdesc);
+
+	e = EduBtM_CreateIndexWithOptions(&catalogEntry, &rootPid, BTM_CLUSTERED);
+	if (e < eNOERROR) ERR(e);
+
+	for (n = 0; n < NUMREFERENCEKEYS; n++) {
+		makeReferenceKeyValue(&ref, makeReferenceKey(n), &kval);
+		makeTestObjectId(volId, n, &oid);
+		makeTestRecord(n, &record);
+		e = EduBtM_InsertRecord(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &record, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		addReferencePair(&ref, makeReferenceKey(n), &oid);
+	}
+
+	for (i = 0; i < 2; i++) {
+		e = checkIndex(&rootPid, &kdesc, &ref, BTM_CLUSTERED, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		/* the record of every key */
+		for (n = 0; n < ref.nPairs; n++) {
+			makeReferenceKeyValue(&ref, ref.pairs[n].key, &kval);
+			e = EduBtM_FetchRecord(&rootPid, &kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor, &fetched);
+			if (e < eNOERROR) ERR(e);
+
+			makeTestRecord(ref.pairs[n].oid.unique, &record);
+			if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+			else if (!sameTestRecord(&record, &fetched)) analytics->numScanNotSameObject++;
+		}
+
+		/* the records of a scan over the whole index */
+		makeReferenceKeyValue(&ref, 0, &startKval);
+		makeReferenceKeyValue(&ref, 2 * NUMREFERENCEKEYS, &stopKval);
+		n = 0;
+		e = EduBtM_FetchRecord(&rootPid, &kdesc, &startKval, SM_BOF, &stopKval, SM_EOF, &cursor, &fetched);
+		if (e < eNOERROR) ERR(e);
+		while (cursor.flag == CURSOR_ON && n < ref.nPairs) {
+			makeTestRecord(ref.pairs[n].oid.unique, &record);
+			if (memcmp(&cursor.oid, &ref.pairs[n].oid, sizeof(ObjectID)) != 0 || !sameTestRecord(&record, &fetched))
+				analytics->numScanNotSameObject++;
+			n++;
+
+			e = EduBtM_FetchNextRecord(&rootPid, &kdesc, &stopKval, SM_EOF, &cursor, &next, &fetched);
+			if (e < eNOERROR) ERR(e);
+			cursor = next;
+		}
+
+		if (cursor.flag == CURSOR_ON) analytics->numScanOvercount++;
+		else if (n < ref.nPairs) analytics->numScanUndercount++;
+
+		if (i == 0) {
+			e = deleteReferencePairs(&catalogEntry, &rootPid, &kdesc, &ref, 3, analytics);
+			if (e < eNOERROR) ERR(e);
+		}
+	}
+
+	e = EduBtM_DropIndex(&pFid, &rootPid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	e = SM_DestroyFile(&fid, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * makeLongKeyValue()
+ *================================*/
+/*
+ * Function: void makeLongKeyValue(Four, KeyValue*)
+ *
+ * Description :
+ *  Make the n-th key of testSmallPageDeletions() and of the reference sets
+ *  of long string keys: a string of NUMSMALLPAGEKEYLEN characters ending
+ *  with the number of the key, so that the keys are in the order of their
+ *  numbers.
+ *
+ * Returns:
+ *  None
+ */
+void makeLongKeyValue(
+		Four n,				/* IN # of the key */
+		KeyValue* kval		/* OUT value of key */
+	)
+{
+	Two length = NUMSMALLPAGEKEYLEN;
+	char str[NUMSMALLPAGEKEYLEN + 1];
+
+	memset(str, 'k', NUMSMALLPAGEKEYLEN);
+	sprintf(&str[NUMSMALLPAGEKEYLEN - 10], "%010ld", (long)n);
+	kval->len = sizeof(Two) + length;
+	memcpy(&(kval->val[0]), &length, sizeof(Two));
+	memcpy(&(kval->val[sizeof(Two)]), str, length);
+}
+
+
+/*@================================
+ * makeTestObjectId()
+ *================================*/
+/*
+ * Function: void makeTestObjectId(Four, Four, ObjectID*)
+ *
+ * Description :
+ *  Make the ObjectID of the n-th object inserted by the tests of the index
+ *  features, in the form execute() gives to the inserted objects.
+ *
+ * Returns:
+ *  None
+ */
+void makeTestObjectId(
+		Four volId,			/* IN volume ID */
+		Four n,				/* IN # of the object */
+		ObjectID* oid		/* OUT object id */
+	)
+{
+	oid->pageNo = 777;
+	oid->volNo = volId;
+	oid->slotNo = n;
+	oid->unique = n;
+}
+
+/*@================================
+ * createTestFile()
+ *================================*/
+/*
+ * Function: Four createTestFile(Four, FileID*, ObjectID*, PhysicalFileID*)
+ *
+ * Description :
+ *  Create a file for the indexes of a test and find its catalog object and
+ *  its physical file ID, which EduBtM_DropIndex() takes.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four createTestFile(
+		Four volId,						/* IN volume ID */
+		FileID* fid,					/* OUT file created */
+		ObjectID* catalogEntry,			/* OUT catalog object of the file */
+		PhysicalFileID* pFid			/* OUT physical file of the file */
+	)
+{
+	Four		e;					/* for errors */
+	ObjectID	*catObjForFile = catalogEntry;	/* for GET_PTR_TO_CATENTRY_FOR_BTREE() */
+	SlottedPage	*catPage;			/* buffer page containing the catalog object */
+	sm_CatOverlayForBtree *catEntry;	/* Btree part of the catalog entry */
+	PageID		catPid;				/* page of the catalog object */
+
+	e = SM_CreateFile(volId, fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, fid, catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	MAKE_PAGEID(catPid, catalogEntry->volNo, catalogEntry->pageNo);
+	e = BfM_GetTrain(&catPid, (char**)&catPage, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, catEntry);
+	MAKE_PHYSICALFILEID(*pFid, catEntry->fid.volNo, catEntry->firstPage);
+	e = BfM_FreeTrain(&catPid, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * makeTestKeyDesc()
+ *================================*/
+/*
+ * Function: void makeTestKeyDesc(Boolean, Boolean, KeyDesc*)
+ *
+ * Description :
+ *  Make the key descriptor of an index of integer keys, or of the long
+ *  string keys made by makeLongKeyValue().
+ *
+ * Returns:
+ *  None
+ */
+void makeTestKeyDesc(
+		Boolean longKeys,	/* IN TRUE for long string keys */
+		Boolean unique,		/* IN TRUE if the keys are unique */
+		KeyDesc* kdesc		/* OUT key descriptor */
+	)
+{
+	kdesc->flag = unique ? KEYFLAG_UNIQUE : 0;
+	kdesc->nparts = 1;
+	kdesc->kpart[0].type = longKeys ? SM_VARSTRING : SM_INT;
+	kdesc->kpart[0].offset = 0;
+	kdesc->kpart[0].length = longKeys ? NUMSMALLPAGEKEYLEN : sizeof(Four);
+}
+
+
+/*@================================
+ * makeReferenceKey()
+ *================================*/
+/*
+ * Function: Four makeReferenceKey(Four)
+ *
+ * Description :
+ *  Make the n-th key No. of the tests (0 <= n < NUMREFERENCEKEYS). The key
+ *  Nos. are the even numbers below 2 * NUMREFERENCEKEYS in a scrambled
+ *  order, so that the odd numbers are keys not in any index.
+ *
+ * Returns:
+ *  the key No.
+ */
+Four makeReferenceKey(
+		Four n				/* IN # of the key */
+	)
+{
+	return(2 * ((n * 7919) % NUMREFERENCEKEYS));
+}
+
+
+/*@================================
+ * makeReferenceKeyValue()
+ *================================*/
+/*
+ * Function: void makeReferenceKeyValue(struct referenceStruct*, Four, KeyValue*)
+ *
+ * Description :
+ *  Make the key value of a key No. of a reference set.
+ *
+ * Returns:
+ *  None
+ */
+void makeReferenceKeyValue(
+		struct referenceStruct* ref,	/* IN reference set */
+		Four key,						/* IN key No. */
+		KeyValue* kval					/* OUT value of key */
+	)
+{
+	if (ref->longKeys) makeLongKeyValue(key, kval);
+	else makeKeyValue(RANDINT, &key, NULL, kval);
+}
+
+
+/*@================================
+ * referenceKeyNo()
+ *================================*/
+/*
+ * Function: Four referenceKeyNo(struct referenceStruct*, char*)
+ *
+ * Description :
+ *  Get the key No. of a key value returned by an index, in the form made
+ *  by makeReferenceKeyValue().
+ *
+ * Returns:
+ *  the key No.
+ */
+Four referenceKeyNo(
+		struct referenceStruct* ref,	/* IN reference set */
+		char* kval						/* IN key value */
+	)
+{
+	Four key;
+	char str[11];
+
+	if (ref->longKeys) {
+		memcpy(str, &kval[sizeof(Two) + NUMSMALLPAGEKEYLEN - 10], 10);
+		str[10] = '\0';
+		key = atol(str);
+	}
+	else memcpy(&key, kval, sizeof(Four));
+
+	return(key);
+}
+
+
+/*@================================
+ * addReferencePair()
+ *================================*/
+/*
+ * Function: void addReferencePair(struct referenceStruct*, Four, ObjectID*)
+ *
+ * Description :
+ *  Add a pair to a reference set.
+ *
+ * Returns:
+ *  None
+ */
+void addReferencePair(
+		struct referenceStruct* ref,	/* INOUT reference set */
+		Four key,						/* IN key No. */
+		ObjectID* oid					/* IN object id */
+	)
+{
+	ref->pairs[ref->nPairs].key = key;
+	ref->pairs[ref->nPairs].oid = *oid;
+	ref->nPairs++;
+}
+
+
+/*@================================
+ * insertReferencePair()
+ *================================*/
+/*
+ * Function: Four insertReferencePair(ObjectID*, PageID*, KeyDesc*, struct referenceStruct*, Four, ObjectID*)
+ *
+ * Description :
+ *  Insert a pair into an index and add it to the reference set of the
+ *  index.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four insertReferencePair(
+		ObjectID* catalogEntry,			/* IN catalog object of the file */
+		PageID* root,					/* IN root page of the index */
+		KeyDesc* kdesc,					/* IN key descriptor */
+		struct referenceStruct* ref,	/* INOUT reference set */
+		Four key,						/* IN key No. */
+		ObjectID* oid					/* IN object id */
+	)
+{
+	Four		e;					/* for errors */
+	KeyValue	kval;				/* value of key */
+
+	makeReferenceKeyValue(ref, key, &kval);
+	e = EduBtM_InsertObject(catalogEntry, root, kdesc, &kval, oid, NULL, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	addReferencePair(ref, key, oid);
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * deleteReferencePairs()
+ *================================*/
+/*
+ * Function: Four deleteReferencePairs(ObjectID*, PageID*, KeyDesc*, struct referenceStruct*, Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Delete every 'step'-th pair of a reference set, starting with the
+ *  first one, from the index and from the reference set.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four deleteReferencePairs(
+		ObjectID* catalogEntry,			/* IN catalog object of the file */
+		PageID* root,					/* IN root page of the index */
+		KeyDesc* kdesc,					/* IN key descriptor */
+		struct referenceStruct* ref,	/* INOUT reference set */
+		Four step,						/* IN one pair out of 'step' is deleted */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four		e;					/* for errors */
+	Four		i;
+	Four		nLeft;				/* # of the pairs left */
+	KeyValue	kval;				/* value of key */
+
+	nLeft = 0;
+	for (i = 0; i < ref->nPairs; i++) {
+		if (i % step != 0) {
+			ref->pairs[nLeft++] = ref->pairs[i];
+			continue;
+		}
+
+		makeReferenceKeyValue(ref, ref->pairs[i].key, &kval);
+		e = EduBtM_DeleteObject(catalogEntry, root, kdesc, &kval, &ref->pairs[i].oid, &dlPool, &dlHead);
+		if (e == eNOTFOUND_BTM) analytics->numDeleteNoExistButExist++;
+		else if (e < eNOERROR) ERR(e);
+	}
+	ref->nPairs = nLeft;
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * compareReferencePairs()
+ *================================*/
+/*
+ * Function: int compareReferencePairs(const void*, const void*)
+ *
+ * Description :
+ *  Compare two pairs of a reference set in the order of an index scan: by
+ *  key No., and then by ObjectID.
+ *
+ * Returns:
+ *  negative, 0, or positive as the first pair is before, the same as, or
+ *  after the second one
+ */
+int compareReferencePairs(
+		const void* p1,			/* IN a pair */
+		const void* p2			/* IN another pair */
+	)
+{
+	const struct referencePairStruct *pair1 = p1;
+	const struct referencePairStruct *pair2 = p2;
+
+	if (pair1->key != pair2->key) return(pair1->key < pair2->key ? -1 : 1);
+	if (pair1->oid.volNo != pair2->oid.volNo) return(pair1->oid.volNo < pair2->oid.volNo ? -1 : 1);
+	if (pair1->oid.pageNo != pair2->oid.pageNo) return(pair1->oid.pageNo < pair2->oid.pageNo ? -1 : 1);
+	if (pair1->oid.slotNo != pair2->oid.slotNo) return(pair1->oid.slotNo < pair2->oid.slotNo ? -1 : 1);
+	return(0);
+}
+
+
+/*@================================
+ * sortReference()
+ *================================*/
+/*
+ * Function: void sortReference(struct referenceStruct*)
+ *
+ * Description :
+ *  Sort the pairs of a reference set in the order of an index scan.
+ *
+ * Returns:
+ *  None
+ */
+void sortReference(
+		struct referenceStruct* ref		/* INOUT reference set */
+	)
+{
+	qsort(ref->pairs, ref->nPairs, sizeof(struct referencePairStruct), compareReferencePairs);
+}
+
+
+/*@================================
+ * findReferencePair()
+ *================================*/
+/*
+ * Function: Four findReferencePair(struct referenceStruct*, char*, ObjectID*)
+ *
+ * Description :
+ *  Find an entry returned by an index in a sorted reference set.
+ *
+ * Returns:
+ *  the position of the pair, or NIL if it is not in the reference set
+ */
+Four findReferencePair(
+		struct referenceStruct* ref,	/* IN sorted reference set */
+		char* kval,						/* IN key value of the entry */
+		ObjectID* oid					/* IN object id of the entry */
+	)
+{
+	struct referencePairStruct pair;	/* the pair looked for */
+	struct referencePairStruct *found;	/* the pair found */
+
+	pair.key = referenceKeyNo(ref, kval);
+	pair.oid = *oid;
+	found = bsearch(&pair, ref->pairs, ref->nPairs, sizeof(struct referencePairStruct), compareReferencePairs);
+
+	return(found == NULL ? NIL : found - ref->pairs);
+}
+
+
+/*@================================
+ * sameReferencePair()
+ *================================*/
+/*
+ * Function: Boolean sameReferencePair(struct referenceStruct*, Four, char*, ObjectID*)
+ *
+ * Description :
+ *  Tell whether an entry returned by an index is the pair at 'pos' of a
+ *  reference set.
+ *
+ * Returns:
+ *  TRUE if the entry is the pair
+ */
+Boolean sameReferencePair(
+		struct referenceStruct* ref,	/* IN reference set */
+		Four pos,						/* IN position of the pair */
+		char* kval,						/* IN key value of the entry */
+		ObjectID* oid					/* IN object id of the entry */
+	)
+{
+	return(referenceKeyNo(ref, kval) == ref->pairs[pos].key &&
+		   memcmp(oid, &ref->pairs[pos].oid, sizeof(ObjectID)) == 0 ? TRUE : FALSE);
+}
+
+
+/*@================================
+ * checkIndex()
+ *================================*/
+/*
+ * Function: Four checkIndex(PageID*, KeyDesc*, struct referenceStruct*, Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Check an index against its reference set, which is sorted first:
+ *  - fetch: every key should be found with its first ObjectID, and the
+ *    odd key after it should not be found
+ *  - scan: the scans of checkRangeScans() over the whole index and over
+ *    two ranges in the middle should return the pairs of the ranges
+ *  - stats: the exact statistics should count the keys and the pairs
+ *  'options' are those the index was created with.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four checkIndex(
+		PageID* root,					/* IN root page of the index */
+		KeyDesc* kdesc,					/* IN key descriptor */
+		struct referenceStruct* ref,	/* INOUT reference set; sorted */
+		Four options,					/* IN options of the index */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four		e;					/* for errors */
+	Four		i;
+	Four		nKeys;				/* # of keys of the reference set */
+	Four		lowKey, highKey;	/* bounds of a range */
+	KeyValue	kval;				/* value of key */
+	BtreeCursor	cursor;				/* cursor of a search */
+	BtreeStats	stats;				/* statistics of the index */
+
+	sortReference(ref);
+
+	nKeys = 0;
+	for (i = 0; i < ref->nPairs; i++) {
+		if (i > 0 && ref->pairs[i].key == ref->pairs[i - 1].key) continue;
+		nKeys++;
+
+		makeReferenceKeyValue(ref, ref->pairs[i].key, &kval);
+		e = EduBtM_Fetch(root, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+		else if (memcmp(&cursor.oid, &ref->pairs[i].oid, sizeof(ObjectID)) != 0) analytics->numScanNotSameObject++;
+
+		makeReferenceKeyValue(ref, ref->pairs[i].key + 1, &kval);
+		e = EduBtM_Fetch(root, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		if (cursor.flag == CURSOR_ON) analytics->numScanNotFoundButFound++;
+	}
+
+	e = checkRangeScans(root, kdesc, ref, options, 0, SM_BOF, 2 * NUMREFERENCEKEYS, SM_EOF, analytics);
+	if (e < eNOERROR) ERR(e);
+
+	if (ref->nPairs > 0) {
+		lowKey = ref->pairs[ref->nPairs / 4].key;
+		highKey = ref->pairs[3 * ref->nPairs / 4].key;
+
+		e = checkRangeScans(root, kdesc, ref, options, lowKey, SM_GE, highKey, SM_LT, analytics);
+		if (e < eNOERROR) ERR(e);
+
+		e = checkRangeScans(root, kdesc, ref, options, lowKey, SM_GT, highKey + 1, SM_LE, analytics);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBtM_GetStats(root, TRUE, &stats);
+	if (e < eNOERROR) ERR(e);
+	if (stats.nKeys != nKeys || stats.nObjects != ref->nPairs) analytics->numEtcError++;
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * checkRangeScans()
+ *================================*/
+/*
+ * Function: Four checkRangeScans(PageID*, KeyDesc*, struct referenceStruct*, Four,
+ *                                Four, Four, Four, Four, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Check the scans of an index over the range given by a lower bound
+ *  (SM_BOF, SM_GE, or SM_GT) and an upper bound (SM_EOF, SM_LE, or SM_LT)
+ *  against the pairs of a sorted reference set in the range: the forward
+ *  and the backward scans by EduBtM_FetchNext(), the forward and the
+ *  backward batch scans by EduBtM_FetchNextBatch(), and the
+ *  callback-parallel scan. An index kept in an adaptive radix tree should
+ *  refuse the last two.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four checkRangeScans(
+		PageID* root,					/* IN root page of the index */
+		KeyDesc* kdesc,					/* IN key descriptor */
+		struct referenceStruct* ref,	/* IN sorted reference set */
+		Four options,					/* IN options of the index */
+		Four lowKey,					/* IN key No. of the lower bound */
+		Four lowOp,						/* IN comparison operator of the lower bound */
+		Four highKey,					/* IN key No. of the upper bound */
+		Four highOp,					/* IN comparison operator of the upper bound */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four		e;					/* for errors */
+	Four		i, j, k;
+	Four		n;					/* # of entries returned by a batch */
+	Four		first;				/* position of the first pair in the range */
+	Four		end;				/* position after the last pair in the range */
+	Four		key;				/* key No. */
+	KeyValue	lowKval;			/* value of key of the lower bound */
+	KeyValue	highKval;			/* value of key of the upper bound */
+	BtreeCursor	cursor;				/* cursor of a scan */
+	BtreeCursor	next;				/* next cursor of a scan */
+	BtreeScan	scan;				/* a batch scan */
+	BtreeScanItem items[NUMSCANBATCHITEMS];	/* entries of a batch */
+	struct parallelScanStruct pscan;	/* entries found by the parallel scan */
+
+	first = end = 0;
+	for (i = 0; i < ref->nPairs; i++) {
+		key = ref->pairs[i].key;
+		if ((lowOp == SM_GE && key < lowKey) || (lowOp == SM_GT && key <= lowKey)) first = i + 1;
+		if (!(highOp == SM_LE && key > highKey) && !(highOp == SM_LT && key >= highKey)) end = i + 1;
+	}
+	if (end < first) end = first;
+
+	makeReferenceKeyValue(ref, lowKey, &lowKval);
+	makeReferenceKeyValue(ref, highKey, &highKval);
+
+	/* forward and backward scans by EduBtM_FetchNext() */
+	for (j = 0; j < 2; j++) {
+		if (j == 0) {
+			i = first;
+			e = EduBtM_Fetch(root, kdesc, &lowKval, lowOp, &highKval, highOp, &cursor);
+		}
+		else {
+			i = end - 1;
+			e = EduBtM_Fetch(root, kdesc, &highKval, highOp, &lowKval, lowOp, &cursor);
+		}
+		if (e < eNOERROR) ERR(e);
+
+		while (cursor.flag == CURSOR_ON && i >= first && i < end) {
+			if (!sameReferencePair(ref, i, cursor.key.val, &cursor.oid)) analytics->numScanNotSameObject++;
+			i += (j == 0) ? 1 : -1;
+
+			if (j == 0)
+				e = EduBtM_FetchNext(root, kdesc, &highKval, highOp, &cursor, &next);
+			else
+				e = EduBtM_FetchNext(root, kdesc, &lowKval, lowOp, &cursor, &next);
+			if (e < eNOERROR) ERR(e);
+			cursor = next;
+		}
+
+		if (cursor.flag == CURSOR_ON) analytics->numScanOvercount++;
+		else if (i >= first && i < end) analytics->numScanUndercount++;
+	}
+
+	/* forward and backward batch scans */
+	for (j = 0; j < 2; j++) {
+		if (j == 0) {
+			i = first;
+			e = EduBtM_OpenScan(root, kdesc, &lowKval, lowOp, &highKval, highOp, &scan);
+		}
+		else {
+			i = end - 1;
+			e = EduBtM_OpenScan(root, kdesc, &highKval, highOp, &lowKval, lowOp, &scan);
+		}
+		if (options & BTM_ART) {
+			if (e != eNOTSUPPORTED_EDUBTM) analytics->numEtcError++;
+			if (e == eNOERROR) EduBtM_CloseScan(&scan);
+			break;
+		}
+		if (e < eNOERROR) ERR(e);
+
+		while ((n = EduBtM_FetchNextBatch(&scan, NUMSCANBATCHITEMS, items)) > 0) {
+			for (k = 0; k < n; k++) {
+				if (i < first || i >= end) analytics->numScanOvercount++;
+				else if (!sameReferencePair(ref, i, items[k].kval, &items[k].oid)) analytics->numScanNotSameObject++;
+				i += (j == 0) ? 1 : -1;
+			}
+		}
+		if (n < eNOERROR) ERR(n);
+		if (i >= first && i < end) analytics->numScanUndercount++;
+
+		e = EduBtM_CloseScan(&scan);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	/* the callback-parallel scan */
+	memset(&pscan, 0, sizeof(pscan));
+	pscan.ref = ref;
+	e = EduBtM_CallbackParallelScan(root, kdesc, &lowKval, lowOp, &highKval, highOp,
+									NUMPARALLELSCANWORKERS, collectParallelScan, &pscan);
+	if (options & BTM_ART) {
+		if (e != eNOTSUPPORTED_EDUBTM) analytics->numEtcError++;
+		return(eNOERROR);
+	}
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < ref->nPairs; i++) {
+		if (i >= first && i < end && pscan.seen[i] == 0) analytics->numScanUndercount++;
+		else if (pscan.seen[i] > (i >= first && i < end ? 1 : 0)) analytics->numScanOvercount++;
+	}
+	for (i = 0; i < NUMPARALLELSCANWORKERS; i++) {
+		analytics->numScanOvercount += pscan.nUnknown[i];
+		analytics->numScanNotSameObject += pscan.nUnordered[i];
+	}
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * collectParallelScan()
+ *================================*/
+/*
+ * Function: Four collectParallelScan(void*, Four, Four, BtreeScanItem*)
+ *
+ * Description :
+ *  Callback of the callback-parallel scan of checkRangeScans(): mark the
+ *  pairs of the reference set found by a worker, and count the entries
+ *  which are not in the reference set or not in key order in the batch.
+ *  The workers mark different pairs unless an entry is returned twice.
+ *
+ * Returns:
+ *  eNOERROR
+ */
+Four collectParallelScan(
+		void* arg,						/* IN the struct parallelScanStruct */
+		Four worker,					/* IN No. of the worker */
+		Four nItems,					/* IN # of entries of the batch */
+		BtreeScanItem* items			/* IN entries of the batch */
+	)
+{
+	struct parallelScanStruct *pscan = arg;
+	Four i;
+	Four pos;						/* position of an entry in the reference set */
+	Four prev = NIL;				/* position of the previous entry of the batch */
+
+	for (i = 0; i < nItems; i++) {
+		pos = findReferencePair(pscan->ref, items[i].kval, &items[i].oid);
+		if (pos == NIL) {
+			pscan->nUnknown[worker]++;
+			continue;
+		}
+
+		if (pos < prev) pscan->nUnordered[worker]++;
+		pscan->seen[pos]++;
+		prev = pos;
+	}
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * checkSnapshot()
+ *================================*/
+/*
+ * Function: Four checkSnapshot(BtreeSnapshot*, KeyDesc*, struct referenceStruct*, struct AnalyticsStruct*)
+ *
+ * Description :
+ *  Check a snapshot of an index against the reference set of the time it
+ *  was opened, as checkIndex() does: every key should be found with its
+ *  first ObjectID and the odd key after it should not, and the forward and
+ *  the backward scans of the whole snapshot should return all the pairs.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four checkSnapshot(
+		BtreeSnapshot* snapshot,		/* IN snapshot of the index */
+		KeyDesc* kdesc,					/* IN key descriptor */
+		struct referenceStruct* ref,	/* INOUT reference set; sorted */
+		struct AnalyticsStruct* analytics	/* INOUT coverage analytics */
+	)
+{
+	Four		e;					/* for errors */
+	Four		i, j;
+	KeyValue	kval;				/* value of key */
+	KeyValue	startKval;			/* start value of key of a scan */
+	KeyValue	stopKval;			/* stop value of key of a scan */
+	BtreeCursor	cursor;				/* cursor of a scan */
+	BtreeCursor	next;				/* next cursor of a scan */
+
+	sortReference(ref);
+
+	for (i = 0; i < ref->nPairs; i++) {
+		if (i > 0 && ref->pairs[i].key == ref->pairs[i - 1].key) continue;
+
+		makeReferenceKeyValue(ref, ref->pairs[i].key, &kval);
+		e = EduBtM_SnapshotFetch(snapshot, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		if (cursor.flag != CURSOR_ON) analytics->numScanFoundButNotFound++;
+		else if (memcmp(&cursor.oid, &ref->pairs[i].oid, sizeof(ObjectID)) != 0) analytics->numScanNotSameObject++;
+
+		makeReferenceKeyValue(ref, ref->pairs[i].key + 1, &kval);
+		e = EduBtM_SnapshotFetch(snapshot, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+		if (cursor.flag == CURSOR_ON) analytics->numScanNotFoundButFound++;
+	}
+
+	makeReferenceKeyValue(ref, 0, &startKval);
+	makeReferenceKeyValue(ref, 2 * NUMREFERENCEKEYS, &stopKval);
+	for (j = 0; j < 2; j++) {
+		if (j == 0) {
+			i = 0;
+			e = EduBtM_SnapshotFetch(snapshot, kdesc, &startKval, SM_BOF, &stopKval, SM_EOF, &cursor);
+		}
+		else {
+			i = ref->nPairs - 1;
+			e = EduBtM_SnapshotFetch(snapshot, kdesc, &stopKval, SM_EOF, &startKval, SM_BOF, &cursor);
+		}
+		if (e < eNOERROR) ERR(e);
+
+		while (cursor.flag == CURSOR_ON && i >= 0 && i < ref->nPairs) {
+			if (!sameReferencePair(ref, i, cursor.key.val, &cursor.oid)) analytics->numScanNotSameObject++;
+			i += (j == 0) ? 1 : -1;
+
+			if (j == 0)
+				e = EduBtM_SnapshotFetchNext(snapshot, kdesc, &stopKval, SM_EOF, &cursor, &next);
+			else
+				e = EduBtM_SnapshotFetchNext(snapshot, kdesc, &startKval, SM_BOF, &cursor, &next);
+			if (e < eNOERROR) ERR(e);
+			cursor = next;
+		}
+
+		if (cursor.flag == CURSOR_ON) analytics->numScanOvercount++;
+		else if (i >= 0 && i < ref->nPairs) analytics->numScanUndercount++;
+	}
+
+	return(eNOERROR);
+}
+
+
+/*@================================
+ * makeTestRecord()
+ *================================*/
+/*
+ * Function: void makeTestRecord(Four, BtreeRecord*)
+ *
+ * Description :
+ *  Make the record of the n-th object inserted by testClusteredIndexes().
+ *  The lengths go up to 64 bytes beyond the default 'inlineRecordMax', so
+ *  that some of the records are not kept in the index.
+ *
+ * Returns:
+ *  None
+ */
+void makeTestRecord(
+		Four n,				/* IN # of the object */
+		BtreeRecord* record	/* OUT record of the object */
+	)
+{
+	Four i;
+
+	record->len = (n * 37) % (BTM_DEFAULT_INLINERECORDMAX + 64);
+	for (i = 0; i < record->len; i++)
+		record->data[i] = (char)(n + i);
+}
+
+
+/*@================================
+ * sameTestRecord()
+ *================================*/
+/*
+ * Function: Boolean sameTestRecord(BtreeRecord*, BtreeRecord*)
+ *
+ * Description :
+ *  Tell whether a record returned by a clustered index is the record
+ *  inserted, which is not kept if it is longer than 'inlineRecordMax'.
+ *
+ * Returns:
+ *  TRUE if the record returned is right
+ */
+Boolean sameTestRecord(
+		BtreeRecord* inserted,	/* IN record inserted */
+		BtreeRecord* fetched	/* IN record returned */
+	)
+{
+	if (inserted->len > BTM_DEFAULT_INLINERECORDMAX) return(fetched->len == NIL ? TRUE : FALSE);
+
+	return(fetched->len == inserted->len && memcmp(fetched->data, inserted->data, inserted->len) == 0 ? TRUE : FALSE);
+}
+
+
 /*@================================
  * dumpBtreePage()
  *================================*/
@@ -0,0 +1,512 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_WorkloadGen.c
+ *
+ * Description : 
+ *  Generate workload files in the format of test/workloads in the manner
+ *  of YCSB. The load file inserts the records; the transaction file holds
+ *  the operations of one of the YCSB core workloads, written as:
+ *    read     SCAN EQ key EQ key
+ *    update   DELETE key
+ *             INSERT key
+ *    insert   INSERT newkey
+ *    scan     SCAN EQ key EOF length
+ *  The records are numbered in the order of insertion, and the number of a
+ *  record is turned into its key by the key type. The records accessed are
+ *  chosen by a request distribution over the numbers. The output depends
+ *  only on the options and the seed.
+ *
+ * Usage:
+ *  EduBtM_WorkloadGen [-w a|b|c|d|e] [-m read,update,insert,scan] [-r records]
+ *                     [-n operations] [-k rand_int|mono_inc|email]
+ *                     [-d uniform|zipfian|latest|hotspot] [-t theta]
+ *                     [-h hotDataFraction] [-H hotOpnFraction] [-l maxScanLength]
+ *                     [-s seed] [-L loadFile] [-T txnsFile]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <math.h>
+#include "EduBtM_common.h"
+
+
+#define GEN_NOPS			4			/* read, update, insert and scan */
+#define GEN_MAXKEY			60			/* size of a key string; MAXKEY of EduBtM_Test */
+#define GEN_BUFSIZE			(1 << 20)	/* output buffer of a file */
+
+typedef enum { GEN_READ=0, GEN_UPDATE=1, GEN_INSERT=2, GEN_SCAN=3 } GenOp;
+typedef enum { GEN_RANDINT=0, GEN_MONOINT=1, GEN_EMAIL=2 } GenKeyType;
+typedef enum { GEN_UNIFORM=0, GEN_ZIPFIAN=1, GEN_LATEST=2, GEN_HOTSPOT=3 } GenDistribution;
+
+/* Zipfian generator of Gray et al., "Quickly Generating Billion-Record Synthetic Databases" */
+struct genZipfian {
+	double		theta;					/* skew; 0 < theta < 1 */
+	uint64_t	n;						/* # of items */
+	double		zetan;					/* zeta(n, theta) */
+	double		zeta2;					/* zeta(2, theta) */
+	double		alpha;					/* 1 / (1 - theta) */
+	double		eta;
+};
+
+/* YCSB core workloads: % of read, update, insert and scan */
+static const Four genMixes[5][GEN_NOPS] = {
+	{ 50, 50,  0,  0 },					/* A: update heavy */
+	{ 95,  5,  0,  0 },					/* B: read mostly */
+	{ 100, 0,  0,  0 },					/* C: read only */
+	{ 95,  0,  5,  0 },					/* D: read latest */
+	{  0,  0,  5, 95 }					/* E: short ranges */
+};
+
+static const char *genSyllables[] = {
+	"an", "be", "chi", "da", "el", "fo", "ga", "hu", "in", "jo", "ka", "li",
+	"mo", "na", "or", "pe", "qu", "ro", "sa", "ti", "ul", "vi", "wa", "yo"
+};
+static const char *genDomains[] = {
+	"yahoo.com", "hotmail.com", "gmail.com", "aol.com", "sbcglobal.net", "comcast.net"
+};
+
+#define GEN_NSYLLABLES		(sizeof(genSyllables) / sizeof(genSyllables[0]))
+#define GEN_NDOMAINS		(sizeof(genDomains) / sizeof(genDomains[0]))
+
+static uint64_t genState;				/* state of the random number generator */
+
+uint64_t genRandom(void);
+double genRandom01(void);
+uint64_t genHash(uint64_t);
+void genInitZipfian(struct genZipfian*, uint64_t, double);
+void genGrowZipfian(struct genZipfian*, uint64_t);
+uint64_t genNextZipfian(struct genZipfian*);
+uint64_t genChooseRecord(GenDistribution, struct genZipfian*, uint64_t, double, double);
+void genWriteKey(FILE*, GenKeyType, uint64_t);
+
+
+
+/*@================================
+ * main()
+ *================================*/
+/*
+ * Function: Four main(int, char**)
+ *
+ * Description:
+ *  Parse the options and write the load and transaction files.
+ *
+ * Returns:
+ *  0 on success, 1 on failure
+ */
+Four main(
+		int		argc,				/* IN # of arguments */
+		char	**argv)				/* IN arguments */
+{
+	int				c;								/* option character */
+	Four			mix[GEN_NOPS];					/* % of each operation */
+	Four			spec = 0;						/* YCSB workload; 0 is A */
+	Boolean			mixGiven = FALSE;				/* TRUE if -m is given */
+	Boolean			distGiven = FALSE;				/* TRUE if -d is given */
+	uint64_t		nRecords = 1000;				/* # of records loaded */
+	uint64_t		nOps = 1000;					/* # of operations */
+	uint64_t		nKeys;							/* # of records inserted so far */
+	uint64_t		op;								/* operation number */
+	uint64_t		rec;							/* a record number */
+	GenKeyType		keyType = GEN_RANDINT;			/* key type */
+	GenDistribution	dist = GEN_ZIPFIAN;				/* request distribution */
+	double			theta = 0.99;					/* skew of the zipfian distributions */
+	double			hotData = 0.2;					/* fraction of the records which are hot */
+	double			hotOpn = 0.8;					/* fraction of the operations on the hot records */
+	Four			maxScanLength = 100;			/* max # of objects of a scan */
+	uint64_t		seed = 1;						/* seed of the random numbers */
+	char			*loadName = "load.dat";			/* load file */
+	char			*txnsName = "txns.dat";			/* transaction file */
+	FILE			*loadFp, *txnsFp;				/* output files */
+	double			u;								/* a random number in [0, 1) */
+	Four			choice;							/* chosen operation */
+	struct genZipfian	zipf;						/* zipfian generator over the records */
+
+	while ((c = getopt(argc, argv, "w:m:r:n:k:d:t:h:H:l:s:L:T:")) != -1) {
+		switch (c) {
+			case 'w': spec = optarg[0] >= 'a' ? optarg[0] - 'a' : optarg[0] - 'A'; break;
+			case 'm':
+				mixGiven = sscanf(optarg, "%d,%d,%d,%d", &mix[0], &mix[1], &mix[2], &mix[3]) == GEN_NOPS;
+				if (!mixGiven) spec = -1;
+				break;
+			case 'r': nRecords = strtoull(optarg, NULL, 10); break;
+			case 'n': nOps = strtoull(optarg, NULL, 10); break;
+			case 'k':
+				keyType = strcmp(optarg, "email") == 0 ? GEN_EMAIL :
+						  strcmp(optarg, "mono_inc") == 0 ? GEN_MONOINT : GEN_RANDINT;
+				break;
+			case 'd':
+				distGiven = TRUE;
+				dist = strcmp(optarg, "uniform") == 0 ? GEN_UNIFORM : strcmp(optarg, "latest") == 0 ? GEN_LATEST :
+					   strcmp(optarg, "hotspot") == 0 ? GEN_HOTSPOT : GEN_ZIPFIAN;
+				break;
+			case 't': theta = atof(optarg); break;
+			case 'h': hotData = atof(optarg); break;
+			case 'H': hotOpn = atof(optarg); break;
+			case 'l': maxScanLength = atoi(optarg); break;
+			case 's': seed = strtoull(optarg, NULL, 10); break;
+			case 'L': loadName = optarg; break;
+			case 'T': txnsName = optarg; break;
+			default: spec = -1; break;
+		}
+	}
+
+	if (spec < 0 || spec > 4 || nRecords < 1 || theta <= 0.0 || theta >= 1.0 || maxScanLength < 1 ||
+		hotData <= 0.0 || hotData >= 1.0 || hotOpn < 0.0 || hotOpn > 1.0) {
+		fprintf(stderr, "usage: %s [-w a|b|c|d|e] [-m read,update,insert,scan] [-r records] [-n operations]\n"
+				"\t[-k rand_int|mono_inc|email] [-d uniform|zipfian|latest|hotspot] [-t theta (0..1)]\n"
+				"\t[-h hotDataFraction] [-H hotOpnFraction] [-l maxScanLength] [-s seed] [-L loadFile] [-T txnsFile]\n",
+				argv[0]);
+		return(1);
+	}
+
+	if (!mixGiven) memcpy(mix, genMixes[spec], sizeof(mix));
+	if (mix[0] + mix[1] + mix[2] + mix[3] != 100) {
+		fprintf(stderr, "the operation mix should add up to 100\n");
+		return(1);
+	}
+	/* YCSB D reads the records inserted last */
+	if (!distGiven && !mixGiven && spec == 3) dist = GEN_LATEST;
+
+	loadFp = fopen(loadName, "w");
+	txnsFp = fopen(txnsName, "w");
+	if (loadFp == NULL || txnsFp == NULL) {
+		fprintf(stderr, "cannot open the output files\n");
+		return(1);
+	}
+	setvbuf(loadFp, NULL, _IOFBF, GEN_BUFSIZE);
+	setvbuf(txnsFp, NULL, _IOFBF, GEN_BUFSIZE);
+
+	genState = seed;
+
+	/*@ load */
+	for (rec = 0; rec < nRecords; rec++) {
+		fputs("INSERT ", loadFp);
+		genWriteKey(loadFp, keyType, rec);
+		fputc('\n', loadFp);
+	}
+
+	/*@ transactions */
+	nKeys = nRecords;
+	genInitZipfian(&zipf, nKeys, theta);
+
+	for (op = 0; op < nOps; op++) {
+		u = genRandom01() * 100.0;
+		for (choice = 0; choice < GEN_NOPS - 1 && u >= mix[choice]; choice++) u -= mix[choice];
+
+		if (choice == GEN_INSERT) {
+			fputs("INSERT ", txnsFp);
+			genWriteKey(txnsFp, keyType, nKeys++);
+			fputc('\n', txnsFp);
+			if (dist == GEN_ZIPFIAN || dist == GEN_LATEST) genGrowZipfian(&zipf, nKeys);
+			continue;
+		}
+
+		rec = genChooseRecord(dist, &zipf, nKeys, hotData, hotOpn);
+
+		switch (choice) {
+			case GEN_READ:
+				fputs("SCAN EQ ", txnsFp);
+				genWriteKey(txnsFp, keyType, rec);
+				fputs(" EQ ", txnsFp);
+				genWriteKey(txnsFp, keyType, rec);
+				fputc('\n', txnsFp);
+				break;
+
+			case GEN_UPDATE:
+				fputs("DELETE ", txnsFp);
+				genWriteKey(txnsFp, keyType, rec);
+				fputs("\nINSERT ", txnsFp);
+				genWriteKey(txnsFp, keyType, rec);
+				fputc('\n', txnsFp);
+				break;
+
+			case GEN_SCAN:
+				fputs("SCAN EQ ", txnsFp);
+				genWriteKey(txnsFp, keyType, rec);
+				fprintf(txnsFp, " EOF %d\n", (Four)(genRandom() % maxScanLength) + 1);
+				break;
+		}
+	}
+
+	if (fclose(loadFp) != 0 || fclose(txnsFp) != 0) {
+		fprintf(stderr, "cannot write the output files\n");
+		return(1);
+	}
+
+	return(0);
+}
+
+
+
+/*@================================
+ * genRandom()
+ *================================*/
+/*
+ * Function: uint64_t genRandom(void)
+ *
+ * Description:
+ *  Return the next 64-bit random number of the splitmix64 generator.
+ *
+ * Returns:
+ *  a random number
+ */
+uint64_t genRandom(void)
+{
+	genState += 0x9E3779B97F4A7C15ULL;
+
+	return(genHash(genState));
+}
+
+
+
+/*@================================
+ * genRandom01()
+ *================================*/
+/*
+ * Function: double genRandom01(void)
+ *
+ * Description:
+ *  Return a random number uniformly distributed in [0, 1).
+ *
+ * Returns:
+ *  a random number
+ */
+double genRandom01(void)
+{
+	return((genRandom() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+
+
+/*@================================
+ * genHash()
+ *================================*/
+/*
+ * Function: uint64_t genHash(uint64_t)
+ *
+ * Description:
+ *  Mix the bits of a number; the mixing function of splitmix64, which is a
+ *  one-to-one mapping of the 64-bit numbers.
+ *
+ * Returns:
+ *  the mixed number
+ */
+uint64_t genHash(
+		uint64_t	x)					/* IN number to mix */
+{
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+	return(x ^ (x >> 31));
+}
+
+
+
+/*@================================
+ * genInitZipfian()
+ *================================*/
+/*
+ * Function: void genInitZipfian(struct genZipfian*, uint64_t, double)
+ *
+ * Description:
+ *  Initialize a zipfian generator over 'n' items. It takes O(n) to compute
+ *  zeta(n, theta).
+ *
+ * Returns:
+ *  None
+ */
+void genInitZipfian(
+		struct genZipfian	*z,			/* OUT generator */
+		uint64_t			n,			/* IN # of items */
+		double				theta)		/* IN skew */
+{
+	uint64_t	i;						/* item */
+
+	z->theta = theta;
+	z->n = 0;
+	z->zetan = 0.0;
+	z->zeta2 = 1.0 + pow(0.5, theta);
+	z->alpha = 1.0 / (1.0 - theta);
+	for (i = 1; i <= n; i++) z->zetan += pow((double)i, -theta);
+	z->n = n;
+	z->eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - z->zeta2 / z->zetan);
+}
+
+
+
+/*@================================
+ * genGrowZipfian()
+ *================================*/
+/*
+ * Function: void genGrowZipfian(struct genZipfian*, uint64_t)
+ *
+ * Description:
+ *  Extend the generator to 'n' items, adding the new items to zeta(n).
+ *
+ * Returns:
+ *  None
+ */
+void genGrowZipfian(
+		struct genZipfian	*z,			/* INOUT generator */
+		uint64_t			n)			/* IN new # of items */
+{
+	uint64_t	i;						/* item */
+
+	for (i = z->n + 1; i <= n; i++) z->zetan += pow((double)i, -z->theta);
+	z->n = n;
+	z->eta = (1.0 - pow(2.0 / n, 1.0 - z->theta)) / (1.0 - z->zeta2 / z->zetan);
+}
+
+
+
+/*@================================
+ * genNextZipfian()
+ *================================*/
+/*
+ * Function: uint64_t genNextZipfian(struct genZipfian*)
+ *
+ * Description:
+ *  Return an item in [0, n); item 0 is the most popular.
+ *
+ * Returns:
+ *  the item
+ */
+uint64_t genNextZipfian(
+		struct genZipfian	*z)			/* IN generator */
+{
+	double		u;						/* a random number in [0, 1) */
+	double		uz;						/* u * zeta(n) */
+	uint64_t	item;					/* the item */
+
+	u = genRandom01();
+	uz = u * z->zetan;
+	if (uz < 1.0) return(0);
+	if (uz < 1.0 + pow(0.5, z->theta)) return(1);
+
+	item = (uint64_t)(z->n * pow(z->eta * u - z->eta + 1.0, z->alpha));
+
+	return(item < z->n ? item : z->n - 1);
+}
+
+
+
+/*@================================
+ * genChooseRecord()
+ *================================*/
+/*
+ * Function: uint64_t genChooseRecord(GenDistribution, struct genZipfian*, uint64_t, double, double)
+ *
+ * Description:
+ *  Choose one of the 'nKeys' records by the request distribution:
+ *   uniform : all records alike
+ *   zipfian : zipfian popularity, with the popular records scattered over
+ *             the records by hashing, as the scrambled zipfian of YCSB
+ *   latest  : zipfian popularity by recency; the last record is the most popular
+ *   hotspot : 'hotOpn' of the operations go uniformly to the first
+ *             'hotData' of the records
+ *
+ * Returns:
+ *  the record number
+ */
+uint64_t genChooseRecord(
+		GenDistribution		dist,		/* IN request distribution */
+		struct genZipfian	*z,			/* IN zipfian generator over the records */
+		uint64_t			nKeys,		/* IN # of records */
+		double				hotData,	/* IN fraction of the records which are hot */
+		double				hotOpn)		/* IN fraction of the operations on the hot records */
+{
+	uint64_t	nHot;					/* # of hot records */
+
+	switch (dist) {
+		case GEN_UNIFORM:
+			return(genRandom() % nKeys);
+
+		case GEN_LATEST:
+			return(nKeys - 1 - genNextZipfian(z));
+
+		case GEN_HOTSPOT:
+			nHot = (uint64_t)(nKeys * hotData);
+			if (nHot == 0) nHot = 1;
+			if (nHot == nKeys || genRandom01() < hotOpn) return(genRandom() % nHot);
+			return(nHot + genRandom() % (nKeys - nHot));
+
+		default:
+			return(genHash(genNextZipfian(z)) % nKeys);
+	}
+}
+
+
+
+/*@================================
+ * genWriteKey()
+ *================================*/
+/*
+ * Function: void genWriteKey(FILE*, GenKeyType, uint64_t)
+ *
+ * Description:
+ *  Write the key of the record 'rec':
+ *   rand_int : a 63-bit number scattered by hashing the record number
+ *   mono_inc : the record number
+ *   email    : an address made of syllables chosen by hashing, the record
+ *              number which makes it unique, and a domain; shorter than
+ *              GEN_MAXKEY
+ *
+ * Returns:
+ *  None
+ */
+void genWriteKey(
+		FILE		*fp,				/* IN output file */
+		GenKeyType	keyType,			/* IN key type */
+		uint64_t	rec)				/* IN record number */
+{
+	uint64_t	h;						/* hash of the record number */
+	Four		nSyllables;				/* # of syllables of the name */
+	Four		i;						/* loop index */
+
+	switch (keyType) {
+		case GEN_MONOINT:
+			fprintf(fp, "%llu", (unsigned long long)rec);
+			break;
+
+		case GEN_EMAIL:
+			h = genHash(rec + 1);
+			nSyllables = 2 + h % 3;
+			h /= 3;
+			for (i = 0; i < nSyllables; i++) {
+				fputs(genSyllables[h % GEN_NSYLLABLES], fp);
+				h /= GEN_NSYLLABLES;
+			}
+			fprintf(fp, "%llu@%s", (unsigned long long)rec, genDomains[h % GEN_NDOMAINS]);
+			break;
+
+		default:
+			fprintf(fp, "%llu", (unsigned long long)(genHash(rec + 1) & 0x7FFFFFFFFFFFFFFFULL));
+			break;
+	}
+}
@@ -36,11 +36,38 @@
  */
 /* Interface Function Prototypes */
 Four EduBtM_CreateIndex(ObjectID*, PageID*);
+Four EduBtM_CreateIndexWithOptions(ObjectID*, PageID*, Four);
+Four EduBtM_InitSortedBulkLoad(ObjectID*, PageID*, KeyDesc*, Two, Two);
+Four EduBtM_NextSortedBulkLoad(Four, KeyValue*, ObjectID*);
+Four EduBtM_FinalSortedBulkLoad(Four, Pool*, DeallocListElem*);
+Four EduBtM_BulkLoad(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*, Two, Two, Pool*, DeallocListElem*);
+Four EduBtM_BuildIndex(ObjectID*, PageID*, KeyDesc*, Four, Four, Two, Two, Pool*, DeallocListElem*);
 Four EduBtM_DeleteObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
 Four EduBtM_DropIndex(PhysicalFileID*, PageID*, Pool*, DeallocListElem*);
 Four EduBtM_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
 Four EduBtM_FetchNext(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+Four EduBtM_OpenScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeScan*);
+Four EduBtM_FetchNextBatch(BtreeScan*, Four, BtreeScanItem*);
+Four EduBtM_CloseScan(BtreeScan*);
+Four EduBtM_CallbackParallelScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, Four, BtreeScanCallback, void*);
 Four EduBtM_InsertObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
+Four EduBtM_InsertObjects(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*, Four*, Pool*, DeallocListElem*);
+Four EduBtM_InsertRecord(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Pool*, DeallocListElem*);
+Four EduBtM_FetchRecord(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, BtreeRecord*);
+Four EduBtM_FetchNextRecord(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*, BtreeRecord*);
+Four EduBtM_SetIndexParams(PageID*, BtreeIndexParams*);
+Four EduBtM_GetIndexParams(PageID*, BtreeIndexParams*);
+Four EduBtM_GetBloomStats(PageID*, BtreeBloomStats*);
+Four EduBtM_GetStats(PageID*, Boolean, BtreeStats*);
+Four EduBtM_FlushWriteBuffer(PageID*);
+Four EduBtM_SetLatencyTracking(Boolean, Four);
+Four EduBtM_GetLatency(Four, BtreeLatency*);
+Four EduBtM_ResetLatency(void);
+Four EduBtM_DumpLatency(FILE*);
+Four EduBtM_OpenSnapshot(PageID*, BtreeSnapshot*);
+Four EduBtM_SnapshotFetch(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
+Four EduBtM_SnapshotFetchNext(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+Four EduBtM_CloseSnapshot(BtreeSnapshot*);
 
 
 #endif /* _EDUBTM_H_ */
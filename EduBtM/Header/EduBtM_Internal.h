@@ -27,6 +27,7 @@
 
 
 #include "Util_pool.h"
+#include "Util_latency.h"
 
 
 /*@
@@ -37,7 +38,7 @@
 #endif
 
 
-#define OBJECTID_SIZE   sizeof(ObjectID)
+#define OBJECTID_SIZE   ((CONSTANT_CASTING_TYPE)sizeof(ObjectID))
 
 
 /*
@@ -106,7 +107,7 @@ typedef struct {   /* Internal (Nonleaf) Page */
  *  BtreeInternal *p      : pointer to the internal page
  * Returns: (Four) size of total free area
  */
-#define BI_FREE(p)    ((p)->hdr.unused + BI_CFREE(p))
+#define BI_FREE(p)    ((CONSTANT_CASTING_TYPE)((p)->hdr.unused + BI_CFREE(p)))
 
 /* Macro: BI_CFREE(p)
  * Description: return the size of contiguous free area of the internal page given as a parameter
@@ -114,8 +115,15 @@ typedef struct {   /* Internal (Nonleaf) Page */
  *  BtreeInternal *p      : pointer to the internal page
  * Returns: (Four) size of contiguous free area
  */
-#define BI_CFREE(p)   (PAGESIZE - BI_FIXED - (p)->hdr.free - ((p)->hdr.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(Two)))
-#define BI_HALF       ((CONSTANT_CASTING_TYPE)((PAGESIZE-BI_FIXED)/2))
+#define BI_CFREE(p)   (BTM_PAGE_SIZE(p) - (CONSTANT_CASTING_TYPE)BI_FIXED - (p)->hdr.free - ((p)->hdr.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(Two)) - BTM_KEYHEADS_SIZE(p))
+
+/* Macro: BI_HALF(p)
+ * Description: return the half of the data area of the internal page given as a parameter
+ * Parameter:
+ *  BtreeInternal *p      : pointer to the internal page
+ * Returns: (Four) half of the size of the data area
+ */
+#define BI_HALF(p)    ((CONSTANT_CASTING_TYPE)((BTM_PAGE_SIZE(p)-BI_FIXED)/2))
 
 
 /*
@@ -148,7 +156,7 @@ typedef struct {   /* Leaf Page */
  *  BtreeLeaf *p      : pointer to the leaf page
  * Returns: (Four) size of total free area
  */
-#define BL_FREE(p)    ((p)->hdr.unused + BL_CFREE(p))
+#define BL_FREE(p)    ((CONSTANT_CASTING_TYPE)((p)->hdr.unused + BL_CFREE(p)))
 
 /* Macro: BL_CFREE(p)
  * Description: return the size of contiguous free area of the leaf page given as a parameter
@@ -156,9 +164,25 @@ typedef struct {   /* Leaf Page */
  *  BtreeLeaf *p      : pointer to the leaf page
  * Returns: (Four) size of contiguous free area
  */
-#define BL_CFREE(p)    (PAGESIZE - BL_FIXED - (p)->hdr.free - ((p)->hdr.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(Two)))
-#define BL_HALF        ((CONSTANT_CASTING_TYPE)((PAGESIZE-BL_FIXED)/2))
-#define OVERFLOW_SPLIT ((CONSTANT_CASTING_TYPE)(PAGESIZE-BL_FIXED)/3)
+#define BL_CFREE(p)    (BTM_PAGE_SIZE(p) - (CONSTANT_CASTING_TYPE)BL_FIXED - (p)->hdr.free - ((p)->hdr.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(Two)) - BTM_KEYHEADS_SIZE(p))
+
+/* Macro: BL_HALF(p)
+ * Description: return the half of the data area of the leaf page given as a parameter
+ * Parameter:
+ *  BtreeLeaf *p      : pointer to the leaf page
+ * Returns: (Four) half of the size of the data area
+ */
+#define BL_HALF(p)     ((CONSTANT_CASTING_TYPE)((BTM_PAGE_SIZE(p)-BL_FIXED)/2))
+
+/* Macro: OVERFLOW_SPLIT(p)
+ * Description: return the max length of a leaf entry of the leaf page given as a parameter;
+ *              the ObjectIDs of a longer entry are moved to an overflow page
+ * Parameter:
+ *  BtreeLeaf *p      : pointer to the leaf page
+ * Returns: (Four) max length of a leaf entry
+ */
+#define OVERFLOW_SPLIT(p)   ((CONSTANT_CASTING_TYPE)(BTM_PAGE_SIZE(p)-BL_FIXED)/3)
+#define MAX_OVERFLOW_SPLIT  ((CONSTANT_CASTING_TYPE)(PAGESIZE-BL_FIXED)/3)  /* OVERFLOW_SPLIT() of the largest page */
 
 
 /*
@@ -192,6 +216,52 @@ typedef struct {   /* Overflow page */
 #define A_FOURTH_OF_OBJECTS     ((CONSTANT_CASTING_TYPE)(NO_OF_OBJECTS/4))
 
 
+/*
+ * BtreeMessage:
+ *  page of the message buffer of a buffered B+ tree (see BTM_BUFFERED).
+ *  The pages form a list starting at the page kept in 'reserved' of the
+ *  root page; the fields marked (head) are used in the first page only.
+ */
+#define BM_KEYBITS  1024    /* # of bits of the filter of the keys of a message page */
+
+typedef struct {
+	PageID pid;                 /* page id of this page, should be located on the beginning */
+	Four flags;                 /* flag to store page information */
+	Four reserved;              /* reserved space to store page information */
+	One     type;             /* Message */
+	ShortPageID nextPage;         /* Next Page */
+	Two     nMessages;        /* # of messages in this page */
+	Two     free;             /* starting point of the free space */
+	ShortPageID lastPage;         /* (head) the page the messages are appended to */
+	Two     nPages;           /* (head) # of pages of the buffer */
+	Four    nTotal;           /* (head) # of messages in the buffer */
+	ObjectID catObjForFile;   /* (head) catalog object of B+ tree file */
+	KeyDesc kdesc;            /* (head) key descriptor of the index */
+	UFour   keyBits[BM_KEYBITS/32]; /* bits set by the keys of the messages of this page */
+} BtreeMessageHdr;
+
+#define BM_FIXED  sizeof(BtreeMessageHdr)
+
+typedef struct {   /* Message page */
+	BtreeMessageHdr     hdr;       /* header of the btree message page */
+	char                data[PAGESIZE-BM_FIXED]; /* messages */
+} BtreeMessage;
+
+/* An insertion of a <key, ObjectID> pair buffered in a message page */
+typedef struct {
+	ObjectID oid;           /* ObjectID to insert */
+	/* 'klen' and 'kval' should be attached in this order */
+	/* to cast this variables the type KeyVlaue. */
+	Two  klen;          /* key length */
+	char kval[1];       /* key value */
+} btm_Message;
+
+/* Macro: BTM_MESSAGE_LEN(klen)
+ * Description: return the length of a message whose key length is given as a parameter
+ */
+#define BTM_MESSAGE_LEN(klen)   ((Two)ALIGNED_LENGTH(OFFSET_OF(btm_Message, kval[0]) + (klen)))
+
+
 /*
  * BtreePage:
  *  Page type contains all page types
@@ -204,6 +274,7 @@ typedef union {
 	BtreeInternal bi;       /* btree internal page */
 	BtreeLeaf     bl;       /* btree leaf page */
 	BtreeOverflow bo;       /* btree overflow page */
+	BtreeMessage  bm;       /* btree message page */
 } BtreePage;
 
 /* Btree Page Type */
@@ -212,6 +283,91 @@ typedef union {
 #define LEAF        0x04
 #define OVERFLOW    0x08
 #define FREEPAGE    0x10
+#define MESSAGE     0x20
+
+/* Btree Page Flags (stored in 'flags' above the page type vector) */
+#define BTM_KEYHEAD         0x0100  /* the page uses the key head layout */
+#define BTM_KEYHEAD_VALID   0x0200  /* the key head array of the page is up to date */
+#define BTM_KEYHEAD_INT     0x0400  /* key heads are made from an SM_INT first key part */
+#define BTM_KEYHEAD_STRING  0x0800  /* key heads are made from an SM_VARSTRING first key part */
+#define BTM_KEYHEAD_EXACT   0x1000  /* key heads hold the whole key (a single SM_INT key part) */
+#define BTM_KEYHEAD_KIND    (BTM_KEYHEAD_INT | BTM_KEYHEAD_STRING | BTM_KEYHEAD_EXACT)
+#define BTM_PAGESIZE_2K     0x2000  /* the leaf and internal pages use 2048 bytes of the page */
+#define BTM_PAGESIZE_1K     0x4000  /* the leaf and internal pages use 1024 bytes of the page */
+#define BTM_PAGESIZE_MASK   0x6000  /* bits holding log2(PAGESIZE / page size of the B+ tree) */
+#define BTM_PAGESIZE_SHIFT  13
+#define BTM_BUFFERED        0x8000  /* the root buffers the insertions in message pages */
+#define BTM_CLUSTERED       0x20000 /* the leaf entries hold the records of their objects; see BtreeRecord */
+#define BTM_INHERITED_FLAGS (BTM_KEYHEAD | BTM_KEYHEAD_KIND | BTM_PAGESIZE_MASK | BTM_BUFFERED | BTM_CLUSTERED) /* flags a new page takes over from its sibling */
+
+
+/*
+ * Page Size:
+ *  The buffer and disk managers work on pages of PAGESIZE bytes, but the
+ *  leaf and internal pages of a B+ tree may use only the first 1024 or
+ *  2048 bytes of their data area and slot array, as chosen by the options
+ *  of EduBtM_CreateIndexWithOptions() and kept in the page flags. All
+ *  free space and fill computations go through BTM_PAGE_SIZE(), so an
+ *  index of smaller pages has a smaller fanout and cheaper page updates
+ *  and searches. The slots still grow down from the end of the buffer.
+ *  btm_Underflow() may merge two pages into one holding more than its
+ *  size; such a page has a negative free space and is split by the next
+ *  insertion into it. Overflow pages always use the whole page.
+ *  Only sizes up to PAGESIZE can be chosen: a larger page would need a
+ *  train of several pages, which the buffer manager and the btm_*
+ *  routines of cosmos.o, all built for PAGESIZE, do not support.
+ */
+#define BTM_MIN_PAGESIZE    1024    /* smallest page size of a B+ tree */
+
+/* Macro: BTM_FLAGS_PAGESIZE(flags)
+ * Description: return the page size given by the page flags
+ * Parameter:
+ *  Four flags      : page flags
+ * Returns: (Four) page size in bytes
+ */
+#define BTM_FLAGS_PAGESIZE(flags)   ((CONSTANT_CASTING_TYPE)(PAGESIZE >> (((flags) & BTM_PAGESIZE_MASK) >> BTM_PAGESIZE_SHIFT)))
+
+/* Macro: BTM_PAGE_SIZE(p)
+ * Description: return the page size of the leaf or internal page given as a parameter
+ * Parameter:
+ *  BtreeLeaf/BtreeInternal/BtreeAny *p  : pointer to the page
+ * Returns: (Four) page size in bytes
+ */
+#define BTM_PAGE_SIZE(p)    BTM_FLAGS_PAGESIZE((p)->hdr.flags)
+
+
+/*
+ * Key Head:
+ *  An order-preserving 4-byte prefix of the key of an entry. When the key head
+ *  layout is used, the heads of all entries are stored as a contiguous array
+ *  just below the slot array in slot order, so that a search can narrow the
+ *  range of slots with a few vector comparisons before touching any entry.
+ *  Comparing two heads as signed integers gives the order of their keys;
+ *  equal heads mean the keys must be compared by edubtm_KeyCompare().
+ */
+typedef Four_Invariable KeyHead;
+
+/* Macro: BTM_KEYHEADS(p, n)
+ * Description: return the key head array of the leaf or internal page given as a parameter
+ * Parameter:
+ *  BtreeLeaf/BtreeInternal *p  : pointer to the page
+ *  Two n                       : # of slots of the page
+ * Returns: (KeyHead*) pointer to the key head of the slot 0
+ */
+#define BTM_KEYHEADS(p, n)  ((KeyHead*)((char*)(p) + PAGESIZE - (n)*((CONSTANT_CASTING_TYPE)(sizeof(Two)+sizeof(KeyHead)))))
+
+/* Macro: BTM_KEYHEADS_SIZE(p)
+ * Description: return the size of the key head array of the leaf or internal page given as a parameter
+ * Parameter:
+ *  BtreeLeaf/BtreeInternal *p  : pointer to the page
+ * Returns: (Four) size of the key head array; 0 if the page has no valid key heads
+ */
+#define BTM_KEYHEADS_SIZE(p) (((p)->hdr.flags & BTM_KEYHEAD_VALID) ? (p)->hdr.nSlots*((CONSTANT_CASTING_TYPE)sizeof(KeyHead)) : 0)
+
+/* Macro: BTM_KEYHEAD_LEN(p)
+ * Description: return the extra space needed by a new entry of the page for its key head
+ */
+#define BTM_KEYHEAD_LEN(p)  (((p)->hdr.flags & BTM_KEYHEAD_VALID) ? ((CONSTANT_CASTING_TYPE)sizeof(KeyHead)) : 0)
 
 
 /****************************************************************
@@ -249,6 +405,53 @@ typedef struct {
 	char kval[1];       /* key value and (ObjectID array or overflow PageID) */
 } btm_LeafEntry;
 
+/* Macro: BTM_LEAFENTRY_LEN(p, e)
+ * Description: return the length of the leaf entry given as a parameter
+ * Parameter:
+ *  BtreeLeaf *p      : pointer to the leaf page holding the entry
+ *  btm_LeafEntry *e  : pointer to the leaf entry
+ * Returns: (Two) length of the entry; when 'nObjects' is NIL the ObjectID
+ *          array is replaced by the ShortPageID of the first overflow page,
+ *          and in a page of a clustered index the ObjectID is followed by
+ *          the inline record
+ */
+#define BTM_LEAFENTRY_LEN(p, e) \
+	((Two)(BTM_LEAFENTRY_FIXED + ALIGNED_LENGTH((e)->klen) + \
+	       (((e)->nObjects < 0) ? sizeof(ShortPageID) : (e)->nObjects*OBJECTID_SIZE) + \
+	       (((p)->hdr.flags & BTM_CLUSTERED) ? BTM_INLINE_LEN(BTM_LEAFENTRY_RECORD(e)->len) : 0)))
+
+/* Macro: BTM_LEAFENTRY_OIDS(e)
+ * Description: return the ObjectID array of the leaf entry given as a parameter
+ * Returns: (ObjectID*) the first ObjectID; meaningful only when 'nObjects' is positive
+ */
+#define BTM_LEAFENTRY_OIDS(e)   ((ObjectID*)&(e)->kval[ALIGNED_LENGTH((e)->klen)])
+
+/* Macro: BTM_LEAFENTRY_OVPAGE(e)
+ * Description: return the first overflow page of the leaf entry given as a parameter
+ * Returns: (ShortPageID) the first overflow page; meaningful only when 'nObjects' is NIL
+ */
+#define BTM_LEAFENTRY_OVPAGE(e) (*(ShortPageID*)&(e)->kval[ALIGNED_LENGTH((e)->klen)])
+
+/* Data type of the record following the ObjectID of a leaf entry of a clustered index */
+typedef struct {
+	Two  len;           /* length of the record; NIL if the record is not in the entry */
+	char data[1];       /* the record */
+} btm_InlineRecord;
+
+/* Macro: BTM_LEAFENTRY_RECORD(e)
+ * Description: return the inline record of the leaf entry given as a parameter
+ * Returns: (btm_InlineRecord*) the record; meaningful only in a page of a clustered index
+ */
+#define BTM_LEAFENTRY_RECORD(e) ((btm_InlineRecord*)&(e)->kval[ALIGNED_LENGTH((e)->klen) + OBJECTID_SIZE])
+
+/* Macro: BTM_INLINE_LEN(len)
+ * Description: return the space taken in a leaf entry by an inline record of the given length
+ * Parameter:
+ *  Two len           : length of the record; NIL if the record is not in the entry
+ * Returns: (Two) length of the record with its length field
+ */
+#define BTM_INLINE_LEN(len) ((Two)ALIGNED_LENGTH((CONSTANT_CASTING_TYPE)sizeof(Two) + (((len) > 0) ? (len) : 0)))
+
 /* Data type for representing an internal item */
 typedef struct {
 	ShortPageID spid;       /* points to the child page */
@@ -265,6 +468,517 @@ typedef struct {
 } LeafItem;
 
 
+/*
+ * Clustered Index:
+ *  The leaf entries of an index made with the BTM_CLUSTERED option hold
+ *  one ObjectID each; a key is never inserted twice, whether the keys are
+ *  declared unique or not. The ObjectID of an object inserted with its
+ *  record by EduBtM_InsertRecord() is followed by a copy of the record
+ *  when the record is not longer than 'inlineRecordMax' and the entry
+ *  stays within a third of a page, so that EduBtM_FetchRecord() returns
+ *  the record from the leaf without reading the object from its data
+ *  file. The other entries keep a NIL record length. The leaves of a
+ *  clustered index are not merged or redistributed, since btm_Underflow()
+ *  does not know the inline records; a leaf emptied by deletions stays in
+ *  the chain until it is filled again.
+ */
+/* BTM_LEAFENTRY_FIXED is not an integer constant expression; 'nObjects' and 'klen' are counted instead */
+#define BTM_MAXINLINERECORD             (MAX_OVERFLOW_SPLIT - 2*(CONSTANT_CASTING_TYPE)sizeof(Two) - OBJECTID_SIZE - (CONSTANT_CASTING_TYPE)sizeof(Two)) /* max length of an inline record */
+
+/* A record given to or returned by a clustered index */
+typedef struct {
+    Two         len;                    /* length of the record; NIL if it is not kept in the index */
+    char        data[BTM_MAXINLINERECORD]; /* the record */
+} BtreeRecord;
+
+
+/*
+ * Bulk Load:
+ *  State of a sorted bulk load which builds a B+ tree bottom-up. On each
+ *  level one page is being filled; it stays fixed in the buffer until it
+ *  reaches the fill factor and is then linked into the level above it.
+ */
+#define BTM_MAXLEVEL        16  /* max height of a B+ tree built by a bulk load */
+#define BTM_MAXBULKLOADS    4   /* max # of bulk loads in progress */
+
+typedef struct {
+    Boolean     isUsed;                 /* TRUE if this entry is in use */
+    ObjectID    catObjForFile;          /* catalog object of B+ tree file */
+    PageID      root;                   /* root page of the B+ tree */
+    KeyDesc     kdesc;                  /* key descriptor */
+    Four        leafFill;               /* # of bytes to fill in a leaf page */
+    Four        internalFill;           /* # of bytes to fill in an internal page */
+    Four        pageFlags;              /* page flags taken over from the root */
+    Two         nLevels;                /* # of levels built so far; 0 if no object is loaded */
+    PageID      pid[BTM_MAXLEVEL];      /* page being filled on each level (level 0 is the leaf level) */
+    BtreePage   *page[BTM_MAXLEVEL];    /* buffer of the page being filled on each level */
+    PageID      lastAllocPid;           /* page allocated last; the next one is allocated near it */
+    KeyValue    lastKey;                /* key loaded last */
+} btm_BulkLoad;
+
+/*
+ * Index Build:
+ *  A B+ tree built from the objects of a data file by an external sort.
+ *  The <key, ObjectID> pairs extracted from the pages are sorted in runs
+ *  of bounded size, which are written to temporary files and merged, at
+ *  most BTM_MAXMERGEFANIN at a time, into a sorted bulk load.
+ */
+#define BTM_MAXBUILDWORKERS 16  /* max # of threads sorting the runs */
+#define BTM_MAXMERGEFANIN   64  /* max # of runs merged at once */
+
+/* A <key, ObjectID> pair being sorted */
+typedef struct {
+    ObjectID    oid;                    /* ObjectID of the object */
+    KeyValue    kval;                   /* key extracted from the object */
+} btm_SortPair;
+
+/* Comparison function of edubtm_MergeSort(), given the context of the sort */
+typedef Four (*btm_SortCompare)(void*, void*, void*);
+
+
+/*
+ * Insert Batch:
+ *  A batch of <key, ObjectID> pairs inserted by EduBtM_InsertObjects(). The
+ *  pairs are not moved; 'order' lists their indexes in ascending key order.
+ */
+typedef struct {
+    KeyDesc     *kdesc;                 /* key descriptor */
+    KeyValue    *kvals;                 /* key values of the batch */
+    ObjectID    *oids;                  /* ObjectIDs of the batch */
+    Four        *order;                 /* indexes of the pairs in ascending key order */
+    Four        nInserted;              /* # of pairs inserted so far */
+} btm_InsertBatch;
+
+/* List of internal items returned by a page which was split into several pages */
+typedef struct {
+    Four         nItems;                /* # of items in the list */
+    Four         maxItems;              /* # of items the array can hold */
+    InternalItem *items;                /* array of items in key order */
+} btm_InternalItemList;
+
+
+/*
+ * Index Info:
+ *  Information about an index kept in memory while the index is in use. It
+ *  is looked up by the root PageID of the index. Nothing of it is stored in
+ *  the pages; the hints are checked against the page before they are used.
+ */
+#define BTM_MAXINDEXINFOS               32  /* max # of indexes whose information is kept */
+#define BTM_ASCENDING_RUN               8   /* # of ascending insertions after which insertion is regarded as ascending */
+#define BTM_DEFAULT_APPENDSPLITRATIO    90  /* default fill (%) of the left page on an append split */
+#define BTM_DEFAULT_UNDERFLOWRATIO      50  /* default fill (%) below which a page is merged or redistributed */
+#define BTM_MAXBLOOMBITSPERKEY          32  /* max bits per key of the Bloom filter */
+#define BTM_MAXWRITEBUFFERKB            16384 /* max of 'writeBufferKB' */
+#define BTM_DEFAULT_INLINERECORDMAX     256 /* default max length of a record kept in a leaf entry */
+
+/* Run-time parameters of an index */
+typedef struct {
+    Two         appendSplitRatio;       /* fill (%) of the left page when a page is split by an append; */
+                                        /* 50 always splits at half, 100 moves only the new key */
+    Two         underflowRatio;         /* a page whose fill (%) is not greater than this after a deletion */
+                                        /* underflows; 50 keeps pages half full, 0 merges only empty pages */
+    Two         bloomBitsPerKey;        /* bits per key of the Bloom filter answering that a key is absent */
+                                        /* without fixing a page; 0 if the index has no filter */
+    Two         writeBufferKB;          /* memory (KB) the write buffer of the insertions may take; 0 if */
+                                        /* the index has no write buffer */
+    Two         inlineRecordMax;        /* max length of a record kept in its leaf entry by a clustered */
+                                        /* index; 0 keeps only empty records */
+} BtreeIndexParams;
+
+#define SET_DEFAULT_INDEXPARAMS(p) \
+    ((p).appendSplitRatio = BTM_DEFAULT_APPENDSPLITRATIO, (p).underflowRatio = BTM_DEFAULT_UNDERFLOWRATIO, \
+     (p).bloomBitsPerKey = 0, (p).writeBufferKB = 0, (p).inlineRecordMax = BTM_DEFAULT_INLINERECORDMAX)
+
+#define IS_DEFAULT_INDEXPARAMS(p) \
+    ((p).appendSplitRatio == BTM_DEFAULT_APPENDSPLITRATIO && (p).underflowRatio == BTM_DEFAULT_UNDERFLOWRATIO && \
+     (p).bloomBitsPerKey == 0 && (p).writeBufferKB == 0 && \
+     (p).inlineRecordMax == BTM_DEFAULT_INLINERECORDMAX)
+
+/* Statistics of the Bloom filter of an index */
+typedef struct {
+    Four        nKeys;                  /* # of keys entered since the filter was built */
+    Four        nBits;                  /* size of the filter in bits; 0 if it is not built */
+    Four        nBuilds;                /* # of times the filter was built from the leaves */
+    Four        nChecks;                /* # of keys looked up in the filter */
+    Four        nNegatives;             /* # of keys answered to be absent */
+    Four        nFalsePositives;        /* # of keys answered to be maybe present which were absent */
+    double      falsePositiveRate;      /* nFalsePositives / (nNegatives + nFalsePositives) */
+} BtreeBloomStats;
+
+/*
+ * Index Statistics:
+ *  The counters are kept by the insertions and deletions while the index
+ *  is in use, so they cost nothing to read; they count from when the index
+ *  information was made. The height is always exact. The figures of the
+ *  pages and entries are computed by a scan of the whole index, and are
+ *  only given when an exact report is asked for.
+ *  Bucket i of the key length histogram counts the keys whose length is at
+ *  most BTM_STATS_MINKEYLEN << i; the last bucket counts the longer keys.
+ */
+#define BTM_KEYLENBUCKETS               8   /* # of buckets of the key length histogram */
+#define BTM_STATS_MINKEYLEN             4   /* upper bound of the key lengths of the first bucket */
+
+typedef struct {
+    /* counters */
+    Four        nInserts;               /* # of ObjectIDs inserted */
+    Four        nDeletes;               /* # of ObjectIDs deleted */
+    Four        nLeafSplits;            /* # of leaf pages split */
+    Four        nInternalSplits;        /* # of internal pages split */
+    Four        nRootSplits;            /* # of times a new root was made */
+    Four        nUnderflows;            /* # of underflows handled by merging or redistributing pages */
+    Four        nOverflowLists;         /* # of ObjectID lists moved to overflow pages */
+    /* shape of the tree */
+    Four        height;                 /* # of levels; 1 if the root is a leaf */
+    Four        pageSize;               /* page size of the leaf and internal pages */
+    Four        nMessages;              /* # of insertions buffered in the root; see BTM_BUFFERED */
+    Four        nWriteBuffered;         /* # of insertions in the write buffer; see 'writeBufferKB' */
+    Boolean     exact;                  /* TRUE if the figures below were computed */
+    Four        nLeaves;                /* # of leaf pages */
+    Four        nInternals;             /* # of internal pages */
+    Four        nOverflowPages;         /* # of overflow pages */
+    Four        nKeys;                  /* # of distinct keys */
+    Four        nObjects;               /* # of ObjectIDs */
+    Four        nOverflowKeys;          /* # of keys whose ObjectIDs are in overflow pages */
+    double      leafFill;               /* average fill (%) of the leaf pages */
+    double      internalFill;           /* average fill (%) of the internal pages */
+    Four        minKeyLen;              /* length of the shortest key */
+    Four        maxKeyLen;              /* length of the longest key */
+    double      avgKeyLen;              /* average key length */
+    Four        keyLenHist[BTM_KEYLENBUCKETS]; /* histogram of the key lengths */
+} BtreeStats;
+
+/*
+ * Leaf Hint:
+ *  A leaf page visited by an equality search with the range of keys which
+ *  the internal pages direct to it: low <= key < high. The range holds as
+ *  long as no page of the index is split, merged or redistributed, which
+ *  is checked with the structure modification count of the index.
+ */
+#define BTM_LEAFHINTS                   8   /* # of leaf hints kept per index */
+
+typedef struct {
+    PageID              leaf;           /* the leaf page; pageNo is NIL if the hint is not used */
+    Four                smoCount;       /* structure modification count when the hint was made */
+    Boolean             hasLow;         /* FALSE if there is no lower bound */
+    Boolean             hasHigh;        /* FALSE if there is no upper bound */
+    KeyValue            low;            /* lower bound (inclusive) */
+    KeyValue            high;           /* upper bound (exclusive) */
+} btm_LeafHint;
+
+/*
+ * Bloom Filter:
+ *  Bits set by the keys of an index, which tell that a key is absent before
+ *  any page is fixed. A key once entered is never removed, so deletions
+ *  only raise the false positive rate; the filter is rebuilt from the leaves
+ *  when it is used next after too many deletions, or after more keys were
+ *  entered than it was sized for.
+ */
+#define BTM_BLOOM_MINKEYS               1024    /* min # of keys a filter is sized for */
+#define BTM_BLOOM_MAXHASHES             16      /* max # of hash functions */
+#define BTM_BLOOM_STALERATIO            4       /* rebuilt when more than 1/4 of the keys were deleted */
+
+typedef struct {
+    Boolean             valid;          /* TRUE if the filter holds all keys of the index */
+    unsigned char       *bits;          /* bit array; NULL if not allocated */
+    Four                nBits;          /* size of the bit array in bits */
+    Four                nHashes;        /* # of bits set per key */
+    Four                capacity;       /* # of keys the filter is sized for */
+    Four                nKeys;          /* # of keys entered */
+    Four                nDeletes;       /* # of deletions since the filter was built */
+    Four                nBuilds;        /* # of times the filter was built */
+    Four                nChecks;        /* # of lookups */
+    Four                nNegatives;     /* # of lookups answered absent */
+    Four                nFalsePositives; /* # of lookups answered maybe present for an absent key */
+} btm_BloomFilter;
+
+/*
+ * Write Buffer:
+ *  A skip list in memory, in the order of <key, ObjectID>, which takes the
+ *  insertions into an index whose 'writeBufferKB' is not 0. Its pairs are
+ *  merged into the tree in key order, in batches of BTM_WB_FLUSHBATCH: all
+ *  of them when an insertion would take more memory than 'writeBufferKB',
+ *  and those of a key range before the range is searched or a key of it is
+ *  deleted. The buffer is in memory only; EduBtM_FlushWriteBuffer() writes it to the tree.
+ */
+#define BTM_WB_MAXLEVELS                16  /* max # of levels of the skip list */
+#define BTM_WB_FLUSHBATCH               1024 /* max # of pairs merged into the tree at once */
+
+typedef struct btm_WriteNode {
+    ObjectID    oid;                    /* ObjectID of the pair */
+    struct btm_WriteNode **next;        /* next node at each level of the node */
+    Two         nLevels;                /* # of levels the node is linked at */
+    Two         klen;                   /* key length; 'klen' and 'kval' are laid out as a KeyValue */
+    char        kval[1];                /* key value */
+} btm_WriteNode;
+
+typedef struct {
+    btm_WriteNode *head[BTM_WB_MAXLEVELS]; /* first node at each level */
+    Four        nLevels;                /* # of levels in use */
+    Four        nPairs;                 /* # of pairs in the buffer */
+    Four        nBytes;                 /* memory taken by the nodes */
+    UFour       seed;                   /* state of the generator of the node levels */
+    ObjectID    catObjForFile;          /* catalog object of B+ tree file given by the insertions */
+    KeyDesc     kdesc;                  /* key descriptor given by the insertions */
+} btm_WriteBuffer;
+
+typedef struct {
+    Boolean             isUsed;         /* TRUE if this entry is in use */
+    PageID              root;           /* root page of the index */
+    BtreeIndexParams    params;         /* run-time parameters */
+    KeyValue            lastKey;        /* key inserted last; len is 0 if none */
+    Four                nAscending;     /* # of successive insertions with increasing keys */
+    PageID              rightmostLeaf;  /* hint: the rightmost leaf page; pageNo is NIL if unknown */
+    Four                smoCount;       /* # of structure modifications (split, merge, redistribution) */
+    Four                nUnderflows;    /* # of underflows handled, which may free pages */
+    Four                nInserts;       /* # of ObjectIDs inserted */
+    Four                nDeletes;       /* # of ObjectIDs deleted */
+    Four                nLeafSplits;    /* # of leaf pages split */
+    Four                nInternalSplits; /* # of internal pages split */
+    Four                nRootSplits;    /* # of new roots made */
+    Four                nOverflowLists; /* # of ObjectID lists moved to overflow pages */
+    Four                nextLeafHint;   /* the leaf hint to be replaced next */
+    btm_LeafHint        leafHints[BTM_LEAFHINTS]; /* leaves visited by recent equality searches */
+    btm_BloomFilter     bloom;          /* Bloom filter of the keys if 'bloomBitsPerKey' is not 0 */
+    btm_WriteBuffer     writeBuffer;    /* insertions not yet in the tree if 'writeBufferKB' is not 0 */
+} btm_IndexInfo;
+
+
+/*
+ * Adaptive Radix Tree:
+ *  An index made with the BTM_ART option keeps its <key, ObjectID> pairs in
+ *  an adaptive radix tree in memory instead of in B+ tree pages; its root
+ *  page is allocated but stays empty. The keys are normalized into byte
+ *  strings whose byte order is the order of edubtm_KeyCompare(), and the
+ *  tree branches on one byte of the normalized key at each inner node. An
+ *  inner node has room for 4, 16, 48 or 256 children and grows or shrinks
+ *  as its children come and go; the bytes shared by all the keys below a
+ *  node are kept as its prefix instead of a chain of nodes with one child.
+ *  Only the first BTM_ART_MAXPREFIX bytes of a prefix are stored, the rest
+ *  is read from a leaf below the node. A leaf holds the normalized key, the
+ *  key value, and the ObjectIDs of the key in ascending order; the leaves
+ *  are linked in key order, so a scan goes to the next key without
+ *  descending the tree.
+ *  The tree lives in memory only, for the lifetime of the process.
+ */
+#define BTM_ART                         0x10000 /* option of EduBtM_CreateIndexWithOptions(); not a page flag */
+#define BTM_MAXARTS                     32      /* max # of indexes kept in adaptive radix trees */
+#define BTM_ART_MAXPREFIX               8       /* # of bytes of a prefix stored in a node */
+#define BTM_ART_MAXKEYLEN               (2 * MAXKEYLEN) /* max length of a normalized key */
+
+/* Node types */
+#define BTM_ART_LEAF                    0
+#define BTM_ART_NODE4                   1
+#define BTM_ART_NODE16                  2
+#define BTM_ART_NODE48                  3
+#define BTM_ART_NODE256                 4
+
+typedef struct {
+    One         type;                   /* BTM_ART_NODE4, BTM_ART_NODE16, BTM_ART_NODE48 or BTM_ART_NODE256 */
+    Two         nChildren;              /* # of children */
+    Two         prefixLen;              /* length of the prefix, which may be longer than 'prefix' */
+    unsigned char prefix[BTM_ART_MAXPREFIX]; /* first bytes of the prefix */
+} btm_ArtNode;
+
+typedef struct {
+    btm_ArtNode n;                      /* node header */
+    unsigned char keys[4];              /* bytes of the children in ascending order */
+    btm_ArtNode *children[4];           /* children */
+} btm_ArtNode4;
+
+typedef struct {
+    btm_ArtNode n;                      /* node header */
+    unsigned char keys[16];             /* bytes of the children in ascending order */
+    btm_ArtNode *children[16];          /* children */
+} btm_ArtNode16;
+
+typedef struct {
+    btm_ArtNode n;                      /* node header */
+    unsigned char childIndex[256];      /* 1 + index of the child of each byte; 0 if none */
+    btm_ArtNode *children[48];          /* children */
+} btm_ArtNode48;
+
+typedef struct {
+    btm_ArtNode n;                      /* node header */
+    btm_ArtNode *children[256];         /* child of each byte; NULL if none */
+} btm_ArtNode256;
+
+typedef struct btm_ArtLeaf {
+    One         type;                   /* BTM_ART_LEAF */
+    Two         nlen;                   /* length of the normalized key */
+    Two         klen;                   /* length of the key value */
+    Four        nOids;                  /* # of ObjectIDs of the key */
+    Four        maxOids;                /* # of ObjectIDs 'oids' can hold */
+    ObjectID    *oids;                  /* ObjectIDs in ascending order; 'firstOid' until it is full */
+    ObjectID    firstOid;               /* room for the first ObjectID */
+    struct btm_ArtLeaf *prev;           /* leaf of the previous key; NULL if none */
+    struct btm_ArtLeaf *next;           /* leaf of the next key; NULL if none */
+    unsigned char bytes[1];             /* normalized key followed by the key value */
+} btm_ArtLeaf;
+
+typedef struct {
+    Boolean     isUsed;                 /* TRUE if this entry is in use */
+    PageID      root;                   /* root page of the index */
+    btm_ArtNode *tree;                  /* root node or leaf of the tree; NULL if empty */
+    btm_ArtLeaf *lastLeaf;              /* leaf of the last cursor set; NULL if none */
+    Four        nKeys;                  /* # of leaves */
+    Four        nObjects;               /* # of ObjectIDs */
+} btm_ArtIndex;
+
+
+/*
+ * Adaptive Hash Index:
+ *  Entries mapping the keys often searched for equality to the leaf slot
+ *  holding them, shared by all indexes and replaced by the clock algorithm.
+ *  A key is entered after BTM_AHI_THRESHOLD searches hit its counter. An
+ *  entry is checked against the leaf page before it is used, and dropped
+ *  when a page of its index may have been freed since it was entered.
+ */
+#define BTM_AHI_ENTRIES                 512     /* max # of entries */
+#define BTM_AHI_BUCKETS                 509     /* # of hash buckets */
+#define BTM_AHI_COUNTERS                4096    /* # of counters of the searches */
+#define BTM_AHI_THRESHOLD               3       /* # of searches after which a key is entered */
+
+typedef struct {
+    Boolean             isUsed;         /* TRUE if this entry is in use */
+    Boolean             referenced;     /* reference bit for the clock algorithm */
+    Four                hashValue;      /* hash value of the root and the key */
+    Four                next;           /* next entry in the bucket; NIL if none */
+    PageID              root;           /* root page of the index */
+    Four                nUnderflows;    /* 'nUnderflows' of the index when the entry was made */
+    PageID              leaf;           /* leaf page holding the key */
+    Two                 slotNo;         /* slot of the key in the leaf page */
+    KeyValue            key;            /* the key */
+} btm_AhiEntry;
+
+
+/*
+ * BtreeScan:
+ *  Range scan which returns the entries of a leaf in batches. The current
+ *  leaf stays fixed in the buffer between the calls and is released only
+ *  when all of its entries are returned, so the buffer manager is called
+ *  once per leaf rather than once per entry. An entry of a non-unique key
+ *  is returned once for each of its ObjectIDs.
+ */
+typedef struct {
+    One         flag;                   /* state of the scan: CURSOR_ON, CURSOR_EOS, or CURSOR_INVALID */
+    Boolean     forward;                /* TRUE if the scan goes to larger keys */
+    KeyDesc     kdesc;                  /* key descriptor */
+    KeyValue    stopKval;               /* key value of stop condition */
+    Four        stopCompOp;             /* comparison operator of stop condition */
+    PageID      leaf;                   /* the leaf page fixed by the scan */
+    BtreeLeaf   *page;                  /* buffer of 'leaf'; NULL if no page is fixed */
+    Two         slotNo;                 /* slot No. of the next entry to return */
+    PageID      overflow;               /* overflow page of the next ObjectID; pageNo is NIL if it is in the leaf */
+    Two         oidNo;                  /* element No. of the next ObjectID; NIL if the entry is not started */
+} BtreeScan;
+
+/* An entry returned by a scan */
+typedef struct {
+    ObjectID    oid;                    /* ObjectID of the entry */
+    Two         klen;                   /* key length */
+    char        *kval;                  /* key value in the fixed leaf; valid until the next call on the scan */
+} BtreeScanItem;
+
+
+/*
+ * Callback-Parallel Scan:
+ *  A range scan split into sub-ranges (morsels) at the separator keys of
+ *  the upper levels of the tree. The workers take the morsels one at a
+ *  time from a shared list, so that a worker which finishes early takes
+ *  over the rest of the work. Each worker passes its entries in batches to
+ *  a callback of the caller; the workers read the tree one at a time, and
+ *  only the callbacks run in parallel.
+ */
+#define BTM_MAXSCANWORKERS              64  /* max # of workers of a parallel scan */
+#define BTM_MORSELS_PER_WORKER          4   /* # of morsels wanted per worker */
+#define BTM_MAXMORSELS                  256 /* max # of morsels of a parallel scan */
+#define BTM_SCANBATCHSIZE               64  /* max # of entries passed to the callback at once */
+
+/* Callback of a parallel scan: (arg, worker No., # of entries, entries); a negative value stops the scan */
+typedef Four (*BtreeScanCallback)(void*, Four, Four, BtreeScanItem*);
+
+/* A sub-range of a parallel scan, given as the conditions of EduBtM_OpenScan() */
+typedef struct {
+    KeyValue    startKval;              /* key value of start condition */
+    Four        startCompOp;            /* comparison operator of start condition */
+    KeyValue    stopKval;               /* key value of stop condition */
+    Four        stopCompOp;             /* comparison operator of stop condition */
+} btm_ScanMorsel;
+
+
+/*
+ * Snapshots:
+ *  A snapshot gives its reader the B+ trees as they were when it was
+ *  opened, while the writers go on changing them. Before a writer changes
+ *  a page for the first time after a snapshot was opened, the image of the
+ *  page is saved as a version, so a page is copied at most once however
+ *  many snapshots are open. A reader of a snapshot reads, for each page,
+ *  the oldest version saved after the snapshot was opened, or the page
+ *  itself if it has not changed since. The versions never change, and a
+ *  reader fixes a page no longer than a call, so it holds up no writer.
+ *
+ *  Opening a snapshot starts a new epoch. A version is tagged with the
+ *  epoch in which it was saved and is freed once no snapshot opened before
+ *  that epoch is left open.
+ */
+#define BTM_VERSION_HASHSIZE            1024 /* # of buckets of the hash table of the versions */
+
+/* A saved image of a page */
+typedef struct btm_PageVersion {
+    struct btm_PageVersion *hashNext;   /* next version in the same bucket */
+    struct btm_PageVersion *retireNext; /* next version in the order of their epochs */
+    PageID      pid;                    /* the page */
+    Four        epoch;                  /* epoch in which the image was saved */
+    BtreePage   image;                  /* the image of the page */
+} btm_PageVersion;
+
+/* A point-in-time view of a B+ tree */
+typedef struct BtreeSnapshot {
+    struct BtreeSnapshot *next;         /* next open snapshot, in the order of their epochs */
+    One         flag;                   /* CURSOR_ON while the snapshot is open; CURSOR_INVALID otherwise */
+    PageID      root;                   /* root page of the index */
+    Four        epoch;                  /* epoch before which the snapshot was opened */
+} BtreeSnapshot;
+
+/*
+ * Message Buffer:
+ *  The root of an index made with the BTM_BUFFERED option buffers the
+ *  insertions in a list of message pages once the root is an internal
+ *  page. An insertion appends a message to the last page instead of
+ *  fixing a leaf; when the buffer is full, all its messages are sorted and
+ *  flushed into the tree at once, so that the leaves are visited in key
+ *  order and each leaf is written once for all its new keys.
+ *  A deletion, a search and a scan first flush the messages of their key
+ *  range, so they see every insertion made before them. The filter of the
+ *  keys of each page lets an equality search skip the pages without its
+ *  key. A pair already in the index is dropped when it is flushed.
+ */
+#define BTM_MSGBUF_PAGES                16  /* max # of pages of the message buffer of an index */
+
+
+/*
+ * Latency Histograms:
+ *  The latency of each call of an interface function is counted in the
+ *  per-thread histograms of Util_latency.c, which are shared by the
+ *  modules; nothing is counted unless the tracking is switched on by
+ *  EduBtM_SetLatencyTracking().
+ */
+/* The interface functions whose latencies are counted */
+enum { BTM_API_CREATEINDEX, BTM_API_CREATEINDEXWITHOPTIONS, BTM_API_DROPINDEX,
+       BTM_API_INSERTOBJECT, BTM_API_INSERTOBJECTS, BTM_API_DELETEOBJECT,
+       BTM_API_FETCH, BTM_API_FETCHNEXT, BTM_API_OPENSCAN, BTM_API_FETCHNEXTBATCH,
+       BTM_API_CLOSESCAN, BTM_API_CALLBACKPARALLELSCAN, BTM_API_INITSORTEDBULKLOAD,
+       BTM_API_NEXTSORTEDBULKLOAD, BTM_API_FINALSORTEDBULKLOAD, BTM_API_BULKLOAD,
+       BTM_API_BUILDINDEX, BTM_API_SETINDEXPARAMS, BTM_API_GETINDEXPARAMS,
+       BTM_API_GETBLOOMSTATS, BTM_API_GETSTATS, BTM_API_OPENSNAPSHOT,
+       BTM_API_SNAPSHOTFETCH, BTM_API_SNAPSHOTFETCHNEXT, BTM_API_CLOSESNAPSHOT,
+       BTM_API_FLUSHWRITEBUFFER, BTM_API_INSERTRECORD, BTM_API_FETCHRECORD,
+       BTM_API_FETCHNEXTRECORD, BTM_NAPIS };
+
+/* The latencies of an interface function, merged over all threads, in microseconds */
+typedef Util_Latency BtreeLatency;
+
+
 /*@
 ** Macro Definitions
 */
@@ -283,6 +997,16 @@ BEGIN_MACRO \
     catEntry = &(((sm_CatOverlayForSysTables*)&(obj->data))->btree);\
 END_MACRO
 
+/* Macro: BTM_LATENCY(api)
+ * Description: count the latency of the current call of an interface function;
+ *              must be the last declaration of the function. The latency is
+ *              counted when the function returns, on any path.
+ * Parameters:
+ *  Four api                        : the interface function, one of BTM_API_*
+ */
+#define BTM_LATENCY(api) \
+    Util_LatencyTimer _latencyTimer __attribute__((cleanup(edubtm_EndLatency))) = edubtm_BeginLatency(api)
+
 
 /*@
  * Function Prototypes
@@ -295,17 +1019,86 @@ Boolean edubtm_BinarySearchLeaf(BtreeLeaf*, KeyDesc*, KeyValue*, Two*);
 void edubtm_CompactInternalPage(BtreeInternal*, Two);
 void edubtm_CompactLeafPage(BtreeLeaf*, Two);
 Four edubtm_KeyCompare(KeyDesc*, KeyValue*, KeyValue*);
-Four edubtm_Delete(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*);
-Four edubtm_Insert(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*);
-Four edubtm_InsertLeaf(ObjectID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*, ObjectID*, Boolean*, Boolean*, InternalItem*);
-Four edubtm_InsertInternal(ObjectID*, BtreeInternal*, InternalItem*, Two, Boolean*, InternalItem*);
+Four edubtm_KeyHeadKind(KeyDesc*);
+KeyHead edubtm_MakeKeyHead(Four, KeyValue*);
+void edubtm_SearchKeyHeads(KeyHead*, Two, KeyHead, Two*, Two*);
+void edubtm_InsertKeyHead(BtreePage*, Two, KeyHead);
+void edubtm_DeleteKeyHead(BtreePage*, Two);
+Boolean edubtm_BuildKeyHeads(BtreePage*, KeyDesc*);
+void edubtm_DropKeyHeads(BtreePage*);
+Four edubtm_DropKeyHeadsAround(PageID*, BtreeInternal*, Two);
+Four edubtm_Delete(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*, btm_IndexInfo*);
+Four edubtm_Insert(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*, btm_IndexInfo*);
+Four edubtm_InsertLeaf(ObjectID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Boolean*, Boolean*, InternalItem*, btm_IndexInfo*);
+Four edubtm_InsertInternal(ObjectID*, BtreeInternal*, InternalItem*, Two, Boolean*, InternalItem*, btm_IndexInfo*);
+Four edubtm_InsertRightmostLeaf(ObjectID*, btm_IndexInfo*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Boolean*);
+Four edubtm_InsertSortedBatch(ObjectID*, PageID*, btm_InsertBatch*, Four);
+Four edubtm_InsertGroup(ObjectID*, PageID*, btm_InsertBatch*, Four, Four, btm_InternalItemList*, btm_IndexInfo*);
+Four edubtm_InsertInternalGroup(ObjectID*, PageID*, BtreeInternal*, KeyDesc*, btm_InternalItemList*, btm_InternalItemList*, btm_IndexInfo*);
+Four edubtm_AppendInternalItem(btm_InternalItemList*, InternalItem*);
 Four edubtm_FirstObject(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*);
 Four edubtm_FreePages(PhysicalFileID*, PageID*, Pool*, DeallocListElem*);
 Four edubtm_InitInternal(PageID*, Boolean, Boolean);
 Four edubtm_InitLeaf(PageID*, Boolean, Boolean);
 Four edubtm_LastObject(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*);
-Four edubtm_SplitInternal(ObjectID*, BtreeInternal*, Two, InternalItem*, InternalItem*);
-Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*);
+Four edubtm_SplitInternal(ObjectID*, BtreeInternal*, Two, InternalItem*, InternalItem*, btm_IndexInfo*);
+Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*, btm_IndexInfo*);
+Four edubtm_SplitLeafEntry(ObjectID*, PageID*, BtreeLeaf*, Two, btm_LeafEntry*, InternalItem*, btm_IndexInfo*);
+Four edubtm_InsertObjectId(ObjectID*, PageID*, BtreeLeaf*, Two, ObjectID*, Boolean*, Boolean*, InternalItem*, btm_IndexInfo*);
+Four edubtm_DeleteObjectId(PhysicalFileID*, BtreeLeaf*, Two, ObjectID*, Boolean*, Pool*, DeallocListElem*);
+Two edubtm_InlineRecordLen(btm_IndexInfo*, BtreeLeaf*, Two, BtreeRecord*);
+void edubtm_PutInlineRecord(btm_LeafEntry*, BtreeRecord*, Two);
+Four edubtm_GetInlineRecord(BtreeCursor*, BtreeRecord*);
+Four edubtm_FirstObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*);
+Four edubtm_NextObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*, Boolean*);
+Four edubtm_SplitLimit(btm_IndexInfo*, BtreePage*, Two);
+Boolean edubtm_IsUnderflow(btm_IndexInfo*, BtreePage*);
+btm_LeafHint *edubtm_LookUpLeafHint(btm_IndexInfo*, KeyDesc*, KeyValue*);
+void edubtm_AddLeafHint(btm_IndexInfo*, btm_LeafHint*);
+Four edubtm_LookUpAdaptiveHash(PageID*, btm_IndexInfo*, KeyDesc*, KeyValue*, BtreeCursor*, Boolean*);
+void edubtm_NoteAdaptiveHash(PageID*, btm_IndexInfo*, BtreeCursor*);
+void edubtm_RemoveAdaptiveHash(PageID*, KeyValue*);
+void edubtm_DropAdaptiveHash(PageID*);
+Four edubtm_CheckBloomFilter(PageID*, btm_IndexInfo*, KeyValue*, Boolean*);
+void edubtm_AddBloomKey(btm_IndexInfo*, KeyValue*);
+void edubtm_NoteBloomDeletion(btm_IndexInfo*);
+void edubtm_NoteBloomFalsePositive(btm_IndexInfo*);
+void edubtm_FreeBloomFilter(btm_IndexInfo*);
+UFour edubtm_BloomHash(char*, Two);
+Four edubtm_ExtractKey(KeyDesc*, Object*, KeyValue*);
+void edubtm_SortPairs(KeyDesc*, btm_SortPair*, btm_SortPair*, Four);
+void edubtm_MergeSort(void*, void*, Four, Four, btm_SortCompare, void*);
+Four edubtm_SplitScanRange(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, Four, btm_ScanMorsel*, Four*);
+Four edubtm_CollectStats(PageID*, Four, BtreeStats*);
+Util_LatencyTimer edubtm_BeginLatency(Four);
+void edubtm_EndLatency(Util_LatencyTimer*);
+Four edubtm_GetTrainForUpdate(PageID*, char**);
+Four edubtm_GetSnapshotTrain(PageID*, char**);
+Four edubtm_SaveVersion(PageID*, char*);
+Four edubtm_SaveVersionsAround(PageID*, BtreeInternal*, Two);
+Four edubtm_SaveOverflowVersions(PageID*);
+Four edubtm_OpenEpoch(BtreeSnapshot*);
+void edubtm_CloseEpoch(BtreeSnapshot*);
+BtreeSnapshot *edubtm_SetReadSnapshot(BtreeSnapshot*);
+Four edubtm_BufferMessage(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*);
+Four edubtm_FlushMessages(PageID*, KeyValue*, Four, KeyValue*, Four);
+Four edubtm_CountMessages(PageID*, Four*);
+Four edubtm_FindMessage(PageID*, KeyDesc*, KeyValue*, Boolean*);
+Four edubtm_ApplyMessages(PageID*, ObjectID*, KeyDesc*, btm_SortPair*, Four);
+Four edubtm_BufferWrite(ObjectID*, btm_IndexInfo*, KeyDesc*, KeyValue*, ObjectID*, Boolean*);
+Four edubtm_FlushWriteBuffer(PageID*, KeyValue*, Four, KeyValue*, Four);
+void edubtm_FreeWriteBuffer(btm_IndexInfo*);
+btm_IndexInfo *edubtm_GetIndexInfo(PageID*, Boolean);
+void edubtm_FreeIndexInfo(PageID*);
+btm_ArtIndex *edubtm_GetArtIndex(PageID*);
+Four edubtm_CreateArtIndex(PageID*);
+void edubtm_DropArtIndex(PageID*);
+Four edubtm_ArtInsert(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*);
+Four edubtm_ArtDelete(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*);
+Four edubtm_ArtFetch(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
+Four edubtm_ArtFetchNext(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+Two edubtm_NormalizeKey(KeyDesc*, KeyValue*, unsigned char*);
+void edubtm_NoteInsertion(btm_IndexInfo*, KeyDesc*, KeyValue*);
 Four edubtm_get_objectid_from_leaf(BtreeCursor*);
 Four edubtm_root_insert(ObjectID*, PageID*, InternalItem*);
 
@@ -327,11 +1120,38 @@ Four btm_IsTemporary(ObjectID*, Boolean*);
  */
 /*
 Four EduBtM_CreateIndex(ObjectID*, PageID*);
+Four EduBtM_CreateIndexWithOptions(ObjectID*, PageID*, Four);
+Four EduBtM_InitSortedBulkLoad(ObjectID*, PageID*, KeyDesc*, Two, Two);
+Four EduBtM_NextSortedBulkLoad(Four, KeyValue*, ObjectID*);
+Four EduBtM_FinalSortedBulkLoad(Four, Pool*, DeallocListElem*);
+Four EduBtM_BulkLoad(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*, Two, Two, Pool*, DeallocListElem*);
+Four EduBtM_BuildIndex(ObjectID*, PageID*, KeyDesc*, Four, Four, Two, Two, Pool*, DeallocListElem*);
 Four EduBtM_DeleteObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
 Four EduBtM_DropIndex(PhysicalFileID*, PageID*, Pool*, DeallocListElem*);
 Four EduBtM_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
 Four EduBtM_FetchNext(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+Four EduBtM_OpenScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeScan*);
+Four EduBtM_FetchNextBatch(BtreeScan*, Four, BtreeScanItem*);
+Four EduBtM_CloseScan(BtreeScan*);
+Four EduBtM_CallbackParallelScan(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, Four, BtreeScanCallback, void*);
 Four EduBtM_InsertObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
+Four EduBtM_InsertObjects(ObjectID*, PageID*, KeyDesc*, Four, KeyValue*, ObjectID*, Four*, Pool*, DeallocListElem*);
+Four EduBtM_InsertRecord(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, BtreeRecord*, Pool*, DeallocListElem*);
+Four EduBtM_FetchRecord(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, BtreeRecord*);
+Four EduBtM_FetchNextRecord(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*, BtreeRecord*);
+Four EduBtM_SetIndexParams(PageID*, BtreeIndexParams*);
+Four EduBtM_GetIndexParams(PageID*, BtreeIndexParams*);
+Four EduBtM_GetBloomStats(PageID*, BtreeBloomStats*);
+Four EduBtM_GetStats(PageID*, Boolean, BtreeStats*);
+Four EduBtM_FlushWriteBuffer(PageID*);
+Four EduBtM_SetLatencyTracking(Boolean, Four);
+Four EduBtM_GetLatency(Four, BtreeLatency*);
+Four EduBtM_ResetLatency(void);
+Four EduBtM_DumpLatency(FILE*);
+Four EduBtM_OpenSnapshot(PageID*, BtreeSnapshot*);
+Four EduBtM_SnapshotFetch(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
+Four EduBtM_SnapshotFetchNext(BtreeSnapshot*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
+Four EduBtM_CloseSnapshot(BtreeSnapshot*);
 */
 
 
@@ -42,6 +42,19 @@
 #define MAXFILENAME 255
 #define MAXKEY 60
 #define MAXPERFTEST 30
+#define NUMBUFFERTESTKEYS 2000
+#define NUMBUFFERPENDINGKEYS 50
+#define NUMSMALLPAGEKEYS 8000
+#define NUMSMALLPAGEKEYLEN 100
+#define NUMSMALLPAGEBLOCK 80
+#define NUMREFERENCEKEYS 4000
+#define NUMREFERENCEPAIRS 12000
+#define NUMHEAVYKEYS 8
+#define NUMHEAVYOBJECTS 500
+#define NUMLIGHTKEYS (2 * NUMHEAVYOBJECTS)
+#define NUMBUILDRUNSIZE 50
+#define NUMSCANBATCHITEMS 7
+#define NUMPARALLELSCANWORKERS 4
 
 #define f(x) #x
 
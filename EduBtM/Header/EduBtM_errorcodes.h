@@ -56,3 +56,11 @@
 #define eBADCACHETREELATCHCELLPTR_BTM            ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,12)
 #define NUM_ERRORS_BTM_ERR_BASE                  13
 #define eNOTSUPPORTED_EDUBTM                     ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,14)
+#define eNOTSORTED_EDUBTM                        ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,15)
+#define eNOTEMPTYINDEX_EDUBTM                    ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,16)
+#define eBADBULKLOADID_EDUBTM                    ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,17)
+#define eTOOMANYBULKLOADS_EDUBTM                 ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,18)
+#define eMEMORYALLOCERR_EDUBTM                   ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,19)
+#define eTOOMANYINDEXES_EDUBTM                   ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,20)
+#define eBADKEYFIELD_EDUBTM                      ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,21)
+#define eSORTFILEIO_EDUBTM                       ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,22)
@@ -33,6 +33,12 @@
 /*
  * define a type for a slot that includes a unique number
  */
+/* The empty slots have EMPTYSLOT with the 'offset' */
+#define EMPTYSLOT       -1
+
+/* Property of an object stored out of the slotted page */
+#define P_LRGOBJ        0x1 /* whether this is a large object */
+
 typedef struct {
     Two 	offset;		/* points to actual storage area */
     Unique	unique;		/* unique number */
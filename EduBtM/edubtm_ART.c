@@ -0,0 +1,1636 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_ART.c
+ *
+ * Description :
+ *  Adaptive radix tree of an index made with the BTM_ART option. The
+ *  <key, ObjectID> pairs of such an index are kept in memory in the tree
+ *  instead of in B+ tree pages, and EduBtM_InsertObject(),
+ *  EduBtM_DeleteObject(), EduBtM_Fetch() and EduBtM_FetchNext() of the
+ *  index are served by the functions here with the semantics of the B+ tree.
+ *
+ *  A key is looked up by the bytes of its normalized form, one byte at each
+ *  inner node, so the cost of a lookup depends on the length of the key
+ *  and not on the number of keys. No key comparison is made until a leaf
+ *  is reached. A scan follows the links between the leaves, starting from
+ *  the leaf of the last cursor set if it is the leaf of the current key.
+ *
+ * Exports:
+ *  btm_ArtIndex *edubtm_GetArtIndex(PageID*)
+ *  Four edubtm_CreateArtIndex(PageID*)
+ *  void edubtm_DropArtIndex(PageID*)
+ *  Four edubtm_ArtInsert(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*)
+ *  Four edubtm_ArtDelete(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*)
+ *  Four edubtm_ArtFetch(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*)
+ *  Four edubtm_ArtFetchNext(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*)
+ *  Two edubtm_NormalizeKey(KeyDesc*, KeyValue*, unsigned char*)
+ */
+
+
+#include <stddef.h> /* for offsetof */
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h> /* for CHAR_MIN */
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Macro Definitions */
+/* size of a leaf with a normalized key of 'nlen' bytes and a key value of 'klen' bytes */
+#define ARTLEAF_SIZE(nlen, klen)    (offsetof(btm_ArtLeaf, bytes) + (nlen) + (klen))
+#define ARTLEAF_KVAL(leaf)          ((leaf)->bytes + (leaf)->nlen)
+#define IS_ARTLEAF(node)            ((node)->type == BTM_ART_LEAF)
+
+
+/*@ Global Variables */
+static btm_ArtIndex edubtm_artTable[BTM_MAXARTS];
+static Four edubtm_nArts = 0;          /* # of entries in use */
+
+
+/*@ Internal Function Prototypes */
+btm_ArtLeaf *edubtm_ArtNewLeaf(unsigned char*, Two, KeyValue*, ObjectID*);
+btm_ArtNode *edubtm_ArtNewNode(One);
+void edubtm_ArtFreeTree(btm_ArtNode*);
+void edubtm_ArtLinkLeaf(btm_ArtLeaf*, btm_ArtLeaf*, btm_ArtLeaf*);
+Four edubtm_ArtCompareLeaf(btm_ArtLeaf*, unsigned char*, Two);
+Boolean edubtm_ArtSearchOid(btm_ArtLeaf*, ObjectID*, Four*);
+btm_ArtNode **edubtm_ArtFindChild(btm_ArtNode*, unsigned char);
+btm_ArtNode *edubtm_ArtNeighborChild(btm_ArtNode*, Four, Boolean, Four*);
+btm_ArtLeaf *edubtm_ArtMinimum(btm_ArtNode*);
+btm_ArtLeaf *edubtm_ArtMaximum(btm_ArtNode*);
+Four edubtm_ArtAddChild(btm_ArtNode**, unsigned char, btm_ArtNode*);
+void edubtm_ArtRemoveChild(btm_ArtNode**, unsigned char, btm_ArtNode**);
+Four edubtm_ArtInsertNode(btm_ArtNode**, unsigned char*, Two, Four, KeyValue*, ObjectID*, Boolean, Boolean*);
+Four edubtm_ArtDeleteNode(btm_ArtNode**, unsigned char*, Two, Four, ObjectID*, Boolean*);
+btm_ArtLeaf *edubtm_ArtSearch(btm_ArtNode*, unsigned char*, Two);
+btm_ArtLeaf *edubtm_ArtSeek(btm_ArtNode*, unsigned char*, Two, Four, Boolean, Boolean);
+Four edubtm_ArtSetCursor(btm_ArtIndex*, KeyDesc*, btm_ArtLeaf*, Four, KeyValue*, Four, BtreeCursor*);
+
+
+
+/*@================================
+ * edubtm_GetArtIndex()
+ *================================*/
+/*
+ * Function: btm_ArtIndex *edubtm_GetArtIndex(PageID*)
+ *
+ * Description:
+ *  Find the adaptive radix tree of the index whose root page is 'root'.
+ *
+ * Returns:
+ *  the entry of the tree; NULL if the index is a B+ tree
+ */
+btm_ArtIndex *edubtm_GetArtIndex(
+    PageID              *root)          /* IN root page of the index */
+{
+    Four                i;              /* index of the table */
+    btm_ArtIndex        *art;           /* an entry of the table */
+
+
+    if (edubtm_nArts == 0) return(NULL);
+
+    for (i = 0; i < BTM_MAXARTS; i++) {
+        art = &edubtm_artTable[i];
+        if (art->isUsed && art->root.volNo == root->volNo && art->root.pageNo == root->pageNo)
+            return(art);
+    }
+
+    return(NULL);
+
+} /* edubtm_GetArtIndex() */
+
+
+
+/*@================================
+ * edubtm_CreateArtIndex()
+ *================================*/
+/*
+ * Function: Four edubtm_CreateArtIndex(PageID*)
+ *
+ * Description:
+ *  Make an empty adaptive radix tree for the index whose root page is
+ *  'root'.
+ *
+ * Returns:
+ *  Error code
+ *    eTOOMANYINDEXES_EDUBTM
+ */
+Four edubtm_CreateArtIndex(
+    PageID              *root)          /* IN root page of the index */
+{
+    Four                i;              /* index of the table */
+    btm_ArtIndex        *art;           /* the new entry */
+
+
+    for (i = 0; i < BTM_MAXARTS; i++)
+        if (!edubtm_artTable[i].isUsed) break;
+    if (i == BTM_MAXARTS) ERR(eTOOMANYINDEXES_EDUBTM);
+
+    art = &edubtm_artTable[i];
+    art->isUsed = TRUE;
+    art->root = *root;
+    art->tree = NULL;
+    art->lastLeaf = NULL;
+    art->nKeys = 0;
+    art->nObjects = 0;
+    edubtm_nArts++;
+
+    return(eNOERROR);
+
+} /* edubtm_CreateArtIndex() */
+
+
+
+/*@================================
+ * edubtm_DropArtIndex()
+ *================================*/
+/*
+ * Function: void edubtm_DropArtIndex(PageID*)
+ *
+ * Description:
+ *  Free the adaptive radix tree of the index whose root page is 'root', if
+ *  the index has one.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_DropArtIndex(
+    PageID              *root)          /* IN root page of the index */
+{
+    btm_ArtIndex        *art;           /* the entry of the tree */
+
+
+    art = edubtm_GetArtIndex(root);
+    if (art == NULL) return;
+
+    edubtm_ArtFreeTree(art->tree);
+    art->tree = NULL;
+    art->lastLeaf = NULL;
+    art->isUsed = FALSE;
+    edubtm_nArts--;
+
+} /* edubtm_DropArtIndex() */
+
+
+
+/*@================================
+ * edubtm_NormalizeKey()
+ *================================*/
+/*
+ * Function: Two edubtm_NormalizeKey(KeyDesc*, KeyValue*, unsigned char*)
+ *
+ * Description:
+ *  Make the normalized form of a key value: a byte string whose order by
+ *  unsigned bytes is the order of the key values by edubtm_KeyCompare().
+ *  An SM_INT part becomes its four bytes, big endian with the sign bit
+ *  flipped. An SM_VARSTRING part becomes its characters, as unsigned bytes
+ *  in the order of 'char', each 0 byte escaped as 0x00 0xFF, followed by
+ *  0x00 0x00; so a string sorts before the strings it is a prefix of, and
+ *  no normalized key is a prefix of another one.
+ *
+ * Returns:
+ *  length of the normalized key
+ *
+ * Side effects:
+ *  nkey : the normalized key; it should have room for BTM_ART_MAXKEYLEN bytes
+ */
+Two edubtm_NormalizeKey(
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value */
+    unsigned char       *nkey)          /* OUT normalized key */
+{
+    Two                 i;              /* index of the key parts */
+    Two                 j;              /* index of the characters */
+    Two                 len;            /* length of a string */
+    Two                 offset;         /* offset of the current key part */
+    Two                 nlen;           /* length of the normalized key */
+    Four_Invariable     iv;             /* an SM_INT value */
+    UFour               u;              /* 'iv' in unsigned order */
+    unsigned char       c;              /* a character in unsigned order */
+
+
+    offset = nlen = 0;
+    for (i = 0; i < kdesc->nparts; i++) {
+        switch (kdesc->kpart[i].type) {
+          case SM_INT:
+            memcpy(&iv, &kval->val[offset], sizeof(Four_Invariable));
+            u = (UFour)iv ^ 0x80000000U;
+            nkey[nlen++] = (unsigned char)(u >> 24);
+            nkey[nlen++] = (unsigned char)(u >> 16);
+            nkey[nlen++] = (unsigned char)(u >> 8);
+            nkey[nlen++] = (unsigned char)u;
+            offset += sizeof(Four_Invariable);
+            break;
+
+          case SM_VARSTRING:
+            memcpy(&len, &kval->val[offset], sizeof(Two));
+            offset += sizeof(Two);
+            for (j = 0; j < len; j++) {
+                c = (unsigned char)(kval->val[offset + j] - CHAR_MIN);
+                nkey[nlen++] = c;
+                if (c == 0) nkey[nlen++] = 0xFF;
+            }
+            nkey[nlen++] = 0;
+            nkey[nlen++] = 0;
+            offset += len;
+            break;
+        }
+    }
+
+    return(nlen);
+
+} /* edubtm_NormalizeKey() */
+
+
+
+/*@================================
+ * edubtm_ArtInsert()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtInsert(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*)
+ *
+ * Description:
+ *  Insert <kval, oid> into the adaptive radix tree. The tree is changed only
+ *  after all the memory it needs has been allocated, so it is left as it
+ *  was if the insertion fails.
+ *
+ * Returns:
+ *  Error code
+ *    eDUPLICATEDKEY_BTM
+ *    eDUPLICATEDOBJECTID_BTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    eBADPARAMETER_BTM
+ */
+Four edubtm_ArtInsert(
+    btm_ArtIndex        *art,           /* INOUT the tree */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid)           /* IN ObjectID to insert */
+{
+    Four                e;              /* error number */
+    Two                 nlen;           /* length of the normalized key */
+    Boolean             newKey;         /* TRUE if a leaf was made for the key */
+    unsigned char       nkey[BTM_ART_MAXKEYLEN]; /* normalized key */
+
+
+    /* A unique key has one part, as edubtm_KeyCompare() requires */
+    if (kdesc->flag & KEYFLAG_UNIQUE && kdesc->nparts != 1) ERR(eBADPARAMETER_BTM);
+
+    nlen = edubtm_NormalizeKey(kdesc, kval, nkey);
+
+    newKey = FALSE;
+    e = edubtm_ArtInsertNode(&art->tree, nkey, nlen, 0, kval, oid,
+                             (kdesc->flag & KEYFLAG_UNIQUE) ? TRUE : FALSE, &newKey);
+    if (e < eNOERROR) ERR(e);
+
+    if (newKey) art->nKeys++;
+    art->nObjects++;
+
+    return(eNOERROR);
+
+} /* edubtm_ArtInsert() */
+
+
+
+/*@================================
+ * edubtm_ArtDelete()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtDelete(btm_ArtIndex*, KeyDesc*, KeyValue*, ObjectID*)
+ *
+ * Description:
+ *  Delete <kval, oid> from the adaptive radix tree. The leaf of a key is
+ *  removed with its last ObjectID, and the inner nodes shrink as their
+ *  children are removed.
+ *
+ * Returns:
+ *  Error code
+ *    eNOTFOUND_BTM
+ */
+Four edubtm_ArtDelete(
+    btm_ArtIndex        *art,           /* INOUT the tree */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid)           /* IN ObjectID to delete */
+{
+    Four                e;              /* error number */
+    Two                 nlen;           /* length of the normalized key */
+    Boolean             keyRemoved;     /* TRUE if the leaf of the key was removed */
+    unsigned char       nkey[BTM_ART_MAXKEYLEN]; /* normalized key */
+
+
+    nlen = edubtm_NormalizeKey(kdesc, kval, nkey);
+
+    keyRemoved = FALSE;
+    e = edubtm_ArtDeleteNode(&art->tree, nkey, nlen, 0, oid, &keyRemoved);
+    if (e < eNOERROR) ERR(e);
+
+    /* The leaf of the last cursor may have been freed */
+    if (keyRemoved) {
+        art->lastLeaf = NULL;
+        art->nKeys--;
+    }
+    art->nObjects--;
+
+    return(eNOERROR);
+
+} /* edubtm_ArtDelete() */
+
+
+
+/*@================================
+ * edubtm_ArtFetch()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtFetch(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*)
+ *
+ * Description:
+ *  Find the first <key, ObjectID> pair of the adaptive radix tree satisfying
+ *  the start condition, as edubtm_Fetch() does in a B+ tree. A scan started
+ *  with SM_LT, SM_LE or SM_EOF goes backward and begins with the last
+ *  ObjectID of its first key; the others begin with the first ObjectID.
+ *  The cursor is set to CURSOR_EOS if the pair does not satisfy the stop
+ *  condition. Its 'leaf' is the root page of the index, and its
+ *  'oidArrayElemNo' the position of the ObjectID among those of the key.
+ *
+ * Returns:
+ *  Error code
+ *    eBADCOMPOP_BTM
+ *
+ * Side effects:
+ *  cursor : the position of the pair found
+ */
+Four edubtm_ArtFetch(
+    btm_ArtIndex        *art,           /* IN the tree */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *startKval,     /* IN key value of start condition */
+    Four                startCompOp,    /* IN comparison operator of start condition */
+    KeyValue            *stopKval,      /* IN key value of stop condition */
+    Four                stopCompOp,     /* IN comparison operator of stop condition */
+    BtreeCursor         *cursor)        /* OUT the position of the pair found */
+{
+    Four                e;              /* error number */
+    Two                 nlen;           /* length of the normalized key */
+    Boolean             backward;       /* TRUE if the scan goes backward */
+    btm_ArtLeaf         *leaf;          /* leaf of the first key */
+    unsigned char       nkey[BTM_ART_MAXKEYLEN]; /* normalized start key */
+
+
+    backward = FALSE;
+    switch (startCompOp) {
+      case SM_BOF:
+        leaf = edubtm_ArtMinimum(art->tree);
+        break;
+
+      case SM_EOF:
+        leaf = edubtm_ArtMaximum(art->tree);
+        backward = TRUE;
+        break;
+
+      case SM_EQ:
+        nlen = edubtm_NormalizeKey(kdesc, startKval, nkey);
+        leaf = edubtm_ArtSearch(art->tree, nkey, nlen);
+        break;
+
+      case SM_GE:
+      case SM_GT:
+        nlen = edubtm_NormalizeKey(kdesc, startKval, nkey);
+        leaf = edubtm_ArtSeek(art->tree, nkey, nlen, 0, TRUE, startCompOp == SM_GT);
+        break;
+
+      case SM_LE:
+      case SM_LT:
+        nlen = edubtm_NormalizeKey(kdesc, startKval, nkey);
+        leaf = edubtm_ArtSeek(art->tree, nkey, nlen, 0, FALSE, startCompOp == SM_LT);
+        backward = TRUE;
+        break;
+
+      default:
+        ERR(eBADCOMPOP_BTM);
+    }
+
+    e = edubtm_ArtSetCursor(art, kdesc, leaf, (leaf != NULL && backward) ? leaf->nOids - 1 : 0,
+                            stopKval, stopCompOp, cursor);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_ArtFetch() */
+
+
+
+/*@================================
+ * edubtm_ArtFetchNext()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtFetchNext(btm_ArtIndex*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*)
+ *
+ * Description:
+ *  Find the <key, ObjectID> pair next to the current one in the direction
+ *  of the scan, as edubtm_FetchNext() does in a B+ tree: the scan goes
+ *  backward if the stop condition is SM_GT, SM_GE or SM_BOF. The pair is
+ *  found from the key and the ObjectID of the current cursor, so the scan
+ *  goes on correctly even if the tree changed after the cursor was set.
+ *  The leaf of the current key is the leaf of the last cursor set, unless
+ *  another cursor was set in between; only then is the key looked up.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  next : the position of the next pair
+ */
+Four edubtm_ArtFetchNext(
+    btm_ArtIndex        *art,           /* IN the tree */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value of stop condition */
+    Four                compOp,         /* IN comparison operator of stop condition */
+    BtreeCursor         *current,       /* IN current cursor */
+    BtreeCursor         *next)          /* OUT next cursor */
+{
+    Four                e;              /* error number */
+    Four                idx;            /* position of the ObjectID in the leaf */
+    Two                 nlen;           /* length of the normalized key */
+    Boolean             backward;       /* TRUE if the scan goes backward */
+    btm_ArtLeaf         *leaf;          /* leaf of the next pair */
+    unsigned char       nkey[BTM_ART_MAXKEYLEN]; /* normalized current key */
+
+
+    backward = (compOp == SM_GT || compOp == SM_GE || compOp == SM_BOF) ? TRUE : FALSE;
+
+    if (next != current) *next = *current;
+
+    /*@ find the leaf of the current key */
+    leaf = art->lastLeaf;
+    if (leaf == NULL || leaf->klen != current->key.len ||
+        memcmp(ARTLEAF_KVAL(leaf), current->key.val, leaf->klen) != 0) {
+        nlen = edubtm_NormalizeKey(kdesc, &current->key, nkey);
+        leaf = edubtm_ArtSearch(art->tree, nkey, nlen);
+
+        /* The key was deleted; go to the key next to it */
+        if (leaf == NULL) {
+            leaf = edubtm_ArtSeek(art->tree, nkey, nlen, 0, !backward, TRUE);
+            if (leaf != NULL) idx = backward ? leaf->nOids - 1 : 0;
+
+            e = edubtm_ArtSetCursor(art, kdesc, leaf, idx, kval, compOp, next);
+            if (e < eNOERROR) ERR(e);
+
+            return(eNOERROR);
+        }
+    }
+
+    /*@ the next ObjectID of the current key, or the first one of the next key */
+    if (edubtm_ArtSearchOid(leaf, &current->oid, &idx) && !backward) idx++;
+    else if (backward) idx--;
+
+    if (idx < 0 || idx >= leaf->nOids) {
+        leaf = backward ? leaf->prev : leaf->next;
+        if (leaf != NULL) idx = backward ? leaf->nOids - 1 : 0;
+    }
+
+    e = edubtm_ArtSetCursor(art, kdesc, leaf, idx, kval, compOp, next);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_ArtFetchNext() */
+
+
+
+/*@================================
+ * edubtm_ArtSetCursor()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtSetCursor(btm_ArtIndex*, KeyDesc*, btm_ArtLeaf*, Four, KeyValue*, Four, BtreeCursor*)
+ *
+ * Description:
+ *  Set the cursor to the 'idx'-th ObjectID of the leaf, or to CURSOR_EOS if
+ *  there is no leaf or its key does not satisfy the stop condition.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_ArtSetCursor(
+    btm_ArtIndex        *art,           /* IN the tree */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    btm_ArtLeaf         *leaf,          /* IN leaf of the pair; NULL if none */
+    Four                idx,            /* IN position of the ObjectID in the leaf */
+    KeyValue            *stopKval,      /* IN key value of stop condition */
+    Four                stopCompOp,     /* IN comparison operator of stop condition */
+    BtreeCursor         *cursor)        /* OUT the cursor */
+{
+    Four                cmp;            /* result of the key comparison */
+
+
+    if (leaf == NULL) {
+        cursor->flag = CURSOR_EOS;
+        return(eNOERROR);
+    }
+
+    cursor->flag = CURSOR_ON;
+    cursor->key.len = leaf->klen;
+    memcpy(cursor->key.val, ARTLEAF_KVAL(leaf), leaf->klen);
+    cursor->oid = leaf->oids[idx];
+    cursor->leaf = art->root;
+    MAKE_PAGEID(cursor->overflow, art->root.volNo, NIL);
+    cursor->slotNo = 0;
+    cursor->oidArrayElemNo = idx;
+    art->lastLeaf = leaf;
+
+    if (stopCompOp == SM_BOF || stopCompOp == SM_EOF) return(eNOERROR);
+
+    cmp = edubtm_KeyCompare(kdesc, &cursor->key, stopKval);
+    if (cmp < eNOERROR) ERR(cmp);
+
+    switch (stopCompOp) {
+      case SM_EQ:
+        if (cmp != EQUAL) cursor->flag = CURSOR_EOS;
+        break;
+      case SM_LT:
+        if (cmp != LESS) cursor->flag = CURSOR_EOS;
+        break;
+      case SM_LE:
+        if (cmp == GREATER) cursor->flag = CURSOR_EOS;
+        break;
+      case SM_GT:
+        if (cmp != GREATER) cursor->flag = CURSOR_EOS;
+        break;
+      case SM_GE:
+        if (cmp == LESS) cursor->flag = CURSOR_EOS;
+        break;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_ArtSetCursor() */
+
+
+
+/*@================================
+ * edubtm_ArtNewLeaf()
+ *================================*/
+/*
+ * Function: btm_ArtLeaf *edubtm_ArtNewLeaf(unsigned char*, Two, KeyValue*, ObjectID*)
+ *
+ * Description:
+ *  Make a leaf for a key with one ObjectID.
+ *
+ * Returns:
+ *  the new leaf; NULL if it could not be allocated
+ */
+btm_ArtLeaf *edubtm_ArtNewLeaf(
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen,           /* IN length of the normalized key */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid)           /* IN ObjectID of the key */
+{
+    btm_ArtLeaf         *leaf;          /* the new leaf */
+
+
+    leaf = (btm_ArtLeaf*)malloc(ARTLEAF_SIZE(nlen, kval->len));
+    if (leaf == NULL) return(NULL);
+
+    leaf->type = BTM_ART_LEAF;
+    leaf->nlen = nlen;
+    leaf->klen = kval->len;
+    leaf->nOids = 1;
+    leaf->maxOids = 1;
+    leaf->oids = &leaf->firstOid;
+    leaf->firstOid = *oid;
+    leaf->prev = leaf->next = NULL;
+    memcpy(leaf->bytes, nkey, nlen);
+    memcpy(ARTLEAF_KVAL(leaf), kval->val, kval->len);
+
+    return(leaf);
+
+} /* edubtm_ArtNewLeaf() */
+
+
+
+/*@================================
+ * edubtm_ArtNewNode()
+ *================================*/
+/*
+ * Function: btm_ArtNode *edubtm_ArtNewNode(One)
+ *
+ * Description:
+ *  Make an inner node of the given type with no children and no prefix.
+ *
+ * Returns:
+ *  the new node; NULL if it could not be allocated
+ */
+btm_ArtNode *edubtm_ArtNewNode(
+    One                 type)           /* IN type of the node */
+{
+    btm_ArtNode         *node;          /* the new node */
+
+
+    switch (type) {
+      case BTM_ART_NODE4:
+        node = (btm_ArtNode*)calloc(1, sizeof(btm_ArtNode4));
+        break;
+      case BTM_ART_NODE16:
+        node = (btm_ArtNode*)calloc(1, sizeof(btm_ArtNode16));
+        break;
+      case BTM_ART_NODE48:
+        node = (btm_ArtNode*)calloc(1, sizeof(btm_ArtNode48));
+        break;
+      default:
+        node = (btm_ArtNode*)calloc(1, sizeof(btm_ArtNode256));
+        break;
+    }
+    if (node == NULL) return(NULL);
+
+    node->type = type;
+
+    return(node);
+
+} /* edubtm_ArtNewNode() */
+
+
+
+/*@================================
+ * edubtm_ArtFreeTree()
+ *================================*/
+/*
+ * Function: void edubtm_ArtFreeTree(btm_ArtNode*)
+ *
+ * Description:
+ *  Free a node or a leaf with everything below it.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_ArtFreeTree(
+    btm_ArtNode         *node)          /* IN node or leaf to free; may be NULL */
+{
+    Four                c;              /* byte of a child */
+    Four                childByte;      /* byte of the child found */
+    btm_ArtNode         *child;         /* a child */
+    btm_ArtLeaf         *leaf;          /* 'node' as a leaf */
+
+
+    if (node == NULL) return;
+
+    if (IS_ARTLEAF(node)) {
+        leaf = (btm_ArtLeaf*)node;
+        if (leaf->oids != &leaf->firstOid) free(leaf->oids);
+        free(leaf);
+        return;
+    }
+
+    for (c = 0; (child = edubtm_ArtNeighborChild(node, c, TRUE, &childByte)) != NULL; c = childByte + 1)
+        edubtm_ArtFreeTree(child);
+
+    free(node);
+
+} /* edubtm_ArtFreeTree() */
+
+
+
+/*@================================
+ * edubtm_ArtLinkLeaf()
+ *================================*/
+/*
+ * Function: void edubtm_ArtLinkLeaf(btm_ArtLeaf*, btm_ArtLeaf*, btm_ArtLeaf*)
+ *
+ * Description:
+ *  Link a new leaf between the leaves of its previous and next keys. Only
+ *  one of them need be given; the other one is found by the links.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_ArtLinkLeaf(
+    btm_ArtLeaf         *leaf,          /* IN the new leaf */
+    btm_ArtLeaf         *prev,          /* IN leaf of the previous key; NULL if not known */
+    btm_ArtLeaf         *next)          /* IN leaf of the next key; NULL if not known */
+{
+    if (prev != NULL) next = prev->next;
+    else if (next != NULL) prev = next->prev;
+
+    leaf->prev = prev;
+    leaf->next = next;
+    if (prev != NULL) prev->next = leaf;
+    if (next != NULL) next->prev = leaf;
+
+} /* edubtm_ArtLinkLeaf() */
+
+
+
+/*@================================
+ * edubtm_ArtCompareLeaf()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtCompareLeaf(btm_ArtLeaf*, unsigned char*, Two)
+ *
+ * Description:
+ *  Compare the normalized key of a leaf with the given normalized key.
+ *
+ * Returns:
+ *  result of the comparison (the key of the leaf against 'nkey')
+ *    EQUAL
+ *    GREATER
+ *    LESS
+ */
+Four edubtm_ArtCompareLeaf(
+    btm_ArtLeaf         *leaf,          /* IN the leaf */
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen)           /* IN length of the normalized key */
+{
+    int                 cmp;            /* result of memcmp() */
+
+
+    cmp = memcmp(leaf->bytes, nkey, MIN(leaf->nlen, nlen));
+    if (cmp == 0) cmp = leaf->nlen - nlen;
+
+    return((cmp == 0) ? EQUAL : ((cmp > 0) ? GREATER : LESS));
+
+} /* edubtm_ArtCompareLeaf() */
+
+
+
+/*@================================
+ * edubtm_ArtSearchOid()
+ *================================*/
+/*
+ * Function: Boolean edubtm_ArtSearchOid(btm_ArtLeaf*, ObjectID*, Four*)
+ *
+ * Description:
+ *  Binary search for an ObjectID among those of a leaf.
+ *
+ * Returns:
+ *  TRUE if the ObjectID is in the leaf
+ *
+ * Side effects:
+ *  idx : position of the ObjectID, or of the first one greater than it
+ */
+Boolean edubtm_ArtSearchOid(
+    btm_ArtLeaf         *leaf,          /* IN the leaf */
+    ObjectID            *oid,           /* IN ObjectID to search */
+    Four                *idx)           /* OUT position of the ObjectID */
+{
+    Four                low, high;      /* bounds of the binary search */
+    Four                mid;            /* mid index */
+    Four                cmp;            /* result of the comparison */
+
+
+    for (low = 0, high = leaf->nOids - 1; low <= high; ) {
+        mid = (low + high) / 2;
+        cmp = btm_ObjectIdComp(&leaf->oids[mid], oid);
+        if (cmp == EQUAL) {
+            *idx = mid;
+            return(TRUE);
+        }
+        if (cmp == LESS) low = mid + 1;
+        else high = mid - 1;
+    }
+
+    *idx = low;
+    return(FALSE);
+
+} /* edubtm_ArtSearchOid() */
+
+
+
+/*@================================
+ * edubtm_ArtFindChild()
+ *================================*/
+/*
+ * Function: btm_ArtNode **edubtm_ArtFindChild(btm_ArtNode*, unsigned char)
+ *
+ * Description:
+ *  Find the child of an inner node for the given byte.
+ *
+ * Returns:
+ *  the link to the child; NULL if there is none
+ */
+btm_ArtNode **edubtm_ArtFindChild(
+    btm_ArtNode         *node,          /* IN the inner node */
+    unsigned char       c)              /* IN byte of the child */
+{
+    Two                 i;              /* index of the children */
+    btm_ArtNode4        *n4;            /* 'node' as a Node4 */
+    btm_ArtNode16       *n16;           /* 'node' as a Node16 */
+    btm_ArtNode48       *n48;           /* 'node' as a Node48 */
+    btm_ArtNode256      *n256;          /* 'node' as a Node256 */
+#ifdef __SSE2__
+    int                 bits;           /* mask of the keys equal to 'c' */
+#endif
+
+
+    switch (node->type) {
+      case BTM_ART_NODE4:
+        n4 = (btm_ArtNode4*)node;
+        for (i = 0; i < node->nChildren; i++)
+            if (n4->keys[i] == c) return(&n4->children[i]);
+        return(NULL);
+
+      case BTM_ART_NODE16:
+        n16 = (btm_ArtNode16*)node;
+#ifdef __SSE2__
+        bits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)c),
+                                                _mm_loadu_si128((__m128i*)n16->keys)));
+        bits &= (1 << node->nChildren) - 1;
+        if (bits != 0) return(&n16->children[__builtin_ctz(bits)]);
+#else
+        for (i = 0; i < node->nChildren; i++)
+            if (n16->keys[i] == c) return(&n16->children[i]);
+#endif
+        return(NULL);
+
+      case BTM_ART_NODE48:
+        n48 = (btm_ArtNode48*)node;
+        if (n48->childIndex[c] != 0) return(&n48->children[n48->childIndex[c] - 1]);
+        return(NULL);
+
+      default:
+        n256 = (btm_ArtNode256*)node;
+        if (n256->children[c] != NULL) return(&n256->children[c]);
+        return(NULL);
+    }
+
+} /* edubtm_ArtFindChild() */
+
+
+
+/*@================================
+ * edubtm_ArtNeighborChild()
+ *================================*/
+/*
+ * Function: btm_ArtNode *edubtm_ArtNeighborChild(btm_ArtNode*, Four, Boolean, Four*)
+ *
+ * Description:
+ *  Find the child of an inner node with the least byte not less than 'c',
+ *  or with the greatest byte not greater than 'c' if 'forward' is FALSE.
+ *  'c' may be out of the range of a byte, -1 or 256, to find nothing.
+ *
+ * Returns:
+ *  the child; NULL if there is none
+ *
+ * Side effects:
+ *  childByte : byte of the child found
+ */
+btm_ArtNode *edubtm_ArtNeighborChild(
+    btm_ArtNode         *node,          /* IN the inner node */
+    Four                c,              /* IN byte to start from */
+    Boolean             forward,        /* IN TRUE to look at the greater bytes */
+    Four                *childByte)     /* OUT byte of the child found */
+{
+    Four                i;              /* index of the children or byte */
+    unsigned char       *keys;          /* bytes of the children of a Node4 or Node16 */
+    btm_ArtNode         **children;     /* children of a Node4 or Node16 */
+    btm_ArtNode48       *n48;           /* 'node' as a Node48 */
+    btm_ArtNode256      *n256;          /* 'node' as a Node256 */
+
+
+    if (c < 0 || c > UCHAR_MAX) return(NULL);
+
+    switch (node->type) {
+      case BTM_ART_NODE4:
+      case BTM_ART_NODE16:
+        if (node->type == BTM_ART_NODE4) {
+            keys = ((btm_ArtNode4*)node)->keys;
+            children = ((btm_ArtNode4*)node)->children;
+        } else {
+            keys = ((btm_ArtNode16*)node)->keys;
+            children = ((btm_ArtNode16*)node)->children;
+        }
+        if (forward) {
+            for (i = 0; i < node->nChildren; i++)
+                if (keys[i] >= c) break;
+            if (i == node->nChildren) return(NULL);
+        } else {
+            for (i = node->nChildren - 1; i >= 0; i--)
+                if (keys[i] <= c) break;
+            if (i < 0) return(NULL);
+        }
+        *childByte = keys[i];
+        return(children[i]);
+
+      case BTM_ART_NODE48:
+        n48 = (btm_ArtNode48*)node;
+        for (i = c; i >= 0 && i <= UCHAR_MAX; i += forward ? 1 : -1)
+            if (n48->childIndex[i] != 0) {
+                *childByte = i;
+                return(n48->children[n48->childIndex[i] - 1]);
+            }
+        return(NULL);
+
+      default:
+        n256 = (btm_ArtNode256*)node;
+        for (i = c; i >= 0 && i <= UCHAR_MAX; i += forward ? 1 : -1)
+            if (n256->children[i] != NULL) {
+                *childByte = i;
+                return(n256->children[i]);
+            }
+        return(NULL);
+    }
+
+} /* edubtm_ArtNeighborChild() */
+
+
+
+/*@================================
+ * edubtm_ArtMinimum()
+ *================================*/
+/*
+ * Function: btm_ArtLeaf *edubtm_ArtMinimum(btm_ArtNode*)
+ *
+ * Description:
+ *  Find the leaf with the least key below a node.
+ *
+ * Returns:
+ *  the leaf; NULL if 'node' is NULL
+ */
+btm_ArtLeaf *edubtm_ArtMinimum(
+    btm_ArtNode         *node)          /* IN node or leaf; may be NULL */
+{
+    Four                childByte;      /* byte of the child found */
+
+
+    while (node != NULL && !IS_ARTLEAF(node))
+        node = edubtm_ArtNeighborChild(node, 0, TRUE, &childByte);
+
+    return((btm_ArtLeaf*)node);
+
+} /* edubtm_ArtMinimum() */
+
+
+
+/*@================================
+ * edubtm_ArtMaximum()
+ *================================*/
+/*
+ * Function: btm_ArtLeaf *edubtm_ArtMaximum(btm_ArtNode*)
+ *
+ * Description:
+ *  Find the leaf with the greatest key below a node.
+ *
+ * Returns:
+ *  the leaf; NULL if 'node' is NULL
+ */
+btm_ArtLeaf *edubtm_ArtMaximum(
+    btm_ArtNode         *node)          /* IN node or leaf; may be NULL */
+{
+    Four                childByte;      /* byte of the child found */
+
+
+    while (node != NULL && !IS_ARTLEAF(node))
+        node = edubtm_ArtNeighborChild(node, UCHAR_MAX, FALSE, &childByte);
+
+    return((btm_ArtLeaf*)node);
+
+} /* edubtm_ArtMaximum() */
+
+
+
+/*@================================
+ * edubtm_ArtAddChild()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtAddChild(btm_ArtNode**, unsigned char, btm_ArtNode*)
+ *
+ * Description:
+ *  Add a child for a byte not yet used to an inner node. A full node is
+ *  replaced by a node of the next larger type, linked from 'ref'.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ */
+Four edubtm_ArtAddChild(
+    btm_ArtNode         **ref,          /* INOUT link to the inner node */
+    unsigned char       c,              /* IN byte of the child */
+    btm_ArtNode         *child)         /* IN the child */
+{
+    Four                i;              /* index of the children or byte */
+    Two                 n;              /* # of children */
+    btm_ArtNode         *node;          /* the inner node */
+    btm_ArtNode4        *n4;            /* 'node' as a Node4 */
+    btm_ArtNode16       *n16;           /* 'node' as a Node16 */
+    btm_ArtNode48       *n48;           /* 'node' as a Node48 */
+    btm_ArtNode256      *n256;          /* 'node' as a Node256 */
+    btm_ArtNode         *grown;         /* node of the next larger type */
+
+
+    node = *ref;
+    n = node->nChildren;
+
+    switch (node->type) {
+      case BTM_ART_NODE4:
+        n4 = (btm_ArtNode4*)node;
+        if (n < 4) {
+            for (i = 0; i < n && n4->keys[i] < c; i++);
+            memmove(&n4->keys[i + 1], &n4->keys[i], n - i);
+            memmove(&n4->children[i + 1], &n4->children[i], (n - i) * sizeof(btm_ArtNode*));
+            n4->keys[i] = c;
+            n4->children[i] = child;
+            node->nChildren++;
+            return(eNOERROR);
+        }
+
+        grown = edubtm_ArtNewNode(BTM_ART_NODE16);
+        if (grown == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        memcpy(((btm_ArtNode16*)grown)->keys, n4->keys, n);
+        memcpy(((btm_ArtNode16*)grown)->children, n4->children, n * sizeof(btm_ArtNode*));
+        break;
+
+      case BTM_ART_NODE16:
+        n16 = (btm_ArtNode16*)node;
+        if (n < 16) {
+            for (i = 0; i < n && n16->keys[i] < c; i++);
+            memmove(&n16->keys[i + 1], &n16->keys[i], n - i);
+            memmove(&n16->children[i + 1], &n16->children[i], (n - i) * sizeof(btm_ArtNode*));
+            n16->keys[i] = c;
+            n16->children[i] = child;
+            node->nChildren++;
+            return(eNOERROR);
+        }
+
+        grown = edubtm_ArtNewNode(BTM_ART_NODE48);
+        if (grown == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        for (i = 0; i < n; i++) {
+            ((btm_ArtNode48*)grown)->children[i] = n16->children[i];
+            ((btm_ArtNode48*)grown)->childIndex[n16->keys[i]] = i + 1;
+        }
+        break;
+
+      case BTM_ART_NODE48:
+        n48 = (btm_ArtNode48*)node;
+        if (n < 48) {
+            for (i = 0; n48->children[i] != NULL; i++);
+            n48->children[i] = child;
+            n48->childIndex[c] = i + 1;
+            node->nChildren++;
+            return(eNOERROR);
+        }
+
+        grown = edubtm_ArtNewNode(BTM_ART_NODE256);
+        if (grown == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        for (i = 0; i <= UCHAR_MAX; i++)
+            if (n48->childIndex[i] != 0)
+                ((btm_ArtNode256*)grown)->children[i] = n48->children[n48->childIndex[i] - 1];
+        break;
+
+      default:
+        n256 = (btm_ArtNode256*)node;
+        n256->children[c] = child;
+        node->nChildren++;
+        return(eNOERROR);
+    }
+
+    /*@ replace the full node and add the child to the new one */
+    grown->nChildren = node->nChildren;
+    grown->prefixLen = node->prefixLen;
+    memcpy(grown->prefix, node->prefix, BTM_ART_MAXPREFIX);
+    *ref = grown;
+    free(node);
+
+    return(edubtm_ArtAddChild(ref, c, child));
+
+} /* edubtm_ArtAddChild() */
+
+
+
+/*@================================
+ * edubtm_ArtRemoveChild()
+ *================================*/
+/*
+ * Function: void edubtm_ArtRemoveChild(btm_ArtNode**, unsigned char, btm_ArtNode**)
+ *
+ * Description:
+ *  Remove the child of a byte from an inner node. A node left with few
+ *  children is replaced by a node of the next smaller type, unless it could
+ *  not be allocated; a Node4 left with one child is replaced by the child,
+ *  which takes over the prefix of the node and the byte of the child.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_ArtRemoveChild(
+    btm_ArtNode         **ref,          /* INOUT link to the inner node */
+    unsigned char       c,              /* IN byte of the child */
+    btm_ArtNode         **slot)         /* IN link to the child in the node */
+{
+    Four                i, j;           /* index of the children or byte */
+    Four                len;            /* # of prefix bytes to store */
+    btm_ArtNode         *node;          /* the inner node */
+    btm_ArtNode4        *n4;            /* 'node' as a Node4 */
+    btm_ArtNode16       *n16;           /* 'node' as a Node16 */
+    btm_ArtNode48       *n48;           /* 'node' as a Node48 */
+    btm_ArtNode256      *n256;          /* 'node' as a Node256 */
+    btm_ArtNode         *shrunk;        /* node of the next smaller type */
+    btm_ArtNode         *child;         /* the only child left */
+
+
+    node = *ref;
+    shrunk = NULL;
+
+    switch (node->type) {
+      case BTM_ART_NODE4:
+        n4 = (btm_ArtNode4*)node;
+        i = slot - n4->children;
+        memmove(&n4->keys[i], &n4->keys[i + 1], node->nChildren - i - 1);
+        memmove(&n4->children[i], &n4->children[i + 1], (node->nChildren - i - 1) * sizeof(btm_ArtNode*));
+        node->nChildren--;
+
+        if (node->nChildren == 1) {
+            /*@ collapse the node into its child */
+            child = n4->children[0];
+            if (!IS_ARTLEAF(child)) {
+                len = node->prefixLen;
+                if (len < BTM_ART_MAXPREFIX) node->prefix[len++] = n4->keys[0];
+                if (len < BTM_ART_MAXPREFIX) {
+                    j = MIN(child->prefixLen, BTM_ART_MAXPREFIX - len);
+                    memcpy(&node->prefix[len], child->prefix, j);
+                    len += j;
+                }
+                memcpy(child->prefix, node->prefix, MIN(len, BTM_ART_MAXPREFIX));
+                child->prefixLen += node->prefixLen + 1;
+            }
+            *ref = child;
+            free(node);
+        }
+        return;
+
+      case BTM_ART_NODE16:
+        n16 = (btm_ArtNode16*)node;
+        i = slot - n16->children;
+        memmove(&n16->keys[i], &n16->keys[i + 1], node->nChildren - i - 1);
+        memmove(&n16->children[i], &n16->children[i + 1], (node->nChildren - i - 1) * sizeof(btm_ArtNode*));
+        node->nChildren--;
+
+        if (node->nChildren == 3 && (shrunk = edubtm_ArtNewNode(BTM_ART_NODE4)) != NULL) {
+            memcpy(((btm_ArtNode4*)shrunk)->keys, n16->keys, 3);
+            memcpy(((btm_ArtNode4*)shrunk)->children, n16->children, 3 * sizeof(btm_ArtNode*));
+        }
+        break;
+
+      case BTM_ART_NODE48:
+        n48 = (btm_ArtNode48*)node;
+        n48->children[n48->childIndex[c] - 1] = NULL;
+        n48->childIndex[c] = 0;
+        node->nChildren--;
+
+        if (node->nChildren == 12 && (shrunk = edubtm_ArtNewNode(BTM_ART_NODE16)) != NULL) {
+            for (i = j = 0; i <= UCHAR_MAX; i++)
+                if (n48->childIndex[i] != 0) {
+                    ((btm_ArtNode16*)shrunk)->keys[j] = i;
+                    ((btm_ArtNode16*)shrunk)->children[j] = n48->children[n48->childIndex[i] - 1];
+                    j++;
+                }
+        }
+        break;
+
+      default:
+        n256 = (btm_ArtNode256*)node;
+        n256->children[c] = NULL;
+        node->nChildren--;
+
+        if (node->nChildren == 37 && (shrunk = edubtm_ArtNewNode(BTM_ART_NODE48)) != NULL) {
+            for (i = j = 0; i <= UCHAR_MAX; i++)
+                if (n256->children[i] != NULL) {
+                    ((btm_ArtNode48*)shrunk)->children[j] = n256->children[i];
+                    ((btm_ArtNode48*)shrunk)->childIndex[i] = ++j;
+                }
+        }
+        break;
+    }
+
+    /*@ replace the node by the smaller one */
+    if (shrunk != NULL) {
+        shrunk->nChildren = node->nChildren;
+        shrunk->prefixLen = node->prefixLen;
+        memcpy(shrunk->prefix, node->prefix, BTM_ART_MAXPREFIX);
+        *ref = shrunk;
+        free(node);
+    }
+
+} /* edubtm_ArtRemoveChild() */
+
+
+
+/*@================================
+ * edubtm_ArtInsertNode()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtInsertNode(btm_ArtNode**, unsigned char*, Two, Four, KeyValue*, ObjectID*, Boolean, Boolean*)
+ *
+ * Description:
+ *  Insert <kval, oid> below the node linked from 'ref', whose bytes before
+ *  'depth' match the normalized key. The ObjectID is added to the leaf of
+ *  the key if there is one; otherwise a new leaf is added, splitting a leaf
+ *  or a prefix of a node that differs from the key with a new Node4.
+ *
+ * Returns:
+ *  Error code
+ *    eDUPLICATEDKEY_BTM
+ *    eDUPLICATEDOBJECTID_BTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    eBADPARAMETER_BTM
+ *
+ * Side effects:
+ *  newKey : TRUE if a leaf was made for the key
+ */
+Four edubtm_ArtInsertNode(
+    btm_ArtNode         **ref,          /* INOUT link to the node or leaf */
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen,           /* IN length of the normalized key */
+    Four                depth,          /* IN # of bytes of the key matched above the node */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid,           /* IN ObjectID to insert */
+    Boolean             unique,         /* IN TRUE if the keys of the index are unique */
+    Boolean             *newKey)        /* OUT TRUE if a leaf was made for the key */
+{
+    Four                e;              /* error number */
+    Four                i;              /* index */
+    Four                diff;           /* # of bytes of the prefix matching the key */
+    Four                idx;            /* position of the ObjectID in the leaf */
+    unsigned char       c;              /* byte of the old node under the new Node4 */
+    btm_ArtNode         *node;          /* the node or leaf */
+    btm_ArtNode         **child;        /* link to the child for the next byte */
+    btm_ArtNode         *split;         /* new Node4 over the node and the new leaf */
+    btm_ArtLeaf         *leaf;          /* 'node' as a leaf */
+    btm_ArtLeaf         *minLeaf;       /* leaf holding the bytes of a long prefix */
+    btm_ArtLeaf         *newLeaf;       /* leaf of the new key */
+    btm_ArtLeaf         *prev, *next;   /* leaves of the keys around the new one */
+    Four                childByte;      /* byte of a child beside the new one */
+    ObjectID            *oids;          /* larger array of ObjectIDs */
+
+
+    node = *ref;
+
+    /*@ an empty tree */
+    if (node == NULL) {
+        newLeaf = edubtm_ArtNewLeaf(nkey, nlen, kval, oid);
+        if (newLeaf == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+        edubtm_ArtLinkLeaf(newLeaf, NULL, NULL);
+        *ref = (btm_ArtNode*)newLeaf;
+        *newKey = TRUE;
+        return(eNOERROR);
+    }
+
+    if (IS_ARTLEAF(node)) {
+        leaf = (btm_ArtLeaf*)node;
+
+        /*@ add the ObjectID to the leaf of the key */
+        if (edubtm_ArtCompareLeaf(leaf, nkey, nlen) == EQUAL) {
+            if (unique) ERR(eDUPLICATEDKEY_BTM);
+            if (edubtm_ArtSearchOid(leaf, oid, &idx)) ERR(eDUPLICATEDOBJECTID_BTM);
+
+            if (leaf->nOids == leaf->maxOids) {
+                oids = (ObjectID*)malloc(2 * leaf->maxOids * sizeof(ObjectID));
+                if (oids == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+                memcpy(oids, leaf->oids, leaf->nOids * sizeof(ObjectID));
+                if (leaf->oids != &leaf->firstOid) free(leaf->oids);
+                leaf->oids = oids;
+                leaf->maxOids *= 2;
+            }
+
+            memmove(&leaf->oids[idx + 1], &leaf->oids[idx], (leaf->nOids - idx) * sizeof(ObjectID));
+            leaf->oids[idx] = *oid;
+            leaf->nOids++;
+            return(eNOERROR);
+        }
+
+        /*@ split the leaf on the first byte where the keys differ */
+        for (i = depth; i < leaf->nlen && i < nlen && leaf->bytes[i] == nkey[i]; i++);
+        if (i == leaf->nlen || i == nlen) ERR(eBADPARAMETER_BTM);
+
+        newLeaf = edubtm_ArtNewLeaf(nkey, nlen, kval, oid);
+        if (newLeaf == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        split = edubtm_ArtNewNode(BTM_ART_NODE4);
+        if (split == NULL) {
+            free(newLeaf);
+            ERR(eMEMORYALLOCERR_EDUBTM);
+        }
+
+        split->prefixLen = i - depth;
+        memcpy(split->prefix, &nkey[depth], MIN(i - depth, BTM_ART_MAXPREFIX));
+        edubtm_ArtAddChild(&split, leaf->bytes[i], node);
+        edubtm_ArtAddChild(&split, nkey[i], (btm_ArtNode*)newLeaf);
+
+        /* no other key shares the bytes before 'i' */
+        if (nkey[i] > leaf->bytes[i]) edubtm_ArtLinkLeaf(newLeaf, leaf, NULL);
+        else edubtm_ArtLinkLeaf(newLeaf, NULL, leaf);
+
+        *ref = split;
+        *newKey = TRUE;
+        return(eNOERROR);
+    }
+
+    if (node->prefixLen > 0) {
+        /*@ compare the prefix; the bytes not stored are read from a leaf */
+        minLeaf = NULL;
+        for (diff = 0; diff < node->prefixLen && depth + diff < nlen; diff++) {
+            if (diff < BTM_ART_MAXPREFIX) c = node->prefix[diff];
+            else {
+                if (minLeaf == NULL) minLeaf = edubtm_ArtMinimum(node);
+                c = minLeaf->bytes[depth + diff];
+            }
+            if (c != nkey[depth + diff]) break;
+        }
+
+        /*@ split the prefix on the first byte where it differs from the key */
+        if (diff < node->prefixLen) {
+            if (depth + diff == nlen) ERR(eBADPARAMETER_BTM);
+
+            newLeaf = edubtm_ArtNewLeaf(nkey, nlen, kval, oid);
+            if (newLeaf == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+            split = edubtm_ArtNewNode(BTM_ART_NODE4);
+            if (split == NULL) {
+                free(newLeaf);
+                ERR(eMEMORYALLOCERR_EDUBTM);
+            }
+
+            split->prefixLen = diff;
+            memcpy(split->prefix, &nkey[depth], MIN(diff, BTM_ART_MAXPREFIX));
+
+            if (node->prefixLen <= BTM_ART_MAXPREFIX) {
+                c = node->prefix[diff];
+                node->prefixLen -= diff + 1;
+                memmove(node->prefix, &node->prefix[diff + 1], node->prefixLen);
+            } else {
+                if (minLeaf == NULL) minLeaf = edubtm_ArtMinimum(node);
+                c = minLeaf->bytes[depth + diff];
+                node->prefixLen -= diff + 1;
+                memcpy(node->prefix, &minLeaf->bytes[depth + diff + 1], MIN(node->prefixLen, BTM_ART_MAXPREFIX));
+            }
+
+            edubtm_ArtAddChild(&split, c, node);
+            edubtm_ArtAddChild(&split, nkey[depth + diff], (btm_ArtNode*)newLeaf);
+
+            if (nkey[depth + diff] > c) edubtm_ArtLinkLeaf(newLeaf, edubtm_ArtMaximum(node), NULL);
+            else edubtm_ArtLinkLeaf(newLeaf, NULL, edubtm_ArtMinimum(node));
+
+            *ref = split;
+            *newKey = TRUE;
+            return(eNOERROR);
+        }
+
+        depth += node->prefixLen;
+    }
+
+    if (depth >= nlen) ERR(eBADPARAMETER_BTM);
+
+    /*@ go down to the child of the next byte */
+    child = edubtm_ArtFindChild(node, nkey[depth]);
+    if (child != NULL) {
+        e = edubtm_ArtInsertNode(child, nkey, nlen, depth + 1, kval, oid, unique, newKey);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    /*@ add a leaf as a new child */
+    newLeaf = edubtm_ArtNewLeaf(nkey, nlen, kval, oid);
+    if (newLeaf == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+    /* the neighbors are found before the node may be replaced */
+    next = edubtm_ArtMinimum(edubtm_ArtNeighborChild(node, nkey[depth] + 1, TRUE, &childByte));
+    prev = (next == NULL) ? edubtm_ArtMaximum(edubtm_ArtNeighborChild(node, nkey[depth] - 1, FALSE, &childByte)) : NULL;
+
+    e = edubtm_ArtAddChild(ref, nkey[depth], (btm_ArtNode*)newLeaf);
+    if (e < eNOERROR) {
+        free(newLeaf);
+        ERR(e);
+    }
+
+    edubtm_ArtLinkLeaf(newLeaf, prev, next);
+
+    *newKey = TRUE;
+    return(eNOERROR);
+
+} /* edubtm_ArtInsertNode() */
+
+
+
+/*@================================
+ * edubtm_ArtDeleteNode()
+ *================================*/
+/*
+ * Function: Four edubtm_ArtDeleteNode(btm_ArtNode**, unsigned char*, Two, Four, ObjectID*, Boolean*)
+ *
+ * Description:
+ *  Delete an ObjectID of a key below the node linked from 'ref', whose
+ *  bytes before 'depth' match the normalized key. The leaf of the key is
+ *  removed from its parent with its last ObjectID.
+ *
+ * Returns:
+ *  Error code
+ *    eNOTFOUND_BTM
+ *
+ * Side effects:
+ *  keyRemoved : TRUE if the leaf of the key was removed
+ */
+Four edubtm_ArtDeleteNode(
+    btm_ArtNode         **ref,          /* INOUT link to the node or leaf */
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen,           /* IN length of the normalized key */
+    Four                depth,          /* IN # of bytes of the key matched above the node */
+    ObjectID            *oid,           /* IN ObjectID to delete */
+    Boolean             *keyRemoved)    /* OUT TRUE if the leaf of the key was removed */
+{
+    Four                i;              /* index */
+    Four                idx;            /* position of the ObjectID in the leaf */
+    btm_ArtNode         *node;          /* the node or leaf */
+    btm_ArtNode         **child;        /* link to the child for the next byte */
+    btm_ArtNode         **leafRef;      /* link to the leaf of the key */
+    btm_ArtLeaf         *leaf;          /* leaf of the key */
+
+
+    node = *ref;
+    if (node == NULL) return(eNOTFOUND_BTM);
+
+    /*@ find the leaf of the key and the link to it */
+    child = NULL;
+    if (IS_ARTLEAF(node))
+        leafRef = ref;
+    else {
+        if (node->prefixLen > 0) {
+            for (i = 0; i < MIN(node->prefixLen, BTM_ART_MAXPREFIX); i++)
+                if (depth + i >= nlen || node->prefix[i] != nkey[depth + i]) return(eNOTFOUND_BTM);
+            depth += node->prefixLen;
+        }
+        if (depth >= nlen) return(eNOTFOUND_BTM);
+
+        child = edubtm_ArtFindChild(node, nkey[depth]);
+        if (child == NULL) return(eNOTFOUND_BTM);
+
+        if (!IS_ARTLEAF(*child))
+            return(edubtm_ArtDeleteNode(child, nkey, nlen, depth + 1, oid, keyRemoved));
+
+        leafRef = child;
+    }
+
+    leaf = (btm_ArtLeaf*)*leafRef;
+    if (edubtm_ArtCompareLeaf(leaf, nkey, nlen) != EQUAL) return(eNOTFOUND_BTM);
+    if (!edubtm_ArtSearchOid(leaf, oid, &idx)) return(eNOTFOUND_BTM);
+
+    /*@ delete the ObjectID */
+    memmove(&leaf->oids[idx], &leaf->oids[idx + 1], (leaf->nOids - idx - 1) * sizeof(ObjectID));
+    leaf->nOids--;
+    if (leaf->nOids > 0) return(eNOERROR);
+
+    /*@ remove the leaf with its last ObjectID */
+    if (leaf->prev != NULL) leaf->prev->next = leaf->next;
+    if (leaf->next != NULL) leaf->next->prev = leaf->prev;
+
+    if (child == NULL) *ref = NULL;
+    else edubtm_ArtRemoveChild(ref, nkey[depth], child);
+    edubtm_ArtFreeTree((btm_ArtNode*)leaf);
+    *keyRemoved = TRUE;
+
+    return(eNOERROR);
+
+} /* edubtm_ArtDeleteNode() */
+
+
+
+/*@================================
+ * edubtm_ArtSearch()
+ *================================*/
+/*
+ * Function: btm_ArtLeaf *edubtm_ArtSearch(btm_ArtNode*, unsigned char*, Two)
+ *
+ * Description:
+ *  Find the leaf of a normalized key. Only the stored bytes of the prefixes
+ *  are compared on the way down; the key of the leaf reached is compared
+ *  with the whole key.
+ *
+ * Returns:
+ *  the leaf; NULL if the key is not in the tree
+ */
+btm_ArtLeaf *edubtm_ArtSearch(
+    btm_ArtNode         *node,          /* IN root of the tree; may be NULL */
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen)           /* IN length of the normalized key */
+{
+    Four                i;              /* index */
+    Four                depth;          /* # of bytes of the key matched */
+    btm_ArtNode         **child;        /* link to the child for the next byte */
+
+
+    for (depth = 0; node != NULL && !IS_ARTLEAF(node); depth++) {
+        if (node->prefixLen > 0) {
+            for (i = 0; i < MIN(node->prefixLen, BTM_ART_MAXPREFIX); i++)
+                if (depth + i >= nlen || node->prefix[i] != nkey[depth + i]) return(NULL);
+            depth += node->prefixLen;
+        }
+        if (depth >= nlen) return(NULL);
+
+        child = edubtm_ArtFindChild(node, nkey[depth]);
+        node = (child != NULL) ? *child : NULL;
+    }
+
+    if (node == NULL || edubtm_ArtCompareLeaf((btm_ArtLeaf*)node, nkey, nlen) != EQUAL) return(NULL);
+
+    return((btm_ArtLeaf*)node);
+
+} /* edubtm_ArtSearch() */
+
+
+
+/*@================================
+ * edubtm_ArtSeek()
+ *================================*/
+/*
+ * Function: btm_ArtLeaf *edubtm_ArtSeek(btm_ArtNode*, unsigned char*, Two, Four, Boolean, Boolean)
+ *
+ * Description:
+ *  Find, below a node whose bytes before 'depth' match the normalized key,
+ *  the leaf with the least key greater than or equal to the given one, or
+ *  with the greatest key less than or equal to it if 'forward' is FALSE.
+ *  The key itself is skipped if 'strict' is TRUE.
+ *
+ * Returns:
+ *  the leaf; NULL if there is none
+ */
+btm_ArtLeaf *edubtm_ArtSeek(
+    btm_ArtNode         *node,          /* IN node or leaf; may be NULL */
+    unsigned char       *nkey,          /* IN normalized key */
+    Two                 nlen,           /* IN length of the normalized key */
+    Four                depth,          /* IN # of bytes of the key matched above the node */
+    Boolean             forward,        /* IN TRUE to find a greater key */
+    Boolean             strict)         /* IN TRUE to skip the key itself */
+{
+    Four                i;              /* index */
+    Four                cmp;            /* result of the comparison */
+    Four                c;              /* next byte of the key */
+    Four                childByte;      /* byte of the child found */
+    unsigned char       b;              /* a byte of the prefix */
+    btm_ArtNode         *child;         /* child for the next byte or beside it */
+    btm_ArtLeaf         *leaf;          /* the leaf found */
+    btm_ArtLeaf         *minLeaf;       /* leaf holding the bytes of a long prefix */
+
+
+    if (node == NULL) return(NULL);
+
+    if (IS_ARTLEAF(node)) {
+        cmp = edubtm_ArtCompareLeaf((btm_ArtLeaf*)node, nkey, nlen);
+        if (cmp == EQUAL) return(strict ? NULL : (btm_ArtLeaf*)node);
+        return((cmp == (forward ? GREATER : LESS)) ? (btm_ArtLeaf*)node : NULL);
+    }
+
+    /*@ the keys below a prefix differing from the key are all on one side of it */
+    if (node->prefixLen > 0) {
+        minLeaf = NULL;
+        for (i = 0; i < node->prefixLen; i++) {
+            if (i < BTM_ART_MAXPREFIX) b = node->prefix[i];
+            else {
+                if (minLeaf == NULL) minLeaf = edubtm_ArtMinimum(node);
+                b = minLeaf->bytes[depth + i];
+            }
+            if (depth + i >= nlen || b > nkey[depth + i])
+                return(forward ? edubtm_ArtMinimum(node) : NULL);
+            if (b < nkey[depth + i])
+                return(forward ? NULL : edubtm_ArtMaximum(node));
+        }
+        depth += node->prefixLen;
+    }
+
+    if (depth >= nlen) return(forward ? edubtm_ArtMinimum(node) : NULL);
+
+    /*@ look below the child of the next byte, then beside it */
+    c = nkey[depth];
+    child = edubtm_ArtNeighborChild(node, c, forward, &childByte);
+    if (child != NULL && childByte == c) {
+        leaf = edubtm_ArtSeek(child, nkey, nlen, depth + 1, forward, strict);
+        if (leaf != NULL) return(leaf);
+
+        child = edubtm_ArtNeighborChild(node, forward ? c + 1 : c - 1, forward, &childByte);
+    }
+    if (child == NULL) return(NULL);
+
+    return(forward ? edubtm_ArtMinimum(child) : edubtm_ArtMaximum(child));
+
+} /* edubtm_ArtSeek() */
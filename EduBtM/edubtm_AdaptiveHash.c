@@ -0,0 +1,386 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_AdaptiveHash.c
+ *
+ * Description :
+ *  Adaptive hash index in front of the Btree indexes. It maps a key which
+ *  has often been searched for equality directly to the leaf slot holding
+ *  it, so that such a search fixes one leaf page and compares one key.
+ *  The entries are made from the observed searches: each search which finds
+ *  its key counts it, and a key is entered when its counter reaches
+ *  BTM_AHI_THRESHOLD. The table has a fixed number of entries shared by
+ *  all indexes, and the clock algorithm replaces the entries which have not
+ *  been used recently.
+ *
+ *  Since the keys are unique, an entry is valid as long as its slot holds
+ *  the key; insertions, splits and deletions moving the key are detected by
+ *  checking the slot, and the entry is dropped then. An entry made before a
+ *  page of its index may have been freed by an underflow is dropped without
+ *  looking at the page.
+ *
+ * Exports:
+ *  Four edubtm_LookUpAdaptiveHash(PageID*, btm_IndexInfo*, KeyDesc*, KeyValue*,
+ *                                 BtreeCursor*, Boolean*)
+ *  void edubtm_NoteAdaptiveHash(PageID*, btm_IndexInfo*, BtreeCursor*)
+ *  void edubtm_RemoveAdaptiveHash(PageID*, KeyValue*)
+ *  void edubtm_DropAdaptiveHash(PageID*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+void edubtm_InitAdaptiveHash(void);
+Four edubtm_AhiHash(PageID*, KeyValue*);
+Four edubtm_AhiFind(PageID*, KeyValue*, Four);
+void edubtm_AhiUnlink(Four);
+
+
+/*@ Global Variables */
+static btm_AhiEntry edubtm_ahiTable[BTM_AHI_ENTRIES];    /* entries of the adaptive hash index */
+static Four edubtm_ahiBuckets[BTM_AHI_BUCKETS];          /* first entry of each bucket; NIL if none */
+static Two edubtm_ahiCounters[BTM_AHI_COUNTERS];         /* # of searches counted for the keys */
+static Four edubtm_ahiClock = 0;                         /* clock hand for the replacement */
+static Boolean edubtm_ahiInitialized = FALSE;            /* TRUE if the buckets are initialized */
+
+
+
+/*@================================
+ * edubtm_LookUpAdaptiveHash()
+ *================================*/
+/*
+ * Function: Four edubtm_LookUpAdaptiveHash(PageID*, btm_IndexInfo*, KeyDesc*,
+ *                                         KeyValue*, BtreeCursor*, Boolean*)
+ *
+ * Description:
+ *  Look up the key in the adaptive hash index. If there is an entry and its
+ *  slot still holds the key, the cursor is set to the slot. An entry which
+ *  turns out to be invalid is dropped.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) cursor : set to the key if it is found
+ *  2) found  : TRUE if the key is found
+ */
+Four edubtm_LookUpAdaptiveHash(
+    PageID              *root,          /* IN root page of the index */
+    btm_IndexInfo       *info,          /* IN information about the index */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value to search */
+    BtreeCursor         *cursor,        /* OUT cursor pointing to the key */
+    Boolean             *found)         /* OUT TRUE if the key is found */
+{
+    Four                e;              /* error number */
+    Four                idx;            /* index of the entry */
+    btm_AhiEntry        *entry;         /* the entry of the key */
+    BtreeLeaf           *apage;         /* pointer to the buffer of the leaf page */
+    btm_LeafEntry       *lEntry;        /* the leaf entry in the slot */
+    Boolean             valid;          /* TRUE if the slot holds the key */
+
+
+    *found = FALSE;
+
+    idx = edubtm_AhiFind(root, kval, edubtm_AhiHash(root, kval));
+    if (idx == NIL) return(eNOERROR);
+
+    entry = &edubtm_ahiTable[idx];
+    if (entry->nUnderflows != info->nUnderflows) {
+        edubtm_AhiUnlink(idx);
+        return(eNOERROR);
+    }
+
+    e = BfM_GetTrain(&entry->leaf, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    valid = ((apage->hdr.type & LEAF) && entry->slotNo < apage->hdr.nSlots) ? TRUE : FALSE;
+    if (valid) {
+        lEntry = (btm_LeafEntry*)&apage->data[apage->slot[-entry->slotNo]];
+        valid = (edubtm_KeyCompare(kdesc, kval, (KeyValue*)&lEntry->klen) == EQUAL) ? TRUE : FALSE;
+    }
+
+    if (valid) {
+        e = edubtm_FirstObjectId(entry->leaf.volNo, lEntry, FALSE, &cursor->overflow, &cursor->oidArrayElemNo, &cursor->oid);
+        if (e < eNOERROR) ERRB1(e, &entry->leaf, PAGE_BUF);
+
+        cursor->flag = (One)CURSOR_ON;
+        memcpy(&cursor->key, &lEntry->klen, sizeof(Two) + lEntry->klen);
+        cursor->leaf = entry->leaf;
+        cursor->slotNo = entry->slotNo;
+
+        entry->referenced = TRUE;
+        *found = TRUE;
+    }
+    else
+        edubtm_AhiUnlink(idx);
+
+    e = BfM_FreeTrain(&entry->leaf, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_LookUpAdaptiveHash() */
+
+
+
+/*@================================
+ * edubtm_NoteAdaptiveHash()
+ *================================*/
+/*
+ * Function: void edubtm_NoteAdaptiveHash(PageID*, btm_IndexInfo*, BtreeCursor*)
+ *
+ * Description:
+ *  Count an equality search which found the key pointed by the cursor, and
+ *  enter the key when it has been counted BTM_AHI_THRESHOLD times.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_NoteAdaptiveHash(
+    PageID              *root,          /* IN root page of the index */
+    btm_IndexInfo       *info,          /* IN information about the index */
+    BtreeCursor         *cursor)        /* IN cursor pointing to the key found */
+{
+    Four                hashValue;      /* hash value of the key */
+    Four                idx;            /* index of the new entry */
+    Four                bucket;         /* bucket of the new entry */
+    btm_AhiEntry        *entry;         /* the new entry */
+
+
+    hashValue = edubtm_AhiHash(root, &cursor->key);
+    if (edubtm_AhiFind(root, &cursor->key, hashValue) != NIL) return;
+
+    if (++edubtm_ahiCounters[hashValue % BTM_AHI_COUNTERS] < BTM_AHI_THRESHOLD) return;
+    edubtm_ahiCounters[hashValue % BTM_AHI_COUNTERS] = 0;
+
+    /*@ select an entry by the clock algorithm */
+    for ( ; ; edubtm_ahiClock = (edubtm_ahiClock + 1) % BTM_AHI_ENTRIES) {
+        entry = &edubtm_ahiTable[edubtm_ahiClock];
+        if (!entry->isUsed) break;
+        if (!entry->referenced) {
+            edubtm_AhiUnlink(edubtm_ahiClock);
+            break;
+        }
+        entry->referenced = FALSE;
+    }
+    idx = edubtm_ahiClock;
+    edubtm_ahiClock = (edubtm_ahiClock + 1) % BTM_AHI_ENTRIES;
+
+    bucket = hashValue % BTM_AHI_BUCKETS;
+    entry->isUsed = TRUE;
+    entry->referenced = FALSE;
+    entry->hashValue = hashValue;
+    entry->next = edubtm_ahiBuckets[bucket];
+    entry->root = *root;
+    entry->nUnderflows = info->nUnderflows;
+    entry->leaf = cursor->leaf;
+    entry->slotNo = cursor->slotNo;
+    memcpy(&entry->key, &cursor->key, sizeof(Two) + cursor->key.len);
+    edubtm_ahiBuckets[bucket] = idx;
+
+}   /* edubtm_NoteAdaptiveHash() */
+
+
+
+/*@================================
+ * edubtm_RemoveAdaptiveHash()
+ *================================*/
+/*
+ * Function: void edubtm_RemoveAdaptiveHash(PageID*, KeyValue*)
+ *
+ * Description:
+ *  Remove the entry of the key, which is being deleted from the index.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_RemoveAdaptiveHash(
+    PageID              *root,          /* IN root page of the index */
+    KeyValue            *kval)          /* IN key value being deleted */
+{
+    Four                idx;            /* index of the entry */
+
+
+    idx = edubtm_AhiFind(root, kval, edubtm_AhiHash(root, kval));
+    if (idx != NIL) edubtm_AhiUnlink(idx);
+
+}   /* edubtm_RemoveAdaptiveHash() */
+
+
+
+/*@================================
+ * edubtm_DropAdaptiveHash()
+ *================================*/
+/*
+ * Function: void edubtm_DropAdaptiveHash(PageID*)
+ *
+ * Description:
+ *  Remove all the entries of the index given by 'root'.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_DropAdaptiveHash(
+    PageID              *root)          /* IN root page of the index */
+{
+    Four                i;              /* index of the entries */
+
+
+    for (i = 0; i < BTM_AHI_ENTRIES; i++)
+        if (edubtm_ahiTable[i].isUsed && edubtm_ahiTable[i].root.volNo == root->volNo &&
+            edubtm_ahiTable[i].root.pageNo == root->pageNo)
+            edubtm_AhiUnlink(i);
+
+}   /* edubtm_DropAdaptiveHash() */
+
+
+
+/*@================================
+ * edubtm_InitAdaptiveHash()
+ *================================*/
+/*
+ * Function: void edubtm_InitAdaptiveHash(void)
+ *
+ * Description:
+ *  Make all the buckets empty when the adaptive hash index is used first.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_InitAdaptiveHash(void)
+{
+    Four                i;              /* index of the buckets */
+
+
+    for (i = 0; i < BTM_AHI_BUCKETS; i++) edubtm_ahiBuckets[i] = NIL;
+    edubtm_ahiInitialized = TRUE;
+
+}   /* edubtm_InitAdaptiveHash() */
+
+
+
+/*@================================
+ * edubtm_AhiHash()
+ *================================*/
+/*
+ * Function: Four edubtm_AhiHash(PageID*, KeyValue*)
+ *
+ * Description:
+ *  Return the hash value of the root page and the key (FNV-1a).
+ *
+ * Returns:
+ *  non-negative hash value
+ */
+Four edubtm_AhiHash(
+    PageID              *root,          /* IN root page of the index */
+    KeyValue            *kval)          /* IN key value */
+{
+    UFour               h;              /* hash value */
+    Two                 i;              /* index of the key bytes */
+
+
+    h = 2166136261U ^ (UFour)root->pageNo ^ ((UFour)root->volNo << 24);
+    for (i = 0; i < kval->len; i++) {
+        h ^= (unsigned char)kval->val[i];
+        h *= 16777619U;
+    }
+
+    return((Four)(h & 0x7fffffff));
+
+}   /* edubtm_AhiHash() */
+
+
+
+/*@================================
+ * edubtm_AhiFind()
+ *================================*/
+/*
+ * Function: Four edubtm_AhiFind(PageID*, KeyValue*, Four)
+ *
+ * Description:
+ *  Find the entry of the key of the index given by 'root'.
+ *
+ * Returns:
+ *  index of the entry; NIL if there is none
+ */
+Four edubtm_AhiFind(
+    PageID              *root,          /* IN root page of the index */
+    KeyValue            *kval,          /* IN key value */
+    Four                hashValue)      /* IN hash value of the root and the key */
+{
+    Four                idx;            /* index of an entry */
+    btm_AhiEntry        *entry;         /* an entry in the bucket */
+
+
+    if (!edubtm_ahiInitialized) edubtm_InitAdaptiveHash();
+
+    for (idx = edubtm_ahiBuckets[hashValue % BTM_AHI_BUCKETS]; idx != NIL; idx = entry->next) {
+        entry = &edubtm_ahiTable[idx];
+        if (entry->hashValue == hashValue && entry->root.pageNo == root->pageNo &&
+            entry->root.volNo == root->volNo && entry->key.len == kval->len &&
+            memcmp(entry->key.val, kval->val, kval->len) == 0)
+            return(idx);
+    }
+
+    return(NIL);
+
+}   /* edubtm_AhiFind() */
+
+
+
+/*@================================
+ * edubtm_AhiUnlink()
+ *================================*/
+/*
+ * Function: void edubtm_AhiUnlink(Four)
+ *
+ * Description:
+ *  Remove the entry from its bucket and mark it unused.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_AhiUnlink(
+    Four                idx)            /* IN index of the entry */
+{
+    Four                *link;          /* link pointing to the entry */
+
+
+    if (!edubtm_ahiInitialized) edubtm_InitAdaptiveHash();
+
+    link = &edubtm_ahiBuckets[edubtm_ahiTable[idx].hashValue % BTM_AHI_BUCKETS];
+    while (*link != idx) link = &edubtm_ahiTable[*link].next;
+
+    *link = edubtm_ahiTable[idx].next;
+    edubtm_ahiTable[idx].isUsed = FALSE;
+
+}   /* edubtm_AhiUnlink() */
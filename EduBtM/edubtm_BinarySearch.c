@@ -91,6 +91,16 @@ Boolean edubtm_BinarySearchInternal(
     low = 0;
     high = ipage->hdr.nSlots - 1;
 
+    /* In the key head layout, narrow the range to the slots whose heads tie with the key */
+    if (ipage->hdr.flags & BTM_KEYHEAD_VALID) {
+        edubtm_SearchKeyHeads(BTM_KEYHEADS(ipage, ipage->hdr.nSlots), ipage->hdr.nSlots,
+                              edubtm_MakeKeyHead(ipage->hdr.flags, kval), &low, &high);
+        if ((ipage->hdr.flags & BTM_KEYHEAD_EXACT) && low <= high) {
+            *idx = low;
+            return TRUE;
+        }
+    }
+
     while (low <= high){
         mid = (low + high) / 2;
         entry = (btm_InternalEntry*)&ipage->data[ipage->slot[-mid]];
@@ -175,6 +185,16 @@ Boolean edubtm_BinarySearchLeaf(
     low = 0;
     high = lpage->hdr.nSlots - 1;
 
+    /* In the key head layout, narrow the range to the slots whose heads tie with the key */
+    if (lpage->hdr.flags & BTM_KEYHEAD_VALID) {
+        edubtm_SearchKeyHeads(BTM_KEYHEADS(lpage, lpage->hdr.nSlots), lpage->hdr.nSlots,
+                              edubtm_MakeKeyHead(lpage->hdr.flags, kval), &low, &high);
+        if ((lpage->hdr.flags & BTM_KEYHEAD_EXACT) && low <= high) {
+            *idx = low;
+            return TRUE;
+        }
+    }
+
     while (low <= high){
         mid = (low + high) / 2;
         entry = (btm_LeafEntry*)&lpage->data[lpage->slot[-mid]];
@@ -0,0 +1,445 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_BloomFilter.c
+ *
+ * Description :
+ *  Bloom filter of the keys of a Btree index. An equality search or a
+ *  deletion of a key which the filter does not hold ends without fixing a
+ *  page, which saves the descent from the root for the keys which are not
+ *  in the index. The filter is kept in memory with the other information
+ *  about the index; it is built from the leaves when it is first used, so
+ *  it needs not be stored with the index, and kept up to date by the
+ *  insertions. Deleted keys stay in the filter until it is rebuilt.
+ *
+ *  The k bit positions of a key are derived from one hash value h1 and a
+ *  second value h2 made from it, as h1 + i*h2 (i = 0, ..., k-1). With b
+ *  bits per key, k is b*ln2, which gives a false positive rate of about
+ *  0.6185^b, e.g. 1% with 10 bits per key.
+ *
+ * Exports:
+ *  Four edubtm_CheckBloomFilter(PageID*, btm_IndexInfo*, KeyValue*, Boolean*)
+ *  void edubtm_AddBloomKey(btm_IndexInfo*, KeyValue*)
+ *  void edubtm_NoteBloomDeletion(btm_IndexInfo*)
+ *  void edubtm_NoteBloomFalsePositive(btm_IndexInfo*)
+ *  void edubtm_FreeBloomFilter(btm_IndexInfo*)
+ *  UFour edubtm_BloomHash(char*, Two)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_BuildBloomFilter(PageID*, btm_IndexInfo*);
+void edubtm_SetBloomBits(btm_BloomFilter*, UFour);
+Boolean edubtm_TestBloomBits(btm_BloomFilter*, UFour);
+
+
+
+/*@================================
+ * edubtm_CheckBloomFilter()
+ *================================*/
+/*
+ * Function: Four edubtm_CheckBloomFilter(PageID*, btm_IndexInfo*, KeyValue*, Boolean*)
+ *
+ * Description:
+ *  Look up the key in the Bloom filter of the index. If the filter is not
+ *  valid, it is built from the leaves first. An index without a filter
+ *  may contain any key.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  mayContain : FALSE if the key is not in the index
+ */
+Four edubtm_CheckBloomFilter(
+    PageID              *root,          /* IN root page of the index */
+    btm_IndexInfo       *info,          /* INOUT information about the index */
+    KeyValue            *kval,          /* IN key value */
+    Boolean             *mayContain)    /* OUT FALSE if the key is not in the index */
+{
+    Four                e;              /* error number */
+
+
+    *mayContain = TRUE;
+
+    if (info->params.bloomBitsPerKey == 0) return(eNOERROR);
+
+    if (!info->bloom.valid) {
+        e = edubtm_BuildBloomFilter(root, info);
+        if (e < eNOERROR) ERR(e);
+
+        /* The bit array could not be allocated */
+        if (!info->bloom.valid) return(eNOERROR);
+    }
+
+    info->bloom.nChecks++;
+    if (!edubtm_TestBloomBits(&info->bloom, edubtm_BloomHash(kval->val, kval->len))) {
+        info->bloom.nNegatives++;
+        *mayContain = FALSE;
+    }
+
+    return(eNOERROR);
+
+}   /* edubtm_CheckBloomFilter() */
+
+
+
+/*@================================
+ * edubtm_AddBloomKey()
+ *================================*/
+/*
+ * Function: void edubtm_AddBloomKey(btm_IndexInfo*, KeyValue*)
+ *
+ * Description:
+ *  Enter the key being inserted into the Bloom filter of the index. When
+ *  the filter already holds as many keys as it was sized for, it is made
+ *  invalid instead, and rebuilt larger when it is used next.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_AddBloomKey(
+    btm_IndexInfo       *info,          /* INOUT information about the index */
+    KeyValue            *kval)          /* IN key value inserted */
+{
+    if (info->params.bloomBitsPerKey == 0 || !info->bloom.valid) return;
+
+    if (info->bloom.nKeys >= info->bloom.capacity) {
+        info->bloom.valid = FALSE;
+        return;
+    }
+
+    edubtm_SetBloomBits(&info->bloom, edubtm_BloomHash(kval->val, kval->len));
+    info->bloom.nKeys++;
+
+}   /* edubtm_AddBloomKey() */
+
+
+
+/*@================================
+ * edubtm_NoteBloomDeletion()
+ *================================*/
+/*
+ * Function: void edubtm_NoteBloomDeletion(btm_IndexInfo*)
+ *
+ * Description:
+ *  Count a deletion from the index. The deleted key stays in the filter;
+ *  when more than 1/BTM_BLOOM_STALERATIO of the keys have been deleted, the
+ *  filter is made invalid and rebuilt from the leaves when it is used next.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_NoteBloomDeletion(
+    btm_IndexInfo       *info)          /* INOUT information about the index */
+{
+    if (info->params.bloomBitsPerKey == 0 || !info->bloom.valid) return;
+
+    info->bloom.nDeletes++;
+    if (info->bloom.nDeletes * BTM_BLOOM_STALERATIO > info->bloom.nKeys)
+        info->bloom.valid = FALSE;
+
+}   /* edubtm_NoteBloomDeletion() */
+
+
+
+/*@================================
+ * edubtm_NoteBloomFalsePositive()
+ *================================*/
+/*
+ * Function: void edubtm_NoteBloomFalsePositive(btm_IndexInfo*)
+ *
+ * Description:
+ *  Count a key which the filter answered to be maybe present but which
+ *  was not found in the index.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_NoteBloomFalsePositive(
+    btm_IndexInfo       *info)          /* INOUT information about the index */
+{
+    if (info->params.bloomBitsPerKey == 0 || !info->bloom.valid) return;
+
+    info->bloom.nFalsePositives++;
+
+}   /* edubtm_NoteBloomFalsePositive() */
+
+
+
+/*@================================
+ * edubtm_FreeBloomFilter()
+ *================================*/
+/*
+ * Function: void edubtm_FreeBloomFilter(btm_IndexInfo*)
+ *
+ * Description:
+ *  Free the bit array of the Bloom filter of the index and clear the
+ *  statistics of the filter.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_FreeBloomFilter(
+    btm_IndexInfo       *info)          /* INOUT information about the index */
+{
+    free(info->bloom.bits);
+    memset(&info->bloom, 0, sizeof(btm_BloomFilter));
+
+}   /* edubtm_FreeBloomFilter() */
+
+
+
+/*@================================
+ * edubtm_BuildBloomFilter()
+ *================================*/
+/*
+ * Function: Four edubtm_BuildBloomFilter(PageID*, btm_IndexInfo*)
+ *
+ * Description:
+ *  Build the Bloom filter of the index from the keys in its leaves. The
+ *  insertions kept in the message buffer of the root and in the write
+ *  buffer of the index are merged into the tree first, as their keys are
+ *  not in the leaves yet. The leftmost leaf is found by following the first
+ *  child pointers, and the leaves are read along the leaf chain. The hash values of the keys are
+ *  gathered first, so that the filter can be sized for twice the current
+ *  number of keys, but not less than BTM_BLOOM_MINKEYS. If memory cannot
+ *  be allocated, the filter stays invalid and is not used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_BuildBloomFilter(
+    PageID              *root,          /* IN root page of the index */
+    btm_IndexInfo       *info)          /* INOUT information about the index */
+{
+    Four                e;              /* error number */
+    Two                 i;              /* slot No. */
+    PageID              pid;            /* page being read */
+    BtreePage           *apage;         /* buffer of 'pid' */
+    btm_LeafEntry       *lEntry;        /* an entry in a leaf page */
+    ShortPageID         next;           /* next leaf page */
+    UFour               *hashes;        /* hash values of the keys */
+    UFour               *tHashes;       /* reallocated 'hashes' */
+    Four                nHashes;        /* # of elements of 'hashes' used */
+    Four                maxHashes;      /* # of elements of 'hashes' allocated */
+    Four                k;              /* # of bits set per key */
+
+
+    /*@ the buffered keys are in the index too */
+    e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_FlushWriteBuffer(root, NULL, SM_BOF, NULL, SM_EOF);
+    if (e < eNOERROR) ERR(e);
+
+    hashes = NULL;
+    nHashes = maxHashes = 0;
+
+    /*@ go down to the leftmost leaf */
+    pid = *root;
+    for (;;) {
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (apage->any.hdr.type & LEAF) break;
+
+        next = apage->bi.hdr.p0;
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        pid.pageNo = next;
+    }
+
+    /*@ gather the hash values of the keys along the leaf chain */
+    for (;;) {
+        if (nHashes + apage->bl.hdr.nSlots > maxHashes) {
+            maxHashes = (maxHashes == 0) ? BTM_BLOOM_MINKEYS : maxHashes;
+            while (nHashes + apage->bl.hdr.nSlots > maxHashes) maxHashes *= 2;
+
+            tHashes = (UFour*)realloc(hashes, maxHashes * sizeof(UFour));
+            if (tHashes == NULL) {
+                free(hashes);
+                e = BfM_FreeTrain(&pid, PAGE_BUF);
+                if (e < eNOERROR) ERR(e);
+                return(eNOERROR);
+            }
+            hashes = tHashes;
+        }
+
+        for (i = 0; i < apage->bl.hdr.nSlots; i++) {
+            lEntry = (btm_LeafEntry*)&apage->bl.data[apage->bl.slot[-i]];
+            hashes[nHashes++] = edubtm_BloomHash(lEntry->kval, lEntry->klen);
+        }
+
+        next = apage->bl.hdr.nextPage;
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) { free(hashes); ERR(e); }
+
+        if (next == NIL) break;
+
+        pid.pageNo = next;
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) { free(hashes); ERR(e); }
+    }
+
+    /*@ make the filter; the lookup statistics are kept */
+    free(info->bloom.bits);
+    info->bloom.bits = NULL;
+    info->bloom.nKeys = info->bloom.nDeletes = 0;
+    info->bloom.nBuilds++;
+
+    info->bloom.capacity = (2 * nHashes > BTM_BLOOM_MINKEYS) ? 2 * nHashes : BTM_BLOOM_MINKEYS;
+    info->bloom.nBits = info->bloom.capacity * info->params.bloomBitsPerKey;
+    info->bloom.bits = (unsigned char*)calloc((info->bloom.nBits + 7) / 8, 1);
+    if (info->bloom.bits == NULL) {
+        free(hashes);
+        info->bloom.nBits = 0;
+        return(eNOERROR);
+    }
+
+    /* k = b*ln2 minimizes the false positive rate */
+    k = info->params.bloomBitsPerKey * 69 / 100;
+    info->bloom.nHashes = (k < 1) ? 1 : MIN(k, BTM_BLOOM_MAXHASHES);
+
+    for (k = 0; k < nHashes; k++)
+        edubtm_SetBloomBits(&info->bloom, hashes[k]);
+    info->bloom.nKeys = nHashes;
+    info->bloom.valid = TRUE;
+
+    free(hashes);
+
+    return(eNOERROR);
+
+}   /* edubtm_BuildBloomFilter() */
+
+
+
+/*@================================
+ * edubtm_BloomHash()
+ *================================*/
+/*
+ * Function: UFour edubtm_BloomHash(char*, Two)
+ *
+ * Description:
+ *  Return the hash value of the key (FNV-1a followed by a final mix, so
+ *  that both halves of the value depend on every byte of the key).
+ *
+ * Returns:
+ *  hash value
+ */
+UFour edubtm_BloomHash(
+    char                *key,           /* IN key value */
+    Two                 len)            /* IN key length */
+{
+    UFour               h;              /* hash value */
+    Two                 i;              /* index of the key bytes */
+
+
+    h = 2166136261U;
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 16777619U;
+    }
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+
+    return(h);
+
+}   /* edubtm_BloomHash() */
+
+
+
+/*@================================
+ * edubtm_SetBloomBits()
+ *================================*/
+/*
+ * Function: void edubtm_SetBloomBits(btm_BloomFilter*, UFour)
+ *
+ * Description:
+ *  Set the bits of the key with the given hash value.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_SetBloomBits(
+    btm_BloomFilter     *bloom,         /* INOUT the Bloom filter */
+    UFour               h1)             /* IN hash value of the key */
+{
+    UFour               h2;             /* step between the bit positions */
+    UFour               pos;            /* a bit position */
+    Four                i;              /* index of the hash functions */
+
+
+    h2 = ((h1 >> 16) | (h1 << 16)) | 1;
+    for (i = 0; i < bloom->nHashes; i++) {
+        pos = (h1 + (UFour)i * h2) % (UFour)bloom->nBits;
+        bloom->bits[pos >> 3] |= (unsigned char)(1 << (pos & 7));
+    }
+
+}   /* edubtm_SetBloomBits() */
+
+
+
+/*@================================
+ * edubtm_TestBloomBits()
+ *================================*/
+/*
+ * Function: Boolean edubtm_TestBloomBits(btm_BloomFilter*, UFour)
+ *
+ * Description:
+ *  Test the bits of the key with the given hash value.
+ *
+ * Returns:
+ *  FALSE if any of the bits is not set, i.e. the key is absent
+ */
+Boolean edubtm_TestBloomBits(
+    btm_BloomFilter     *bloom,         /* IN the Bloom filter */
+    UFour               h1)             /* IN hash value of the key */
+{
+    UFour               h2;             /* step between the bit positions */
+    UFour               pos;            /* a bit position */
+    Four                i;              /* index of the hash functions */
+
+
+    h2 = ((h1 >> 16) | (h1 << 16)) | 1;
+    for (i = 0; i < bloom->nHashes; i++) {
+        pos = (h1 + (UFour)i * h2) % (UFour)bloom->nBits;
+        if (!(bloom->bits[pos >> 3] & (1 << (pos & 7)))) return(FALSE);
+    }
+
+    return(TRUE);
+
+}   /* edubtm_TestBloomBits() */
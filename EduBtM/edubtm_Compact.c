@@ -89,7 +89,7 @@ void edubtm_CompactInternalPage(
         --------------------------------------
         ShortPageID       Two      entry->klen
         */
-        entry = (btm_InternalEntry*)(tpage.data[tpage.slot[-i]]);
+        entry = (btm_InternalEntry*)&(tpage.data[tpage.slot[-i]]);
         alignedKlen = ALIGNED_LENGTH(sizeof(Two)+entry->klen);
         len = sizeof(ShortPageID)+ alignedKlen;
         memcpy((apage->data)+apageDataOffset, entry, len);
@@ -99,7 +99,7 @@ void edubtm_CompactInternalPage(
 
     // slotNo에 대응하는 index entry를 데이터 영역 상에서의 마지막 index entry로 저장함
     if (slotNo != NIL){
-        entry = (btm_InternalEntry*)(tpage.data[tpage.slot[-slotNo]]);
+        entry = (btm_InternalEntry*)&(tpage.data[tpage.slot[-slotNo]]);
         alignedKlen = ALIGNED_LENGTH(sizeof(Two)+entry->klen);
         len = sizeof(ShortPageID)+ alignedKlen;
         memcpy((apage->data)+apageDataOffset, entry, len);
@@ -147,7 +147,6 @@ void edubtm_CompactLeafPage(
     Two                 len;                    /* length of the leaf entry */
     Two                 i;                      /* index variable */
     btm_LeafEntry 	*entry;			/* an entry in leaf page */
-    Two 		alignedKlen;		/* aligned length of the key length */
     Two 		lastSlot;		/* position of last slot */
 
     tpage = *apage;
@@ -166,8 +165,7 @@ void edubtm_CompactLeafPage(
             Two        Two   (aligned)klen    ObjectID
         */
         entry = (btm_LeafEntry*)&(tpage.data[tpage.slot[-i]]);
-        alignedKlen = ALIGNED_LENGTH(entry->klen);
-        len = sizeof(Two)+ sizeof(Two)+ alignedKlen+ sizeof(ObjectID);
+        len = BTM_LEAFENTRY_LEN(apage, entry);
         memcpy((apage->data)+apageDataOffset, entry, len);
         apage->slot[-i] = apageDataOffset;
         apageDataOffset += len;
@@ -176,8 +174,7 @@ void edubtm_CompactLeafPage(
     // slotNo에 대응하는 index entry를 데이터 영역 상에서의 마지막 index entry로 저장함
     if (slotNo != NIL){
         entry = (btm_LeafEntry*)&tpage.data[tpage.slot[-slotNo]];
-        alignedKlen = ALIGNED_LENGTH(entry->klen);
-        len = sizeof(Two)+ sizeof(Two)+ alignedKlen+ sizeof(ObjectID);
+        len = BTM_LEAFENTRY_LEN(apage, entry);
         memcpy(&apage->data[apageDataOffset], entry, len);
         apage->slot[-slotNo] = apageDataOffset;
         apageDataOffset += len;
@@ -119,11 +119,11 @@ Four edubtm_KeyCompare(
                 len2 = *(Two*)&key2->val[offset2];
                 offset1+=2;
                 offset2+=2;
-                for(i = offset1, j = offset2; i < len1, j < len2; i++, j++){
-                    if(key1->val[i]==key2->val[j])
+                for(j = 0; j < len1 && j < len2; j++){
+                    if(key1->val[offset1+j]==key2->val[offset2+j])
                         continue;
                     else
-                        return key1->val[i]>key2->val[j]? GREATER:LESS;
+                        return key1->val[offset1+j]>key2->val[offset2+j]? GREATER:LESS;
                 }
                 if (len1 != len2)
                     return len1 > len2? GREATER:LESS;
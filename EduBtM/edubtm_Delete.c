@@ -48,6 +48,10 @@
  *  Deleting an ObjectID may cause redistribute pages and by this reason, the
  *  page may be splitted.
  *
+ *  In a tree whose pages are smaller than PAGESIZE, a child with no key left
+ *  is freed with its subtree instead of being merged, since a page with only
+ *  'p0' has no sibling for it to be merged with.
+ *
  * Exports:
  *  Four edubtm_Delete(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*,
  *                  Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*)
@@ -65,7 +69,10 @@
 
 /*@ Internal Function Prototypes */
 Four edubtm_DeleteLeaf(PhysicalFileID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*, ObjectID*,
-		    Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*);
+		    Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*, btm_IndexInfo*);
+Four edubtm_FitsMerge(PageID*, BtreeInternal*, Two, Boolean*);
+Four edubtm_IsEmptySubtree(PageID*, Boolean*);
+Four edubtm_FreeEmptyChild(PhysicalFileID*, PageID*, BtreeInternal*, Two, Pool*, DeallocListElem*);
 
 
 
@@ -74,7 +81,8 @@ Four edubtm_DeleteLeaf(PhysicalFileID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*
  *================================*/
 /*
  * Function: Four edubtm_Delete(ObjectID*, PageID*, KeyDesc*, KeyValue*,
- *                           ObjectID*, Boolean*, Boolean*, InternalItem*)
+ *                           ObjectID*, Boolean*, Boolean*, InternalItem*,
+ *                           Pool*, DeallocListElem*, btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -87,7 +95,8 @@ Four edubtm_DeleteLeaf(PhysicalFileID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*
  *    some errors caused by function calls
  *
  * Side effects:
- *  f    : TRUE if the given root page is not half full.
+ *  f    : TRUE if the given root page underflows; by default when it is
+ *         not half full, see the 'underflowRatio' index parameter.
  *  h    : TRUE if the given page is splitted.
  *  item : The internal item to be inserted into the parent if 'h' is TRUE.
  */
@@ -101,7 +110,8 @@ Four edubtm_Delete(
     Boolean                     *h,             /* OUT TRUE if it is spiltted. */
     InternalItem                *item,          /* OUT The internal item to be returned */
     Pool                        *dlPool,        /* INOUT pool of dealloc list elements */
-    DeallocListElem             *dlHead)        /* INOUT head of the dealloc list */
+    DeallocListElem             *dlHead,        /* INOUT head of the dealloc list */
+    btm_IndexInfo               *info)          /* IN information about the index; NULL if none */
 {
     Four                        e;              /* error number */
     Boolean                     lf;             /* TRUE if a page is not half full */
@@ -115,6 +125,7 @@ Four edubtm_Delete(
     SlottedPage                 *catPage;       /* buffer page containing the catalog object */
     sm_CatOverlayForBtree       *catEntry;      /* pointer to Btree file catalog information */
     PhysicalFileID              pFid;           /* B+-tree file's FileID */
+    Boolean                     empty;          /* TRUE if the child has no key left */
   
 
     /* Error check whether using not supported functionality by EduBtM */
@@ -136,7 +147,7 @@ Four edubtm_Delete(
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
     
     // get root page
-    e = BfM_GetTrain(root, (char**)&rpage, PAGE_BUF);
+    e = edubtm_GetTrainForUpdate(root, (char**)&rpage);
     if (e < eNOERROR) ERR(e);
 
     // 파라미터로 주어진 root page가 internal page인 경우
@@ -152,12 +163,58 @@ Four edubtm_Delete(
         /*삭제할<object의 key, object ID> pair가 저장된 leaf page를 찾기 위해 다음으로 방문할 자식 page를 결정함
         – 결정된자식page를root page로 하는 B+ subtree에서 <object의 key, object ID> pair를 삭제하기 위해
         재귀적으로edubtm_Delete()를 호출함*/
-        e = edubtm_Delete(catObjForFile, &child, kdesc, kval, oid, &lf, &lh, &litem, dlPool, dlHead);
-        if (e < eNOERROR) ERR(e);
+        e = edubtm_Delete(catObjForFile, &child, kdesc, kval, oid, &lf, &lh, &litem, dlPool, dlHead, info);
+        if (e < eNOERROR) ERRB2(e, catObjForFile, PAGE_BUF, root, PAGE_BUF);
+
+        /* A child with no key left is freed, since it may have no sibling to be merged with */
+        if (lf && BTM_PAGE_SIZE(&rpage->bi) < PAGESIZE) {
+            e = edubtm_IsEmptySubtree(&child, &empty);
+            if (e < eNOERROR) ERR(e);
+
+            if (empty && rpage->bi.hdr.nSlots == 0) {
+                /* the only child; the parent frees this page together with it */
+                lf = FALSE;
+                *f = TRUE;
+            }
+            else if (empty) {
+                lf = FALSE;
+                if (info != NULL) {
+                    info->smoCount++;
+                    info->nUnderflows++;
+                }
+
+                e = edubtm_FreeEmptyChild(&pFid, root, &rpage->bi, idx, dlPool, dlHead);
+                if (e < eNOERROR) ERR(e);
+
+                e = BfM_SetDirty(root, PAGE_BUF);
+                if (e < eNOERROR) ERR(e);
+
+                if (edubtm_IsUnderflow(info, rpage)) *f = TRUE;
+            }
+        }
+
+        /* btm_Underflow() would merge the child into more than one page of the tree */
+        if (lf && BTM_PAGE_SIZE(&rpage->bi) < PAGESIZE) {
+            e = edubtm_FitsMerge(root, &rpage->bi, idx, &lf);
+            if (e < eNOERROR) ERR(e);
+        }
 
         // Underflow 발생시 
         if (lf){
             lf = lh = FALSE;
+            if (info != NULL) {
+                info->smoCount++;
+                info->nUnderflows++;
+            }
+
+            /* btm_Underflow() is not aware of the key head layout */
+            e = edubtm_DropKeyHeadsAround(root, rpage, idx);
+            if (e < eNOERROR) ERR(e);
+
+            /* btm_Underflow() changes and frees the pages around the child on its own */
+            e = edubtm_SaveVersionsAround(root, rpage, idx);
+            if (e < eNOERROR) ERR(e);
+
             e = btm_Underflow(&pFid, rpage, &child, idx, &lf, &lh, &litem, dlPool, dlHead);
             if (e < eNOERROR) ERR(e);
 
@@ -167,11 +224,11 @@ Four edubtm_Delete(
                 /* edubtm_InsertInternal()을 호출하여 overflow로 인해 삽입되지 못한 internal index entry를 부모 page에 삽입함
                 edubtm_InsertInternal() 호출 결과로서 부모 page가 split 되므로, out parameter인 h를 TRUE로 설정하고 
                 split으로 생성된 새로운 page를 가리키는 internal index entry를 반환함*/
+				/* 삽입할 위치를 찾는 것이므로 같은 key가 없는 것이 정상임 */
 				memcpy(&tKey, &litem.klen, sizeof(KeyValue));
-				if (edubtm_BinarySearchInternal(rpage, kdesc, &tKey, &idx) == FALSE)
-					return (eNOTFOUND_BTM);
+				edubtm_BinarySearchInternal(rpage, kdesc, &tKey, &idx);
 
-				e = edubtm_InsertInternal(catObjForFile, rpage, &litem, idx, h, item);
+				e = edubtm_InsertInternal(catObjForFile, rpage, &litem, idx, h, item, NULL);
 				if (e < eNOERROR) ERR(e);
 			}
 
@@ -179,13 +236,16 @@ Four edubtm_Delete(
             btm_Underflow() 호출 후 root page의 DIRTY bit를 1로 set 해야 함*/
             e = BfM_SetDirty(root, PAGE_BUF);
             if (e < eNOERROR) ERR(e);
+
+            /* 자식 page와 합쳐져 root page에서 underflow가 발생한 경우 부모 page에 알림 */
+            if (lf && edubtm_IsUnderflow(info, rpage)) *f = TRUE;
         }
     } 
     // 파라미터로 주어진 root page가 root page인 경우
     // 호출하면 된다. dirty 처리와 비트 세팅 전부 함.
     else {
-        e = edubtm_DeleteLeaf(&pFid, root, rpage, kdesc, kval, oid, f, h, &litem, dlPool, dlHead);
-        if (e < eNOERROR) ERR(e);
+        e = edubtm_DeleteLeaf(&pFid, root, rpage, kdesc, kval, oid, f, h, &litem, dlPool, dlHead, info);
+        if (e < eNOERROR) ERRB2(e, catObjForFile, PAGE_BUF, root, PAGE_BUF);
     }
 
     e = BfM_FreeTrain(catObjForFile, PAGE_BUF);
@@ -205,7 +265,8 @@ Four edubtm_Delete(
 /*
  * Function: Four edubtm_DeleteLeaf(PhysicalFileID*, PageID*, BtreeLeaf*, KeyDesc*,
  *                               KeyValue*, ObjectID*, Boolean*, Boolean*,
- *                               InternalItem*, Pool*, DeallocListElem*)
+ *                               InternalItem*, Pool*, DeallocListElem*,
+ *                               btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -233,7 +294,8 @@ Four edubtm_DeleteLeaf(
     Boolean                     *h,             /* OUT TRUE if it is spiltted. */
     InternalItem                *item,          /* OUT The internal item to be returned */
     Pool                        *dlPool,        /* INOUT pool of dealloc list elements */
-    DeallocListElem             *dlHead)        /* INOUT head of a dealloc list */
+    DeallocListElem             *dlHead,        /* INOUT head of a dealloc list */
+    btm_IndexInfo               *info)          /* IN information about the index; NULL if none */
 {
     Four                        e;              /* error number */
     Two                         i;              /* index */
@@ -242,6 +304,7 @@ Four edubtm_DeleteLeaf(
     ObjectID                    tOid;           /* a Object IDentifier */
     BtreeOverflow               *opage;         /* for a overflow page */
     Boolean                     found;          /* Search Result */
+    Boolean                     empty;          /* TRUE if the entry has no more ObjectIDs */
     Two                         lEntryOffset;   /* starting offset of a leaf entry */
     btm_LeafEntry               *lEntry;        /* an entry in leaf page */
     ObjectID                    *oidArray;      /* start position of the ObjectID array */
@@ -260,26 +323,38 @@ Four edubtm_DeleteLeaf(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
-    //삭제할<object의 key, object ID> pair가 저장된 index entry의 offset이 저장된 slot을 삭제함
     //note: apage를 줬으므로 gettrain 안해도 됨.
     found = edubtm_BinarySearchLeaf(apage, kdesc, kval, &idx);
-    lEntryOffset = apage->slot[-idx];
-    lEntry = (btm_LeafEntry*)&apage->data[lEntryOffset];
-    alignedKlen = ALIGNED_LENGTH(lEntry->klen);
-    entryLen = sizeof(Two) + sizeof(Two) + alignedKlen + sizeof(ObjectID);
-
-    // Slot array 중간에 삭제된 빈 slot이 없도록 slot array를 compact 함
-    for(i = idx; i < apage->hdr.nSlots; i++){
-        apage->slot[-i] = apage->slot[-(i+1)];
+    if (!found) ERR(eNOTFOUND_BTM);
+
+    /* index entry의 ObjectID 목록에서 object ID를 삭제함
+       - 삭제 후에도 남은 object ID가 있으면 index entry는 그대로 둠 */
+    e = edubtm_DeleteObjectId(pFid, apage, idx, oid, &empty, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    //마지막 object ID가 삭제된 경우, index entry의 offset이 저장된 slot을 삭제함
+    if (empty) {
+        lEntryOffset = apage->slot[-idx];
+        lEntry = (btm_LeafEntry*)&apage->data[lEntryOffset];
+        entryLen = BTM_LEAFENTRY_LEN(apage, lEntry);
+
+        // Slot array 중간에 삭제된 빈 slot이 없도록 slot array를 compact 함
+        for(i = idx; i < apage->hdr.nSlots; i++){
+            apage->slot[-i] = apage->slot[-(i+1)];
+        }
+        // key head layout에서는 slot array를 compact 한 후 key head를 삭제함
+        if (apage->hdr.flags & BTM_KEYHEAD_VALID)
+            edubtm_DeleteKeyHead((BtreePage*)apage, idx);
+        // Leaf page의 header를 갱신함
+        apage->hdr.nSlots -= 1;
+        apage->hdr.unused += entryLen;
     }
-    // Leaf page의 header를 갱신함
-    apage->hdr.nSlots -= 1;
-    apage->hdr.unused += entryLen;
 
     /*Leaf page에서 underflow가 발생한 경우
     (page의 data 영역중자유영역의크기> (page의data 영역의전체크기/ 2)), 
-    out parameter인 f를 TRUE로 설정함*/
-    if (BL_FREE(apage) >= BL_HALF) *f = TRUE;
+    out parameter인 f를 TRUE로 설정함
+    – underflowRatio index parameter로 기준을 낮출 수 있음 */
+    if (edubtm_IsUnderflow(info, (BtreePage*)apage)) *f = TRUE;
 
     //note: gettrain 안했으므로 free 안해도 됨.
     e = BfM_SetDirty(pid, PAGE_BUF);
@@ -288,3 +363,257 @@ Four edubtm_DeleteLeaf(
     return(eNOERROR);
     
 } /* edubtm_DeleteLeaf() */
+
+
+
+/*@================================
+ * edubtm_FitsMerge()
+ *================================*/
+/*
+ * Function: Four edubtm_FitsMerge(PageID*, BtreeInternal*, Two, Boolean*)
+ *
+ * Description:
+ *  btm_Underflow() merges the underflowed child with its sibling whenever
+ *  both fit in PAGESIZE bytes, which would overfill the pages of a B+ tree
+ *  with a smaller page size. Check whether the child at the slot 'idx'
+ *  (-1 denotes 'p0') fits in one page of the tree together with each of
+ *  its siblings, including the separator an internal merge takes down.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_FitsMerge(
+    PageID                      *pid,           /* IN PageID of the internal page */
+    BtreeInternal               *ppage,         /* IN the internal page */
+    Two                         idx,            /* IN slot No. of the underflowed child */
+    Boolean                     *fits)          /* OUT TRUE if the child fits with any sibling */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* slot No. */
+    Boolean                     isLeaf;         /* TRUE if the children are leaf pages */
+    Four                        size;           /* size of the data area of a child */
+    Four                        used[3];        /* used part of the children idx-1, idx, idx+1; -1 if none */
+    Four                        sepLen;         /* length of the separator taken down by a merge */
+    PageID                      child;          /* PageID of a child */
+    BtreePage                   *cpage;         /* pointer to the child page */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+
+
+    isLeaf = FALSE;
+    size = 0;
+
+    for (i = idx - 1; i <= idx + 1; i++) {
+        used[i - idx + 1] = -1;
+        if (i < -1 || i >= ppage->hdr.nSlots) continue;
+
+        if (i == -1) {
+            MAKE_PAGEID(child, pid->volNo, ppage->hdr.p0);
+        }
+        else {
+            iEntry = (btm_InternalEntry*)&ppage->data[ppage->slot[-i]];
+            MAKE_PAGEID(child, pid->volNo, iEntry->spid);
+        }
+
+        e = BfM_GetTrain(&child, (char**)&cpage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        isLeaf = (cpage->any.hdr.type & LEAF) ? TRUE : FALSE;
+        if (isLeaf) {
+            size = BTM_PAGE_SIZE(&cpage->bl) - BL_FIXED;
+            used[i - idx + 1] = size - BL_FREE(&cpage->bl);
+        }
+        else {
+            size = BTM_PAGE_SIZE(&cpage->bi) - BI_FIXED;
+            used[i - idx + 1] = size - BI_FREE(&cpage->bi);
+        }
+
+        e = BfM_FreeTrain(&child, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    /* an only child has nothing to be merged with */
+    *fits = (used[0] >= 0 || used[2] >= 0) ? TRUE : FALSE;
+    for (i = idx - 1; i <= idx + 1; i += 2) {
+        if (used[i - idx + 1] < 0) continue;
+
+        /* the separator of the right one of the two pages */
+        sepLen = 0;
+        if (!isLeaf) {
+            iEntry = (btm_InternalEntry*)&ppage->data[ppage->slot[-((i > idx) ? i : idx)]];
+            sepLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + iEntry->klen) + sizeof(Two);
+        }
+
+        if (used[1] + used[i - idx + 1] + sizeof(Two) + sepLen > size) *fits = FALSE;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_FitsMerge() */
+
+
+
+/*@================================
+ * edubtm_IsEmptySubtree()
+ *================================*/
+/*
+ * Function: Four edubtm_IsEmptySubtree(PageID*, Boolean*)
+ *
+ * Description:
+ *  Check whether the subtree of the given page has no key, i.e. whether
+ *  it is a chain of internal pages with no slot ending at an empty leaf.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_IsEmptySubtree(
+    PageID                      *pid,           /* IN root page of the subtree */
+    Boolean                     *empty)         /* OUT TRUE if the subtree has no key */
+{
+    Four                        e;              /* error number */
+    PageID                      curPid;         /* the page being checked */
+    BtreePage                   *apage;         /* pointer to the page */
+    ShortPageID                 p0;             /* the first child of an internal page; NIL if none */
+
+
+    curPid = *pid;
+    *empty = FALSE;
+
+    for (;;) {
+        e = BfM_GetTrain(&curPid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        p0 = NIL;
+        if (apage->any.hdr.type & LEAF)
+            *empty = (apage->bl.hdr.nSlots == 0) ? TRUE : FALSE;
+        else if ((apage->any.hdr.type & INTERNAL) && apage->bi.hdr.nSlots == 0)
+            p0 = apage->bi.hdr.p0;
+
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (p0 == NIL) break;
+        curPid.pageNo = p0;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_IsEmptySubtree() */
+
+
+
+/*@================================
+ * edubtm_FreeEmptyChild()
+ *================================*/
+/*
+ * Function: Four edubtm_FreeEmptyChild(PhysicalFileID*, PageID*, BtreeInternal*,
+ *                                      Two, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Remove the child at the slot 'idx' (-1 denotes 'p0') of the given
+ *  internal page, whose subtree has no key, and free the pages of the
+ *  subtree. The empty leaf at the bottom of the subtree is unlinked from
+ *  its neighbours first. When 'p0' is removed, the child of the slot 0
+ *  becomes 'p0'. The internal page should have at least one slot.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for the internal page.
+ */
+Four edubtm_FreeEmptyChild(
+    PhysicalFileID              *pFid,          /* IN FileID of the Btree file */
+    PageID                      *pid,           /* IN PageID of the internal page */
+    BtreeInternal               *ppage,         /* INOUT the internal page */
+    Two                         idx,            /* IN slot No. of the child */
+    Pool                        *dlPool,        /* INOUT pool of dealloc list elements */
+    DeallocListElem             *dlHead)        /* INOUT head of the dealloc list */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* slot No. */
+    Two                         slotNo;         /* slot No. of the entry to delete */
+    Two                         entryLen;       /* length of the entry to delete */
+    PageID                      child;          /* root page of the subtree to free */
+    PageID                      leaf;           /* the leaf of the subtree */
+    PageID                      sibling;        /* a neighbour of the leaf */
+    BtreePage                   *apage;         /* pointer to a page */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+    ShortPageID                 prevPage;       /* previous leaf of the leaf */
+    ShortPageID                 nextPage;       /* next leaf of the leaf */
+
+
+    /*@ remove the entry of the child */
+    slotNo = (idx == -1) ? 0 : idx;
+    iEntry = (btm_InternalEntry*)&ppage->data[ppage->slot[-slotNo]];
+    entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + iEntry->klen);
+
+    if (idx == -1) {
+        MAKE_PAGEID(child, pid->volNo, ppage->hdr.p0);
+        ppage->hdr.p0 = iEntry->spid;
+    }
+    else
+        MAKE_PAGEID(child, pid->volNo, iEntry->spid);
+
+    for (i = slotNo; i < ppage->hdr.nSlots - 1; i++)
+        ppage->slot[-i] = ppage->slot[-(i+1)];
+    if (ppage->hdr.flags & BTM_KEYHEAD_VALID)
+        edubtm_DeleteKeyHead((BtreePage*)ppage, slotNo);
+    ppage->hdr.nSlots--;
+    ppage->hdr.unused += entryLen;
+
+    /*@ find the leaf of the subtree */
+    leaf = child;
+    for (;;) {
+        e = BfM_GetTrain(&leaf, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (apage->any.hdr.type & LEAF) break;
+
+        sibling = leaf;
+        leaf.pageNo = apage->bi.hdr.p0;
+        e = BfM_FreeTrain(&sibling, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+    prevPage = apage->bl.hdr.prevPage;
+    nextPage = apage->bl.hdr.nextPage;
+
+    e = BfM_FreeTrain(&leaf, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ unlink the leaf from its neighbours */
+    if (prevPage != NIL) {
+        MAKE_PAGEID(sibling, pid->volNo, prevPage);
+        e = edubtm_GetTrainForUpdate(&sibling, (char**)&apage);
+        if (e < eNOERROR) ERR(e);
+
+        apage->bl.hdr.nextPage = nextPage;
+
+        e = BfM_SetDirty(&sibling, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &sibling, PAGE_BUF);
+        e = BfM_FreeTrain(&sibling, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    if (nextPage != NIL) {
+        MAKE_PAGEID(sibling, pid->volNo, nextPage);
+        e = edubtm_GetTrainForUpdate(&sibling, (char**)&apage);
+        if (e < eNOERROR) ERR(e);
+
+        apage->bl.hdr.prevPage = prevPage;
+
+        e = BfM_SetDirty(&sibling, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &sibling, PAGE_BUF);
+        e = BfM_FreeTrain(&sibling, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    /*@ free the pages of the subtree */
+    e = edubtm_FreePages(pFid, &child, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_FreeEmptyChild() */
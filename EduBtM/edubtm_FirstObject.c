@@ -93,16 +93,33 @@ Four edubtm_FirstObject(
 
     // find leftmost leaf
     curPid = *root;
-    e = BfM_GetTrain(&curPid, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetSnapshotTrain(&curPid, (char**)&apage);
     if (e < eNOERROR) ERR(e);
     while(!(apage->any.hdr.type & LEAF)){
         MAKE_PAGEID(child, curPid.volNo, apage->bi.hdr.p0);
         e = BfM_FreeTrain(&curPid, PAGE_BUF);
         if (e < eNOERROR) ERR(e);
-        e = BfM_GetTrain(&child, (char**)&apage, PAGE_BUF);
+        e = edubtm_GetSnapshotTrain(&child, (char**)&apage);
         if (e < eNOERROR) ERR(e);
         curPid = child;
     }
+    /* a leaf left empty by a merge that did not fit is passed over */
+    while (apage->bl.hdr.nSlots == 0 && apage->bl.hdr.nextPage != NIL) {
+        MAKE_PAGEID(child, curPid.volNo, apage->bl.hdr.nextPage);
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = edubtm_GetSnapshotTrain(&child, (char**)&apage);
+        if (e < eNOERROR) ERR(e);
+        curPid = child;
+    }
+    /* 빈 B+ tree 색인에는 object가 없음 */
+    if (apage->bl.hdr.nSlots == 0) {
+        cursor->flag = CURSOR_EOS;
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
     /* B+ tree 색인의 첫 번째 leaf page의 첫 번째 leaf index entry를 
     가리키는 cursor를 반환함*/    
     lEntry = (btm_LeafEntry*)&(apage->bl.data[apage->bl.slot[0]]);
@@ -110,13 +127,14 @@ Four edubtm_FirstObject(
     alignedKlen = ALIGNED_LENGTH(klen);
 
     // make cursor
-    cursor->oid = *(ObjectID*)&(lEntry->kval[alignedKlen]);
     cursor->key.len = klen;
     memcpy(cursor->key.val, lEntry->kval, klen);
     cursor->leaf = apage->bl.hdr.pid;
     /* note: cursor->overflow: 
     중복key 사용시 동일key 값을갖는object들의ID (OID) 들이 
-    저장된page의 page ID로서, 유일 key만을 사용하는 EduBtM에서는 overflow 사용하지않음*/
+    저장된page의 page ID로서, ObjectID 목록이 leaf에 있으면 NIL page임*/
+    e = edubtm_FirstObjectId(curPid.volNo, lEntry, FALSE, &cursor->overflow, &cursor->oidArrayElemNo, &cursor->oid);
+    if (e < eNOERROR) ERRB1(e, &curPid, PAGE_BUF);
     cursor->slotNo = 0;
     cmp = edubtm_KeyCompare(kdesc, stopKval, &cursor->key);
     // 검색종료key 값이첫번째object의 key 값 보다 작거나
@@ -55,7 +55,8 @@
  *  In a leaf page, examine all leaf items whether it has an overflow page list
  *  before it is freed. If it has, recursively call itself by using the first
  *  overflow page. In an overflow page, it recursively calls itself if the
- *  'nextPage' exist.
+ *  'nextPage' exist. The message buffer of the root, if any, is freed with
+ *  the root, in the same way as an overflow page list.
  *
  * Returns:
  *  error code
@@ -83,9 +84,16 @@ Four edubtm_FreePages(
 
     /* Page header의 type에서 해당 page가 deallocate 될 page임을 나타내는 bit를set
      및 나머지bit들을 unset 함*/
-    e = BfM_GetTrain(curPid, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetTrainForUpdate(curPid, (char**)&apage);
     if (e < eNOERROR) ERR(e);
 
+    if((apage->any.hdr.type & ROOT) && apage->any.hdr.reserved != NIL){
+        /*Free the message buffer of the root.*/
+        MAKE_PAGEID(tPid, curPid->volNo, apage->any.hdr.reserved);
+        e = edubtm_FreePages(pFid, &tPid, dlPool, dlHead);
+        if (e < eNOERROR) ERR(e);
+    }
+
     if(apage->any.hdr.type & INTERNAL){
         /*If the given page is an internal page, recursively free all child pages before it is freed.*/
         MAKE_PAGEID(tPid, curPid->volNo, apage->bi.hdr.p0);
@@ -101,7 +109,34 @@ Four edubtm_FreePages(
             if (e < eNOERROR) ERR(e);
         }
     }
-    /* Note: EduBtM에서는 Overflow 고려 안함.*/
+    else if(apage->any.hdr.type & LEAF){
+        /*In a leaf page, free the overflow page list of every entry which has one.*/
+        for (i = 0; i<apage->bl.hdr.nSlots; i++){
+            lEntryOffset = apage->bl.slot[-i];
+            lEntry = (btm_LeafEntry*)(&apage->bl.data[lEntryOffset]);
+            if (lEntry->nObjects >= 0) continue;
+
+            MAKE_PAGEID(ovPid, curPid->volNo, BTM_LEAFENTRY_OVPAGE(lEntry));
+            e = edubtm_FreePages(pFid, &ovPid, dlPool, dlHead);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+    else if(apage->any.hdr.type & OVERFLOW){
+        /*In an overflow page, free the next overflow page first.*/
+        if (apage->bo.hdr.nextPage != NIL){
+            MAKE_PAGEID(ovPid, curPid->volNo, apage->bo.hdr.nextPage);
+            e = edubtm_FreePages(pFid, &ovPid, dlPool, dlHead);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+    else if(apage->any.hdr.type & MESSAGE){
+        /*In a page of the message buffer, free the next page first.*/
+        if (apage->bm.hdr.nextPage != NIL){
+            MAKE_PAGEID(tPid, curPid->volNo, apage->bm.hdr.nextPage);
+            e = edubtm_FreePages(pFid, &tPid, dlPool, dlHead);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
     
 	apage->any.hdr.type = FREEPAGE;
     
@@ -110,7 +145,7 @@ Four edubtm_FreePages(
     if (e < eNOERROR) ERR(e);
     // Store the information about the pages to be deallocated into the element allocated.
     dlElem->type = DL_PAGE;
-    dlElem->elem.pid = tPid;
+    dlElem->elem.pid = *curPid;
     // Insert the element into the dealloc list as the first element.
     dlElem->next = dlHead->next;
     dlHead->next = dlElem; 
@@ -0,0 +1,280 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_IndexInfo.c
+ *
+ * Description :
+ *  Keep in memory per-index information which is not stored in the pages:
+ *  run-time parameters and hints gathered from the insertions, such as the
+ *  rightmost leaf page and whether the keys are inserted in ascending order,
+ *  the leaf pages visited by recent equality searches, and the Bloom filter
+ *  of the keys.
+ *  The entries are looked up by the root PageID of the index.
+ *
+ * Exports:
+ *  btm_IndexInfo *edubtm_GetIndexInfo(PageID*, Boolean)
+ *  void edubtm_FreeIndexInfo(PageID*)
+ *  void edubtm_NoteInsertion(btm_IndexInfo*, KeyDesc*, KeyValue*)
+ *  Four edubtm_SplitLimit(btm_IndexInfo*, BtreePage*, Two)
+ *  Boolean edubtm_IsUnderflow(btm_IndexInfo*, BtreePage*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Global Variables */
+static btm_IndexInfo edubtm_indexInfoTable[BTM_MAXINDEXINFOS];  /* information about the indexes in use */
+static Four edubtm_indexInfoVictim = 0;                          /* where to start looking for an entry to reuse */
+
+
+
+/*@================================
+ * edubtm_GetIndexInfo()
+ *================================*/
+/*
+ * Function: btm_IndexInfo *edubtm_GetIndexInfo(PageID*, Boolean)
+ *
+ * Description:
+ *  Return the entry of the index given by 'root'. If there is none and
+ *  'create' is TRUE, a new entry with the default parameters is made; when
+ *  the table is full, the entry of another index which has the default
+ *  parameters is reused, since only hints are lost with it.
+ *
+ * Returns:
+ *  pointer to the entry; NULL if there is none
+ */
+btm_IndexInfo *edubtm_GetIndexInfo(
+    PageID              *root,          /* IN root page of the index */
+    Boolean             create)         /* IN TRUE if a new entry should be made */
+{
+    Four                i;              /* index of the table */
+    Four                freeIdx;        /* index of an unused entry */
+    btm_IndexInfo       *info;          /* an entry of the table */
+
+
+    freeIdx = NIL;
+    for (i = 0; i < BTM_MAXINDEXINFOS; i++) {
+        info = &edubtm_indexInfoTable[i];
+        if (!info->isUsed) {
+            if (freeIdx == NIL) freeIdx = i;
+        }
+        else if (info->root.volNo == root->volNo && info->root.pageNo == root->pageNo)
+            return(info);
+    }
+
+    if (!create) return(NULL);
+
+    /*@ reuse an entry of an index with the default parameters */
+    if (freeIdx == NIL) {
+        for (i = 0; i < BTM_MAXINDEXINFOS; i++) {
+            info = &edubtm_indexInfoTable[(edubtm_indexInfoVictim + i) % BTM_MAXINDEXINFOS];
+            if (IS_DEFAULT_INDEXPARAMS(info->params)) break;
+        }
+        if (i == BTM_MAXINDEXINFOS) return(NULL);
+
+        freeIdx = (edubtm_indexInfoVictim + i) % BTM_MAXINDEXINFOS;
+        edubtm_indexInfoVictim = (freeIdx + 1) % BTM_MAXINDEXINFOS;
+
+        /* The adaptive hash entries are validated with this entry */
+        edubtm_DropAdaptiveHash(&edubtm_indexInfoTable[freeIdx].root);
+    }
+
+    info = &edubtm_indexInfoTable[freeIdx];
+    edubtm_FreeBloomFilter(info);
+    edubtm_FreeWriteBuffer(info);
+    info->isUsed = TRUE;
+    info->root = *root;
+    SET_DEFAULT_INDEXPARAMS(info->params);
+    info->lastKey.len = 0;
+    info->nAscending = 0;
+    MAKE_PAGEID(info->rightmostLeaf, root->volNo, NIL);
+    info->smoCount = 0;
+    info->nUnderflows = 0;
+    info->nInserts = info->nDeletes = 0;
+    info->nLeafSplits = info->nInternalSplits = info->nRootSplits = 0;
+    info->nOverflowLists = 0;
+    info->nextLeafHint = 0;
+    for (i = 0; i < BTM_LEAFHINTS; i++)
+        MAKE_PAGEID(info->leafHints[i].leaf, root->volNo, NIL);
+
+    return(info);
+
+}   /* edubtm_GetIndexInfo() */
+
+
+
+/*@================================
+ * edubtm_FreeIndexInfo()
+ *================================*/
+/*
+ * Function: void edubtm_FreeIndexInfo(PageID*)
+ *
+ * Description:
+ *  Forget the information about the index given by 'root'. It is called
+ *  when the index is created or dropped, since its root page may be reused.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_FreeIndexInfo(
+    PageID              *root)          /* IN root page of the index */
+{
+    btm_IndexInfo       *info;          /* the entry of the index */
+
+
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info != NULL) {
+        edubtm_FreeBloomFilter(info);
+        edubtm_FreeWriteBuffer(info);
+        info->isUsed = FALSE;
+    }
+
+    edubtm_DropAdaptiveHash(root);
+
+}   /* edubtm_FreeIndexInfo() */
+
+
+
+/*@================================
+ * edubtm_NoteInsertion()
+ *================================*/
+/*
+ * Function: void edubtm_NoteInsertion(btm_IndexInfo*, KeyDesc*, KeyValue*)
+ *
+ * Description:
+ *  Record the key of an insertion to detect ascending insertion: the count
+ *  of successive insertions, each with a key greater than the one before.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_NoteInsertion(
+    btm_IndexInfo       *info,          /* INOUT information about the index */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval)          /* IN key value inserted */
+{
+    if (info->lastKey.len > 0 && edubtm_KeyCompare(kdesc, kval, &info->lastKey) == GREAT)
+        info->nAscending++;
+    else
+        info->nAscending = 0;
+
+    info->lastKey.len = kval->len;
+    memcpy(info->lastKey.val, kval->val, kval->len);
+
+}   /* edubtm_NoteInsertion() */
+
+
+
+/*@================================
+ * edubtm_SplitLimit()
+ *================================*/
+/*
+ * Function: Four edubtm_SplitLimit(btm_IndexInfo*, BtreePage*, Two)
+ *
+ * Description:
+ *  Return how many bytes of entries the page being split keeps; the rest
+ *  go to the new page. Normally a page is split at half. When the new entry
+ *  is appended after the last entry of the page, and either the page is the
+ *  rightmost leaf or the keys have been inserted in ascending order, the
+ *  following insertions will go to the new page and the page being split
+ *  is not expected to grow again. It then keeps 'appendSplitRatio' percent
+ *  of a page instead of half, which keeps an index built by appending about
+ *  as dense as the ratio rather than half full.
+ *
+ * Returns:
+ *  # of bytes of entries (with their slots) the page keeps
+ */
+Four edubtm_SplitLimit(
+    btm_IndexInfo       *info,          /* IN information about the index; NULL if none */
+    BtreePage           *page,          /* IN the page which will be split */
+    Two                 high)           /* IN slot No. after which the new entry is inserted */
+{
+    Boolean             isLeaf;         /* TRUE if the page is a leaf */
+    Two                 nSlots;         /* # of entries in the page */
+
+
+    isLeaf = (page->any.hdr.type & LEAF) ? TRUE : FALSE;
+    nSlots = isLeaf ? page->bl.hdr.nSlots : page->bi.hdr.nSlots;
+
+    if (info == NULL || info->params.appendSplitRatio <= 50 || high + 1 != nSlots)
+        return(isLeaf ? BL_HALF(&page->bl) : BI_HALF(&page->bi));
+
+    if (!(isLeaf && page->bl.hdr.nextPage == NIL) && info->nAscending < BTM_ASCENDING_RUN)
+        return(isLeaf ? BL_HALF(&page->bl) : BI_HALF(&page->bi));
+
+    return((BTM_PAGE_SIZE(&page->any) - (isLeaf ? BL_FIXED : BI_FIXED)) * info->params.appendSplitRatio / 100);
+
+}   /* edubtm_SplitLimit() */
+
+
+
+/*@================================
+ * edubtm_IsUnderflow()
+ *================================*/
+/*
+ * Function: Boolean edubtm_IsUnderflow(btm_IndexInfo*, BtreePage*)
+ *
+ * Description:
+ *  Return whether the page underflows after a deletion, so that it should
+ *  be merged with or redistributed from its sibling. By default a page
+ *  underflows when it is not half full. With a lower 'underflowRatio' an
+ *  emptier page is left as it is, which saves the merges, redistributions
+ *  and separator updates of a delete-heavy workload at the cost of space;
+ *  with 0 a page is merged only when it becomes empty. A leaf of a
+ *  clustered index never underflows, since btm_Underflow() would lose the
+ *  inline records of its entries.
+ *
+ * Returns:
+ *  TRUE if the page underflows
+ */
+Boolean edubtm_IsUnderflow(
+    btm_IndexInfo       *info,          /* IN information about the index; NULL if none */
+    BtreePage           *page)          /* IN the page from which an entry was deleted */
+{
+    Four                ratio;          /* underflow ratio (%) */
+    Four                size;           /* size of the data area */
+    Four                used;           /* size of the used part of the data area */
+
+
+    ratio = (info == NULL) ? BTM_DEFAULT_UNDERFLOWRATIO : info->params.underflowRatio;
+
+    if (page->any.hdr.type & LEAF) {
+        if (page->bl.hdr.flags & BTM_CLUSTERED) return(FALSE);
+        if (page->bl.hdr.nSlots == 0) return(TRUE);
+        size = BTM_PAGE_SIZE(&page->bl) - BL_FIXED;
+        used = size - BL_FREE(&page->bl);
+    }
+    else {
+        if (page->bi.hdr.nSlots == 0) return(TRUE);
+        size = BTM_PAGE_SIZE(&page->bi) - BI_FIXED;
+        used = size - BI_FREE(&page->bi);
+    }
+
+    return((used * 100 <= size * ratio) ? TRUE : FALSE);
+
+}   /* edubtm_IsUnderflow() */
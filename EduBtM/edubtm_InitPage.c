@@ -71,6 +71,7 @@ Four edubtm_InitInternal(
 
     page->hdr.pid = *internal;
     page->hdr.flags = BTREE_PAGE_TYPE;
+    page->hdr.reserved = NIL;
 	page->hdr.type = INTERNAL;
 	if (root) page->hdr.type |= ROOT;
     page->hdr.p0 = NIL;
@@ -119,6 +120,7 @@ Four edubtm_InitLeaf(
 
     page->hdr.pid = *leaf;
     page->hdr.flags = BTREE_PAGE_TYPE;
+    page->hdr.reserved = NIL;
 	page->hdr.type = LEAF;
 	if (root) page->hdr.type |= ROOT;
     page->hdr.nSlots = 0;
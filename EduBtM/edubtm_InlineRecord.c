@@ -0,0 +1,161 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_InlineRecord.c
+ *
+ * Description:
+ *  Functions for the records kept in the leaf entries of a clustered index
+ *  (see BTM_CLUSTERED). The record of an entry follows its ObjectID as a
+ *  length and the bytes of the record; the length is NIL when the record
+ *  is not kept in the index.
+ *
+ * Exports:
+ *  Two edubtm_InlineRecordLen(btm_IndexInfo*, BtreeLeaf*, Two, BtreeRecord*)
+ *  void edubtm_PutInlineRecord(btm_LeafEntry*, BtreeRecord*, Two)
+ *  Four edubtm_GetInlineRecord(BtreeCursor*, BtreeRecord*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * edubtm_InlineRecordLen()
+ *================================*/
+/*
+ * Function: Two edubtm_InlineRecordLen(btm_IndexInfo*, BtreeLeaf*, Two, BtreeRecord*)
+ *
+ * Description:
+ *  Decide whether the record 'record' is kept in the new entry of the
+ *  clustered leaf 'page' whose length without the record is 'entryLen'.
+ *  The record is kept when it is not longer than 'inlineRecordMax' of the
+ *  index and the entry with the record stays within OVERFLOW_SPLIT() of
+ *  the page.
+ *
+ * Returns:
+ *  length of the record to keep in the entry; NIL if none
+ */
+Two edubtm_InlineRecordLen(
+    btm_IndexInfo *info,	/* IN information about the index; NULL if none */
+    BtreeLeaf *page,		/* IN the leaf to take the entry */
+    Two entryLen,		/* IN length of the entry without its record */
+    BtreeRecord *record)	/* IN the record of the entry; NULL if none */
+{
+    Two maxLen;			/* max length of an inline record */
+
+
+    if (record == NULL || record->len < 0) return(NIL);
+
+    maxLen = (info != NULL) ? info->params.inlineRecordMax : BTM_DEFAULT_INLINERECORDMAX;
+    if (record->len > maxLen) return(NIL);
+
+    if (entryLen + BTM_INLINE_LEN(record->len) > OVERFLOW_SPLIT(page)) return(NIL);
+
+    return(record->len);
+
+}   /* edubtm_InlineRecordLen() */
+
+
+
+/*@================================
+ * edubtm_PutInlineRecord()
+ *================================*/
+/*
+ * Function: void edubtm_PutInlineRecord(btm_LeafEntry*, BtreeRecord*, Two)
+ *
+ * Description:
+ *  Write the record part of the clustered leaf entry 'entry', whose key
+ *  and ObjectID are already in place. 'recLen' is the result of
+ *  edubtm_InlineRecordLen(); with NIL only the length is written.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_PutInlineRecord(
+    btm_LeafEntry *entry,	/* INOUT the leaf entry */
+    BtreeRecord *record,	/* IN the record of the entry; NULL if none */
+    Two recLen)			/* IN length of the record to keep; NIL if none */
+{
+    btm_InlineRecord *inl;	/* the record part of the entry */
+
+
+    inl = BTM_LEAFENTRY_RECORD(entry);
+    inl->len = recLen;
+    if (recLen > 0) memcpy(inl->data, record->data, recLen);
+
+}   /* edubtm_PutInlineRecord() */
+
+
+
+/*@================================
+ * edubtm_GetInlineRecord()
+ *================================*/
+/*
+ * Function: Four edubtm_GetInlineRecord(BtreeCursor*, BtreeRecord*)
+ *
+ * Description:
+ *  Copy the record of the leaf entry under 'cursor' into 'record'. The
+ *  leaf was visited by the search that set the cursor, so fixing it again
+ *  is a buffer hit. 'record->len' is NIL if the entry keeps no record.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_GetInlineRecord(
+    BtreeCursor *cursor,	/* IN a cursor on an ObjectID */
+    BtreeRecord *record)	/* OUT the record of the ObjectID */
+{
+    Four e;			/* error number */
+    BtreeLeaf *apage;		/* the leaf under the cursor */
+    btm_LeafEntry *entry;	/* the leaf entry under the cursor */
+    btm_InlineRecord *inl;	/* the record part of the entry */
+
+
+    record->len = NIL;
+
+    e = edubtm_GetSnapshotTrain(&cursor->leaf, (char**)&apage);
+    if (e < eNOERROR) ERR(e);
+
+    if ((apage->hdr.type & LEAF) && (apage->hdr.flags & BTM_CLUSTERED) &&
+        cursor->slotNo >= 0 && cursor->slotNo < apage->hdr.nSlots) {
+        entry = (btm_LeafEntry*)&apage->data[apage->slot[-cursor->slotNo]];
+        inl = BTM_LEAFENTRY_RECORD(entry);
+        if (inl->len >= 0) {
+            record->len = inl->len;
+            memcpy(record->data, inl->data, inl->len);
+        }
+    }
+
+    e = BfM_FreeTrain(&cursor->leaf, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_GetInlineRecord() */
@@ -36,11 +36,15 @@
  *
  * Exports:
  *  Four edubtm_Insert(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*,
- *                  Boolean*, Boolean*, InternalItem*, Pool*, DeallocListElem*)
+ *                  BtreeRecord*, Boolean*, Boolean*, InternalItem*, Pool*,
+ *                  DeallocListElem*, btm_IndexInfo*)
  *  Four edubtm_InsertLeaf(ObjectID*, PageID*, BtreeLeaf*, KeyDesc*, KeyValue*,
- *                      ObjectID*, Boolean*, Boolean*, InternalItem*)
+ *                      ObjectID*, BtreeRecord*, Boolean*, Boolean*, InternalItem*,
+ *                      btm_IndexInfo*)
  *  Four edubtm_InsertInternal(ObjectID*, BtreeInternal*, InternalItem*,
- *                          Two, Boolean*, InternalItem*)
+ *                          Two, Boolean*, InternalItem*, btm_IndexInfo*)
+ *  Four edubtm_InsertRightmostLeaf(ObjectID*, btm_IndexInfo*, KeyDesc*, KeyValue*,
+ *                               ObjectID*, BtreeRecord*, Boolean*)
  */
 
 
@@ -57,8 +61,8 @@
  *================================*/
 /*
  * Function: Four edubtm_Insert(ObjectID*, PageID*, KeyDesc*, KeyValue*,
- *                           ObjectID*, Boolean*, Boolean*, InternalItem*,
- *                           Pool*, DeallocListElem*)
+ *                           ObjectID*, BtreeRecord*, Boolean*, Boolean*,
+ *                           InternalItem*, Pool*, DeallocListElem*, btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -76,6 +80,9 @@
  *  inserted into the parent page.  'f' is TRUE if the given page is not half
  *  full because of creating a new overflow page.
  *
+ *  The record of the object, if given, is kept in the new leaf entry when
+ *  the index is clustered (see BTM_CLUSTERED).
+ *
  * Returns:
  *  Error code
  *    eBADBTREEPAGE_BTM
@@ -87,12 +94,14 @@ Four edubtm_Insert(
     KeyDesc                     *kdesc,                 /* IN Btree key descriptor */
     KeyValue                    *kval,                  /* IN key value */
     ObjectID                    *oid,                   /* IN ObjectID which will be inserted */
+    BtreeRecord                 *record,                /* IN record of the object; NULL if not given */
     Boolean                     *f,                     /* OUT whether it is merged by creating a new overflow page */
     Boolean                     *h,                     /* OUT whether it is splitted */
     InternalItem                *item,                  /* OUT Internal Item which will be inserted */
                                                         /*     into its parent when 'h' is TRUE */
     Pool                        *dlPool,                /* INOUT pool of dealloc list */
-    DeallocListElem             *dlHead)                /* INOUT head of the dealloc list */
+    DeallocListElem             *dlHead,                /* INOUT head of the dealloc list */
+    btm_IndexInfo               *info)                  /* INOUT information about the index; NULL if none */
 {
     Four                        e;                      /* error number */
     Boolean                     lh;                     /* local 'h' */
@@ -120,10 +129,14 @@ Four edubtm_Insert(
     *f = *h = FALSE;
     lf = lh = FALSE;
 
-    e = BfM_GetTrain(root, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetTrainForUpdate(root, (char**)&apage);
     if (e < eNOERROR) ERR(e);
 
     if(apage->any.hdr.type & INTERNAL){
+        /* In the key head layout, rebuild the key heads if they were dropped */
+        if ((apage->bi.hdr.flags & BTM_KEYHEAD) && !(apage->bi.hdr.flags & BTM_KEYHEAD_VALID))
+            edubtm_BuildKeyHeads(apage, kdesc);
+
         /*  
         – 새로운<object의 key, object ID> pair를 삽입할 leaf page를 찾기위해
           다음으로방문할자식page를결정함
@@ -143,8 +156,8 @@ Four edubtm_Insert(
         – 결정된자식page를 root page로 하는 B+ subtree에 새로운 <object의 key, object ID> pair를 삽입하기 위해 
           재귀적으로 edubtm_Insert()를 호출함
         */
-        e = edubtm_Insert(catObjForFile, &newPid, kdesc, kval, oid, &lf, &lh, &litem, dlPool, dlHead);
-        if (e < eNOERROR) ERR(e);
+        e = edubtm_Insert(catObjForFile, &newPid, kdesc, kval, oid, record, &lf, &lh, &litem, dlPool, dlHead, info);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
 
         // – 결정된자식page에서split이 발생한 경우, 
         if(lh){
@@ -156,19 +169,19 @@ Four edubtm_Insert(
             edubtm_BinarySearchInternal(&(apage->bi), kdesc, &tKey, &idx);
             /* » edubtm_InsertInternal()을 호출하여 결정된 slot 번호로index entry를 삽입함
             – 파라미터로주어진root page에서 split이 발생한 경우, 해당split으로 생성된 새로운 page를 가리키는 internal index entry를 반환함 */
-            e = edubtm_InsertInternal(catObjForFile, &(apage->bi), &litem, idx, h, item);
-            if (e < eNOERROR) ERR(e);
+            e = edubtm_InsertInternal(catObjForFile, &(apage->bi), &litem, idx, h, item, info);
+            if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
         }
     }
     else{
         /*edubtm_InsertLeaf()를 호출하여 해당 page에 새로운 <object의 key, object ID> pair를 삽입함
         – Split이 발생한 경우, 해당 split으로 생성된 새로운 page를 가리키는internal index entry를 반환함*/
-        e = edubtm_InsertLeaf(catObjForFile, root, &apage->bl, kdesc, kval, oid, f, h, item);
-        if (e < eNOERROR) ERR(e);
+        e = edubtm_InsertLeaf(catObjForFile, root, &apage->bl, kdesc, kval, oid, record, f, h, item, info);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
     }
 
     e = BfM_SetDirty(root, PAGE_BUF);
-    if (e < eNOERROR) ERR(e);
+    if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
     e = BfM_FreeTrain(root, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
 
@@ -183,14 +196,16 @@ Four edubtm_Insert(
  *================================*/
 /*
  * Function: Four edubtm_InsertLeaf(ObjectID*, PageID*, BtreeLeaf*, KeyDesc*,
- *                               KeyValue*, ObjectID*, Boolean*, Boolean*,
- *                               InternalItem*)
+ *                               KeyValue*, ObjectID*, BtreeRecord*, Boolean*,
+ *                               Boolean*, InternalItem*, btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
  *  For ODYSSEUS/EduCOSMOS EduBtM, refer to the EduBtM project manual.)
  *
  *  Insert into the given leaf page an ObjectID with the given key.
+ *  In a page of a clustered index a key holds only one ObjectID, and the
+ *  new entry carries the record of the object if it is short enough.
  *
  * Returns:
  *  Error code
@@ -210,11 +225,13 @@ Four edubtm_InsertLeaf(
     KeyDesc                     *kdesc,         /* IN Btree key descriptor */
     KeyValue                    *kval,          /* IN key value */
     ObjectID                    *oid,           /* IN ObjectID which will be inserted */
+    BtreeRecord                 *record,        /* IN record of the object; NULL if not given */
     Boolean                     *f,             /* OUT whether it is merged by creating */
                                                 /*     a new overflow page */
     Boolean                     *h,             /* OUT whether it is splitted */
-    InternalItem                *item)          /* OUT Internal Item which will be inserted */
+    InternalItem                *item,          /* OUT Internal Item which will be inserted */
                                                 /*     into its parent when 'h' is TRUE */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
 {
     Four                        e;              /* error number */
     Two                         i;
@@ -229,6 +246,8 @@ Four edubtm_InsertLeaf(
     Two                         neededSpace;
     ObjectID                    *oidArray;      /* an array of ObjectIDs */
     Two                         oidArrayElemNo; /* an index for the ObjectID array */
+    Two                         recLen;         /* length of the inline record; NIL if none */
+    ObjectID                    entryBuf[MAX_OVERFLOW_SPLIT/sizeof(ObjectID) + 1]; /* the new entry of a clustered page */
 
 
     /* Error check whether using not supported functionality by EduBtM */
@@ -241,15 +260,26 @@ Four edubtm_InsertLeaf(
     
     /*@ Initially the flags are FALSE */
     *h = *f = FALSE;
+
+    /* In the key head layout, rebuild the key heads if they were dropped */
+    if ((page->hdr.flags & BTM_KEYHEAD) && !(page->hdr.flags & BTM_KEYHEAD_VALID))
+        edubtm_BuildKeyHeads((BtreePage*)page, kdesc);
     
     /*
     • 새로운index entry의 삽입 위치 (slot 번호) 를 결정함
         – Slot array에 저장된 index entry의 offset들이 index entry의 key 순으로 정렬되어야 함
         – 새로운index entry의 key 값과 동일한 key 값을 갖는 index entry가 존재하는 경우
-          eDUPLICATEDKEY_BTM error 를 반환함
+          유일 key 색인이면 eDUPLICATEDKEY_BTM error 를 반환하고,
+          그렇지 않으면 해당 index entry의 ObjectID 목록에 object ID를 추가함
     */
-    if (edubtm_BinarySearchLeaf(page, kdesc, kval, &idx)) 
-        ERR(eDUPLICATEDKEY_BTM);
+    if (edubtm_BinarySearchLeaf(page, kdesc, kval, &idx)) {
+        if ((kdesc->flag & KEYFLAG_UNIQUE) || (page->hdr.flags & BTM_CLUSTERED)) ERR(eDUPLICATEDKEY_BTM);
+
+        e = edubtm_InsertObjectId(catObjForFile, pid, page, idx, oid, f, h, item, info);
+        if (e < eNOERROR) ERR(e);
+
+        return(eNOERROR);
+    }
 
     // 새로운index entry 삽입을 위해 필요한 자유 영역의 크기를계산함
     alignedKlen = 0;
@@ -265,14 +295,24 @@ Four edubtm_InsertLeaf(
         Two        Two   (aligned)klen    ObjectID
     */
     entryLen = sizeof(Two)+ sizeof(Two)+ alignedKlen+ sizeof(ObjectID);
-    // Align 된 key 영역을 고려한 새로운 index entry의 크기 + slot의 크기
-    neededSpace = entryLen+ sizeof(Two);
+    // clustered index의 page에서는 object ID 뒤에 inline record가 붙음
+    recLen = NIL;
+    if (page->hdr.flags & BTM_CLUSTERED) {
+        recLen = edubtm_InlineRecordLen(info, page, entryLen, record);
+        entryLen += BTM_INLINE_LEN(recLen);
+    }
+    // Align 된 key 영역을 고려한 새로운 index entry의 크기 + slot의 크기 (+ key head의 크기)
+    neededSpace = entryLen+ sizeof(Two)+ BTM_KEYHEAD_LEN(page);
     
     // • Page에 여유 영역이있는경우,
     if (BL_FREE(page) >= neededSpace){
         // – 필요시page를compact 함  
         if (BL_CFREE(page) < neededSpace)
             edubtm_CompactLeafPage(page, NIL);
+
+        // key head layout에서는 slot array를 재배열하기 전에 key head를 삽입함
+        if (page->hdr.flags & BTM_KEYHEAD_VALID)
+            edubtm_InsertKeyHead((BtreePage*)page, idx+1, edubtm_MakeKeyHead(page->hdr.flags, kval));
         
         // » 결정된slot 번호를갖는slot을 사용하기 위해slot array를 재배열함
         for(i = page->hdr.nSlots - 1; i > idx; i--){
@@ -284,18 +324,36 @@ Four edubtm_InsertLeaf(
 
         // » Page의 contiguous free area에 새로운 index entry를 복사함
         entry = (btm_LeafEntry*)&page->data[entryOffset];
-        entry->nObjects = 1; // 유일key를 사용하는EduBtM에서는 각key 값 갖는 object는 한개씩만 존재함
+        entry->nObjects = 1; // 새로운 index entry는 object ID 하나로 시작함; 같은 key의 object ID는 edubtm_InsertObjectId()가 추가함
         entry->klen = kval->len;
         memcpy(entry->kval, kval->val, alignedKlen);
         memcpy(&entry->kval[alignedKlen], oid, sizeof(ObjectID));
+        if (page->hdr.flags & BTM_CLUSTERED) edubtm_PutInlineRecord(entry, record, recLen);
 
         // Page의 header을 갱신함
         page->hdr.free = page->hdr.free + entryLen;
         page->hdr.nSlots ++;
+
+        // 마지막 leaf page이면 다음 삽입을 위해 기억해 둠
+        if (info != NULL && page->hdr.nextPage == NIL && !(page->hdr.type & ROOT))
+            info->rightmostLeaf = *pid;
     }
     /*• Page에 여유 영역이없는경우(page overflow),
         – edubtm_SplitLeaf()를 호출하여 page를 split 함
         – Split으로 생성된 새로운 leaf page를 가리키는 internal index entry를 반환함 */
+    else if (page->hdr.flags & BTM_CLUSTERED){
+        /* LeafItem에는 record를 담을 수 없으므로 entry를 만들어 split에 넘김 */
+        entry = (btm_LeafEntry*)entryBuf;
+        entry->nObjects = 1;
+        entry->klen = kval->len;
+        memcpy(entry->kval, kval->val, alignedKlen);
+        memcpy(&entry->kval[alignedKlen], oid, sizeof(ObjectID));
+        edubtm_PutInlineRecord(entry, record, recLen);
+
+        e = edubtm_SplitLeafEntry(catObjForFile, pid, page, idx, entry, item, info);
+        if (e < eNOERROR) ERR(e);
+        *h = TRUE; // is Splitted
+    }
     else{
         /* LeafItem
         ----------------------------------------------------
@@ -307,7 +365,7 @@ Four edubtm_InsertLeaf(
         leaf.oid = *oid;
         leaf.nObjects = 1;
         memcpy(&leaf.klen, kval, sizeof(KeyValue));
-        e = edubtm_SplitLeaf(catObjForFile, pid, page, idx, &leaf, item);
+        e = edubtm_SplitLeaf(catObjForFile, pid, page, idx, &leaf, item, info);
         if (e < eNOERROR) ERR(e);
         *h = TRUE; // is Splitted
     }
@@ -322,7 +380,7 @@ Four edubtm_InsertLeaf(
  * edubtm_InsertInternal()
  *================================*/
 /*
- * Function: Four edubtm_InsertInternal(ObjectID*, BtreeInternal*, InternalItem*, Two, Boolean*, InternalItem*)
+ * Function: Four edubtm_InsertInternal(ObjectID*, BtreeInternal*, InternalItem*, Two, Boolean*, InternalItem*, btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -347,7 +405,8 @@ Four edubtm_InsertInternal(
     InternalItem        *item,          /* IN Iternal item which is inserted */
     Two                 high,           /* IN index in the given page */
     Boolean             *h,             /* OUT whether the given page is splitted */
-    InternalItem        *ritem)         /* OUT if the given page is splitted, the internal item may be returned by 'ritem'. */
+    InternalItem        *ritem,         /* OUT if the given page is splitted, the internal item may be returned by 'ritem'. */
+    btm_IndexInfo       *info)          /* IN information about the index; NULL if none */
 {
     Four                e;              /* error number */
     Two                 i;              /* index */
@@ -367,18 +426,22 @@ Four edubtm_InsertInternal(
     ------------------------------------------------
     |     spid    |     klen     |      kval[]     |
     ------------------------------------------------
-    ShortPageID       Two            entry->klen
+    ShortPageID       Two            item->klen
     */
-    alignedKlen = ALIGNED_LENGTH(sizeof(Two)+entry->klen);
+    alignedKlen = ALIGNED_LENGTH(sizeof(Two)+item->klen);
     entryLen = sizeof(ShortPageID)+ alignedKlen;
-    // Align 된 key 영역을 고려한 새로운 index entry의 크기 + slot의 크기
-    neededSpace = entryLen+ sizeof(Two);
+    // Align 된 key 영역을 고려한 새로운 index entry의 크기 + slot의 크기 (+ key head의 크기)
+    neededSpace = entryLen+ sizeof(Two)+ BTM_KEYHEAD_LEN(page);
     
     // • Page에 여유 영역이있는경우,
-    if (BL_FREE(page) >= neededSpace){
+    if (BI_FREE(page) >= neededSpace){
         // – 필요시page를compact 함  
-        if (BL_CFREE(page) < neededSpace)
+        if (BI_CFREE(page) < neededSpace)
             edubtm_CompactInternalPage(page, NIL);
+
+        // key head layout에서는 slot array를 재배열하기 전에 key head를 삽입함
+        if (page->hdr.flags & BTM_KEYHEAD_VALID)
+            edubtm_InsertKeyHead((BtreePage*)page, high+1, edubtm_MakeKeyHead(page->hdr.flags, (KeyValue*)&item->klen));
         
         // » 결정된slot 번호를갖는slot을 사용하기 위해slot array를 재배열함
         for(i = page->hdr.nSlots - 1; i > high; i--){
@@ -402,7 +465,7 @@ Four edubtm_InsertInternal(
         – edubtm_SplitInternal()를 호출하여 page를 split 함
         – Split으로 생성된 새로운 internal page를 가리키는 internal index entry를 반환함 */
     else{
-        e = edubtm_SplitInternal(catObjForFile, page, high, item, ritem);
+        e = edubtm_SplitInternal(catObjForFile, page, high, item, ritem, info);
         if (e < eNOERROR) ERR(e);
         *h = TRUE; // is Splitted
     }
@@ -411,3 +474,102 @@ Four edubtm_InsertInternal(
     
 } /* edubtm_InsertInternal() */
 
+
+
+/*@================================
+ * edubtm_InsertRightmostLeaf()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertRightmostLeaf(ObjectID*, btm_IndexInfo*, KeyDesc*,
+ *                                        KeyValue*, ObjectID*, BtreeRecord*, Boolean*)
+ *
+ * Description:
+ *  Try to insert an ObjectID with the given key directly into the rightmost
+ *  leaf remembered in 'info', without descending from the root. This is
+ *  done only if the hint is still valid and the key surely belongs to the
+ *  leaf: the page is a leaf without a next page, and the key is greater than
+ *  its first key, which is not less than the key of the leaf in its parent.
+ *  The leaf should also have room for the new entry, because a split needs
+ *  the path to the parent; otherwise nothing is done. Nothing is done for
+ *  a buffered index (see BTM_BUFFERED) either, whose insertions are made
+ *  through the message buffer of its root.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) done : TRUE if the ObjectID is inserted
+ *  2) the hint is cleared if it is no longer valid
+ */
+Four edubtm_InsertRightmostLeaf(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+-tree file */
+    btm_IndexInfo               *info,          /* INOUT information about the index */
+    KeyDesc                     *kdesc,         /* IN Btree key descriptor */
+    KeyValue                    *kval,          /* IN key value */
+    ObjectID                    *oid,           /* IN ObjectID which will be inserted */
+    BtreeRecord                 *record,        /* IN record of the object; NULL if not given */
+    Boolean                     *done)          /* OUT whether the ObjectID is inserted */
+{
+    Four                        e;              /* error number */
+    PageID                      pid;            /* PageID of the rightmost leaf */
+    BtreeLeaf                   *page;          /* pointer to buffer page of the rightmost leaf */
+    btm_LeafEntry               *entry;         /* the first entry of the leaf */
+    Four                        neededSpace;    /* space for the new entry, its slot, and key heads */
+    Boolean                     lf;             /* for merging */
+    Boolean                     lh;             /* for spliting */
+    InternalItem                item;           /* Internal Item; not used since no split occurs */
+
+
+    *done = FALSE;
+
+    if (IS_NILPAGEID(info->rightmostLeaf)) return(eNOERROR);
+
+    pid = info->rightmostLeaf;
+    e = edubtm_GetTrainForUpdate(&pid, (char**)&page);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ check that the hint is still valid */
+    if (!(page->hdr.type & LEAF) || (page->hdr.type & ROOT) || (page->hdr.flags & BTM_BUFFERED) ||
+        page->hdr.nextPage != NIL || page->hdr.nSlots == 0) {
+        info->rightmostLeaf.pageNo = NIL;
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    entry = (btm_LeafEntry*)&page->data[page->slot[0]];
+    if (edubtm_KeyCompare(kdesc, kval, (KeyValue*)&entry->klen) != GREAT) {
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    /*@ the leaf should have room without a split */
+    neededSpace = sizeof(Two) + sizeof(Two) + ALIGNED_LENGTH(kval->len) + sizeof(ObjectID);
+    if (page->hdr.flags & BTM_CLUSTERED)
+        neededSpace += BTM_INLINE_LEN(edubtm_InlineRecordLen(info, page, neededSpace, record));
+    neededSpace += sizeof(Two);
+    if (page->hdr.flags & BTM_KEYHEAD)
+        neededSpace += (page->hdr.flags & BTM_KEYHEAD_VALID) ? sizeof(KeyHead) : (page->hdr.nSlots+1)*sizeof(KeyHead);
+
+    if (BL_FREE(page) < neededSpace) {
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    e = edubtm_InsertLeaf(catObjForFile, &pid, page, kdesc, kval, oid, record, &lf, &lh, &item, info);
+    if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    *done = TRUE;
+
+    return(eNOERROR);
+
+} /* edubtm_InsertRightmostLeaf() */
+
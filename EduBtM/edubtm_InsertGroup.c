@@ -0,0 +1,601 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_InsertGroup.c
+ *
+ * Description :
+ *  Insert a group of <key, ObjectID> pairs sorted in key order into a B+
+ *  subtree with a single descent. On an internal page the group is
+ *  partitioned among the children by their key ranges, so that every page
+ *  on the way is fixed once for the whole group rather than once per key.
+ *  On a leaf page all the keys of the group are merged with the entries of
+ *  the page at once. A page that overflows is also split only once: its
+ *  entries and the new entries are distributed over as many pages as they
+ *  need, and an internal item for each new page is returned to the parent.
+ *
+ * Exports:
+ *  Four edubtm_InsertGroup(ObjectID*, PageID*, btm_InsertBatch*, Four, Four,
+ *                          btm_InternalItemList*, btm_IndexInfo*)
+ *  Four edubtm_InsertInternalGroup(ObjectID*, PageID*, BtreeInternal*, KeyDesc*,
+ *                                  btm_InternalItemList*, btm_InternalItemList*, btm_IndexInfo*)
+ *  Four edubtm_AppendInternalItem(btm_InternalItemList*, InternalItem*)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "OM_Internal.h"	/* for SlottedPage containing catalog object */
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_InsertLeafGroup(ObjectID*, PageID*, BtreeLeaf*, btm_InsertBatch*, Four, Four, btm_InternalItemList*, btm_IndexInfo*);
+Four edubtm_DistributeEntries(ObjectID*, PageID*, BtreePage*, KeyDesc*, Four, char**, Two*, btm_InternalItemList*, btm_IndexInfo*);
+
+
+
+/*@================================
+ * edubtm_InsertGroup()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertGroup(ObjectID*, PageID*, btm_InsertBatch*, Four, Four,
+ *                                   btm_InternalItemList*, btm_IndexInfo*)
+ *
+ * Description:
+ *  Insert the keys batch->order[lo .. hi-1] of the batch into the B+ subtree
+ *  given by 'root'. The keys should be in ascending order and should all
+ *  fall into the key range of the subtree.
+ *
+ *  If 'root' is an internal page, the keys are divided into runs which go
+ *  to the same child: a run ends at the first key not less than the key of
+ *  the next entry. Each run is inserted by a recursive call, and the items
+ *  returned by the children are inserted into 'root' together.
+ *
+ *  If the subtree was split, an internal item for each new page is appended
+ *  to 'ritems' in key order.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_InsertGroup(
+    ObjectID                    *catObjForFile,         /* IN catalog object of B+-tree file */
+    PageID                      *root,                  /* IN the root of a Btree */
+    btm_InsertBatch             *batch,                 /* INOUT keys and ObjectIDs to insert */
+    Four                        lo,                     /* IN first index of the keys in batch->order */
+    Four                        hi,                     /* IN index next to the last key in batch->order */
+    btm_InternalItemList        *ritems,                /* INOUT Internal Items which will be inserted */
+                                                        /*       into the parent */
+    btm_IndexInfo               *info)                  /* INOUT information about the index; NULL if none */
+{
+    Four                        e;                      /* error number */
+    Four                        i;                      /* index of the first key of a run */
+    Four                        j;                      /* index next to the last key of a run */
+    Two                         idx;                    /* index for the given key value */
+    PageID                      childPid;               /* PageID of a child page */
+    BtreePage                   *apage;                 /* a pointer to the root page */
+    btm_InternalEntry           *iEntry;                /* an internal entry */
+    btm_InternalEntry           *bound;                 /* entry bounding the key range of a child */
+    btm_InternalItemList        citems;                 /* Internal Items returned by the children */
+
+
+    e = edubtm_GetTrainForUpdate(root, (char**)&apage);
+    if (e < eNOERROR) ERR(e);
+
+    if (apage->any.hdr.type & INTERNAL) {
+        /* In the key head layout, rebuild the key heads if they were dropped */
+        if ((apage->bi.hdr.flags & BTM_KEYHEAD) && !(apage->bi.hdr.flags & BTM_KEYHEAD_VALID))
+            edubtm_BuildKeyHeads(apage, batch->kdesc);
+
+        citems.nItems = citems.maxItems = 0;
+        citems.items = NULL;
+
+        for (i = lo; i < hi; i = j) {
+
+            /*@ find the child for the first key of the run */
+            edubtm_BinarySearchInternal(&apage->bi, batch->kdesc, &batch->kvals[batch->order[i]], &idx);
+
+            if (idx == -1) {
+                MAKE_PAGEID(childPid, root->volNo, apage->bi.hdr.p0);
+            } else {
+                iEntry = (btm_InternalEntry*)&apage->bi.data[apage->bi.slot[-idx]];
+                MAKE_PAGEID(childPid, root->volNo, iEntry->spid);
+            }
+
+            /*@ extend the run up to the key range of the child */
+            bound = (idx + 1 < apage->bi.hdr.nSlots) ?
+                (btm_InternalEntry*)&apage->bi.data[apage->bi.slot[-(idx+1)]] : NULL;
+
+            for (j = i + 1; j < hi; j++)
+                if (bound != NULL &&
+                    edubtm_KeyCompare(batch->kdesc, &batch->kvals[batch->order[j]], (KeyValue*)&bound->klen) != LESS)
+                    break;
+
+            e = edubtm_InsertGroup(catObjForFile, &childPid, batch, i, j, &citems, info);
+            if (e < eNOERROR) {
+                free(citems.items);
+                ERRB1(e, root, PAGE_BUF);
+            }
+        }
+
+        /*@ insert the items of the split children */
+        e = edubtm_InsertInternalGroup(catObjForFile, root, &apage->bi, batch->kdesc, &citems, ritems, info);
+        free(citems.items);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+    }
+    else {
+        e = edubtm_InsertLeafGroup(catObjForFile, root, &apage->bl, batch, lo, hi, ritems, info);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+    }
+
+    e = BfM_SetDirty(root, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_InsertGroup() */
+
+
+
+/*@================================
+ * edubtm_InsertLeafGroup()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertLeafGroup(ObjectID*, PageID*, BtreeLeaf*, btm_InsertBatch*,
+ *                                       Four, Four, btm_InternalItemList*, btm_IndexInfo*)
+ *
+ * Description:
+ *  Merge the keys batch->order[lo .. hi-1] with the entries of the given
+ *  leaf page and write the result back with edubtm_DistributeEntries().
+ *  A key which is already in the page, or which is repeated in the batch,
+ *  is skipped; batch->nInserted counts the keys actually inserted.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_InsertLeafGroup(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+-tree file */
+    PageID                      *pid,           /* IN PageID of the leaf page */
+    BtreeLeaf                   *page,          /* INOUT pointer to buffer page of the leaf page */
+    btm_InsertBatch             *batch,         /* INOUT keys and ObjectIDs to insert */
+    Four                        lo,             /* IN first index of the keys in batch->order */
+    Four                        hi,             /* IN index next to the last key in batch->order */
+    btm_InternalItemList        *ritems,        /* INOUT Internal Items which will be inserted into the parent */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
+{
+    Four                        e;              /* error number */
+    Four                        i;              /* index of an entry of the page */
+    Four                        j;              /* index of a key of the batch */
+    Four                        n;              /* # of merged entries */
+    Four                        nNew;           /* # of new entries */
+    Four                        cmp;            /* result of a key comparison */
+    BtreeLeaf                   tpage;          /* a copy of the page */
+    btm_LeafEntry               *entry;         /* an entry of the page */
+    btm_LeafEntry               *newEntry;      /* a new entry */
+    btm_LeafEntry               *lastNew;       /* the new entry made last */
+    KeyValue                    *kval;          /* key value of the batch */
+    Two                         alignedKlen;    /* aligned length of the key length */
+    char                        **entries;      /* merged entries in key order */
+    Two                         *lens;          /* lengths of the merged entries */
+    char                        *arena;         /* storage for the new entries */
+    Four                        arenaFree;      /* starting point of the free space of 'arena' */
+
+
+    memcpy(&tpage, page, PAGESIZE);
+
+    entries = (char**)malloc((tpage.hdr.nSlots + hi - lo) * sizeof(char*));
+    lens = (Two*)malloc((tpage.hdr.nSlots + hi - lo) * sizeof(Two));
+    arena = (char*)malloc((hi - lo) * (BTM_LEAFENTRY_FIXED + ALIGNED_LENGTH(MAXKEYLEN) + sizeof(ObjectID) + BTM_INLINE_LEN(NIL)));
+    if (entries == NULL || lens == NULL || arena == NULL) {
+        free(entries); free(lens); free(arena);
+        ERR(eMEMORYALLOCERR_EDUBTM);
+    }
+
+    /*@ merge the entries of the page with the new keys */
+    i = 0; j = lo; n = nNew = 0;
+    arenaFree = 0;
+    lastNew = NULL;
+    while (i < tpage.hdr.nSlots || j < hi) {
+        entry = (i < tpage.hdr.nSlots) ? (btm_LeafEntry*)&tpage.data[tpage.slot[-i]] : NULL;
+        kval = (j < hi) ? &batch->kvals[batch->order[j]] : NULL;
+
+        if (kval == NULL) cmp = LESS;
+        else if (entry == NULL) cmp = GREAT;
+        else cmp = edubtm_KeyCompare(batch->kdesc, (KeyValue*)&entry->klen, kval);
+
+        if (cmp == LESS) {
+            entries[n] = (char*)entry;
+            lens[n++] = BTM_LEAFENTRY_LEN(&tpage, entry);
+            i++;
+        }
+        else if (cmp == EQUAL ||
+                 (lastNew != NULL && edubtm_KeyCompare(batch->kdesc, (KeyValue*)&lastNew->klen, kval) == EQUAL)) {
+            /* the key is already in the index: skip it */
+            j++;
+        }
+        else {
+            /*
+            -----------------------------------------------------
+            |  nObjects |  klen  |   key   |  value(Object ID)  |
+            -----------------------------------------------------
+            */
+            alignedKlen = ALIGNED_LENGTH(kval->len);
+            newEntry = (btm_LeafEntry*)&arena[arenaFree];
+            newEntry->nObjects = 1;
+            newEntry->klen = kval->len;
+            memcpy(newEntry->kval, kval->val, kval->len);
+            memcpy(&newEntry->kval[alignedKlen], &batch->oids[batch->order[j]], sizeof(ObjectID));
+
+            /* a batch has no records; an entry of a clustered index keeps a NIL record length */
+            if (tpage.hdr.flags & BTM_CLUSTERED) edubtm_PutInlineRecord(newEntry, NULL, NIL);
+
+            entries[n] = (char*)newEntry;
+            lens[n++] = BTM_LEAFENTRY_LEN(&tpage, newEntry);
+            arenaFree += lens[n-1];
+            lastNew = newEntry;
+            nNew++;
+            j++;
+        }
+    }
+
+    e = eNOERROR;
+    if (nNew > 0) {
+        e = edubtm_DistributeEntries(catObjForFile, pid, (BtreePage*)page, batch->kdesc, n, entries, lens, ritems, info);
+        if (e >= eNOERROR) batch->nInserted += nNew;
+    }
+
+    free(entries); free(lens); free(arena);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_InsertLeafGroup() */
+
+
+
+/*@================================
+ * edubtm_InsertInternalGroup()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertInternalGroup(ObjectID*, PageID*, BtreeInternal*, KeyDesc*,
+ *                                           btm_InternalItemList*, btm_InternalItemList*,
+ *                                           btm_IndexInfo*)
+ *
+ * Description:
+ *  Insert the internal items of 'items', which are in key order, into the
+ *  given internal page. If the page overflows, it is split into as many
+ *  pages as needed and an item for each new page is appended to 'ritems'.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_InsertInternalGroup(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+-tree file */
+    PageID                      *pid,           /* IN PageID of the internal page */
+    BtreeInternal               *page,          /* INOUT pointer to buffer page of the internal page */
+    KeyDesc                     *kdesc,         /* IN Btree key descriptor */
+    btm_InternalItemList        *items,         /* IN Internal Items to insert */
+    btm_InternalItemList        *ritems,        /* INOUT Internal Items which will be inserted into the parent */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
+{
+    Four                        e;              /* error number */
+    Four                        i;              /* index of an entry of the page */
+    Four                        j;              /* index of an item */
+    Four                        n;              /* # of merged entries */
+    BtreeInternal               tpage;          /* a copy of the page */
+    btm_InternalEntry           *entry;         /* an entry of the page */
+    InternalItem                *item;          /* an item to insert */
+    char                        **entries;      /* merged entries in key order */
+    Two                         *lens;          /* lengths of the merged entries */
+
+
+    if (items->nItems == 0) return(eNOERROR);
+
+    memcpy(&tpage, page, PAGESIZE);
+
+    entries = (char**)malloc((tpage.hdr.nSlots + items->nItems) * sizeof(char*));
+    lens = (Two*)malloc((tpage.hdr.nSlots + items->nItems) * sizeof(Two));
+    if (entries == NULL || lens == NULL) {
+        free(entries); free(lens);
+        ERR(eMEMORYALLOCERR_EDUBTM);
+    }
+
+    /*@ merge the entries of the page with the items */
+    /* An InternalItem has the same layout as a btm_InternalEntry, so it is used as an entry as it is. */
+    for (i = 0, j = 0, n = 0; i < tpage.hdr.nSlots || j < items->nItems; n++) {
+        entry = (i < tpage.hdr.nSlots) ? (btm_InternalEntry*)&tpage.data[tpage.slot[-i]] : NULL;
+        item = (j < items->nItems) ? &items->items[j] : NULL;
+
+        if (item == NULL ||
+            (entry != NULL && edubtm_KeyCompare(kdesc, (KeyValue*)&entry->klen, (KeyValue*)&item->klen) == LESS)) {
+            entries[n] = (char*)entry;
+            lens[n] = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + entry->klen);
+            i++;
+        } else {
+            entries[n] = (char*)item;
+            lens[n] = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + item->klen);
+            j++;
+        }
+    }
+
+    e = edubtm_DistributeEntries(catObjForFile, pid, (BtreePage*)page, kdesc, n, entries, lens, ritems, info);
+
+    free(entries); free(lens);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_InsertInternalGroup() */
+
+
+
+/*@================================
+ * edubtm_DistributeEntries()
+ *================================*/
+/*
+ * Function: Four edubtm_DistributeEntries(ObjectID*, PageID*, BtreePage*, KeyDesc*,
+ *                                         Four, char**, Two*, btm_InternalItemList*,
+ *                                         btm_IndexInfo*)
+ *
+ * Description:
+ *  Rewrite the given leaf or internal page with the given entries, which
+ *  are in key order and do not point into the page itself. If they do not
+ *  fit into the page, they are spread evenly over the page and as many new
+ *  pages as needed, which are allocated next to each other; this is a
+ *  single split of the page into several pages.
+ *
+ *  For each new page an internal item is appended to 'ritems'. For a leaf,
+ *  the item has the first key of the new page and the new pages are linked
+ *  into the leaf chain. For an internal page, the first entry assigned to
+ *  a new page moves up to the item and its child becomes 'p0' of the page.
+ *  A page split in this way is counted once in the statistics of the index.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_DistributeEntries(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+-tree file */
+    PageID                      *pid,           /* IN PageID of the page */
+    BtreePage                   *page,          /* INOUT pointer to buffer page of the page */
+    KeyDesc                     *kdesc,         /* IN Btree key descriptor */
+    Four                        nEntries,       /* IN # of entries */
+    char                        **entries,      /* IN entries in key order */
+    Two                         *lens,          /* IN lengths of the entries */
+    btm_InternalItemList        *ritems,        /* INOUT Internal Items which will be inserted into the parent */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
+{
+    Four                        e;              /* error number */
+    Four                        i;              /* index of an entry */
+    Boolean                     isLeaf;         /* TRUE if the page is a leaf */
+    Four                        headLen;        /* length of a key head of an entry */
+    Four                        capacity;       /* # of bytes for entries, slots, and key heads in a page */
+    Four                        total;          /* # of bytes needed by all the entries */
+    Four                        target;         /* # of bytes to fill in a page */
+    Four                        used;           /* # of bytes filled in the current page */
+    Four                        cost;           /* # of bytes needed by an entry */
+    ShortPageID                 origNext;       /* next page of the given leaf page */
+    PageID                      curPid;         /* PageID of the page being filled */
+    BtreePage                   *cur;           /* the page being filled */
+    PageID                      newPid;         /* PageID of a new page */
+    BtreePage                   *npage;         /* a new page */
+    PageID                      nextPid;        /* PageID of the old next page */
+    BtreeLeaf                   *nextPage;      /* the old next page */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+    btm_LeafEntry               *lEntry;        /* a leaf entry */
+    InternalItem                ritem;          /* an item for a new page */
+
+
+    isLeaf = (page->any.hdr.type & LEAF) ? TRUE : FALSE;
+    headLen = (page->any.hdr.flags & BTM_KEYHEAD) ? sizeof(KeyHead) : 0;
+    capacity = BTM_PAGE_SIZE(&page->any) - (isLeaf ? BL_FIXED : BI_FIXED) + sizeof(Two);
+
+    for (total = 0, i = 0; i < nEntries; i++)
+        total += lens[i] + sizeof(Two) + headLen;
+
+    /*@ spread the entries evenly over the pages they need */
+    target = (total <= capacity) ? capacity : total / ((total + capacity - 1) / capacity);
+
+    /* The key heads are rebuilt after the page is written. */
+    edubtm_DropKeyHeads(page);
+
+    if (isLeaf) {
+        origNext = page->bl.hdr.nextPage;
+        page->bl.hdr.nSlots = 0;
+        page->bl.hdr.free = 0;
+        page->bl.hdr.unused = 0;
+    } else {
+        page->bi.hdr.nSlots = 0;
+        page->bi.hdr.free = 0;
+        page->bi.hdr.unused = 0;
+    }
+
+    curPid = *pid;
+    cur = page;
+    used = 0;
+
+    for (i = 0; i < nEntries; i++) {
+        cost = lens[i] + sizeof(Two) + headLen;
+
+        /*@ start a new page; an internal page keeps at least one entry after the moved-up one */
+        if (used > 0 && (used + cost > target || used + cost > capacity) && (isLeaf || i < nEntries - 1)) {
+
+            e = btm_AllocPage(catObjForFile, &curPid, &newPid);
+            if (e < eNOERROR) {
+                if (cur != page) ERRB1(e, &curPid, PAGE_BUF);
+                ERR(e);
+            }
+
+            e = isLeaf ? edubtm_InitLeaf(&newPid, FALSE, FALSE) : edubtm_InitInternal(&newPid, FALSE, FALSE);
+            if (e < eNOERROR) {
+                if (cur != page) ERRB1(e, &curPid, PAGE_BUF);
+                ERR(e);
+            }
+
+            e = BfM_GetTrain(&newPid, (char**)&npage, PAGE_BUF);
+            if (e < eNOERROR) {
+                if (cur != page) ERRB1(e, &curPid, PAGE_BUF);
+                ERR(e);
+            }
+
+            npage->any.hdr.flags |= page->any.hdr.flags & BTM_INHERITED_FLAGS;
+
+            ritem.spid = newPid.pageNo;
+            if (isLeaf) {
+                lEntry = (btm_LeafEntry*)entries[i];
+                ritem.klen = lEntry->klen;
+                memcpy(ritem.kval, lEntry->kval, lEntry->klen);
+
+                npage->bl.hdr.prevPage = curPid.pageNo;
+                cur->bl.hdr.nextPage = newPid.pageNo;
+            } else {
+                iEntry = (btm_InternalEntry*)entries[i];
+                ritem.klen = iEntry->klen;
+                memcpy(ritem.kval, iEntry->kval, iEntry->klen);
+
+                npage->bi.hdr.p0 = iEntry->spid;
+            }
+
+            e = edubtm_AppendInternalItem(ritems, &ritem);
+            if (e < eNOERROR) {
+                if (cur != page) ERRB2(e, &curPid, PAGE_BUF, &newPid, PAGE_BUF);
+                ERRB1(e, &newPid, PAGE_BUF);
+            }
+
+            /*@ finish the filled page */
+            if (headLen > 0) edubtm_BuildKeyHeads(cur, kdesc);
+            if (cur != page) {
+                e = BfM_SetDirty(&curPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB2(e, &curPid, PAGE_BUF, &newPid, PAGE_BUF);
+                e = BfM_FreeTrain(&curPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, &newPid, PAGE_BUF);
+            }
+
+            cur = npage;
+            curPid = newPid;
+            used = 0;
+
+            /* The first entry of a new internal page is moved up to the parent. */
+            if (!isLeaf) continue;
+        }
+
+        if (isLeaf) {
+            memcpy(&cur->bl.data[cur->bl.hdr.free], entries[i], lens[i]);
+            cur->bl.slot[-cur->bl.hdr.nSlots] = cur->bl.hdr.free;
+            cur->bl.hdr.free += lens[i];
+            cur->bl.hdr.nSlots++;
+        } else {
+            memcpy(&cur->bi.data[cur->bi.hdr.free], entries[i], lens[i]);
+            cur->bi.slot[-cur->bi.hdr.nSlots] = cur->bi.hdr.free;
+            cur->bi.hdr.free += lens[i];
+            cur->bi.hdr.nSlots++;
+        }
+        used += cost;
+    }
+
+    if (headLen > 0) edubtm_BuildKeyHeads(cur, kdesc);
+
+    if (cur != page) {
+        /*@ link the last new page with the old next page */
+        if (isLeaf) {
+            cur->bl.hdr.nextPage = origNext;
+            if (origNext != NIL) {
+                MAKE_PAGEID(nextPid, pid->volNo, origNext);
+                e = edubtm_GetTrainForUpdate(&nextPid, (char**)&nextPage);
+                if (e < eNOERROR) ERRB1(e, &curPid, PAGE_BUF);
+
+                nextPage->hdr.prevPage = curPid.pageNo;
+
+                e = BfM_SetDirty(&nextPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB2(e, &nextPid, PAGE_BUF, &curPid, PAGE_BUF);
+                e = BfM_FreeTrain(&nextPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, &curPid, PAGE_BUF);
+            }
+        }
+
+        e = BfM_SetDirty(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &curPid, PAGE_BUF);
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        /* The root is split; edubtm_root_insert() makes a new root above it. */
+        if (page->any.hdr.type & ROOT)
+            page->any.hdr.type = isLeaf ? LEAF : INTERNAL;
+
+        if (info != NULL) {
+            if (isLeaf) info->nLeafSplits++;
+            else info->nInternalSplits++;
+        }
+    }
+
+    return(eNOERROR);
+
+}   /* edubtm_DistributeEntries() */
+
+
+
+/*@================================
+ * edubtm_AppendInternalItem()
+ *================================*/
+/*
+ * Function: Four edubtm_AppendInternalItem(btm_InternalItemList*, InternalItem*)
+ *
+ * Description:
+ *  Append a copy of the given internal item to the list, growing the list
+ *  if it is full.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ */
+Four edubtm_AppendInternalItem(
+    btm_InternalItemList        *list,          /* INOUT list of Internal Items */
+    InternalItem                *item)          /* IN Internal Item to append */
+{
+    InternalItem                *items;         /* the grown array of items */
+
+
+    if (list->nItems == list->maxItems) {
+        items = (InternalItem*)realloc(list->items, (list->maxItems*2 + 4) * sizeof(InternalItem));
+        if (items == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+        list->items = items;
+        list->maxItems = list->maxItems*2 + 4;
+    }
+
+    list->items[list->nItems++] = *item;
+
+    return(eNOERROR);
+
+}   /* edubtm_AppendInternalItem() */
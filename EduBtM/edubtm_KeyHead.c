@@ -0,0 +1,438 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_KeyHead.c
+ *
+ * Description:
+ *  Functions for the key head layout of B+ tree pages. In this layout, each
+ *  leaf or internal page keeps an order-preserving 4-byte prefix (key head)
+ *  of every entry in a contiguous array just below the slot array. Searching
+ *  the array first narrows the range of slots to the few entries whose heads
+ *  tie with the searched key, so that edubtm_KeyCompare() is called on them
+ *  only. The array is a cache of the entries; when it cannot be maintained
+ *  (e.g. the page is too full or is reorganized by a routine not aware of the
+ *  layout) it is dropped and rebuilt later.
+ *
+ * Exports:
+ *  Four edubtm_KeyHeadKind(KeyDesc*)
+ *  KeyHead edubtm_MakeKeyHead(Four, KeyValue*)
+ *  void edubtm_SearchKeyHeads(KeyHead*, Two, KeyHead, Two*, Two*)
+ *  void edubtm_InsertKeyHead(BtreePage*, Two, KeyHead)
+ *  void edubtm_DeleteKeyHead(BtreePage*, Two)
+ *  Boolean edubtm_BuildKeyHeads(BtreePage*, KeyDesc*)
+ *  void edubtm_DropKeyHeads(BtreePage*)
+ *  Four edubtm_DropKeyHeadsAround(PageID*, BtreeInternal*, Two)
+ */
+
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * edubtm_KeyHeadKind()
+ *================================*/
+/*
+ * Function: Four edubtm_KeyHeadKind(KeyDesc*)
+ *
+ * Description:
+ *  Return the kind of key heads which can be made for the given key
+ *  descriptor. The kind is stored in the page flags.
+ *
+ * Returns:
+ *  BTM_KEYHEAD_INT | BTM_KEYHEAD_EXACT, BTM_KEYHEAD_INT, or BTM_KEYHEAD_STRING
+ */
+Four edubtm_KeyHeadKind(
+    KeyDesc                     *kdesc)         /* IN key descriptor */
+{
+    if (kdesc->kpart[0].type == SM_INT)
+        return((kdesc->nparts == 1) ? (BTM_KEYHEAD_INT | BTM_KEYHEAD_EXACT) : BTM_KEYHEAD_INT);
+    else
+        return(BTM_KEYHEAD_STRING);
+
+} /* edubtm_KeyHeadKind() */
+
+
+
+/*@================================
+ * edubtm_MakeKeyHead()
+ *================================*/
+/*
+ * Function: KeyHead edubtm_MakeKeyHead(Four, KeyValue*)
+ *
+ * Description:
+ *  Make the key head of the given key value. An SM_INT head is the integer
+ *  itself. An SM_VARSTRING head packs the first four characters (padded
+ *  with the smallest code) in big-endian order, so that comparing heads as
+ *  signed integers gives the order of edubtm_KeyCompare().
+ *
+ * Returns:
+ *  key head of the given key value
+ */
+KeyHead edubtm_MakeKeyHead(
+    Four                        flags,          /* IN page flags holding the kind of key heads */
+    KeyValue                    *kval)          /* IN key value */
+{
+    Two                         len;            /* string length */
+    Two                         i;              /* index */
+    UFour_Invariable            head;           /* unsigned key head */
+
+
+    if (flags & BTM_KEYHEAD_INT)
+        return(*(Four_Invariable*)kval->val);
+
+    len = *(Two*)kval->val;
+    head = 0;
+    for (i = 0; i < sizeof(KeyHead); i++) {
+        head <<= 8;
+        /* characters are compared as signed chars */
+        if (i < len) head |= (UFour_Invariable)(((unsigned char)kval->val[sizeof(Two)+i]) ^ 0x80);
+    }
+
+    return((KeyHead)(head ^ 0x80000000));
+
+} /* edubtm_MakeKeyHead() */
+
+
+
+/*@================================
+ * edubtm_SearchKeyHeads()
+ *================================*/
+/*
+ * Function: void edubtm_SearchKeyHeads(KeyHead*, Two, KeyHead, Two*, Two*)
+ *
+ * Description:
+ *  Find the range of the key heads which tie with the given head. The heads
+ *  are compared four at a time with SSE2 instructions when available, and
+ *  by binary search otherwise.
+ *
+ * Returns:
+ *  None
+ *
+ * Side effects:
+ *  1) low  : # of heads less than the given head
+ *  2) high : (# of heads less than or equal to the given head) - 1
+ *            i.e. low > high if no head ties with the given head
+ */
+void edubtm_SearchKeyHeads(
+    KeyHead                     *heads,         /* IN key head array */
+    Two                         nHeads,         /* IN # of key heads */
+    KeyHead                     probe,          /* IN key head to search */
+    Two                         *low,           /* OUT the first slot which may match */
+    Two                         *high)          /* OUT the last slot which may match */
+{
+    Two                         nLess;          /* # of heads less than 'probe' */
+    Two                         nLessEqual;     /* # of heads less than or equal to 'probe' */
+    Two                         i;              /* index */
+#ifdef __SSE2__
+    __m128i                     p;              /* 'probe' in all lanes */
+    __m128i                     h;              /* four heads */
+    int                         lt;             /* mask of heads less than 'probe' */
+    int                         gt;             /* mask of heads greater than 'probe' */
+
+
+    p = _mm_set1_epi32(probe);
+    nLess = nLessEqual = 0;
+    for (i = 0; i + 4 <= nHeads; i += 4) {
+        h = _mm_loadu_si128((__m128i*)&heads[i]);
+        lt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(h, p)));
+        gt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(h, p)));
+        nLess += __builtin_popcount(lt);
+        nLessEqual += 4 - __builtin_popcount(gt);
+
+        /* the heads are sorted; the remaining ones are all greater */
+        if (gt != 0) break;
+    }
+    if (i + 4 > nHeads) {
+        for ( ; i < nHeads && heads[i] <= probe; i++) {
+            if (heads[i] < probe) nLess++;
+            nLessEqual++;
+        }
+    }
+#else
+    Two                         lo, hi;         /* bounds of the binary search */
+    Two                         mid;            /* mid index */
+
+
+    /* lower bound */
+    for (lo = 0, hi = nHeads; lo < hi; ) {
+        mid = (lo + hi) / 2;
+        if (heads[mid] < probe) lo = mid + 1;
+        else hi = mid;
+    }
+    nLess = lo;
+
+    /* upper bound */
+    for (hi = nHeads; lo < hi; ) {
+        mid = (lo + hi) / 2;
+        if (heads[mid] <= probe) lo = mid + 1;
+        else hi = mid;
+    }
+    nLessEqual = lo;
+#endif
+
+    *low = nLess;
+    *high = nLessEqual - 1;
+
+} /* edubtm_SearchKeyHeads() */
+
+
+
+/*@================================
+ * edubtm_InsertKeyHead()
+ *================================*/
+/*
+ * Function: void edubtm_InsertKeyHead(BtreePage*, Two, KeyHead)
+ *
+ * Description:
+ *  Insert the key head of a new entry into the key head array of the page
+ *  at the position 'slotNo'. The array grows by one slot and one head, so it
+ *  should be called before the slot array is rearranged for the new entry
+ *  and 'nSlots' of the page is incremented.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_InsertKeyHead(
+    BtreePage                   *apage,         /* INOUT leaf or internal page */
+    Two                         slotNo,         /* IN slot No. of the new entry */
+    KeyHead                     head)           /* IN key head of the new entry */
+{
+    Two                         nSlots;         /* # of slots before the insertion */
+    KeyHead                     *oldHeads;      /* key head array before the insertion */
+    KeyHead                     *newHeads;      /* key head array after the insertion */
+
+
+    nSlots = (apage->any.hdr.type & LEAF) ? apage->bl.hdr.nSlots : apage->bi.hdr.nSlots;
+    oldHeads = BTM_KEYHEADS(apage, nSlots);
+    newHeads = BTM_KEYHEADS(apage, nSlots+1);
+
+    /* move the lower part first; the upper part overlaps its source */
+    memmove(newHeads, oldHeads, slotNo*sizeof(KeyHead));
+    memmove(&newHeads[slotNo+1], &oldHeads[slotNo], (nSlots-slotNo)*sizeof(KeyHead));
+    newHeads[slotNo] = head;
+
+} /* edubtm_InsertKeyHead() */
+
+
+
+/*@================================
+ * edubtm_DeleteKeyHead()
+ *================================*/
+/*
+ * Function: void edubtm_DeleteKeyHead(BtreePage*, Two)
+ *
+ * Description:
+ *  Delete the key head at the position 'slotNo' from the key head array of
+ *  the page. It should be called after the slot array is compacted and
+ *  before 'nSlots' of the page is decremented.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_DeleteKeyHead(
+    BtreePage                   *apage,         /* INOUT leaf or internal page */
+    Two                         slotNo)         /* IN slot No. of the deleted entry */
+{
+    Two                         nSlots;         /* # of slots before the deletion */
+    KeyHead                     *oldHeads;      /* key head array before the deletion */
+    KeyHead                     *newHeads;      /* key head array after the deletion */
+
+
+    nSlots = (apage->any.hdr.type & LEAF) ? apage->bl.hdr.nSlots : apage->bi.hdr.nSlots;
+    oldHeads = BTM_KEYHEADS(apage, nSlots);
+    newHeads = BTM_KEYHEADS(apage, nSlots-1);
+
+    /* move the upper part first; the lower part overlaps its source */
+    memmove(&newHeads[slotNo], &oldHeads[slotNo+1], (nSlots-slotNo-1)*sizeof(KeyHead));
+    memmove(newHeads, oldHeads, slotNo*sizeof(KeyHead));
+
+} /* edubtm_DeleteKeyHead() */
+
+
+
+/*@================================
+ * edubtm_BuildKeyHeads()
+ *================================*/
+/*
+ * Function: Boolean edubtm_BuildKeyHeads(BtreePage*, KeyDesc*)
+ *
+ * Description:
+ *  Build the key head array of a page using the key head layout if it is
+ *  not valid. If the kind of the key heads is not determined yet, it is
+ *  determined by the given key descriptor; 'kdesc' may be NULL when the
+ *  kind is already known. The page is compacted if needed. If there is not
+ *  enough space, the page is left in the plain layout.
+ *
+ * Returns:
+ *  TRUE if the key head array of the page is valid
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for the page.
+ */
+Boolean edubtm_BuildKeyHeads(
+    BtreePage                   *apage,         /* INOUT leaf or internal page */
+    KeyDesc                     *kdesc)         /* IN key descriptor (may be NULL) */
+{
+    Two                         i;              /* slot No. */
+    Two                         nSlots;         /* # of slots */
+    KeyHead                     *heads;         /* key head array */
+    btm_LeafEntry               *lEntry;        /* a leaf entry */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+
+
+    if (!(apage->any.hdr.flags & BTM_KEYHEAD)) return(FALSE);
+    if (apage->any.hdr.flags & BTM_KEYHEAD_VALID) return(TRUE);
+
+    if (!(apage->any.hdr.flags & BTM_KEYHEAD_KIND)) {
+        if (kdesc == NULL) return(FALSE);
+        apage->any.hdr.flags |= edubtm_KeyHeadKind(kdesc);
+    }
+
+    if (apage->any.hdr.type & LEAF) {
+        nSlots = apage->bl.hdr.nSlots;
+        if (BL_FREE(&apage->bl) < nSlots*(CONSTANT_CASTING_TYPE)sizeof(KeyHead)) return(FALSE);
+        if (BL_CFREE(&apage->bl) < nSlots*(CONSTANT_CASTING_TYPE)sizeof(KeyHead))
+            edubtm_CompactLeafPage(&apage->bl, NIL);
+
+        heads = BTM_KEYHEADS(apage, nSlots);
+        for (i = 0; i < nSlots; i++) {
+            lEntry = (btm_LeafEntry*)&apage->bl.data[apage->bl.slot[-i]];
+            heads[i] = edubtm_MakeKeyHead(apage->any.hdr.flags, (KeyValue*)&lEntry->klen);
+        }
+    }
+    else {
+        nSlots = apage->bi.hdr.nSlots;
+        if (BI_FREE(&apage->bi) < nSlots*(CONSTANT_CASTING_TYPE)sizeof(KeyHead)) return(FALSE);
+        if (BI_CFREE(&apage->bi) < nSlots*(CONSTANT_CASTING_TYPE)sizeof(KeyHead))
+            edubtm_CompactInternalPage(&apage->bi, NIL);
+
+        heads = BTM_KEYHEADS(apage, nSlots);
+        for (i = 0; i < nSlots; i++) {
+            iEntry = (btm_InternalEntry*)&apage->bi.data[apage->bi.slot[-i]];
+            heads[i] = edubtm_MakeKeyHead(apage->any.hdr.flags, (KeyValue*)&iEntry->klen);
+        }
+    }
+
+    apage->any.hdr.flags |= BTM_KEYHEAD_VALID;
+
+    return(TRUE);
+
+} /* edubtm_BuildKeyHeads() */
+
+
+
+/*@================================
+ * edubtm_DropKeyHeads()
+ *================================*/
+/*
+ * Function: void edubtm_DropKeyHeads(BtreePage*)
+ *
+ * Description:
+ *  Invalidate the key head array of the page. The space of the array
+ *  becomes a part of the contiguous free area.
+ *
+ * Returns:
+ *  None
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for the page.
+ */
+void edubtm_DropKeyHeads(
+    BtreePage                   *apage)         /* INOUT leaf or internal page */
+{
+    apage->any.hdr.flags &= ~BTM_KEYHEAD_VALID;
+
+} /* edubtm_DropKeyHeads() */
+
+
+
+/*@================================
+ * edubtm_DropKeyHeadsAround()
+ *================================*/
+/*
+ * Function: Four edubtm_DropKeyHeadsAround(PageID*, BtreeInternal*, Two)
+ *
+ * Description:
+ *  Invalidate the key head arrays of the given internal page and of its
+ *  children at the slots idx-1, idx, and idx+1 (-1 denotes 'p0'). It is
+ *  called before the pages are handed to a routine which is not aware of
+ *  the key head layout, e.g. btm_Underflow(); the arrays are rebuilt lazily
+ *  by the next insertion into each page.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_DropKeyHeadsAround(
+    PageID                      *pid,           /* IN PageID of the internal page */
+    BtreeInternal               *ppage,         /* INOUT the internal page */
+    Two                         idx)            /* IN slot No. of the child in question */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* slot No. */
+    PageID                      child;          /* PageID of a child */
+    BtreePage                   *cpage;         /* pointer to the child page */
+    btm_InternalEntry           *iEntry;        /* an internal entry */
+
+
+    if (!(ppage->hdr.flags & BTM_KEYHEAD)) return(eNOERROR);
+
+    edubtm_DropKeyHeads((BtreePage*)ppage);
+
+    for (i = idx - 1; i <= idx + 1; i++) {
+        if (i < -1 || i >= ppage->hdr.nSlots) continue;
+
+        if (i == -1) {
+            MAKE_PAGEID(child, pid->volNo, ppage->hdr.p0);
+        }
+        else {
+            iEntry = (btm_InternalEntry*)&ppage->data[ppage->slot[-i]];
+            MAKE_PAGEID(child, pid->volNo, iEntry->spid);
+        }
+
+        e = edubtm_GetTrainForUpdate(&child, (char**)&cpage);
+        if (e < eNOERROR) ERR(e);
+
+        if (cpage->any.hdr.flags & BTM_KEYHEAD_VALID) {
+            edubtm_DropKeyHeads(cpage);
+
+            e = BfM_SetDirty(&child, PAGE_BUF);
+            if (e < eNOERROR) ERRB1(e, &child, PAGE_BUF);
+        }
+
+        e = BfM_FreeTrain(&child, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_DropKeyHeadsAround() */
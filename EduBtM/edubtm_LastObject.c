@@ -99,21 +99,44 @@ Four edubtm_LastObject(
     /*B+ tree 색인에서 마지막 object (가장 큰 key값을 갖는leaf index entry) 를 검색함*/
     // find rightmost leaf
     curPid = *root;
-    e = BfM_GetTrain(&curPid, (char**)&apage, PAGE_BUF);
+    e = edubtm_GetSnapshotTrain(&curPid, (char**)&apage);
     if (e < eNOERROR) ERR(e);
     while(!(apage->any.hdr.type & LEAF)){
         slotIdx = apage->bi.hdr.nSlots - 1;
-        iEntryOffset = apage->bi.slot[-slotIdx];
-        iEntry = (btm_InternalEntry*)&apage->bi.data[iEntryOffset];
-        MAKE_PAGEID(child, curPid.volNo, iEntry->spid);
+        if (slotIdx < 0) {
+            /* an internal page whose only child could not be merged */
+            MAKE_PAGEID(child, curPid.volNo, apage->bi.hdr.p0);
+        } else {
+            iEntryOffset = apage->bi.slot[-slotIdx];
+            iEntry = (btm_InternalEntry*)&apage->bi.data[iEntryOffset];
+            MAKE_PAGEID(child, curPid.volNo, iEntry->spid);
+        }
 
         e = BfM_FreeTrain(&curPid, PAGE_BUF);
         if (e < eNOERROR) ERR(e);
-        e = BfM_GetTrain(&child, (char**)&apage, PAGE_BUF);
+        e = edubtm_GetSnapshotTrain(&child, (char**)&apage);
+        if (e < eNOERROR) ERR(e);
+        curPid = child;
+    }
+
+    /* a leaf left empty by a merge that did not fit is passed over */
+    while (apage->bl.hdr.nSlots == 0 && apage->bl.hdr.prevPage != NIL) {
+        MAKE_PAGEID(child, curPid.volNo, apage->bl.hdr.prevPage);
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = edubtm_GetSnapshotTrain(&child, (char**)&apage);
         if (e < eNOERROR) ERR(e);
         curPid = child;
     }
     
+    /* 빈 B+ tree 색인에는 object가 없음 */
+    if (apage->bl.hdr.nSlots == 0) {
+        cursor->flag = CURSOR_EOS;
+        e = BfM_FreeTrain(&curPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
     /* B+ tree 색인의 마지막 leaf page의 마지막 index entry (slot 번호 = nSlots- 1) 를 
     가리키는 cursor를 반환함 */
     slotIdx = apage->bl.hdr.nSlots - 1;
@@ -125,11 +148,13 @@ Four edubtm_LastObject(
     memcpy(cursor->key.val, lEntry->kval, lEntry->klen);
 
     cursor->leaf = curPid;
-    cursor->oid = *(ObjectID*)&lEntry->kval[alignedKlen];
     cursor->slotNo = slotIdx;
     /* note: cursor->overflow: 
     중복key 사용시 동일key 값을갖는object들의ID (OID) 들이 
-    저장된page의 page ID로서, 유일 key만을 사용하는 EduBtM에서는 overflow 사용하지않음*/
+    저장된page의 page ID로서, ObjectID 목록이 leaf에 있으면 NIL page임.
+    마지막 object이므로 key의 마지막 object ID를 가리킴*/
+    e = edubtm_FirstObjectId(curPid.volNo, lEntry, TRUE, &cursor->overflow, &cursor->oidArrayElemNo, &cursor->oid);
+    if (e < eNOERROR) ERRB1(e, &curPid, PAGE_BUF);
     
     cmp = edubtm_KeyCompare(kdesc, stopKval, &cursor->key);
     // 검색종료key 값이마지막object의 key 값 보다 크거나, 
@@ -0,0 +1,117 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_LeafHint.c
+ *
+ * Description :
+ *  Keep the leaf pages visited by recent equality searches of an index,
+ *  each with the range of keys the internal pages direct to it. A search
+ *  for a key in one of the ranges goes directly to the leaf page, fixing
+ *  one page instead of one page per level. A hint is used only while the
+ *  structure modification count of the index is the same as when the hint
+ *  was made; otherwise the search starts from the root as usual.
+ *
+ * Exports:
+ *  btm_LeafHint *edubtm_LookUpLeafHint(btm_IndexInfo*, KeyDesc*, KeyValue*)
+ *  void edubtm_AddLeafHint(btm_IndexInfo*, btm_LeafHint*)
+ */
+
+
+#include "EduBtM_common.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * edubtm_LookUpLeafHint()
+ *================================*/
+/*
+ * Function: btm_LeafHint *edubtm_LookUpLeafHint(btm_IndexInfo*, KeyDesc*, KeyValue*)
+ *
+ * Description:
+ *  Return the hint whose key range contains the given key. The hints made
+ *  before the last structure modification of the index are dropped.
+ *
+ * Returns:
+ *  pointer to the hint; NULL if there is none
+ */
+btm_LeafHint *edubtm_LookUpLeafHint(
+    btm_IndexInfo       *info,          /* INOUT information about the index */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval)          /* IN key value to search */
+{
+    Four                i;              /* index of the hints */
+    btm_LeafHint        *hint;          /* a leaf hint */
+
+
+    for (i = 0; i < BTM_LEAFHINTS; i++) {
+        hint = &info->leafHints[i];
+
+        if (IS_NILPAGEID(hint->leaf)) continue;
+
+        if (hint->smoCount != info->smoCount) {
+            hint->leaf.pageNo = NIL;
+            continue;
+        }
+
+        if (hint->hasLow && edubtm_KeyCompare(kdesc, kval, &hint->low) == LESS) continue;
+        if (hint->hasHigh && edubtm_KeyCompare(kdesc, kval, &hint->high) != LESS) continue;
+
+        return(hint);
+    }
+
+    return(NULL);
+
+}   /* edubtm_LookUpLeafHint() */
+
+
+
+/*@================================
+ * edubtm_AddLeafHint()
+ *================================*/
+/*
+ * Function: void edubtm_AddLeafHint(btm_IndexInfo*, btm_LeafHint*)
+ *
+ * Description:
+ *  Remember the given leaf page and its key range, replacing the oldest
+ *  hint when all of them are in use.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_AddLeafHint(
+    btm_IndexInfo       *info,          /* INOUT information about the index */
+    btm_LeafHint        *newHint)       /* IN the leaf page and its key range */
+{
+    btm_LeafHint        *hint;          /* the hint to be replaced */
+
+
+    hint = &info->leafHints[info->nextLeafHint];
+    info->nextLeafHint = (info->nextLeafHint + 1) % BTM_LEAFHINTS;
+
+    *hint = *newHint;
+    hint->smoCount = info->smoCount;
+
+}   /* edubtm_AddLeafHint() */
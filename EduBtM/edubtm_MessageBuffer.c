@@ -0,0 +1,817 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_MessageBuffer.c
+ *
+ * Description :
+ *  Message buffer of a buffered B+ tree (see BTM_BUFFERED). The insertions
+ *  into the index are appended as messages to a list of message pages
+ *  kept by the root, and are flushed into the tree in key order, all at
+ *  once when the buffer is full, or those of a key range before the range
+ *  is searched or a key of it is deleted.
+ *
+ *  The message pages are allocated as the buffer grows and are kept until
+ *  the index is dropped; after a flush of the whole buffer the messages
+ *  are appended from the first page again. The pages after the one being
+ *  appended to are always empty.
+ *
+ * Exports:
+ *  Four edubtm_BufferMessage(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*)
+ *  Four edubtm_FindMessage(PageID*, KeyDesc*, KeyValue*, Boolean*)
+ *  Four edubtm_FlushMessages(PageID*, KeyValue*, Four, KeyValue*, Four)
+ *  Four edubtm_CountMessages(PageID*, Four*)
+ *  Four edubtm_ApplyMessages(PageID*, ObjectID*, KeyDesc*, btm_SortPair*, Four)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_MessageHead(PageID*, PageID*);
+Four edubtm_NewMessagePage(ObjectID*, PageID*, PageID*, BtreeMessage**);
+void edubtm_SetMessageKeyBits(BtreeMessage*, KeyValue*);
+Boolean edubtm_TestMessageKeyBits(BtreeMessage*, KeyValue*);
+Boolean edubtm_MessageInRange(KeyDesc*, btm_Message*, KeyValue*, KeyValue*, KeyValue*);
+Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, btm_LeafHint*);
+
+
+
+/*@================================
+ * edubtm_BufferMessage()
+ *================================*/
+/*
+ * Function: Four edubtm_BufferMessage(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Boolean*)
+ *
+ * Description:
+ *  Append the insertion of <kval, oid> to the message buffer of the root,
+ *  if the index is buffered and its root is an internal page. The first
+ *  message makes the buffer; when the buffer is full, it is flushed first.
+ *  If the root of a buffered index has become a leaf again, the messages
+ *  left in its buffer are flushed before the insertion is made in the tree,
+ *  so that the tree never holds a pair inserted after a buffered one.
+ *  The key of a unique index is looked for in the buffer and in the tree
+ *  before it is buffered, so that a key already in the index is rejected
+ *  at once as the tree would reject it.
+ *
+ * Returns:
+ *  Error code
+ *    eDUPLICATEDKEY_BTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  done : TRUE if the insertion was buffered; FALSE if it should be made
+ *         in the tree
+ */
+Four edubtm_BufferMessage(
+    ObjectID            *catObjForFile, /* IN catalog object of B+ tree file */
+    PageID              *root,          /* IN root page of the index */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid,           /* IN ObjectID to insert */
+    Boolean             *done)          /* OUT TRUE if the insertion was buffered */
+{
+    Four                e;              /* error number */
+    Two                 len;            /* length of the message */
+    PageID              headPid;        /* first page of the buffer */
+    PageID              lastPid;        /* page the message is appended to */
+    PageID              nextPid;        /* page after the last page */
+    BtreePage           *rootPage;      /* pointer to the root page */
+    BtreeMessage        *head;          /* pointer to the first page */
+    BtreeMessage        *last;          /* pointer to the page the message is appended to */
+    BtreeMessage        *newPage;       /* pointer to a page added to the buffer */
+    btm_Message         *msg;           /* the message appended */
+    Boolean             found;          /* TRUE if the key is buffered already */
+    BtreeCursor         cursor;         /* result of the search of the key in the tree */
+
+
+    *done = FALSE;
+
+    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (!(rootPage->any.hdr.flags & BTM_BUFFERED)) {
+        e = BfM_FreeTrain(root, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+    MAKE_PAGEID(headPid, root->volNo, rootPage->any.hdr.reserved);
+
+    /* A leaf root buffers no insertion; the messages left from before it
+     * became a leaf should be in the tree before the insertion is */
+    if (!(rootPage->any.hdr.type & INTERNAL)) {
+        e = BfM_FreeTrain(root, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ a unique key in the buffer or in the tree is rejected */
+    if (kdesc->flag & KEYFLAG_UNIQUE) {
+        e = edubtm_FindMessage(root, kdesc, kval, &found);
+        if (e < eNOERROR) ERR(e);
+        if (found) ERR(eDUPLICATEDKEY_BTM);
+
+        e = edubtm_Fetch(root, kdesc, kval, SM_EQ, kval, SM_EQ, &cursor, NULL);
+        if (e < eNOERROR) ERR(e);
+        if (cursor.flag == CURSOR_ON) ERR(eDUPLICATEDKEY_BTM);
+    }
+
+    /*@ make the buffer with its first page */
+    if (headPid.pageNo == NIL) {
+        e = edubtm_NewMessagePage(catObjForFile, root, &headPid, &head);
+        if (e < eNOERROR) ERR(e);
+
+        head->hdr.lastPage = headPid.pageNo;
+        head->hdr.nPages = 1;
+        head->hdr.nTotal = 0;
+        head->hdr.catObjForFile = *catObjForFile;
+        head->hdr.kdesc = *kdesc;
+
+        e = BfM_SetDirty(&headPid, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+        e = BfM_FreeTrain(&headPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        e = edubtm_GetTrainForUpdate(root, (char**)&rootPage);
+        if (e < eNOERROR) ERR(e);
+        rootPage->any.hdr.reserved = headPid.pageNo;
+        e = BfM_SetDirty(root, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, root, PAGE_BUF);
+        e = BfM_FreeTrain(root, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    len = BTM_MESSAGE_LEN(kval->len);
+
+    e = BfM_GetTrain(&headPid, (char**)&head, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /*@ find the page with room for the message */
+    MAKE_PAGEID(lastPid, root->volNo, head->hdr.lastPage);
+    if (lastPid.pageNo == headPid.pageNo) last = head;
+    else {
+        e = BfM_GetTrain(&lastPid, (char**)&last, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+    }
+
+    if (BM_FIXED + last->hdr.free + len > PAGESIZE) {
+        /* the next page is empty, or a new page is added while the buffer may grow */
+        if (last->hdr.nextPage != NIL) {
+            MAKE_PAGEID(nextPid, root->volNo, last->hdr.nextPage);
+            if (last != head) {
+                e = BfM_FreeTrain(&lastPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+            }
+            lastPid = nextPid;
+            e = BfM_GetTrain(&lastPid, (char**)&last, PAGE_BUF);
+            if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+        }
+        else if (head->hdr.nPages < BTM_MSGBUF_PAGES) {
+            e = edubtm_NewMessagePage(catObjForFile, root, &nextPid, &newPage);
+            if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+            last->hdr.nextPage = nextPid.pageNo;
+            head->hdr.nPages++;
+
+            e = BfM_SetDirty(&lastPid, PAGE_BUF);
+            if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+            if (last != head) {
+                e = BfM_FreeTrain(&lastPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+            }
+            lastPid = nextPid;
+            last = newPage;
+        }
+        else {
+            /* the buffer is full; flush all the messages and start from the first page */
+            if (last != head) {
+                e = BfM_FreeTrain(&lastPid, PAGE_BUF);
+                if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+            }
+            e = BfM_FreeTrain(&headPid, PAGE_BUF);
+            if (e < eNOERROR) ERR(e);
+
+            e = edubtm_FlushMessages(root, NULL, SM_BOF, NULL, SM_EOF);
+            if (e < eNOERROR) ERR(e);
+
+            e = BfM_GetTrain(&headPid, (char**)&head, PAGE_BUF);
+            if (e < eNOERROR) ERR(e);
+            lastPid = headPid;
+            last = head;
+        }
+        head->hdr.lastPage = lastPid.pageNo;
+    }
+
+    /*@ append the message */
+    msg = (btm_Message*)&last->data[last->hdr.free];
+    msg->oid = *oid;
+    msg->klen = kval->len;
+    memcpy(msg->kval, kval->val, kval->len);
+    last->hdr.free += len;
+    last->hdr.nMessages++;
+    edubtm_SetMessageKeyBits(last, kval);
+    head->hdr.nTotal++;
+
+    if (last != head) {
+        e = BfM_SetDirty(&lastPid, PAGE_BUF);
+        if (e < eNOERROR) ERRB2(e, &lastPid, PAGE_BUF, &headPid, PAGE_BUF);
+        e = BfM_FreeTrain(&lastPid, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+    }
+    e = BfM_SetDirty(&headPid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &headPid, PAGE_BUF);
+    e = BfM_FreeTrain(&headPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    *done = TRUE;
+
+    return(eNOERROR);
+
+} /* edubtm_BufferMessage() */
+
+
+
+/*@================================
+ * edubtm_FlushMessages()
+ *================================*/
+/*
+ * Function: Four edubtm_FlushMessages(PageID*, KeyValue*, Four, KeyValue*, Four)
+ *
+ * Description:
+ *  Apply the buffered insertions of the keys in the range given as in
+ *  EduBtM_Fetch() to the tree, in the order of <key, ObjectID>. If either
+ *  end of the range is SM_BOF or SM_EOF, the range is open on that side;
+ *  flushing the range (SM_BOF, SM_EOF) empties the buffer. The pages of
+ *  the buffer whose key filter excludes the key of an equality range are
+ *  not searched. A buffered insertion of a pair already in the tree is
+ *  dropped.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_FlushMessages(
+    PageID              *root,          /* IN root page of the index */
+    KeyValue            *startKval,     /* IN key value of start condition */
+    Four                startCompOp,    /* IN comparison operator of start condition */
+    KeyValue            *stopKval,      /* IN key value of stop condition */
+    Four                stopCompOp)     /* IN comparison operator of stop condition */
+{
+    Four                e;              /* error number */
+    Four                n;              /* # of messages flushed */
+    Two                 len;            /* length of a message */
+    Two                 from;           /* offset of the message read */
+    Two                 to;             /* offset the message kept is moved to */
+    Two                 nKept;          /* # of messages kept in a page */
+    PageID              headPid;        /* first page of the buffer */
+    PageID              pid;            /* page of the buffer read */
+    ShortPageID         nextPage;       /* page after the page read */
+    KeyValue            *lo;            /* lower end of the range; NULL if none */
+    KeyValue            *hi;            /* upper end of the range; NULL if none */
+    KeyValue            key;            /* key of a message */
+    Boolean             point;          /* TRUE if the range is a single key */
+    Boolean             dirty;          /* TRUE if the page read is changed */
+    ObjectID            catObjForFile;  /* catalog object of B+ tree file */
+    KeyDesc             kdesc;          /* key descriptor of the index */
+    BtreePage           *rootPage;      /* pointer to the root page */
+    BtreeMessage        *head;          /* pointer to the first page */
+    BtreeMessage        *apage;         /* pointer to the page read */
+    btm_Message         *msg;           /* a message */
+    btm_SortPair        *pairs;         /* insertions flushed */
+    btm_SortPair        *tmp;           /* work area of the sort */
+
+
+    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(headPid, root->volNo, rootPage->any.hdr.reserved);
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (headPid.pageNo == NIL) return(eNOERROR);
+
+    e = BfM_GetTrain(&headPid, (char**)&head, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (head->hdr.nTotal == 0) {
+        e = BfM_FreeTrain(&headPid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    catObjForFile = head->hdr.catObjForFile;
+    kdesc = head->hdr.kdesc;
+
+    /*@ the ends of the range */
+    lo = hi = NULL;
+    if (startCompOp != SM_BOF && stopCompOp != SM_BOF) {
+        if (startCompOp == SM_EOF) lo = stopKval;
+        else if (stopCompOp == SM_EOF) lo = startKval;
+        else lo = (edubtm_KeyCompare(&kdesc, startKval, stopKval) == GREATER) ? stopKval : startKval;
+    }
+    if (startCompOp != SM_EOF && stopCompOp != SM_EOF) {
+        if (startCompOp == SM_BOF) hi = stopKval;
+        else if (stopCompOp == SM_BOF) hi = startKval;
+        else hi = (edubtm_KeyCompare(&kdesc, startKval, stopKval) == GREATER) ? startKval : stopKval;
+    }
+    point = (lo != NULL && hi != NULL && edubtm_KeyCompare(&kdesc, lo, hi) == EQUAL);
+
+    /*@ take the messages in the range out of the pages */
+    pairs = tmp = NULL;
+    n = 0;
+    pid = headPid;
+    apage = head;
+    for (;;) {
+        dirty = FALSE;
+
+        if (apage->hdr.nMessages > 0 && (!point || edubtm_TestMessageKeyBits(apage, lo))) {
+            /* the page is changed only if it has a message in the range */
+            for (from = 0; from < apage->hdr.free; from += len) {
+                msg = (btm_Message*)&apage->data[from];
+                len = BTM_MESSAGE_LEN(msg->klen);
+                if (edubtm_MessageInRange(&kdesc, msg, lo, hi, &key)) break;
+            }
+            dirty = (from < apage->hdr.free);
+        }
+
+        if (dirty && pairs == NULL) {
+            pairs = (btm_SortPair*)malloc(sizeof(btm_SortPair) * head->hdr.nTotal * 2);
+            if (pairs == NULL) {
+                if (apage != head) BfM_FreeTrain(&pid, PAGE_BUF);
+                ERRB1(eMEMORYALLOCERR_EDUBTM, &headPid, PAGE_BUF);
+            }
+            tmp = &pairs[head->hdr.nTotal];
+        }
+
+        if (dirty) {
+            memset(apage->hdr.keyBits, 0, sizeof(apage->hdr.keyBits));
+            nKept = 0;
+            for (from = to = 0; from < apage->hdr.free; from += len) {
+                msg = (btm_Message*)&apage->data[from];
+                len = BTM_MESSAGE_LEN(msg->klen);
+
+                if (edubtm_MessageInRange(&kdesc, msg, lo, hi, &key)) {
+                    pairs[n].oid = msg->oid;
+                    pairs[n].kval = key;
+                    n++;
+                }
+                else {
+                    if (to != from) memmove(&apage->data[to], msg, len);
+                    to += len;
+                    nKept++;
+                    edubtm_SetMessageKeyBits(apage, &key);
+                }
+            }
+            apage->hdr.free = to;
+            apage->hdr.nMessages = nKept;
+        }
+
+        nextPage = apage->hdr.nextPage;
+
+        if (apage != head) {
+            if (dirty) {
+                e = BfM_SetDirty(&pid, PAGE_BUF);
+                if (e < eNOERROR) {
+                    free(pairs);
+                    ERRB2(e, &pid, PAGE_BUF, &headPid, PAGE_BUF);
+                }
+            }
+            e = BfM_FreeTrain(&pid, PAGE_BUF);
+            if (e < eNOERROR) {
+                free(pairs);
+                ERRB1(e, &headPid, PAGE_BUF);
+            }
+        }
+
+        if (nextPage == NIL || n == head->hdr.nTotal) break;
+
+        MAKE_PAGEID(pid, root->volNo, nextPage);
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) {
+            free(pairs);
+            ERRB1(e, &headPid, PAGE_BUF);
+        }
+    }
+
+    if (n > 0) {
+        head->hdr.nTotal -= n;
+        if (head->hdr.nTotal == 0) head->hdr.lastPage = headPid.pageNo;
+
+        e = BfM_SetDirty(&headPid, PAGE_BUF);
+        if (e < eNOERROR) {
+            free(pairs);
+            ERRB1(e, &headPid, PAGE_BUF);
+        }
+    }
+    e = BfM_FreeTrain(&headPid, PAGE_BUF);
+    if (e < eNOERROR) {
+        free(pairs);
+        ERR(e);
+    }
+
+    /*@ apply the insertions in the order of the keys */
+    if (n > 0) {
+        edubtm_SortPairs(&kdesc, pairs, tmp, n);
+
+        e = edubtm_ApplyMessages(root, &catObjForFile, &kdesc, pairs, n);
+        if (e < eNOERROR) {
+            free(pairs);
+            ERR(e);
+        }
+    }
+
+    free(pairs);
+
+    return(eNOERROR);
+
+} /* edubtm_FlushMessages() */
+
+
+
+/*@================================
+ * edubtm_FindMessage()
+ *================================*/
+/*
+ * Function: Four edubtm_FindMessage(PageID*, KeyDesc*, KeyValue*, Boolean*)
+ *
+ * Description:
+ *  Look for a buffered insertion of the key in the message buffer of the
+ *  index. The pages whose key filter excludes the key are not searched.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  found : TRUE if an insertion of the key is buffered
+ */
+Four edubtm_FindMessage(
+    PageID              *root,          /* IN root page of the index */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key to look for */
+    Boolean             *found)         /* OUT TRUE if an insertion of the key is buffered */
+{
+    Four                e;              /* error number */
+    Two                 from;           /* offset of the message read */
+    PageID              pid;            /* page of the buffer read */
+    ShortPageID         nextPage;       /* page after the page read */
+    ShortPageID         lastPage;       /* page being appended to */
+    KeyValue            key;            /* key of a message */
+    BtreePage           *rootPage;      /* pointer to the root page */
+    BtreeMessage        *apage;         /* pointer to the page read */
+    btm_Message         *msg;           /* a message */
+
+
+    *found = FALSE;
+    lastPage = NIL;
+
+    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(pid, root->volNo, rootPage->any.hdr.reserved);
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /* the pages after the one being appended to are empty */
+    while (pid.pageNo != NIL && !*found) {
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (lastPage == NIL) lastPage = apage->hdr.lastPage;
+
+        if (apage->hdr.nMessages > 0 && edubtm_TestMessageKeyBits(apage, kval)) {
+            for (from = 0; from < apage->hdr.free; from += BTM_MESSAGE_LEN(msg->klen)) {
+                msg = (btm_Message*)&apage->data[from];
+                if (edubtm_MessageInRange(kdesc, msg, kval, kval, &key)) {
+                    *found = TRUE;
+                    break;
+                }
+            }
+        }
+
+        nextPage = (pid.pageNo == lastPage) ? NIL : apage->hdr.nextPage;
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        MAKE_PAGEID(pid, root->volNo, nextPage);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_FindMessage() */
+
+
+
+/*@================================
+ * edubtm_CountMessages()
+ *================================*/
+/*
+ * Function: Four edubtm_CountMessages(PageID*, Four*)
+ *
+ * Description:
+ *  Give the number of the insertions in the message buffer of the index.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_CountMessages(
+    PageID              *root,          /* IN root page of the index */
+    Four                *nMessages)     /* OUT # of buffered insertions */
+{
+    Four                e;              /* error number */
+    PageID              headPid;        /* first page of the buffer */
+    BtreePage           *rootPage;      /* pointer to the root page */
+    BtreeMessage        *head;          /* pointer to the first page */
+
+
+    *nMessages = 0;
+
+    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(headPid, root->volNo, rootPage->any.hdr.reserved);
+
+    e = BfM_FreeTrain(root, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (headPid.pageNo == NIL) return(eNOERROR);
+
+    e = BfM_GetTrain(&headPid, (char**)&head, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    *nMessages = head->hdr.nTotal;
+
+    e = BfM_FreeTrain(&headPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_CountMessages() */
+
+
+
+/*@================================
+ * edubtm_NewMessagePage()
+ *================================*/
+/*
+ * Function: Four edubtm_NewMessagePage(ObjectID*, PageID*, PageID*, BtreeMessage**)
+ *
+ * Description:
+ *  Allocate an empty page of the message buffer, which is left fixed.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ */
+Four edubtm_NewMessagePage(
+    ObjectID            *catObjForFile, /* IN catalog object of B+ tree file */
+    PageID              *root,          /* IN root page of the index */
+    PageID              *pid,           /* OUT the page allocated */
+    BtreeMessage        **apage)        /* OUT pointer to the page allocated */
+{
+    Four                e;              /* error number */
+
+
+    e = btm_AllocPage(catObjForFile, root, pid);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_GetNewTrain(pid, (char**)apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    (*apage)->hdr.pid = *pid;
+    (*apage)->hdr.flags = BTREE_PAGE_TYPE;
+    (*apage)->hdr.reserved = NIL;
+    (*apage)->hdr.type = MESSAGE;
+    (*apage)->hdr.nextPage = NIL;
+    (*apage)->hdr.nMessages = 0;
+    (*apage)->hdr.free = 0;
+    (*apage)->hdr.lastPage = NIL;
+    (*apage)->hdr.nPages = 0;
+    (*apage)->hdr.nTotal = 0;
+    memset((*apage)->hdr.keyBits, 0, sizeof((*apage)->hdr.keyBits));
+
+    return(eNOERROR);
+
+} /* edubtm_NewMessagePage() */
+
+
+
+/*@================================
+ * edubtm_SetMessageKeyBits()
+ *================================*/
+/*
+ * Function: void edubtm_SetMessageKeyBits(BtreeMessage*, KeyValue*)
+ *
+ * Description:
+ *  Set the bits of the key filter of a message page for the given key.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_SetMessageKeyBits(
+    BtreeMessage        *apage,         /* INOUT page of the message buffer */
+    KeyValue            *kval)          /* IN key of a message */
+{
+    UFour               h;              /* hash value of the key */
+    UFour               bit;            /* a bit of the filter */
+
+
+    h = edubtm_BloomHash(kval->val, kval->len);
+
+    bit = h % BM_KEYBITS;
+    apage->hdr.keyBits[bit / 32] |= (UFour)1 << (bit % 32);
+    bit = (h >> 16) % BM_KEYBITS;
+    apage->hdr.keyBits[bit / 32] |= (UFour)1 << (bit % 32);
+
+} /* edubtm_SetMessageKeyBits() */
+
+
+
+/*@================================
+ * edubtm_TestMessageKeyBits()
+ *================================*/
+/*
+ * Function: Boolean edubtm_TestMessageKeyBits(BtreeMessage*, KeyValue*)
+ *
+ * Description:
+ *  Test whether the key filter of a message page may contain the given key.
+ *
+ * Returns:
+ *  FALSE if no message of the page has the key
+ */
+Boolean edubtm_TestMessageKeyBits(
+    BtreeMessage        *apage,         /* IN page of the message buffer */
+    KeyValue            *kval)          /* IN key to test */
+{
+    UFour               h;              /* hash value of the key */
+    UFour               bit;            /* a bit of the filter */
+
+
+    h = edubtm_BloomHash(kval->val, kval->len);
+
+    bit = h % BM_KEYBITS;
+    if (!(apage->hdr.keyBits[bit / 32] & ((UFour)1 << (bit % 32)))) return(FALSE);
+    bit = (h >> 16) % BM_KEYBITS;
+    if (!(apage->hdr.keyBits[bit / 32] & ((UFour)1 << (bit % 32)))) return(FALSE);
+
+    return(TRUE);
+
+} /* edubtm_TestMessageKeyBits() */
+
+
+
+/*@================================
+ * edubtm_MessageInRange()
+ *================================*/
+/*
+ * Function: Boolean edubtm_MessageInRange(KeyDesc*, btm_Message*, KeyValue*, KeyValue*, KeyValue*)
+ *
+ * Description:
+ *  Test whether the key of a message is between 'lo' and 'hi', both
+ *  inclusive; a NULL end is unbounded. The key is copied into 'key'.
+ *
+ * Returns:
+ *  TRUE if the key is in the range
+ */
+Boolean edubtm_MessageInRange(
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    btm_Message         *msg,           /* IN a message */
+    KeyValue            *lo,            /* IN lower end of the range; NULL if none */
+    KeyValue            *hi,            /* IN upper end of the range; NULL if none */
+    KeyValue            *key)           /* OUT key of the message */
+{
+    key->len = msg->klen;
+    memcpy(key->val, msg->kval, msg->klen);
+
+    if (lo != NULL && edubtm_KeyCompare(kdesc, key, lo) == LESS) return(FALSE);
+    if (hi != NULL && edubtm_KeyCompare(kdesc, key, hi) == GREATER) return(FALSE);
+
+    return(TRUE);
+
+} /* edubtm_MessageInRange() */
+
+
+
+/*@================================
+ * edubtm_ApplyMessages()
+ *================================*/
+/*
+ * Function: Four edubtm_ApplyMessages(PageID*, ObjectID*, KeyDesc*, btm_SortPair*, Four)
+ *
+ * Description:
+ *  Insert the sorted <key, ObjectID> pairs flushed from the message buffer
+ *  or the write buffer into the tree. The pairs already in the tree are not
+ *  counted as insertions of the index any more. The pairs of a unique index
+ *  are inserted with one descent of the tree by edubtm_InsertSortedBatch().
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_ApplyMessages(
+    PageID              *root,          /* IN root page of the index */
+    ObjectID            *catObjForFile, /* IN catalog object of B+ tree file */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    btm_SortPair        *pairs,         /* IN pairs to insert */
+    Four                nPairs)         /* IN # of pairs */
+{
+    Four                e;              /* error number */
+    Four                i;              /* index */
+    Boolean             lf;             /* for merging */
+    Boolean             lh;             /* for splitting */
+    InternalItem        item;           /* internal item made by a root split */
+    btm_IndexInfo       *info;          /* information about the index */
+    btm_InsertBatch     batch;          /* the pairs of a unique index */
+
+
+    info = edubtm_GetIndexInfo(root, TRUE);
+
+    /*@ insert the pairs of a unique index as a batch */
+    if (kdesc->flag & KEYFLAG_UNIQUE) {
+        batch.kdesc = kdesc;
+        batch.nInserted = 0;
+        batch.kvals = (KeyValue*)malloc(nPairs * sizeof(KeyValue));
+        batch.oids = (ObjectID*)malloc(nPairs * sizeof(ObjectID));
+        batch.order = (Four*)malloc(nPairs * sizeof(Four));
+        if (batch.kvals == NULL || batch.oids == NULL || batch.order == NULL) {
+            free(batch.kvals);
+            free(batch.oids);
+            free(batch.order);
+            ERR(eMEMORYALLOCERR_EDUBTM);
+        }
+
+        for (i = 0; i < nPairs; i++) {
+            batch.kvals[i] = pairs[i].kval;
+            batch.oids[i] = pairs[i].oid;
+            batch.order[i] = i;
+        }
+
+        e = edubtm_InsertSortedBatch(catObjForFile, root, &batch, nPairs);
+
+        free(batch.kvals);
+        free(batch.oids);
+        free(batch.order);
+        if (e < eNOERROR) ERR(e);
+
+        if (info != NULL) info->nInserts -= nPairs - batch.nInserted;
+
+        return(eNOERROR);
+    }
+
+    for (i = 0; i < nPairs; i++) {
+        lf = lh = FALSE;
+        e = edubtm_Insert(catObjForFile, root, kdesc, &pairs[i].kval, &pairs[i].oid, NULL,
+                          &lf, &lh, &item, NULL, NULL, info);
+        if (e == eDUPLICATEDOBJECTID_BTM || e == eDUPLICATEDKEY_BTM) {
+            if (info != NULL) info->nInserts--;
+            continue;
+        }
+        if (e < eNOERROR) ERR(e);
+
+        if (lh == TRUE) {
+            e = edubtm_root_insert(catObjForFile, root, &item);
+            if (e < eNOERROR) ERR(e);
+            if (info != NULL) info->nRootSplits++;
+        }
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_ApplyMessages() */
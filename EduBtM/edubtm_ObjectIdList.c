@@ -0,0 +1,497 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_ObjectIdList.c
+ *
+ * Description :
+ *  Lists of the ObjectIDs of a non-unique key. All the ObjectIDs with the
+ *  same key are kept in one leaf entry, sorted in ObjectID order, so that a
+ *  key is stored only once however many objects have it. When the entry
+ *  grows beyond a third of a page, its ObjectIDs are moved to a chain of
+ *  overflow pages and the entry keeps only the first overflow page, with
+ *  'nObjects' set to NIL. When the chain shrinks to less than a fourth of a
+ *  page, its ObjectIDs are moved back into the leaf.
+ *
+ *  The ObjectIDs are kept at their full width, not delta/varint encoded.
+ *  The overflow pages are changed by btm_InsertOverflow() and
+ *  btm_DeleteOverflow() of cosmos.o, and btm_Underflow() there moves the
+ *  leaf entries with lengths computed from 'nObjects', so neither kind of
+ *  list can take another format. A list of a low-cardinality key, which
+ *  the encoding was meant for, is in overflow pages anyway.
+ *
+ *  A cursor on a non-unique key points to one ObjectID of the list: the
+ *  'overflow' field of the cursor is the overflow page holding it, or a NIL
+ *  page if the list is in the leaf, and 'oidArrayElemNo' is its position
+ *  in that array.
+ *
+ * Exports:
+ *  Four edubtm_InsertObjectId(ObjectID*, PageID*, BtreeLeaf*, Two, ObjectID*,
+ *                             Boolean*, Boolean*, InternalItem*, btm_IndexInfo*)
+ *  Four edubtm_DeleteObjectId(PhysicalFileID*, BtreeLeaf*, Two, ObjectID*, Boolean*,
+ *                             Pool*, DeallocListElem*)
+ *  Four edubtm_FirstObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*)
+ *  Four edubtm_NextObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*, Boolean*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@================================
+ * edubtm_InsertObjectId()
+ *================================*/
+/*
+ * Function: Four edubtm_InsertObjectId(ObjectID*, PageID*, BtreeLeaf*, Two, ObjectID*,
+ *                                      Boolean*, Boolean*, InternalItem*, btm_IndexInfo*)
+ *
+ * Description:
+ *  Insert an ObjectID into the list of the entry in the slot 'slotNo',
+ *  whose key is the key of the ObjectID. If the list is in overflow pages,
+ *  the ObjectID is inserted there. If the entry would become longer than
+ *  a third of a page, its list is moved to a new overflow page. Otherwise
+ *  the entry grows in the leaf; if the leaf is full, the entry is taken out
+ *  of it and the leaf is split with the enlarged entry.
+ *
+ * Returns:
+ *  Error code
+ *    eDUPLICATEDOBJECTID_BTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) f : TRUE if the leaf page is underflowed by creating an overflow page
+ *  2) h : TRUE if the leaf page is splitted
+ *  3) item : item to be inserted into the parent
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for 'page'.
+ */
+Four edubtm_InsertObjectId(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+-tree file */
+    PageID                      *pid,           /* IN PageID of the leaf page */
+    BtreeLeaf                   *page,          /* INOUT pointer to buffer page of the leaf page */
+    Two                         slotNo,         /* IN slot No. of the entry */
+    ObjectID                    *oid,           /* IN ObjectID which will be inserted */
+    Boolean                     *f,             /* OUT whether the page is underflowed */
+    Boolean                     *h,             /* OUT whether the page is splitted */
+    InternalItem                *item,          /* OUT Internal Item which will be inserted */
+                                                /*     into its parent when 'h' is TRUE */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* slot No. */
+    btm_LeafEntry               *entry;         /* the entry of the key */
+    btm_LeafEntry               *newEntry;      /* the enlarged entry when the page is split */
+    Two                         entryOffset;    /* starting offset of the entry */
+    Two                         entryLen;       /* length of the entry */
+    ObjectID                    *oidArray;      /* ObjectID array of the entry */
+    ObjectID                    *newOidArray;   /* ObjectID array of 'newEntry' */
+    Two                         oidArrayElemNo; /* the ObjectID is inserted after this element */
+    Two                         nObjects;       /* # of ObjectIDs of the entry */
+    PageID                      ovPid;          /* the first overflow page */
+    ObjectID                    entryBuf[MAX_OVERFLOW_SPLIT/sizeof(ObjectID) + 1]; /* space for 'newEntry' */
+
+
+    *f = *h = FALSE;
+
+    entryOffset = page->slot[-slotNo];
+    entry = (btm_LeafEntry*)&page->data[entryOffset];
+
+    /*@ the ObjectIDs are in overflow pages */
+    if (entry->nObjects < 0) {
+        MAKE_PAGEID(ovPid, pid->volNo, BTM_LEAFENTRY_OVPAGE(entry));
+
+        /* btm_InsertOverflow() changes the overflow pages on its own */
+        e = edubtm_SaveOverflowVersions(&ovPid);
+        if (e < eNOERROR) ERR(e);
+
+        e = btm_InsertOverflow(catObjForFile, &ovPid, oid);
+        if (e < eNOERROR) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    nObjects = entry->nObjects;
+    oidArray = BTM_LEAFENTRY_OIDS(entry);
+    if (btm_BinarySearchOidArray(oidArray, oid, nObjects, &oidArrayElemNo))
+        ERR(eDUPLICATEDOBJECTID_BTM);
+
+    entryLen = BTM_LEAFENTRY_LEN(page, entry);
+
+    /*@ the entry becomes too long: move its ObjectIDs to an overflow page */
+    if (entryLen + OBJECTID_SIZE > OVERFLOW_SPLIT(page)) {
+        e = btm_CreateOverflow(catObjForFile, page, slotNo, oid);
+        if (e < eNOERROR) ERR(e);
+        if (info != NULL) info->nOverflowLists++;
+
+        if (edubtm_IsUnderflow(info, (BtreePage*)page)) *f = TRUE;
+
+        return(eNOERROR);
+    }
+
+    /*@ the entry grows in the page */
+    if (BL_FREE(page) >= OBJECTID_SIZE) {
+
+        /* The entry should be followed by the contiguous free area */
+        if (entryOffset + entryLen != page->hdr.free || BL_CFREE(page) < OBJECTID_SIZE) {
+            if (BL_CFREE(page) >= entryLen + OBJECTID_SIZE) {
+                memcpy(&page->data[page->hdr.free], entry, entryLen);
+                page->slot[-slotNo] = page->hdr.free;
+                page->hdr.free += entryLen;
+                page->hdr.unused += entryLen;
+            }
+            else
+                edubtm_CompactLeafPage(page, slotNo);
+
+            entry = (btm_LeafEntry*)&page->data[page->slot[-slotNo]];
+            oidArray = BTM_LEAFENTRY_OIDS(entry);
+        }
+
+        memmove(&oidArray[oidArrayElemNo+2], &oidArray[oidArrayElemNo+1],
+                (nObjects - oidArrayElemNo - 1) * OBJECTID_SIZE);
+        oidArray[oidArrayElemNo+1] = *oid;
+        entry->nObjects++;
+        page->hdr.free += OBJECTID_SIZE;
+
+        return(eNOERROR);
+    }
+
+    /*@ no space in the page: split it with the enlarged entry */
+    newEntry = (btm_LeafEntry*)entryBuf;
+    memcpy(newEntry, entry, entryLen - (nObjects - oidArrayElemNo - 1) * OBJECTID_SIZE);
+    newOidArray = BTM_LEAFENTRY_OIDS(newEntry);
+    newOidArray[oidArrayElemNo+1] = *oid;
+    memcpy(&newOidArray[oidArrayElemNo+2], &oidArray[oidArrayElemNo+1],
+           (nObjects - oidArrayElemNo - 1) * OBJECTID_SIZE);
+    newEntry->nObjects++;
+
+    /* Take the entry out of the page; the split rebuilds the key heads */
+    edubtm_DropKeyHeads((BtreePage*)page);
+    for (i = slotNo; i < page->hdr.nSlots - 1; i++)
+        page->slot[-i] = page->slot[-(i+1)];
+    page->hdr.nSlots--;
+    if (entryOffset + entryLen == page->hdr.free)
+        page->hdr.free -= entryLen;
+    else
+        page->hdr.unused += entryLen;
+
+    e = edubtm_SplitLeafEntry(catObjForFile, pid, page, slotNo - 1, newEntry, item, info);
+    if (e < eNOERROR) ERR(e);
+    *h = TRUE;
+
+    return(eNOERROR);
+
+}   /* edubtm_InsertObjectId() */
+
+
+
+/*@================================
+ * edubtm_DeleteObjectId()
+ *================================*/
+/*
+ * Function: Four edubtm_DeleteObjectId(PhysicalFileID*, BtreeLeaf*, Two, ObjectID*, Boolean*,
+ *                                      Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Delete an ObjectID from the list of the entry in the slot 'slotNo'. If
+ *  it is the last ObjectID of the entry, the entry is left as it is and
+ *  'empty' is set; the caller should remove the entry. If the list is in
+ *  overflow pages and becomes shorter than a fourth of a page, it is moved
+ *  back into the leaf when the leaf has room for it.
+ *
+ * Returns:
+ *  Error code
+ *    eNOTFOUND_BTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  empty : TRUE if the entry has no more ObjectIDs
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for 'page'.
+ */
+Four edubtm_DeleteObjectId(
+    PhysicalFileID              *pFid,          /* IN FileID of the Btree file */
+    BtreeLeaf                   *page,          /* INOUT pointer to buffer page of the leaf page */
+    Two                         slotNo,         /* IN slot No. of the entry */
+    ObjectID                    *oid,           /* IN ObjectID which will be deleted */
+    Boolean                     *empty,         /* OUT TRUE if the entry has no more ObjectIDs */
+    Pool                        *dlPool,        /* INOUT pool of dealloc list elements */
+    DeallocListElem             *dlHead)        /* INOUT head of the dealloc list */
+{
+    Four                        e;              /* error number */
+    btm_LeafEntry               *entry;         /* the entry of the key */
+    btm_LeafEntry               *newEntry;      /* the entry holding the ObjectIDs moved back */
+    Two                         entryOffset;    /* starting offset of the entry */
+    Two                         entryLen;       /* length of the entry */
+    Two                         newLen;         /* length of 'newEntry' */
+    ObjectID                    *oidArray;      /* ObjectID array of the entry */
+    Two                         oidArrayElemNo; /* element No. of the ObjectID */
+    Two                         of;             /* # of ObjectIDs of an overflow page when less than 1/4 */
+    Boolean                     last;           /* TRUE if the ObjectID is the only one in overflow pages */
+    PageID                      ovPid;          /* the first overflow page */
+    BtreeOverflow               *opage;         /* buffer of 'ovPid' */
+
+
+    *empty = FALSE;
+
+    entryOffset = page->slot[-slotNo];
+    entry = (btm_LeafEntry*)&page->data[entryOffset];
+    entryLen = BTM_LEAFENTRY_LEN(page, entry);
+
+    /*@ the ObjectIDs are in the leaf */
+    if (entry->nObjects > 0) {
+        oidArray = BTM_LEAFENTRY_OIDS(entry);
+        if (!btm_BinarySearchOidArray(oidArray, oid, entry->nObjects, &oidArrayElemNo))
+            ERR(eNOTFOUND_BTM);
+
+        if (entry->nObjects == 1) {
+            *empty = TRUE;
+            return(eNOERROR);
+        }
+
+        memmove(&oidArray[oidArrayElemNo], &oidArray[oidArrayElemNo+1],
+                (entry->nObjects - oidArrayElemNo - 1) * OBJECTID_SIZE);
+        entry->nObjects--;
+
+        if (entryOffset + entryLen == page->hdr.free)
+            page->hdr.free -= OBJECTID_SIZE;
+        else
+            page->hdr.unused += OBJECTID_SIZE;
+
+        return(eNOERROR);
+    }
+
+    /*@ the ObjectIDs are in overflow pages */
+    MAKE_PAGEID(ovPid, page->hdr.pid.volNo, BTM_LEAFENTRY_OVPAGE(entry));
+
+    /* The last ObjectID goes with its overflow page */
+    e = BfM_GetTrain(&ovPid, (char**)&opage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    last = (opage->hdr.nextPage == NIL && opage->hdr.nObjects == 1 &&
+            btm_ObjectIdComp(oid, &opage->oid[0]) == EQUAL) ? TRUE : FALSE;
+
+    e = BfM_FreeTrain(&ovPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (last) {
+        e = edubtm_FreePages(pFid, &ovPid, dlPool, dlHead);
+        if (e < eNOERROR) ERR(e);
+
+        *empty = TRUE;
+        return(eNOERROR);
+    }
+
+    /* btm_DeleteOverflow() changes and frees the overflow pages on its own */
+    e = edubtm_SaveOverflowVersions(&ovPid);
+    if (e < eNOERROR) ERR(e);
+
+    e = btm_DeleteOverflow(pFid, &ovPid, oid, &of, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    /* Move the remaining ObjectIDs back into the leaf if it has room for them */
+    newLen = BTM_LEAFENTRY_FIXED + ALIGNED_LENGTH(entry->klen) + of * OBJECTID_SIZE;
+    if (of == 0 || BL_FREE(page) < newLen) return(eNOERROR);
+
+    if (BL_CFREE(page) < newLen) {
+        edubtm_CompactLeafPage(page, NIL);
+        entry = (btm_LeafEntry*)&page->data[page->slot[-slotNo]];
+    }
+
+    e = BfM_GetTrain(&ovPid, (char**)&opage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    newEntry = (btm_LeafEntry*)&page->data[page->hdr.free];
+    memcpy(newEntry, entry, BTM_LEAFENTRY_FIXED + ALIGNED_LENGTH(entry->klen));
+    newEntry->nObjects = opage->hdr.nObjects;
+    memcpy(BTM_LEAFENTRY_OIDS(newEntry), opage->oid, opage->hdr.nObjects * OBJECTID_SIZE);
+
+    e = BfM_FreeTrain(&ovPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    page->slot[-slotNo] = page->hdr.free;
+    page->hdr.free += BTM_LEAFENTRY_LEN(page, newEntry);
+    page->hdr.unused += entryLen;
+
+    e = edubtm_FreePages(pFid, &ovPid, dlPool, dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_DeleteObjectId() */
+
+
+
+/*@================================
+ * edubtm_FirstObjectId()
+ *================================*/
+/*
+ * Function: Four edubtm_FirstObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*)
+ *
+ * Description:
+ *  Return the first ObjectID of the list of the given entry, or the last
+ *  one if 'backward' is TRUE, with its position in the list.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) overflow : overflow page holding the ObjectID; its pageNo is NIL if it is in the leaf
+ *  2) oidNo : element No. of the ObjectID in its array
+ *  3) oid : the ObjectID
+ */
+Four edubtm_FirstObjectId(
+    VolNo                       volNo,          /* IN volume of the index */
+    btm_LeafEntry               *entry,         /* IN the leaf entry */
+    Boolean                     backward,       /* IN TRUE to return the last ObjectID */
+    PageID                      *overflow,      /* OUT overflow page holding the ObjectID */
+    Two                         *oidNo,         /* OUT element No. of the ObjectID */
+    ObjectID                    *oid)           /* OUT the ObjectID */
+{
+    Four                        e;              /* error number */
+    PageID                      nextPid;        /* the next overflow page */
+    BtreeOverflow               *opage;         /* buffer of an overflow page */
+
+
+    /*@ the ObjectIDs are in the leaf */
+    if (entry->nObjects > 0) {
+        MAKE_PAGEID(*overflow, volNo, NIL);
+        *oidNo = backward ? entry->nObjects - 1 : 0;
+        *oid = BTM_LEAFENTRY_OIDS(entry)[*oidNo];
+
+        return(eNOERROR);
+    }
+
+    /*@ the ObjectIDs are in overflow pages; the last one is in the last page */
+    MAKE_PAGEID(*overflow, volNo, BTM_LEAFENTRY_OVPAGE(entry));
+    e = edubtm_GetSnapshotTrain(overflow, (char**)&opage);
+    if (e < eNOERROR) ERR(e);
+
+    while (backward && opage->hdr.nextPage != NIL) {
+        MAKE_PAGEID(nextPid, volNo, opage->hdr.nextPage);
+
+        e = BfM_FreeTrain(overflow, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        *overflow = nextPid;
+        e = edubtm_GetSnapshotTrain(overflow, (char**)&opage);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    *oidNo = backward ? opage->hdr.nObjects - 1 : 0;
+    *oid = opage->oid[*oidNo];
+
+    e = BfM_FreeTrain(overflow, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_FirstObjectId() */
+
+
+
+/*@================================
+ * edubtm_NextObjectId()
+ *================================*/
+/*
+ * Function: Four edubtm_NextObjectId(VolNo, btm_LeafEntry*, Boolean, PageID*, Two*, ObjectID*, Boolean*)
+ *
+ * Description:
+ *  Move the position given by 'overflow' and 'oidNo' to the next ObjectID
+ *  of the list of the given entry, or to the previous one if 'backward' is
+ *  TRUE. The position is not changed at the end of the list.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) overflow, oidNo : position of the next ObjectID
+ *  2) oid : the next ObjectID
+ *  3) found : FALSE if there is no more ObjectID in the list
+ */
+Four edubtm_NextObjectId(
+    VolNo                       volNo,          /* IN volume of the index */
+    btm_LeafEntry               *entry,         /* IN the leaf entry */
+    Boolean                     backward,       /* IN TRUE to move to the previous ObjectID */
+    PageID                      *overflow,      /* INOUT overflow page holding the ObjectID */
+    Two                         *oidNo,         /* INOUT element No. of the ObjectID */
+    ObjectID                    *oid,           /* OUT the next ObjectID */
+    Boolean                     *found)         /* OUT FALSE at the end of the list */
+{
+    Four                        e;              /* error number */
+    Two                         i;              /* element No. of the next ObjectID */
+    ShortPageID                 nextPage;       /* the next overflow page */
+    BtreeOverflow               *opage;         /* buffer of an overflow page */
+
+
+    *found = FALSE;
+    i = *oidNo + (backward ? -1 : 1);
+
+    /*@ the ObjectIDs are in the leaf */
+    if (IS_NILPAGEID(*overflow)) {
+        if (i < 0 || i >= entry->nObjects) return(eNOERROR);
+
+        *oidNo = i;
+        *oid = BTM_LEAFENTRY_OIDS(entry)[i];
+        *found = TRUE;
+
+        return(eNOERROR);
+    }
+
+    /*@ the ObjectIDs are in overflow pages */
+    e = edubtm_GetSnapshotTrain(overflow, (char**)&opage);
+    if (e < eNOERROR) ERR(e);
+
+    if (i < 0 || i >= opage->hdr.nObjects) {
+        nextPage = backward ? opage->hdr.prevPage : opage->hdr.nextPage;
+
+        e = BfM_FreeTrain(overflow, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (nextPage == NIL) return(eNOERROR);
+
+        MAKE_PAGEID(*overflow, volNo, nextPage);
+        e = edubtm_GetSnapshotTrain(overflow, (char**)&opage);
+        if (e < eNOERROR) ERR(e);
+
+        i = backward ? opage->hdr.nObjects - 1 : 0;
+    }
+
+    *oidNo = i;
+    *oid = opage->oid[i];
+    *found = TRUE;
+
+    e = BfM_FreeTrain(overflow, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}   /* edubtm_NextObjectId() */
@@ -0,0 +1,537 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_PageVersion.c
+ *
+ * Description :
+ *  Versions of the B+ tree pages for the snapshots. A writer fixes a page
+ *  it is going to change by edubtm_GetTrainForUpdate(), which saves the
+ *  image of the page first if an open snapshot may still need it. The
+ *  routines of the storage system which change pages on their own, e.g.
+ *  btm_Underflow() and the overflow page routines, are preceded by saving
+ *  the pages they may change. A reader of a snapshot fixes the pages by
+ *  edubtm_GetSnapshotTrain(), which gives the version of the page in the
+ *  snapshot instead of the page if there is one; the page itself stays
+ *  fixed until the reader frees it, as for any other fix.
+ *
+ *  The versions are kept in a hash table on the PageID, and in a list in
+ *  the order of their epochs, from which they are freed when the oldest
+ *  open snapshot no longer needs them.
+ *
+ * Exports:
+ *  Four edubtm_GetTrainForUpdate(PageID*, char**)
+ *  Four edubtm_GetSnapshotTrain(PageID*, char**)
+ *  Four edubtm_SaveVersion(PageID*, char*)
+ *  Four edubtm_SaveVersionsAround(PageID*, BtreeInternal*, Two)
+ *  Four edubtm_SaveOverflowVersions(PageID*)
+ *  Four edubtm_OpenEpoch(BtreeSnapshot*)
+ *  void edubtm_CloseEpoch(BtreeSnapshot*)
+ *  BtreeSnapshot *edubtm_SetReadSnapshot(BtreeSnapshot*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_VersionHash(PageID*);
+btm_PageVersion *edubtm_FindVersion(PageID*, Four);
+Four edubtm_SaveVersionOf(PageID*);
+void edubtm_ReclaimVersions(void);
+
+
+/*@ Global Variables */
+static btm_PageVersion *edubtm_versions[BTM_VERSION_HASHSIZE];   /* hash table of the versions */
+static btm_PageVersion *edubtm_retireHead = NULL;                 /* oldest version */
+static btm_PageVersion *edubtm_retireTail = NULL;                 /* newest version */
+static BtreeSnapshot *edubtm_snapshotHead = NULL;                 /* oldest open snapshot */
+static BtreeSnapshot *edubtm_snapshotTail = NULL;                 /* newest open snapshot */
+static Four edubtm_epoch = 1;                                     /* the current epoch */
+static __thread BtreeSnapshot *edubtm_readSnapshot = NULL;        /* snapshot read by this thread */
+
+
+
+/*@================================
+ * edubtm_GetTrainForUpdate()
+ *================================*/
+/*
+ * Function: Four edubtm_GetTrainForUpdate(PageID*, char**)
+ *
+ * Description:
+ *  Fix a page which the caller is going to change. If a snapshot is open
+ *  and the page has not been saved in the current epoch, its image is
+ *  saved first.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_GetTrainForUpdate(
+    PageID              *pid,           /* IN the page to fix */
+    char                **page)         /* OUT buffer of the page */
+{
+    Four                e;              /* error number */
+
+
+    e = BfM_GetTrain(pid, page, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubtm_SaveVersion(pid, *page);
+    if (e < eNOERROR) ERRB1(e, pid, PAGE_BUF);
+
+    return(eNOERROR);
+
+} /* edubtm_GetTrainForUpdate() */
+
+
+
+/*@================================
+ * edubtm_GetSnapshotTrain()
+ *================================*/
+/*
+ * Function: Four edubtm_GetSnapshotTrain(PageID*, char**)
+ *
+ * Description:
+ *  Fix a page for reading. If this thread reads a snapshot and the page
+ *  has changed since the snapshot was opened, the version of the page in
+ *  the snapshot is returned instead of the buffer of the page. The page
+ *  is fixed in either case and should be freed by BfM_FreeTrain().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_GetSnapshotTrain(
+    PageID              *pid,           /* IN the page to fix */
+    char                **page)         /* OUT buffer of the page or its version */
+{
+    Four                e;              /* error number */
+    btm_PageVersion     *v;             /* version of the page in the snapshot */
+
+
+    e = BfM_GetTrain(pid, page, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    if (edubtm_readSnapshot != NULL) {
+        v = edubtm_FindVersion(pid, edubtm_readSnapshot->epoch);
+        if (v != NULL) *page = (char*)&v->image;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_GetSnapshotTrain() */
+
+
+
+/*@================================
+ * edubtm_SaveVersion()
+ *================================*/
+/*
+ * Function: Four edubtm_SaveVersion(PageID*, char*)
+ *
+ * Description:
+ *  Save the image of the given fixed page unless no snapshot is open or
+ *  the page has already been saved in the current epoch. The newest open
+ *  snapshot was opened before the current epoch, so a version saved in
+ *  the current epoch holds the page as every open snapshot which has not
+ *  got an older version sees it.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBTM
+ */
+Four edubtm_SaveVersion(
+    PageID              *pid,           /* IN the page */
+    char                *page)          /* IN buffer of the page */
+{
+    Four                h;              /* hash value of the page */
+    btm_PageVersion     *v;             /* the new version */
+
+
+    if (edubtm_snapshotHead == NULL) return(eNOERROR);
+
+    if (edubtm_FindVersion(pid, edubtm_epoch - 1) != NULL) return(eNOERROR);
+
+    v = (btm_PageVersion*)malloc(sizeof(btm_PageVersion));
+    if (v == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+    v->pid = *pid;
+    v->epoch = edubtm_epoch;
+    memcpy(&v->image, page, PAGESIZE);
+
+    h = edubtm_VersionHash(pid);
+    v->hashNext = edubtm_versions[h];
+    edubtm_versions[h] = v;
+
+    v->retireNext = NULL;
+    if (edubtm_retireTail == NULL) edubtm_retireHead = v;
+    else edubtm_retireTail->retireNext = v;
+    edubtm_retireTail = v;
+
+    return(eNOERROR);
+
+} /* edubtm_SaveVersion() */
+
+
+
+/*@================================
+ * edubtm_SaveVersionsAround()
+ *================================*/
+/*
+ * Function: Four edubtm_SaveVersionsAround(PageID*, BtreeInternal*, Two)
+ *
+ * Description:
+ *  Save the children of the given internal page at the slots idx-1, idx,
+ *  and idx+1 (-1 denotes 'p0'), and the neighbours of the children which
+ *  are leaves. It is called before btm_Underflow() or btm_root_delete(),
+ *  which merge or redistribute a child with its sibling, link the leaves
+ *  around a merged leaf, and free the merged page on their own.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_SaveVersionsAround(
+    PageID              *pid,           /* IN PageID of the internal page */
+    BtreeInternal       *ppage,         /* IN the internal page */
+    Two                 idx)            /* IN slot No. of the child in question */
+{
+    Four                e;              /* error number */
+    Two                 i;              /* slot No. */
+    PageID              child;          /* PageID of a child */
+    PageID              sibling;        /* PageID of a neighbour of a leaf */
+    BtreePage           *cpage;         /* pointer to the child page */
+    btm_InternalEntry   *iEntry;        /* an internal entry */
+    ShortPageID         prevPage;       /* previous leaf of a child leaf */
+    ShortPageID         nextPage;       /* next leaf of a child leaf */
+
+
+    if (edubtm_snapshotHead == NULL) return(eNOERROR);
+
+    for (i = idx - 1; i <= idx + 1; i++) {
+        if (i < -1 || i >= ppage->hdr.nSlots) continue;
+
+        if (i == -1) {
+            MAKE_PAGEID(child, pid->volNo, ppage->hdr.p0);
+        }
+        else {
+            iEntry = (btm_InternalEntry*)&ppage->data[ppage->slot[-i]];
+            MAKE_PAGEID(child, pid->volNo, iEntry->spid);
+        }
+
+        e = edubtm_GetTrainForUpdate(&child, (char**)&cpage);
+        if (e < eNOERROR) ERR(e);
+
+        prevPage = nextPage = NIL;
+        if (cpage->any.hdr.type & LEAF) {
+            prevPage = cpage->bl.hdr.prevPage;
+            nextPage = cpage->bl.hdr.nextPage;
+        }
+
+        e = BfM_FreeTrain(&child, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (prevPage != NIL) {
+            MAKE_PAGEID(sibling, pid->volNo, prevPage);
+            e = edubtm_SaveVersionOf(&sibling);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        if (nextPage != NIL) {
+            MAKE_PAGEID(sibling, pid->volNo, nextPage);
+            e = edubtm_SaveVersionOf(&sibling);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_SaveVersionsAround() */
+
+
+
+/*@================================
+ * edubtm_SaveOverflowVersions()
+ *================================*/
+/*
+ * Function: Four edubtm_SaveOverflowVersions(PageID*)
+ *
+ * Description:
+ *  Save the pages of the overflow page list starting at the given page. It
+ *  is called before btm_InsertOverflow() or btm_DeleteOverflow(), which
+ *  split, merge, and free the pages of the list on their own.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_SaveOverflowVersions(
+    PageID              *ovPid)         /* IN the first page of the list */
+{
+    Four                e;              /* error number */
+    PageID              pid;            /* the current overflow page */
+    BtreeOverflow       *opage;         /* buffer of the current overflow page */
+    ShortPageID         nextPage;       /* the next overflow page */
+
+
+    if (edubtm_snapshotHead == NULL) return(eNOERROR);
+
+    pid = *ovPid;
+    for (;;) {
+        e = edubtm_GetTrainForUpdate(&pid, (char**)&opage);
+        if (e < eNOERROR) ERR(e);
+
+        nextPage = opage->hdr.nextPage;
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (nextPage == NIL) break;
+        MAKE_PAGEID(pid, pid.volNo, nextPage);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_SaveOverflowVersions() */
+
+
+
+/*@================================
+ * edubtm_OpenEpoch()
+ *================================*/
+/*
+ * Function: Four edubtm_OpenEpoch(BtreeSnapshot*)
+ *
+ * Description:
+ *  Register the snapshot as the newest open one and start a new epoch; the
+ *  snapshot sees the changes made up to the end of the epoch before.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubtm_OpenEpoch(
+    BtreeSnapshot       *snapshot)      /* INOUT the snapshot */
+{
+    snapshot->epoch = edubtm_epoch++;
+
+    snapshot->next = NULL;
+    if (edubtm_snapshotTail == NULL) edubtm_snapshotHead = snapshot;
+    else edubtm_snapshotTail->next = snapshot;
+    edubtm_snapshotTail = snapshot;
+
+    return(eNOERROR);
+
+} /* edubtm_OpenEpoch() */
+
+
+
+/*@================================
+ * edubtm_CloseEpoch()
+ *================================*/
+/*
+ * Function: void edubtm_CloseEpoch(BtreeSnapshot*)
+ *
+ * Description:
+ *  Remove the snapshot from the open ones and free the versions which no
+ *  open snapshot needs any more.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_CloseEpoch(
+    BtreeSnapshot       *snapshot)      /* IN the snapshot */
+{
+    BtreeSnapshot       *prev;          /* the snapshot before the given one */
+
+
+    if (edubtm_snapshotHead == snapshot) {
+        edubtm_snapshotHead = snapshot->next;
+        prev = NULL;
+    }
+    else {
+        for (prev = edubtm_snapshotHead; prev != NULL && prev->next != snapshot; prev = prev->next);
+        if (prev == NULL) return;
+        prev->next = snapshot->next;
+    }
+    if (edubtm_snapshotTail == snapshot) edubtm_snapshotTail = prev;
+
+    edubtm_ReclaimVersions();
+
+} /* edubtm_CloseEpoch() */
+
+
+
+/*@================================
+ * edubtm_SetReadSnapshot()
+ *================================*/
+/*
+ * Function: BtreeSnapshot *edubtm_SetReadSnapshot(BtreeSnapshot*)
+ *
+ * Description:
+ *  Make this thread read the given snapshot by edubtm_GetSnapshotTrain(),
+ *  or the current pages if it is NULL.
+ *
+ * Returns:
+ *  the snapshot read before
+ */
+BtreeSnapshot *edubtm_SetReadSnapshot(
+    BtreeSnapshot       *snapshot)      /* IN the snapshot to read; NULL if none */
+{
+    BtreeSnapshot       *old;           /* the snapshot read before */
+
+
+    old = edubtm_readSnapshot;
+    edubtm_readSnapshot = snapshot;
+
+    return(old);
+
+} /* edubtm_SetReadSnapshot() */
+
+
+
+/*@================================
+ * edubtm_VersionHash()
+ *================================*/
+/*
+ * Function: Four edubtm_VersionHash(PageID*)
+ *
+ * Description:
+ *  Hash a PageID into a bucket of the versions.
+ *
+ * Returns:
+ *  bucket No.
+ */
+Four edubtm_VersionHash(
+    PageID              *pid)           /* IN the page */
+{
+    return(((UFour)pid->pageNo * 31 + (UFour)pid->volNo) % BTM_VERSION_HASHSIZE);
+
+} /* edubtm_VersionHash() */
+
+
+
+/*@================================
+ * edubtm_FindVersion()
+ *================================*/
+/*
+ * Function: btm_PageVersion *edubtm_FindVersion(PageID*, Four)
+ *
+ * Description:
+ *  Find the oldest version of the page saved after the given epoch. It is
+ *  the page as a snapshot of that epoch sees it: the page did not change
+ *  between the end of the epoch and the saving of the version.
+ *
+ * Returns:
+ *  the version; NULL if the page has not changed since the epoch
+ */
+btm_PageVersion *edubtm_FindVersion(
+    PageID              *pid,           /* IN the page */
+    Four                epoch)          /* IN the epoch */
+{
+    btm_PageVersion     *v;             /* a version in the bucket */
+    btm_PageVersion     *found;         /* the oldest version after the epoch */
+
+
+    found = NULL;
+    for (v = edubtm_versions[edubtm_VersionHash(pid)]; v != NULL; v = v->hashNext) {
+        if (v->epoch > epoch && v->pid.pageNo == pid->pageNo && v->pid.volNo == pid->volNo &&
+            (found == NULL || v->epoch < found->epoch))
+            found = v;
+    }
+
+    return(found);
+
+} /* edubtm_FindVersion() */
+
+
+
+/*@================================
+ * edubtm_SaveVersionOf()
+ *================================*/
+/*
+ * Function: Four edubtm_SaveVersionOf(PageID*)
+ *
+ * Description:
+ *  Save the given page which is not fixed by the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_SaveVersionOf(
+    PageID              *pid)           /* IN the page */
+{
+    Four                e;              /* error number */
+    char                *page;          /* buffer of the page */
+
+
+    e = edubtm_GetTrainForUpdate(pid, &page);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_SaveVersionOf() */
+
+
+
+/*@================================
+ * edubtm_ReclaimVersions()
+ *================================*/
+/*
+ * Function: void edubtm_ReclaimVersions(void)
+ *
+ * Description:
+ *  Free the versions saved in or before the epoch of the oldest open
+ *  snapshot, or all of them if no snapshot is open. Every open snapshot
+ *  has seen the changes of those epochs, so no one reads the versions.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_ReclaimVersions(void)
+{
+    btm_PageVersion     *v;             /* the version to free */
+    btm_PageVersion     **link;         /* link to 'v' in its bucket */
+
+
+    while ((v = edubtm_retireHead) != NULL &&
+           (edubtm_snapshotHead == NULL || v->epoch <= edubtm_snapshotHead->epoch)) {
+        edubtm_retireHead = v->retireNext;
+        if (edubtm_retireHead == NULL) edubtm_retireTail = NULL;
+
+        for (link = &edubtm_versions[edubtm_VersionHash(&v->pid)]; *link != v; link = &(*link)->hashNext);
+        *link = v->hashNext;
+
+        free(v);
+    }
+
+} /* edubtm_ReclaimVersions() */
@@ -32,8 +32,9 @@
  *  parent page.
  *
  * Exports:
- *  Four edubtm_SplitInternal(ObjectID*, BtreeInternal*, Two, InternalItem*, InternalItem*)
- *  Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*)
+ *  Four edubtm_SplitInternal(ObjectID*, BtreeInternal*, Two, InternalItem*, InternalItem*, btm_IndexInfo*)
+ *  Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*, btm_IndexInfo*)
+ *  Four edubtm_SplitLeafEntry(ObjectID*, PageID*, BtreeLeaf*, Two, btm_LeafEntry*, InternalItem*, btm_IndexInfo*)
  */
 
 
@@ -48,7 +49,7 @@
  * edubtm_SplitInternal()
  *================================*/
 /*
- * Function: Four edubtm_SplitInternal(ObjectID*, BtreeInternal*,Two, InternalItem*, InternalItem*)
+ * Function: Four edubtm_SplitInternal(ObjectID*, BtreeInternal*,Two, InternalItem*, InternalItem*, btm_IndexInfo*)
  *
  * Description:
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -63,6 +64,10 @@
  *  A temporary page is used because it is difficult to use the given page
  *  directly and the temporary page will be copied to the given page later.
  *
+ *  When the item is appended to the end of the page during ascending
+ *  insertion, the given page keeps more than half of the entries as
+ *  determined by edubtm_SplitLimit().
+ *
  * Returns:
  *  error code
  *    some errors caused by function calls
@@ -75,7 +80,8 @@ Four edubtm_SplitInternal(
     BtreeInternal               *fpage,                 /* INOUT the page which will be splitted */
     Two                         high,                   /* IN slot No. for the given 'item' */
     InternalItem                *item,                  /* IN the item which will be inserted */
-    InternalItem                *ritem)                 /* OUT the item which will be returned by spliting */
+    InternalItem                *ritem,                 /* OUT the item which will be returned by spliting */
+    btm_IndexInfo               *info)                  /* IN information about the index; NULL if none */
 {
     Four                        e;                      /* error number */
     Two                         i;                      /* slot No. in the given page, fpage */
@@ -83,8 +89,9 @@ Four edubtm_SplitInternal(
     Two                         k;                      /* slot No. in the new page */
     Two                         maxLoop;                /* # of max loops; # of slots in fpage + 1 */
     Four                        sum;                    /* the size of a filled area */
-    Boolean                     flag=FALSE;             /* TRUE if 'item' become a member of fpage */
+    Four                        limit;                  /* the size of the area to fill in fpage */
     PageID                      newPid;                 /* for a New Allocated Page */
+    BtreeInternal               tpage;                  /* a temporary page for the given page */
     BtreeInternal               *npage;                 /* a page pointer for the new allocated page */
     Two                         fEntryOffset;           /* starting offset of an entry in fpage */
     Two                         nEntryOffset;           /* starting offset of an entry in npage */
@@ -96,54 +103,105 @@ Four edubtm_SplitInternal(
     /* 새로운page를 할당받음 */
     e = btm_AllocPage(catObjForFile, &fpage->hdr.pid, &newPid);
     if (e < eNOERROR) ERR(e);
+    if (info != NULL) {
+        info->smoCount++;
+        info->nInternalSplits++;
+    }
     e = BfM_GetNewTrain(&newPid, (char**)&npage, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
 
     /* 할당받은page를 Internal page로 초기화함*/
     e = edubtm_InitInternal(&newPid, FALSE, FALSE);
-    if (e < eNOERROR) ERR(e);
+    if (e < eNOERROR) ERRB1(e, &newPid, PAGE_BUF);
+
+    /* The entries are moved around below; the key heads are rebuilt at the end */
+    edubtm_DropKeyHeads((BtreePage*)fpage);
+    npage->hdr.flags |= fpage->hdr.flags & BTM_INHERITED_FLAGS;
+
+    /* fpage를 얼마나 채울지 결정함 (보통은 절반, 오름차순 append이면 그 이상) */
+    limit = edubtm_SplitLimit(info, (BtreePage*)fpage, high);
 
-    maxLoop = fpage->hdr.nSlots + 1;
+    /* fpage의 entry들은 tpage에 보관하고, fpage는 앞쪽 entry들로 다시 채움 */
+    tpage = *fpage;
+    fpage->hdr.nSlots = 0;
+    fpage->hdr.free = 0;
+    fpage->hdr.unused = 0;
+
+    // 부모로 올라갈 entry 다음에 적어도 하나의 entry가 npage에 남도록 함
+    maxLoop = tpage.hdr.nSlots + 1;
     sum = 0;
-    j = maxLoop - 1;
-    flag = TRUE;
-    // calculate numbers(j) of entries just over half of the fpage.
-    for(i = maxLoop - 1; i >= 0 && sum <= BI_HALF; i--){
-        if (i == high + 1){
-            flag = FALSE;
-            entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + item->klen);
-        }else{
-            fEntryOffset = fpage->slot[-j];
-            fEntry = (btm_InternalEntry*)&fpage->data[fEntryOffset];
-            entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + fEntry->klen);
-            j--;
+    j = 0;
+    for (i = 0; i < maxLoop - 2 && sum < limit; i++) {
+        fEntryOffset = fpage->hdr.free;
+        fpage->slot[-i] = fEntryOffset;
+        fEntry = (btm_InternalEntry*)&fpage->data[fEntryOffset];
+
+        if (i == high + 1) {
+            fEntry->spid = item->spid;
+            fEntry->klen = item->klen;
+            memcpy(fEntry->kval, item->kval, item->klen);
         }
-        fpage->hdr.unused += entryLen + sizeof(SlotNo);
-        sum += entryLen + sizeof(SlotNo);
+        else {
+            nEntry = (btm_InternalEntry*)&tpage.data[tpage.slot[-j]];
+            memcpy(fEntry, nEntry, sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + nEntry->klen));
+            j++;
+        }
+
+        entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + fEntry->klen);
+        fpage->hdr.free += entryLen;
+        sum += entryLen + sizeof(Two);
+    }
+    fpage->hdr.nSlots = i;
+
+    /* 다음 entry의 key는 부모 page로 올라가고, 그 자식 page는 새로운 page의 p0가 됨 */
+    if (i == high + 1) {
+        ritem->spid = item->spid;
+        ritem->klen = item->klen;
+        memcpy(ritem->kval, item->kval, item->klen);
     }
-    fpage->hdr.nSlots = j + 1;
+    else {
+        nEntry = (btm_InternalEntry*)&tpage.data[tpage.slot[-j]];
+        ritem->spid = nEntry->spid;
+        ritem->klen = nEntry->klen;
+        memcpy(ritem->kval, nEntry->kval, nEntry->klen);
+        j++;
+    }
+    i++;
+    npage->hdr.p0 = ritem->spid;
+    ritem->spid = newPid.pageNo;
 
-    k = 0;
-    npage->hdr.p0 = ((btm_InternalEntry*)&fpage->data[fpage->slot[-(j+1)]])->spid;
-    for(i = j + 2; i < maxLoop; i++, k++){
+    /* 나머지 entry들을 새로운 page로 복사함 */
+    for (k = 0; i < maxLoop; i++, k++) {
         nEntryOffset = npage->hdr.free;
         npage->slot[-k] = nEntryOffset;
         nEntry = (btm_InternalEntry*)&npage->data[nEntryOffset];
-        if( i == high + 1 && flag == TRUE){
-            nEntry->klen = item->klen;
+
+        if (i == high + 1) {
             nEntry->spid = item->spid;
+            nEntry->klen = item->klen;
             memcpy(nEntry->kval, item->kval, item->klen);
-            entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + item->klen);
-        } else{
-            fEntryOffset = fpage->slot[-i];
-            fEntry = (btm_InternalEntry*)&fpage->data[fEntryOffset];
-            nEntry->klen = fEntry->klen;
-            nEntry->spid = fEntry->spid;
-            entryLen = sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + fEntry->klen);
-            memcpy(nEntry->kval, fEntry->kval, fEntry->klen);
         }
-        npage->hdr.free += entryLen + sizeof(SlotNo);
+        else {
+            fEntry = (btm_InternalEntry*)&tpage.data[tpage.slot[-j]];
+            memcpy(nEntry, fEntry, sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + fEntry->klen));
+            j++;
+        }
+
+        npage->hdr.free += sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two) + nEntry->klen);
     }
+    npage->hdr.nSlots = k;
+
+    // Split된 page가 ROOT일 경우, type을 INTERNAL로 변경함
+    if (fpage->hdr.type & ROOT)
+        fpage->hdr.type = INTERNAL;
+
+    edubtm_BuildKeyHeads((BtreePage*)fpage, NULL);
+    edubtm_BuildKeyHeads((BtreePage*)npage, NULL);
+
+    e = BfM_SetDirty(&newPid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &newPid, PAGE_BUF);
+    e = BfM_FreeTrain(&newPid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
     
     return(eNOERROR);
     
@@ -155,7 +213,7 @@ Four edubtm_SplitInternal(
  * edubtm_SplitLeaf()
  *================================*/
 /*
- * Function: Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*)
+ * Function: Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalItem*, btm_IndexInfo*)
  *
  * Description: 
  * (Following description is for original ODYSSEUS/COSMOS BtM.
@@ -167,6 +225,12 @@ Four edubtm_SplitInternal(
  *  Internal pages do not maintain the linked list, but leaves do it, so links
  *  are properly updated.
  *
+ *  When the item is appended to the end of the rightmost leaf, or to the end
+ *  of a leaf during ascending insertion, the given page keeps more than half
+ *  of the entries as determined by edubtm_SplitLimit(); with a ratio of 100
+ *  only the new item goes to the new page. If the new page is the rightmost
+ *  leaf, it is remembered in 'info' for the next insertion.
+ *
  * Returns:
  *  Error code
  *  eDUPLICATEDOBJECTID_BTM
@@ -181,7 +245,61 @@ Four edubtm_SplitLeaf(
     BtreeLeaf                   *fpage,         /* INOUT the page which will be splitted */
     Two                         high,           /* IN slotNo for the given 'item' */
     LeafItem                    *item,          /* IN the item which will be inserted */
-    InternalItem                *ritem)         /* OUT the item which will be returned by spliting */
+    InternalItem                *ritem,         /* OUT the item which will be returned by spliting */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
+{
+    Four                        e;              /* error number */
+    btm_LeafEntry               *itemEntry;     /* entry for the given 'item' */
+    ObjectID                    entryBuf[(BTM_LEAFENTRY_FIXED+MAXKEYLEN)/sizeof(ObjectID) + 2]; /* space for 'itemEntry' */
+
+
+    /*
+    -----------------------------------------------------
+    |  nObjects |  klen  |   key   |  value(Object ID)  |
+    -----------------------------------------------------
+    */
+    itemEntry = (btm_LeafEntry*)entryBuf;
+    itemEntry->nObjects = item->nObjects;
+    itemEntry->klen = item->klen;
+    memcpy(itemEntry->kval, item->kval, item->klen);
+    memcpy(&itemEntry->kval[ALIGNED_LENGTH(item->klen)], &item->oid, OBJECTID_SIZE);
+
+    e = edubtm_SplitLeafEntry(catObjForFile, root, fpage, high, itemEntry, ritem, info);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubtm_SplitLeaf() */
+
+
+
+/*@================================
+ * edubtm_SplitLeafEntry()
+ *================================*/
+/*
+ * Function: Four edubtm_SplitLeafEntry(ObjectID*, PageID*, BtreeLeaf*, Two, btm_LeafEntry*, InternalItem*, btm_IndexInfo*)
+ *
+ * Description:
+ *  Split the leaf page as edubtm_SplitLeaf() does, inserting the given leaf
+ *  entry after the slot 'high'. The entry may hold any number of ObjectIDs
+ *  or the first overflow page of its key, so that an entry which outgrows
+ *  its page by a new ObjectID can be moved with the split.
+ *
+ * Returns:
+ *  Error code
+ *    some errors caused by function calls
+ *
+ * Note:
+ *  The caller should call BfM_SetDirty() for 'fpage'.
+ */
+Four edubtm_SplitLeafEntry(
+    ObjectID                    *catObjForFile, /* IN catalog object of B+ tree file */
+    PageID                      *root,          /* IN PageID for the given page, 'fpage' */
+    BtreeLeaf                   *fpage,         /* INOUT the page which will be splitted */
+    Two                         high,           /* IN slotNo for the given 'itemEntry' */
+    btm_LeafEntry               *itemEntry,     /* IN the entry which will be inserted */
+    InternalItem                *ritem,         /* OUT the item which will be returned by spliting */
+    btm_IndexInfo               *info)          /* INOUT information about the index; NULL if none */
 {
     Four                        e;              /* error number */
     Two                         i;              /* slot No. in the given page, fpage */
@@ -189,12 +307,12 @@ Four edubtm_SplitLeaf(
     Two                         k;              /* slot No. in the new page */
     Two                         maxLoop;        /* # of max loops; # of slots in fpage + 1 */
     Four                        sum;            /* the size of a filled area */
+    Four                        limit;          /* the size of the area to fill in fpage */
     PageID                      newPid;         /* for a New Allocated Page */
     PageID                      nextPid;        /* for maintaining doubly linked list */
     BtreeLeaf                   tpage;          /* a temporary page for the given page */
     BtreeLeaf                   *npage;         /* a page pointer for the new page */
     BtreeLeaf                   *mpage;         /* for doubly linked list */
-    btm_LeafEntry               *itemEntry;     /* entry for the given 'item' */
     btm_LeafEntry               *fEntry;        /* an entry in the given page, 'fpage' */
     btm_LeafEntry               *nEntry;        /* an entry in the new page, 'npage' */
     ObjectID                    *iOidArray;     /* ObjectID array of 'itemEntry' */
@@ -210,67 +328,73 @@ Four edubtm_SplitLeaf(
     /* 새로운page를 할당받음 */
     e = btm_AllocPage(catObjForFile, root, &newPid);
     if (e < eNOERROR) ERR(e);
+    if (info != NULL) {
+        info->smoCount++;
+        info->nLeafSplits++;
+    }
     e = BfM_GetNewTrain(&newPid, (char**)&npage, PAGE_BUF);
     if (e < eNOERROR) ERR(e);
 
     /* 할당받은page를 leaf page로 초기화함*/
     e = edubtm_InitLeaf(&newPid, FALSE, FALSE);
     if (e < eNOERROR) ERR(e);
+
+    /* The entries are moved around below; the key heads are rebuilt at the end */
+    edubtm_DropKeyHeads((BtreePage*)fpage);
+    npage->hdr.flags |= fpage->hdr.flags & BTM_INHERITED_FLAGS;
     
-    itemEntryLen = sizeof(Two) + sizeof(Two) + ALIGNED_LENGTH(item->klen) + sizeof(ObjectID); 
+    itemEntryLen = BTM_LEAFENTRY_LEN(fpage, itemEntry);
+
+    /* fpage를 얼마나 채울지 결정함 (보통은 절반, append이면 그 이상) */
+    limit = edubtm_SplitLimit(info, (BtreePage*)fpage, high);
+
+    /* fpage의 entry들은 tpage에 보관하고, fpage는 앞쪽 entry들로 다시 채움 */
+    tpage = *fpage;
+    fpage->hdr.nSlots = 0;
+    fpage->hdr.free = 0;
+    fpage->hdr.unused = 0;
 
-    // calculate numbers(j) of entries just over half of the fpage.
+    // fill fpage with the entries just over the limit.
+    // at least one entry remains for npage.
     sum = 0;
     j = 0;
-    maxLoop = fpage->hdr.nSlots + 1;
-    for(i = 0; i < maxLoop && sum <= BL_HALF; i++){
+    maxLoop = tpage.hdr.nSlots + 1;
+    for(i = 0; i < maxLoop - 1 && sum < limit; i++){
+        fEntryOffset = fpage->hdr.free;
+        fpage->slot[-i] = fEntryOffset;
+        fEntry = (btm_LeafEntry*)&fpage->data[fEntryOffset];
 
         if (i == high + 1){
             // item slotNo (high) is inside fpage
-            flag = TRUE;
-            entryLen = itemEntryLen; 
+            memcpy(fEntry, itemEntry, itemEntryLen);
+            entryLen = itemEntryLen;
         }else{
-            fEntryOffset = fpage->slot[-j];
-            fEntry = &fpage->data[fEntryOffset];
-            entryLen = sizeof(Two) + sizeof(Two) + ALIGNED_LENGTH(fEntry->klen) + sizeof(ObjectID); 
+            nEntry = (btm_LeafEntry*)&tpage.data[tpage.slot[-j]];
+            entryLen = BTM_LEAFENTRY_LEN(&tpage, nEntry);
+            memcpy(fEntry, nEntry, entryLen);
             j++;
         }
+        fpage->hdr.free += entryLen;
         sum += (entryLen + sizeof(Two));
     }
-    // fpage has only j entries now.
-    // slots from slot[j] should be moved into npage.
-    fpage->hdr.nSlots = j;
+    fpage->hdr.nSlots = i;
 
-    // remaining entries of fpage (j~nSlots) should be copied into npage.
+    // remaining entries (i~maxLoop-1) should be copied into npage.
     for (k = 0; i < maxLoop; i++, k++){
         nEntryOffset = npage->hdr.free;
         npage->slot[-k] = nEntryOffset;
-        nEntry = &npage->data[nEntryOffset];
+        nEntry = (btm_LeafEntry*)&npage->data[nEntryOffset];
         
         if (i == high + 1){
             // item slotNo (high) is inside npage
-            nEntry->klen = item->klen;
-            nEntry->nObjects = item->nObjects;
-            
+            memcpy(nEntry, itemEntry, itemEntryLen);
             entryLen = itemEntryLen;
-            memcpy(nEntry->kval, item->kval, item->klen);
-            memcpy(&nEntry->kval[ALIGNED_LENGTH(item->klen)], &item->oid, OBJECTID_SIZE);
         }
         else{
-            // copy fpage entry into npage from slot[j]
-            fEntryOffset = fpage->slot[-j];
-            fEntry = &fpage->data[fEntryOffset];
-            entryLen = sizeof(Two) + sizeof(Two) + ALIGNED_LENGTH(fEntry->klen) + sizeof(ObjectID);
+            // copy the entry of the old fpage into npage
+            fEntry = (btm_LeafEntry*)&tpage.data[tpage.slot[-j]];
+            entryLen = BTM_LEAFENTRY_LEN(&tpage, fEntry);
             memcpy(nEntry, fEntry, entryLen);
-            /* look at page 16 of manual.
-             * we are removing fEntry from fpage.
-             * if fEntry is the last object of data area just before conti-free area,
-             * starting address of continuous free area should be reduced. */
-            if (fEntryOffset + entryLen == fpage->hdr.free)
-                fpage->hdr.free -= entryLen;
-            else
-            // else, just increase unused area.
-                fpage->hdr.unused += entryLen;
             j++;
         }
         // update continuous free area address.
@@ -278,33 +402,6 @@ Four edubtm_SplitLeaf(
     }
     npage->hdr.nSlots = k;
 
-    // this flag means that item slotNo (high) is inside fpage
-    // therefore, we need to insert input item into fpage at high.
-    if(flag){
-        // shift other pages
-        for(i = fpage->hdr.nSlots - 1; i > high; i--){
-            fpage->slot[-(i+1)] = fpage->slot[-i];
-        }
-        // compact page if you need to.
-        if (BI_CFREE(fpage) < itemEntryLen){
-            edubtm_CompactLeafPage(fpage, NIL);
-        }
-        
-        // we will add the item at the end of free area.
-        fpage->slot[-(high + 1)] = fpage->hdr.free;
-
-        // copy item into the end of free area.
-        fEntry = &fpage->data[fpage->hdr.free];
-        fEntry->nObjects = item->nObjects;
-        fEntry->klen = item->klen;
-        memcpy(fEntry->kval, item->kval, item->klen);        
-        memcpy(&fEntry->kval[ALIGNED_LENGTH(item->klen)], &item->oid, OBJECTID_SIZE);
-
-        // now update the continuous free area address.
-        fpage->hdr.free += sizeof(Two) + sizeof(Two) + ALIGNED_LENGTH(item->klen) + sizeof(ObjectID);
-        fpage->hdr.nSlots ++;
-    }
-
 
     /*할당받은page를leaf page들간의 doubly linked list에 추가함
     – 할당받은page가overflow가 발생한 page의 다음 page가 되도록 추가함 */
@@ -324,7 +421,7 @@ Four edubtm_SplitLeaf(
     if (npage->hdr.nextPage != NIL){
         // acquire n.next (it was f')
         MAKE_PAGEID(nextPid, npage->hdr.pid.volNo, npage->hdr.nextPage);
-        e = BfM_GetTrain(&nextPid, &mpage, PAGE_BUF);
+        e = edubtm_GetTrainForUpdate(&nextPid, (char**)&mpage);
         if(e < eNOERROR) ERR(e);
         
         mpage->hdr.prevPage = npage->hdr.pid.pageNo;
@@ -344,10 +441,17 @@ Four edubtm_SplitLeaf(
     memcpy(ritem->kval, nEntry->kval, nEntry->klen);
     ritem->spid = npage->hdr.pid.pageNo;
 
+    // npage가 마지막 leaf page이면 다음 삽입을 위해 기억해 둠
+    if (info != NULL && npage->hdr.nextPage == NIL)
+        info->rightmostLeaf = newPid;
+
     // Split된 page가 ROOT일 경우, type을 LEAF로 변경함
     if (fpage->hdr.type & ROOT)
         fpage->hdr.type = LEAF;
 
+    edubtm_BuildKeyHeads((BtreePage*)fpage, NULL);
+    edubtm_BuildKeyHeads((BtreePage*)npage, NULL);
+
     e = BfM_SetDirty(&newPid, PAGE_BUF);
     if(e < eNOERROR) ERR(e);
     e = BfM_FreeTrain(&newPid, PAGE_BUF);
@@ -355,4 +459,4 @@ Four edubtm_SplitLeaf(
 
     return(eNOERROR);
     
-} /* edubtm_SplitLeaf() */
+} /* edubtm_SplitLeafEntry() */
@@ -0,0 +1,480 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_WriteBuffer.c
+ *
+ * Description :
+ *  Write buffer of an index whose 'writeBufferKB' is not 0. The insertions
+ *  into the index are kept in memory in a skip list ordered by <key,
+ *  ObjectID>, and are merged into the tree in key order, in batches of at
+ *  most BTM_WB_FLUSHBATCH pairs: all of them when the memory cap would be
+ *  passed, or those of a key range before the range is searched.
+ *
+ *  Each pair is a node allocated by itself and freed as soon as it leaves
+ *  the buffer, so the memory counted against the cap is the memory in use.
+ *  A node is linked at a random number of levels, each level holding about
+ *  a quarter of the nodes of the level below it.
+ *
+ *  The buffer is merged only by the calls on the index; no thread merges
+ *  it in the background. A search does not read the skip list alongside
+ *  the tree: the pairs of its key range are merged into the tree first,
+ *  so a read of a range with buffered pairs pays for their insertion.
+ *
+ * Exports:
+ *  Four edubtm_BufferWrite(ObjectID*, btm_IndexInfo*, KeyDesc*, KeyValue*, ObjectID*, Boolean*)
+ *  Four edubtm_FlushWriteBuffer(PageID*, KeyValue*, Four, KeyValue*, Four)
+ *  void edubtm_FreeWriteBuffer(btm_IndexInfo*)
+ */
+
+
+#include <stddef.h> /* for offsetof */
+#include <stdlib.h>
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+/*@ Constant Definitions */
+#define WRITEBUFFER_SEED    2463534242U     /* initial state of the generator of the node levels */
+
+/*@ Macro Definitions */
+/* offset of the links of a node with a key of 'klen' bytes; the links follow the key */
+#define WRITENODE_LINKS(klen) \
+    ((offsetof(btm_WriteNode, kval) + (klen) + sizeof(btm_WriteNode*) - 1) / sizeof(btm_WriteNode*) * sizeof(btm_WriteNode*))
+/* size of a node with a key of 'klen' bytes linked at 'nLevels' levels */
+#define WRITENODE_SIZE(klen, nLevels) \
+    ((Four)(WRITENODE_LINKS(klen) + (nLevels) * sizeof(btm_WriteNode*)))
+
+
+/*@ Internal Function Prototypes */
+Four edubtm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*, btm_LeafHint*);
+Four edubtm_CompareWriteNode(KeyDesc*, btm_WriteNode*, KeyValue*, ObjectID*);
+btm_WriteNode *edubtm_SeekWriteBuffer(btm_WriteBuffer*, KeyValue*, ObjectID*, btm_WriteNode***);
+void edubtm_UnlinkWriteNode(btm_WriteBuffer*, btm_WriteNode*, btm_WriteNode***);
+Two edubtm_WriteNodeLevels(btm_WriteBuffer*);
+
+
+
+/*@================================
+ * edubtm_BufferWrite()
+ *================================*/
+/*
+ * Function: Four edubtm_BufferWrite(ObjectID*, btm_IndexInfo*, KeyDesc*, KeyValue*, ObjectID*, Boolean*)
+ *
+ * Description:
+ *  Put the insertion of <kval, oid> into the write buffer of the index, if
+ *  the index has one. If the pair would take the buffer over its memory
+ *  cap, the buffer is merged into the tree first. A pair, or for a unique
+ *  index a key, already in the buffer is rejected as the tree would reject
+ *  it. The key of a unique index is also looked for in the tree, after its
+ *  insertions buffered at the root are flushed, so that a key already in
+ *  the index is rejected at once; a pair of a non-unique index already in
+ *  the tree is dropped when the buffer is merged.
+ *
+ * Returns:
+ *  Error code
+ *    eDUPLICATEDKEY_BTM
+ *    eDUPLICATEDOBJECTID_BTM
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  done : TRUE if the insertion was buffered; FALSE if it should be made
+ *         in the tree
+ */
+Four edubtm_BufferWrite(
+    ObjectID            *catObjForFile, /* IN catalog object of B+ tree file */
+    btm_IndexInfo       *info,          /* INOUT information about the index; NULL if none */
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid,           /* IN ObjectID to insert */
+    Boolean             *done)          /* OUT TRUE if the insertion was buffered */
+{
+    Four                e;              /* error number */
+    Four                i;              /* level */
+    Four                size;           /* size of the new node */
+    Two                 nLevels;        /* # of levels of the new node */
+    Boolean             unique;         /* TRUE if the keys of the index are unique */
+    Boolean             mayContain;     /* FALSE if the Bloom filter rules the key out */
+    BtreeCursor         cursor;         /* result of the search of the key in the tree */
+    btm_WriteBuffer     *wb;            /* the write buffer */
+    btm_WriteNode       *node;          /* the new node */
+    btm_WriteNode       *succ;          /* the first node not before the new one */
+    btm_WriteNode       **update[BTM_WB_MAXLEVELS]; /* link to the new node at each level */
+
+
+    *done = FALSE;
+
+    if (info == NULL || info->params.writeBufferKB == 0) return(eNOERROR);
+
+    wb = &info->writeBuffer;
+    nLevels = edubtm_WriteNodeLevels(wb);
+    size = WRITENODE_SIZE(kval->len, nLevels);
+
+    /*@ make room for the pair */
+    if (wb->nPairs > 0 && wb->nBytes + size > info->params.writeBufferKB * 1024) {
+        e = edubtm_FlushWriteBuffer(&info->root, NULL, SM_BOF, NULL, SM_EOF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    /*@ a unique key in the tree is rejected as the tree would reject it */
+    unique = (kdesc->flag & KEYFLAG_UNIQUE) ? TRUE : FALSE;
+    if (unique) {
+        e = edubtm_FlushMessages(&info->root, kval, SM_EQ, kval, SM_EQ);
+        if (e < eNOERROR) ERR(e);
+
+        /* a rebuild of the filter may merge the buffer; it is searched after this */
+        e = edubtm_CheckBloomFilter(&info->root, info, kval, &mayContain);
+        if (e < eNOERROR) ERR(e);
+
+        if (mayContain) {
+            e = edubtm_Fetch(&info->root, kdesc, kval, SM_EQ, kval, SM_EQ, &cursor, NULL);
+            if (e < eNOERROR) ERR(e);
+            if (cursor.flag == CURSOR_ON) ERR(eDUPLICATEDKEY_BTM);
+        }
+    }
+
+    if (wb->nPairs == 0) {
+        wb->catObjForFile = *catObjForFile;
+        wb->kdesc = *kdesc;
+    }
+
+    /*@ find the place of the pair; a unique key is looked for with any ObjectID */
+    succ = edubtm_SeekWriteBuffer(wb, kval, unique ? NULL : oid, update);
+    if (succ != NULL && edubtm_KeyCompare(kdesc, (KeyValue*)&succ->klen, kval) == EQUAL) {
+        if (unique) ERR(eDUPLICATEDKEY_BTM);
+        if (btm_ObjectIdComp(&succ->oid, oid) == EQUAL) ERR(eDUPLICATEDOBJECTID_BTM);
+    }
+
+    /*@ link a new node */
+    node = (btm_WriteNode*)malloc(size);
+    if (node == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+    node->oid = *oid;
+    node->next = (btm_WriteNode**)((char*)node + WRITENODE_LINKS(kval->len));
+    node->nLevels = nLevels;
+    node->klen = kval->len;
+    memcpy(node->kval, kval->val, kval->len);
+
+    for (i = wb->nLevels; i < nLevels; i++) update[i] = &wb->head[i];
+    if (nLevels > wb->nLevels) wb->nLevels = nLevels;
+
+    for (i = 0; i < nLevels; i++) {
+        node->next[i] = *update[i];
+        *update[i] = node;
+    }
+
+    wb->nPairs++;
+    wb->nBytes += size;
+
+    *done = TRUE;
+
+    return(eNOERROR);
+
+} /* edubtm_BufferWrite() */
+
+
+
+/*@================================
+ * edubtm_FlushWriteBuffer()
+ *================================*/
+/*
+ * Function: Four edubtm_FlushWriteBuffer(PageID*, KeyValue*, Four, KeyValue*, Four)
+ *
+ * Description:
+ *  Merge the pairs of the write buffer whose keys are in the range given
+ *  as in EduBtM_Fetch() into the tree. If either end of the range is SM_BOF
+ *  or SM_EOF, the range is open on that side; the range (SM_BOF, SM_EOF)
+ *  empties the buffer. The pairs are taken out of the buffer in key order
+ *  and inserted by edubtm_ApplyMessages() in batches of BTM_WB_FLUSHBATCH.
+ *
+ * Returns:
+ *  Error code
+ *    eMEMORYALLOCERR_EDUBTM
+ *    some errors caused by function calls
+ */
+Four edubtm_FlushWriteBuffer(
+    PageID              *root,          /* IN root page of the index */
+    KeyValue            *startKval,     /* IN key value of start condition */
+    Four                startCompOp,    /* IN comparison operator of start condition */
+    KeyValue            *stopKval,      /* IN key value of stop condition */
+    Four                stopCompOp)     /* IN comparison operator of stop condition */
+{
+    Four                e;              /* error number */
+    Four                i;              /* level */
+    Four                n;              /* # of pairs in the batch */
+    KeyValue            *lo;            /* lower end of the range; NULL if none */
+    KeyValue            *hi;            /* upper end of the range; NULL if none */
+    ObjectID            catObjForFile;  /* catalog object of B+ tree file */
+    KeyDesc             kdesc;          /* key descriptor of the index */
+    btm_IndexInfo       *info;          /* information about the index */
+    btm_WriteBuffer     *wb;            /* the write buffer */
+    btm_WriteNode       *node;          /* the next node in the range */
+    btm_WriteNode       **update[BTM_WB_MAXLEVELS]; /* link to 'node' at each level */
+    btm_SortPair        *pairs;         /* the batch */
+
+
+    info = edubtm_GetIndexInfo(root, FALSE);
+    if (info == NULL || info->writeBuffer.nPairs == 0) return(eNOERROR);
+
+    wb = &info->writeBuffer;
+    catObjForFile = wb->catObjForFile;
+    kdesc = wb->kdesc;
+
+    /*@ the ends of the range */
+    lo = hi = NULL;
+    if (startCompOp != SM_BOF && stopCompOp != SM_BOF) {
+        if (startCompOp == SM_EOF) lo = stopKval;
+        else if (stopCompOp == SM_EOF) lo = startKval;
+        else lo = (edubtm_KeyCompare(&kdesc, startKval, stopKval) == GREATER) ? stopKval : startKval;
+    }
+    if (startCompOp != SM_EOF && stopCompOp != SM_EOF) {
+        if (startCompOp == SM_BOF) hi = stopKval;
+        else if (stopCompOp == SM_BOF) hi = startKval;
+        else hi = (edubtm_KeyCompare(&kdesc, startKval, stopKval) == GREATER) ? startKval : stopKval;
+    }
+
+    if (lo != NULL)
+        node = edubtm_SeekWriteBuffer(wb, lo, NULL, update);
+    else {
+        for (i = 0; i < wb->nLevels; i++) update[i] = &wb->head[i];
+        node = wb->head[0];
+    }
+
+    /*@ take the pairs out in key order and merge them batch by batch */
+    pairs = NULL;
+    n = 0;
+    while (node != NULL && (hi == NULL || edubtm_KeyCompare(&kdesc, (KeyValue*)&node->klen, hi) != GREATER)) {
+        if (pairs == NULL) {
+            pairs = (btm_SortPair*)malloc(sizeof(btm_SortPair) * BTM_WB_FLUSHBATCH);
+            if (pairs == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+        }
+
+        pairs[n].oid = node->oid;
+        pairs[n].kval.len = node->klen;
+        memcpy(pairs[n].kval.val, node->kval, node->klen);
+        n++;
+
+        /* the predecessors of the node stay, so 'update' gives the node after it */
+        edubtm_UnlinkWriteNode(wb, node, update);
+        node = *update[0];
+
+        if (n == BTM_WB_FLUSHBATCH) {
+            e = edubtm_ApplyMessages(root, &catObjForFile, &kdesc, pairs, n);
+            if (e < eNOERROR) {
+                free(pairs);
+                ERR(e);
+            }
+            n = 0;
+        }
+    }
+
+    if (n > 0) {
+        e = edubtm_ApplyMessages(root, &catObjForFile, &kdesc, pairs, n);
+        if (e < eNOERROR) {
+            free(pairs);
+            ERR(e);
+        }
+    }
+
+    free(pairs);
+
+    return(eNOERROR);
+
+} /* edubtm_FlushWriteBuffer() */
+
+
+
+/*@================================
+ * edubtm_FreeWriteBuffer()
+ *================================*/
+/*
+ * Function: void edubtm_FreeWriteBuffer(btm_IndexInfo*)
+ *
+ * Description:
+ *  Free the nodes of the write buffer of the index without merging them
+ *  into the tree, and make the buffer empty.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_FreeWriteBuffer(
+    btm_IndexInfo       *info)          /* INOUT information about the index */
+{
+    Four                i;              /* level */
+    btm_WriteBuffer     *wb;            /* the write buffer */
+    btm_WriteNode       *node;          /* a node */
+    btm_WriteNode       *next;          /* node after 'node' */
+
+
+    wb = &info->writeBuffer;
+
+    for (node = wb->head[0]; node != NULL; node = next) {
+        next = node->next[0];
+        free(node);
+    }
+
+    for (i = 0; i < BTM_WB_MAXLEVELS; i++) wb->head[i] = NULL;
+    wb->nLevels = 0;
+    wb->nPairs = 0;
+    wb->nBytes = 0;
+    wb->seed = WRITEBUFFER_SEED;
+
+} /* edubtm_FreeWriteBuffer() */
+
+
+
+/*@================================
+ * edubtm_CompareWriteNode()
+ *================================*/
+/*
+ * Function: Four edubtm_CompareWriteNode(KeyDesc*, btm_WriteNode*, KeyValue*, ObjectID*)
+ *
+ * Description:
+ *  Compare the pair of a node with <kval, oid>. If 'oid' is NULL, only the
+ *  keys are compared.
+ *
+ * Returns:
+ *  LESS, EQUAL or GREATER as the pair of the node is before, the same as,
+ *  or after the given pair
+ */
+Four edubtm_CompareWriteNode(
+    KeyDesc             *kdesc,         /* IN key descriptor */
+    btm_WriteNode       *node,          /* IN a node */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid)           /* IN ObjectID; NULL to compare the keys only */
+{
+    Four                cmp;            /* result of comparison */
+
+
+    cmp = edubtm_KeyCompare(kdesc, (KeyValue*)&node->klen, kval);
+    if (cmp != EQUAL || oid == NULL) return(cmp);
+
+    return(btm_ObjectIdComp(&node->oid, oid));
+
+} /* edubtm_CompareWriteNode() */
+
+
+
+/*@================================
+ * edubtm_SeekWriteBuffer()
+ *================================*/
+/*
+ * Function: btm_WriteNode *edubtm_SeekWriteBuffer(btm_WriteBuffer*, KeyValue*, ObjectID*, btm_WriteNode***)
+ *
+ * Description:
+ *  Find the first node not before <kval, oid>, or the first node of the
+ *  key if 'oid' is NULL. At each level in use, 'update' is set to the link
+ *  of the last node before it, or to the head of the level.
+ *
+ * Returns:
+ *  the node found; NULL if every node is before the pair
+ */
+btm_WriteNode *edubtm_SeekWriteBuffer(
+    btm_WriteBuffer     *wb,            /* IN the write buffer */
+    KeyValue            *kval,          /* IN key value */
+    ObjectID            *oid,           /* IN ObjectID; NULL for the first node of the key */
+    btm_WriteNode       ***update)      /* OUT link to the node found at each level in use */
+{
+    Four                i;              /* level */
+    btm_WriteNode       **links;        /* links of the last node before the pair; the heads at first */
+
+
+    links = wb->head;
+    for (i = wb->nLevels - 1; i >= 0; i--) {
+        while (links[i] != NULL && edubtm_CompareWriteNode(&wb->kdesc, links[i], kval, oid) == LESS)
+            links = links[i]->next;
+        update[i] = &links[i];
+    }
+
+    return((wb->nLevels > 0) ? *update[0] : NULL);
+
+} /* edubtm_SeekWriteBuffer() */
+
+
+
+/*@================================
+ * edubtm_UnlinkWriteNode()
+ *================================*/
+/*
+ * Function: void edubtm_UnlinkWriteNode(btm_WriteBuffer*, btm_WriteNode*, btm_WriteNode***)
+ *
+ * Description:
+ *  Unlink the node which 'update' leads to at each of its levels, as set
+ *  by edubtm_SeekWriteBuffer(), and free it.
+ *
+ * Returns:
+ *  None
+ */
+void edubtm_UnlinkWriteNode(
+    btm_WriteBuffer     *wb,            /* INOUT the write buffer */
+    btm_WriteNode       *node,          /* IN the node to unlink */
+    btm_WriteNode       ***update)      /* INOUT link to the node at each level */
+{
+    Four                i;              /* level */
+
+
+    for (i = 0; i < node->nLevels; i++) *update[i] = node->next[i];
+
+    while (wb->nLevels > 0 && wb->head[wb->nLevels - 1] == NULL) wb->nLevels--;
+
+    wb->nPairs--;
+    wb->nBytes -= WRITENODE_SIZE(node->klen, node->nLevels);
+    free(node);
+
+} /* edubtm_UnlinkWriteNode() */
+
+
+
+/*@================================
+ * edubtm_WriteNodeLevels()
+ *================================*/
+/*
+ * Function: Two edubtm_WriteNodeLevels(btm_WriteBuffer*)
+ *
+ * Description:
+ *  Draw the # of levels of a new node: one more level with probability
+ *  1/4, up to BTM_WB_MAXLEVELS. The generator is a xorshift of 32 bits.
+ *
+ * Returns:
+ *  # of levels
+ */
+Two edubtm_WriteNodeLevels(
+    btm_WriteBuffer     *wb)            /* INOUT the write buffer */
+{
+    Two                 nLevels;        /* # of levels */
+
+
+    for (nLevels = 1; nLevels < BTM_WB_MAXLEVELS; nLevels++) {
+        wb->seed ^= wb->seed << 13;
+        wb->seed ^= wb->seed >> 17;
+        wb->seed ^= wb->seed << 5;
+        if (wb->seed & 3) break;
+    }
+
+    return(nLevels);
+
+} /* edubtm_WriteNodeLevels() */
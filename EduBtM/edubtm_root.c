@@ -79,6 +79,7 @@ Four edubtm_root_insert(
     BtreeLeaf *nextPage;	/* pointer to a buffer holding next page of root */
     btm_InternalEntry *entry;	/* an internal entry */
     Boolean   isTmp;
+    Four      msgPage;		/* first page of the message buffer of the root */
 
     /* 새로운page를 할당받음 */
     e = btm_AllocPage(catObjForFile, root, &newPid);
@@ -87,15 +88,19 @@ Four edubtm_root_insert(
     if (e < eNOERROR) ERR(e);
     
     /* 기존 root page를 할당 받은 page로 복사함 */
-    e = BfM_GetTrain(root, (char**)&rootPage, PAGE_BUF);
+    e = edubtm_GetTrainForUpdate(root, (char**)&rootPage);
     if (e < eNOERROR) ERR(e);
 
     memcpy(newPage, rootPage, PAGESIZE);
     newPage->any.hdr.pid=newPid;
+    newPage->any.hdr.reserved = NIL;
+    msgPage = rootPage->any.hdr.reserved;
 
     /* 기존 root page를 새로운 root page로서 초기화함*/
     e = edubtm_InitInternal(root, TRUE, FALSE);
     if (e < eNOERROR) ERR(e);
+    rootPage->bi.hdr.flags |= newPage->any.hdr.flags & BTM_INHERITED_FLAGS;
+    rootPage->bi.hdr.reserved = msgPage;  /* the root keeps its message buffer */
 
     /*
     * 할당받은page와 root page split으로 생성된 page가 새로운 root page의 자식 page들이 되도록 설정함
@@ -116,16 +121,17 @@ Four edubtm_root_insert(
     rootPage->bi.hdr.free += sizeof(ShortPageID) + ALIGNED_LENGTH(sizeof(Two)+item->klen);
     rootPage->bi.hdr.p0 = newPid.pageNo;
     rootPage->bi.hdr.nSlots = 1;
+    edubtm_BuildKeyHeads(rootPage, NULL);
 
     /*
     * – 새로운root page의 두 자식 page들이leaf인 경우, 두 자식 page들간의doubly linked list를 설정함
     *     » Split으로 생성된 page가 할당 받은 page의 다음 page가되도록설정함
     */
     MAKE_PAGEID(nextPid, rootPage->any.hdr.pid.volNo ,item->spid);
-    e = BfM_GetTrain(&nextPid, (char**)&nextPage, PAGE_BUF);
+    e = edubtm_GetTrainForUpdate(&nextPid, (char**)&nextPage);
     if (e < eNOERROR) ERR(e);
 
-    if ((newPage->any.hdr.flags & LEAF) && (nextPage->hdr.flags & LEAF)){
+    if ((newPage->any.hdr.type & LEAF) && (nextPage->hdr.type & LEAF)){
         newPage->bl.hdr.nextPage = nextPid.pageNo;
         nextPage->hdr.prevPage = newPid.pageNo;
     }
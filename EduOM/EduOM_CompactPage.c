@@ -87,6 +87,7 @@ Four EduOM_CompactPage(
     Four   alignedLen=0;			/* ailgned length of ObjectHdr */
     Two    lastSlot;		/* last non empty slot */
     Two    i;			/* index variable */
+    OM_LATENCY(OM_API_COMPACTPAGE);
 
     // Page의 데이터 영역의 모든 자유공간이 연속된 하나의 contiguous free area를 형성하도록 object들의 offset를 조정함
     // save given page to temporary page
@@ -91,6 +91,7 @@ Four EduOM_CreateObject(
 {
     Four        e;		/* error number */
     ObjectHdr   objectHdr;	/* ObjectHdr with tag set from parameter */
+    OM_LATENCY(OM_API_CREATEOBJECT);
 
 
     /*@ parameter checking */
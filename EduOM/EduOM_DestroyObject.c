@@ -98,6 +98,7 @@ Four EduOM_DestroyObject(
     PhysicalFileID pFid;	/* physical ID of file */
     VolNo volNo;			/* a temporary var for volNo */
     PageNo pageNo;		/* a temporary var for next page's PageNo */
+    OM_LATENCY(OM_API_DESTROYOBJECT);
     
     
 
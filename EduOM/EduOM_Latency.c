@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Latency.c
+ *
+ * Description :
+ *  Count the latencies of the calls of the interface functions of EduOM.
+ *  The histograms are kept by Util_latency.c; this file has the table of
+ *  the interface functions, and UTIL_LATENCY_FUNCTIONS() defines the
+ *  functions below on it.
+ *
+ * Exports:
+ *  Four EduOM_SetLatencyTracking(Boolean, Four)
+ *  Four EduOM_GetLatency(Four, ObjectLatency*)
+ *  Four EduOM_ResetLatency(void)
+ *  Four EduOM_DumpLatency(FILE*)
+ *  Util_LatencyTimer eduom_BeginLatency(Four)
+ *  void eduom_EndLatency(Util_LatencyTimer*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/* Names of the interface functions, in the order of OM_API_* */
+static const char *eduom_apiNames[OM_NAPIS] = {
+    "CompactPage", "CreateObject", "DestroyObject", "NextObject", "PrevObject", "ReadObject" };
+
+static Util_LatencyTable eduom_latency = UTIL_LATENCY_TABLE(eduom_apiNames, OM_NAPIS); /* latencies of EduOM */
+static __thread Util_LatencyThread *eduom_latencyThread = NULL; /* histograms of this thread */
+
+
+/*@
+ * EduOM_SetLatencyTracking(), EduOM_GetLatency(), EduOM_ResetLatency(),
+ * EduOM_DumpLatency(), and eduom_BeginLatency()/eduom_EndLatency() called by OM_LATENCY()
+ */
+UTIL_LATENCY_FUNCTIONS(EduOM, eduom, eduom_latency, eduom_latencyThread, ObjectLatency, eBADPARAMETER_OM, eMEMORYALLOCERR_EDUOM)
@@ -81,6 +81,7 @@ Four EduOM_NextObject(
     PhysicalFileID pFid;	/* file in which the objects are located */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+    OM_LATENCY(OM_API_NEXTOBJECT);
 
 
 
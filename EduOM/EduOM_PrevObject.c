@@ -82,6 +82,7 @@ Four EduOM_PrevObject(
     PhysicalFileID pFid;	/* file in which the objects are located */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    OM_LATENCY(OM_API_PREVOBJECT);
 
 
 
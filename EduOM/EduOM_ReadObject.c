@@ -97,6 +97,7 @@ Four EduOM_ReadObject(
     SlottedPage	*apage;		/* pointer to the buffer of the page  */
     Object	*obj;		/* pointer to the object in the slotted page */
     Four	offset;		/* offset of the object in the page */
+    OM_LATENCY(OM_API_READOBJECT);
 
     
     
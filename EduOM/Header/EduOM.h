@@ -41,6 +41,10 @@ Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_SetLatencyTracking(Boolean, Four);
+Four EduOM_GetLatency(Four, ObjectLatency*);
+Four EduOM_ResetLatency(void);
+Four EduOM_DumpLatency(FILE*);
 
 Four OM_DumpObject(ObjectID *);
 
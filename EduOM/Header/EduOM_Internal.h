@@ -25,6 +25,8 @@
 #ifndef _EDUOM_INTERNAL_H_
 #define _EDUOM_INTERNAL_H_
 
+#include "Util_latency.h"
+
 
 /*@
  * Type Definitions
@@ -75,6 +77,21 @@ typedef struct {
 } SlottedPage;
 
 
+/*
+ * Latency Histograms:
+ *  The latency of each call of an interface function is counted in the
+ *  per-thread histograms of Util_latency.c, which are shared by the
+ *  modules; nothing is counted unless the tracking is switched on by
+ *  EduOM_SetLatencyTracking().
+ */
+/* The interface functions whose latencies are counted */
+enum { OM_API_COMPACTPAGE, OM_API_CREATEOBJECT, OM_API_DESTROYOBJECT,
+       OM_API_NEXTOBJECT, OM_API_PREVOBJECT, OM_API_READOBJECT, OM_NAPIS };
+
+/* The latencies of an interface function, merged over all threads, in microseconds */
+typedef Util_Latency ObjectLatency;
+
+
 /*@
  * Macro Function Definitions
  */
@@ -136,6 +153,17 @@ typedef struct {
 }
 
 
+/* Macro: OM_LATENCY(api)
+ * Description: count the latency of the current call of an interface function;
+ *              must be the last declaration of the function. The latency is
+ *              counted when the function returns, on any path.
+ * Parameters:
+ *  Four api                        : the interface function, one of OM_API_*
+ */
+#define OM_LATENCY(api) \
+    Util_LatencyTimer _latencyTimer __attribute__((cleanup(eduom_EndLatency))) = eduom_BeginLatency(api)
+
+
 /*@
  * Function Prototypes
  */
@@ -148,6 +176,8 @@ Four om_GetUnique(PageID*, Unique*);
 Four om_IsTemporary(FileID*, Boolean*);
 Four om_PutInAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
 Four om_RemoveFromAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
+Util_LatencyTimer eduom_BeginLatency(Four);
+void eduom_EndLatency(Util_LatencyTimer*);
 
     
 #endif /* _EDUOM_INTERNAL_H_ */
@@ -42,6 +42,10 @@ typedef unsigned short          UTwo;
 typedef int                     Four;
 typedef unsigned int            UFour;
 
+/* eight bytes data type */
+typedef long                    Eight;
+typedef unsigned long           UEight;
+
 /* invarialbe size data type */       
 typedef char                    One_Invariable;
 typedef unsigned char           UOne_Invariable;
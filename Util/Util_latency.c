@@ -0,0 +1,453 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: Util_latency.c
+ *
+ * Description :
+ *  Count the latencies of the calls of the interface functions of a module
+ *  in log-bucketed histograms kept per thread, and report them merged over
+ *  all threads, together with the calls slower than a given threshold.
+ *  Shared by EduBfM, EduOM and EduBtM; each module passes its own
+ *  Util_LatencyTable.
+ *
+ * Exports:
+ *  void Util_SetLatencyTracking(Util_LatencyTable*, int, int)
+ *  void Util_GetLatency(Util_LatencyTable*, int, Util_Latency*)
+ *  void Util_ResetLatency(Util_LatencyTable*)
+ *  int Util_DumpLatency(Util_LatencyTable*, FILE*)
+ *  Util_LatencyTimer Util_BeginLatency(Util_LatencyTable*, int)
+ *  void Util_EndLatency(Util_LatencyTable*, Util_LatencyThread**, Util_LatencyTimer*)
+ *  unsigned long Util_LatencyNow(void)
+ *  int Util_LatencyBucket(unsigned long)
+ *  unsigned long Util_LatencyBucketValue(int)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Util_latency.h"
+
+
+/* Order the slow calls by the time they ended */
+static int util_CompareSlowCalls(const void *a, const void *b)
+{
+    const Util_SlowCall *x = a, *y = b;
+
+    return (x->at < y->at) ? -1 : (x->at > y->at) ? 1 : 0;
+}
+
+
+
+/*@================================
+ * Util_SetLatencyTracking()
+ *================================*/
+/*
+ * Function: void Util_SetLatencyTracking(Util_LatencyTable*, int, int)
+ *
+ * Description:
+ *  Switch the counting of the latencies of 'table' on or off. The times
+ *  reported are counted from when the tracking was last switched on. The
+ *  calls taking 'slowUs' microseconds or more are kept as slow calls; none
+ *  is kept if 'slowUs' is 0. The histograms are not cleared; see
+ *  Util_ResetLatency(). 'slowUs' is checked by the caller.
+ *
+ * Returns:
+ *  None
+ */
+void Util_SetLatencyTracking(
+    Util_LatencyTable   *table,         /* INOUT latencies of a module */
+    int                 enable,         /* IN nonzero to count the latencies */
+    int                 slowUs)         /* IN threshold of the slow calls in microseconds; 0 for none */
+{
+    table->slowNs = (unsigned long)slowUs * 1000;
+    if (enable && !table->on) table->epoch = Util_LatencyNow();
+    table->on = enable;
+
+}   /* Util_SetLatencyTracking() */
+
+
+
+/*@================================
+ * Util_GetLatency()
+ *================================*/
+/*
+ * Function: void Util_GetLatency(Util_LatencyTable*, int, Util_Latency*)
+ *
+ * Description:
+ *  Get the latencies of the interface function 'api', merged over all
+ *  threads. A percentile is the upper bound of the bucket holding it, so
+ *  it is over the exact value by less than 1/UTIL_LATENCY_SUBBUCKETS of it.
+ *  The histograms are read while other threads may count into them, so
+ *  the calls ending meanwhile may or may not be included. 'api' is
+ *  checked by the caller.
+ *
+ * Returns:
+ *  None
+ */
+void Util_GetLatency(
+    Util_LatencyTable   *table,         /* IN latencies of a module */
+    int                 api,            /* IN the interface function */
+    Util_Latency        *lat)           /* OUT latencies of the function */
+{
+    Util_LatencyThread  *t;             /* histograms of a thread */
+    unsigned long       counts[UTIL_LATENCY_BUCKETS]; /* the merged histogram */
+    unsigned long       totalNs;        /* sum of the latencies */
+    unsigned long       maxNs;          /* largest latency */
+    unsigned long       seen;           /* # of calls in the buckets passed */
+    unsigned long       rank;           /* # of calls at or below a percentile */
+    unsigned long       value;          /* a latency in nanoseconds */
+    int                 b;              /* bucket No. */
+    int                 q;              /* index of the percentile */
+    double              *pct[4];        /* where the percentiles go */
+    static const double quantiles[4] = { 0.5, 0.9, 0.99, 0.999 };
+
+
+    memset(lat, 0, sizeof(Util_Latency));
+    memset(counts, 0, sizeof(counts));
+    totalNs = maxNs = 0;
+
+    for (t = table->threads; t != NULL; t = t->next) {
+        for (b = 0; b < UTIL_LATENCY_BUCKETS; b++) counts[b] += t->counts[api][b];
+        lat->nCalls += t->nCalls[api];
+        totalNs += t->totalNs[api];
+        if (t->maxNs[api] > maxNs) {
+            maxNs = t->maxNs[api];
+            lat->maxAtMs = t->maxAt[api] / 1e6;
+        }
+    }
+    if (lat->nCalls == 0) return;
+
+    lat->meanUs = (double)totalNs / lat->nCalls / 1e3;
+    lat->maxUs = maxNs / 1e3;
+
+    pct[0] = &lat->p50Us; pct[1] = &lat->p90Us; pct[2] = &lat->p99Us; pct[3] = &lat->p999Us;
+    seen = 0;
+    b = 0;
+    for (q = 0; q < 4; q++) {
+        rank = (unsigned long)(quantiles[q] * lat->nCalls + 0.999999);
+        if (rank == 0) rank = 1;
+        while (b < UTIL_LATENCY_BUCKETS - 1 && seen + counts[b] < rank) seen += counts[b++];
+
+        value = Util_LatencyBucketValue(b);
+        if (value > maxNs) value = maxNs;
+        *pct[q] = value / 1e3;
+    }
+
+}   /* Util_GetLatency() */
+
+
+
+/*@================================
+ * Util_ResetLatency()
+ *================================*/
+/*
+ * Function: void Util_ResetLatency(Util_LatencyTable*)
+ *
+ * Description:
+ *  Clear the histograms and the slow calls of all threads. The calls
+ *  ending while they are cleared may be partly counted.
+ *
+ * Returns:
+ *  None
+ */
+void Util_ResetLatency(
+    Util_LatencyTable   *table)         /* INOUT latencies of a module */
+{
+    Util_LatencyThread  *t;             /* histograms of a thread */
+
+
+    for (t = table->threads; t != NULL; t = t->next) {
+        memset(t->counts, 0, table->nApis * sizeof(t->counts[0]));
+        memset(t->nCalls, 0, table->nApis * sizeof(unsigned long));
+        memset(t->totalNs, 0, table->nApis * sizeof(unsigned long));
+        memset(t->maxNs, 0, table->nApis * sizeof(unsigned long));
+        memset(t->maxAt, 0, table->nApis * sizeof(unsigned long));
+        t->nSlowCalls = 0;
+    }
+
+}   /* Util_ResetLatency() */
+
+
+
+/*@================================
+ * Util_DumpLatency()
+ *================================*/
+/*
+ * Function: int Util_DumpLatency(Util_LatencyTable*, FILE*)
+ *
+ * Description:
+ *  Print the latencies of the interface functions which have been called,
+ *  and then the slow calls kept, in the order they ended, each with the
+ *  function, the thread and the time it ended.
+ *
+ * Returns:
+ *  0 on success, -1 if the memory for sorting the slow calls cannot be
+ *  allocated
+ */
+int Util_DumpLatency(
+    Util_LatencyTable   *table,         /* IN latencies of a module */
+    FILE                *fp)            /* IN file to print to */
+{
+    int                 api;            /* an interface function */
+    int                 i;              /* index */
+    int                 n;              /* # of slow calls */
+    int                 nKept;          /* # of slow calls kept by a thread */
+    Util_SlowCall       *calls;         /* the slow calls of all threads */
+    Util_LatencyThread  *t;             /* histograms of a thread */
+    Util_Latency        lat;            /* latencies of a function */
+
+
+    fprintf(fp, "%-24s %12s %10s %10s %10s %10s %10s %10s %12s\n", "function", "calls",
+            "mean(us)", "p50(us)", "p90(us)", "p99(us)", "p99.9(us)", "max(us)", "max at(ms)");
+    for (api = 0; api < table->nApis; api++) {
+        Util_GetLatency(table, api, &lat);
+        if (lat.nCalls == 0) continue;
+
+        fprintf(fp, "%-24s %12lu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %12.3f\n", table->apiNames[api],
+                lat.nCalls, lat.meanUs, lat.p50Us, lat.p90Us, lat.p99Us, lat.p999Us, lat.maxUs, lat.maxAtMs);
+    }
+
+    /*@ gather the slow calls of all threads */
+    n = 0;
+    for (t = table->threads; t != NULL; t = t->next)
+        n += (t->nSlowCalls < UTIL_LATENCY_SLOWCALLS) ? t->nSlowCalls : UTIL_LATENCY_SLOWCALLS;
+    if (n == 0) return(0);
+
+    calls = (Util_SlowCall*)malloc(n * sizeof(Util_SlowCall));
+    if (calls == NULL) return(-1);
+
+    i = 0;
+    for (t = table->threads; t != NULL && i < n; t = t->next) {
+        nKept = (t->nSlowCalls < UTIL_LATENCY_SLOWCALLS) ? t->nSlowCalls : UTIL_LATENCY_SLOWCALLS;
+        for ( ; nKept > 0 && i < n; nKept--)
+            calls[i++] = t->slowCalls[(t->nSlowCalls - nKept) % UTIL_LATENCY_SLOWCALLS];
+    }
+    n = i;
+    qsort(calls, n, sizeof(Util_SlowCall), util_CompareSlowCalls);
+
+    fprintf(fp, "\nslow calls (>= %lu us)\n", table->slowNs / 1000);
+    fprintf(fp, "%12s %-24s %8s %12s\n", "at(ms)", "function", "thread", "latency(us)");
+    for (i = 0; i < n; i++)
+        fprintf(fp, "%12.3f %-24s %8d %12.2f\n", calls[i].at / 1e6, table->apiNames[calls[i].api],
+                calls[i].threadNo, calls[i].ns / 1e3);
+
+    free(calls);
+
+    return(0);
+
+}   /* Util_DumpLatency() */
+
+
+
+/*@================================
+ * Util_BeginLatency()
+ *================================*/
+/*
+ * Function: Util_LatencyTimer Util_BeginLatency(Util_LatencyTable*, int)
+ *
+ * Description:
+ *  Start the timer of a call of the interface function 'api'. The timer
+ *  is not started if the tracking of 'table' is off.
+ *
+ * Returns:
+ *  the timer
+ */
+Util_LatencyTimer Util_BeginLatency(
+    Util_LatencyTable   *table,         /* IN latencies of a module */
+    int                 api)            /* IN the interface function */
+{
+    Util_LatencyTimer   timer;          /* the timer */
+
+
+    timer.api = api;
+    timer.start = table->on ? Util_LatencyNow() : 0;
+
+    return(timer);
+
+}   /* Util_BeginLatency() */
+
+
+
+/*@================================
+ * Util_EndLatency()
+ *================================*/
+/*
+ * Function: void Util_EndLatency(Util_LatencyTable*, Util_LatencyThread**, Util_LatencyTimer*)
+ *
+ * Description:
+ *  Count the latency of the call timed by 'timer' in the histograms of this
+ *  thread, '*mine', which are made and entered in the list of all threads
+ *  of 'table' on the first call the thread counts. 'mine' is a thread-local
+ *  variable of the module. If the memory for the histograms cannot be
+ *  allocated, the call is not counted.
+ *
+ * Returns:
+ *  None
+ */
+void Util_EndLatency(
+    Util_LatencyTable   *table,         /* INOUT latencies of a module */
+    Util_LatencyThread  **mine,         /* INOUT histograms of this thread */
+    Util_LatencyTimer   *timer)         /* IN the timer of the call */
+{
+    Util_LatencyThread  *t;             /* histograms of this thread */
+    Util_SlowCall       *call;          /* where a slow call is kept */
+    unsigned long       *stats;         /* the arrays of the histograms */
+    unsigned long       end;            /* time the call ended */
+    unsigned long       ns;             /* latency of the call */
+
+
+    if (timer->start == 0) return;
+
+    end = Util_LatencyNow();
+    ns = end - timer->start;
+
+    /*@ make the histograms of this thread */
+    t = *mine;
+    if (t == NULL) {
+        t = (Util_LatencyThread*)calloc(1, sizeof(Util_LatencyThread) +
+                                        table->nApis * (UTIL_LATENCY_BUCKETS + 4) * sizeof(unsigned long));
+        if (t == NULL) return;
+
+        stats = (unsigned long*)(t + 1);
+        t->counts = (unsigned long (*)[UTIL_LATENCY_BUCKETS])stats;
+        t->nCalls = stats + table->nApis * UTIL_LATENCY_BUCKETS;
+        t->totalNs = t->nCalls + table->nApis;
+        t->maxNs = t->totalNs + table->nApis;
+        t->maxAt = t->maxNs + table->nApis;
+
+        t->threadNo = __sync_fetch_and_add(&table->nThreads, 1);
+        do {
+            t->next = table->threads;
+        } while (!__sync_bool_compare_and_swap(&table->threads, t->next, t));
+
+        *mine = t;
+    }
+
+    t->counts[timer->api][Util_LatencyBucket(ns)]++;
+    t->nCalls[timer->api]++;
+    t->totalNs[timer->api] += ns;
+    if (ns > t->maxNs[timer->api]) {
+        t->maxNs[timer->api] = ns;
+        t->maxAt[timer->api] = end - table->epoch;
+    }
+
+    if (table->slowNs > 0 && ns >= table->slowNs) {
+        call = &t->slowCalls[t->nSlowCalls % UTIL_LATENCY_SLOWCALLS];
+        call->api = timer->api;
+        call->threadNo = t->threadNo;
+        call->ns = ns;
+        call->at = end - table->epoch;
+        t->nSlowCalls++;
+    }
+
+}   /* Util_EndLatency() */
+
+
+
+/*@================================
+ * Util_LatencyNow()
+ *================================*/
+/*
+ * Function: unsigned long Util_LatencyNow(void)
+ *
+ * Description:
+ *  Get the time of the monotonic clock in nanoseconds.
+ *
+ * Returns:
+ *  the time
+ */
+unsigned long Util_LatencyNow(void)
+{
+    struct timespec     ts;             /* the time */
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return((unsigned long)ts.tv_sec * 1000000000 + ts.tv_nsec);
+
+}   /* Util_LatencyNow() */
+
+
+
+/*@================================
+ * Util_LatencyBucket()
+ *================================*/
+/*
+ * Function: int Util_LatencyBucket(unsigned long)
+ *
+ * Description:
+ *  Get the bucket of the latency histograms counting 'ns'. The latencies
+ *  below 2 * UTIL_LATENCY_SUBBUCKETS have a bucket each; a larger latency
+ *  is shifted right until it has UTIL_LATENCY_SUBBITS + 1 bits, and its
+ *  bucket is found from the shift and the remaining bits.
+ *
+ * Returns:
+ *  bucket No.
+ */
+int Util_LatencyBucket(
+    unsigned long       ns)             /* IN latency in nanoseconds */
+{
+    int                 shift;          /* # of low bits dropped */
+
+
+    if (ns < 2 * UTIL_LATENCY_SUBBUCKETS) return((int)ns);
+
+    shift = (63 - __builtin_clzl(ns)) - UTIL_LATENCY_SUBBITS;
+    if (shift > UTIL_LATENCY_MAXSHIFT) return(UTIL_LATENCY_BUCKETS - 1);
+
+    return(shift * UTIL_LATENCY_SUBBUCKETS + (int)(ns >> shift));
+
+}   /* Util_LatencyBucket() */
+
+
+
+/*@================================
+ * Util_LatencyBucketValue()
+ *================================*/
+/*
+ * Function: unsigned long Util_LatencyBucketValue(int)
+ *
+ * Description:
+ *  Get the largest latency counted in the bucket 'b'.
+ *
+ * Returns:
+ *  latency in nanoseconds
+ */
+unsigned long Util_LatencyBucketValue(
+    int                 b)              /* IN bucket No. */
+{
+    int                 shift;          /* # of low bits dropped */
+    int                 top;            /* the remaining bits */
+
+
+    if (b < 2 * UTIL_LATENCY_SUBBUCKETS) return((unsigned long)b);
+
+    shift = b / UTIL_LATENCY_SUBBUCKETS - 1;
+    top = b - shift * UTIL_LATENCY_SUBBUCKETS;
+
+    return((((unsigned long)top + 1) << shift) - 1);
+
+}   /* Util_LatencyBucketValue() */
@@ -0,0 +1,188 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _UTIL_LATENCY_H_
+#define _UTIL_LATENCY_H_
+
+#include <stdio.h>
+
+
+/*
+ * Latency Histograms:
+ *  The latency of each call of an interface function is counted in a
+ *  log-bucketed histogram: the values are grouped by their most significant
+ *  bit, and each group is split into UTIL_LATENCY_SUBBUCKETS buckets, so the
+ *  error of a reported value is at most 1/UTIL_LATENCY_SUBBUCKETS of it.
+ *  Each thread counts into its own histograms, which are merged when they
+ *  are read, so the calls do not contend for a shared counter. The calls
+ *  slower than a given threshold are also kept, most recent last, so that
+ *  a spike of the tail latency can be traced to the operation causing it.
+ *  The latencies are in nanoseconds.
+ *
+ *  Each module keeps a Util_LatencyTable with the names of its interface
+ *  functions, and a thread-local pointer to the histograms of the thread.
+ *  This file is shared by the modules, each of which has its own basic
+ *  types, so only the C types are used here: int for Four and unsigned
+ *  long for UEight.
+ */
+#define UTIL_LATENCY_SUBBITS            4   /* log2 of the # of buckets per power of 2 */
+#define UTIL_LATENCY_SUBBUCKETS         (1 << UTIL_LATENCY_SUBBITS)
+#define UTIL_LATENCY_MAXSHIFT           39  /* latencies of 2^(MAXSHIFT+SUBBITS+1) ns or more go to the last bucket */
+#define UTIL_LATENCY_BUCKETS            ((UTIL_LATENCY_MAXSHIFT + 2) * UTIL_LATENCY_SUBBUCKETS)
+#define UTIL_LATENCY_SLOWCALLS          32  /* # of slow calls kept per thread */
+
+
+/*@
+ * Type Definitions
+ */
+/* A call slower than the threshold */
+typedef struct {
+    int             api;                /* the interface function called */
+    int             threadNo;           /* No. of the thread which made the call */
+    unsigned long   ns;                 /* latency of the call */
+    unsigned long   at;                 /* time the call ended, from when the tracking was switched on */
+} Util_SlowCall;
+
+/* The histograms of a thread; the arrays have an element per interface function */
+typedef struct Util_LatencyThread {
+    struct Util_LatencyThread *next;    /* next thread in the list of all threads */
+    int             threadNo;           /* No. of the thread, in the order of their first call */
+    unsigned long   (*counts)[UTIL_LATENCY_BUCKETS]; /* the histograms */
+    unsigned long   *nCalls;            /* # of calls */
+    unsigned long   *totalNs;           /* sum of the latencies */
+    unsigned long   *maxNs;             /* largest latency */
+    unsigned long   *maxAt;             /* time the slowest call ended */
+    int             nSlowCalls;         /* # of slow calls ever kept; the last UTIL_LATENCY_SLOWCALLS are in 'slowCalls' */
+    Util_SlowCall   slowCalls[UTIL_LATENCY_SLOWCALLS]; /* ring of the slow calls */
+} Util_LatencyThread;
+
+/* The latencies of the interface functions of a module */
+typedef struct {
+    const char      **apiNames;         /* names of the interface functions */
+    int             nApis;              /* # of interface functions */
+    int             on;                 /* nonzero if the latencies are counted */
+    unsigned long   epoch;              /* time the tracking was switched on */
+    unsigned long   slowNs;             /* threshold of the slow calls; 0 if none is kept */
+    Util_LatencyThread *threads;        /* histograms of all threads */
+    int             nThreads;           /* # of threads which have counted a call */
+} Util_LatencyTable;
+
+/* Started at the entry of an interface function and ended when it returns */
+typedef struct {
+    int             api;                /* the interface function called */
+    unsigned long   start;              /* time of the entry; 0 if the tracking is off */
+} Util_LatencyTimer;
+
+/* The latencies of an interface function, merged over all threads, in microseconds */
+typedef struct {
+    unsigned long   nCalls;             /* # of calls */
+    double          meanUs;             /* mean latency */
+    double          p50Us;              /* median latency */
+    double          p90Us;              /* 90th percentile latency */
+    double          p99Us;              /* 99th percentile latency */
+    double          p999Us;             /* 99.9th percentile latency */
+    double          maxUs;              /* largest latency */
+    double          maxAtMs;            /* time the slowest call ended, in ms from when the tracking was switched on */
+} Util_Latency;
+
+
+/*@
+ * Macro Definitions
+ */
+/* Macro: UTIL_LATENCY_TABLE(apiNames, nApis)
+ * Description: initializer of a Util_LatencyTable with the tracking off
+ * Parameters:
+ *  const char *apiNames[]          : names of the interface functions
+ *  int nApis                       : # of interface functions
+ */
+#define UTIL_LATENCY_TABLE(apiNames, nApis) { (apiNames), (nApis), 0, 0, 0, NULL, 0 }
+
+/* Macro: UTIL_LATENCY_FUNCTIONS(Module, module, table, thread, Latency, eBadParameter, eMemoryAlloc)
+ * Description: define the latency functions of a module on its Util_LatencyTable;
+ *              expanded in the *_Latency.c file of the module, with its Four,
+ *              Boolean and ERR()
+ *  Four Module_SetLatencyTracking(Boolean enable, Four slowUs) : Util_SetLatencyTracking()
+ *  Four Module_GetLatency(Four api, Latency *lat)               : Util_GetLatency()
+ *  Four Module_ResetLatency(void)                               : Util_ResetLatency()
+ *  Four Module_DumpLatency(FILE *fp)                            : Util_DumpLatency()
+ *  Util_LatencyTimer module_BeginLatency(Four api)              : Util_BeginLatency()
+ *  void module_EndLatency(Util_LatencyTimer *timer)             : Util_EndLatency() into 'thread'
+ *  The interface functions return eBadParameter for a bad parameter and
+ *  eMemoryAlloc if the dump runs out of memory.
+ * Parameters:
+ *  Module, module                  : prefixes of the interface and the internal functions
+ *  Util_LatencyTable table         : latencies of the module
+ *  __thread Util_LatencyThread *thread : histograms of the calling thread
+ *  Latency                         : the module's name of Util_Latency
+ *  eBadParameter, eMemoryAlloc     : error codes of the module
+ */
+#define UTIL_LATENCY_FUNCTIONS(Module, module, table, thread, Latency, eBadParameter, eMemoryAlloc) \
+    Four Module##_SetLatencyTracking(Boolean enable, Four slowUs) \
+    { \
+        if (slowUs < 0) ERR(eBadParameter); \
+        Util_SetLatencyTracking(&(table), enable, slowUs); \
+        return(eNOERROR); \
+    } \
+    Four Module##_GetLatency(Four api, Latency *lat) \
+    { \
+        if (api < 0 || api >= (table).nApis || lat == NULL) ERR(eBadParameter); \
+        Util_GetLatency(&(table), api, lat); \
+        return(eNOERROR); \
+    } \
+    Four Module##_ResetLatency(void) \
+    { \
+        Util_ResetLatency(&(table)); \
+        return(eNOERROR); \
+    } \
+    Four Module##_DumpLatency(FILE *fp) \
+    { \
+        if (fp == NULL) ERR(eBadParameter); \
+        if (Util_DumpLatency(&(table), fp) < 0) ERR(eMemoryAlloc); \
+        return(eNOERROR); \
+    } \
+    Util_LatencyTimer module##_BeginLatency(Four api) \
+    { \
+        return(Util_BeginLatency(&(table), api)); \
+    } \
+    void module##_EndLatency(Util_LatencyTimer *timer) \
+    { \
+        Util_EndLatency(&(table), &(thread), timer); \
+    }
+
+
+/*@
+ * Function Prototypes
+ */
+void Util_SetLatencyTracking(Util_LatencyTable*, int, int);
+void Util_GetLatency(Util_LatencyTable*, int, Util_Latency*);
+void Util_ResetLatency(Util_LatencyTable*);
+int Util_DumpLatency(Util_LatencyTable*, FILE*);
+Util_LatencyTimer Util_BeginLatency(Util_LatencyTable*, int);
+void Util_EndLatency(Util_LatencyTable*, Util_LatencyThread**, Util_LatencyTimer*);
+unsigned long Util_LatencyNow(void);
+int Util_LatencyBucket(unsigned long);
+unsigned long Util_LatencyBucketValue(int);
+
+
+#endif /* _UTIL_LATENCY_H_ */